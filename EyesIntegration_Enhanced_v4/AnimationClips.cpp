@@ -0,0 +1,139 @@
+/**
+ * AnimationClips.cpp
+ *
+ * The clip library - choreography as data (see KeyframeAnimation.h)
+ *
+ * ADDING A CLIP:
+ * 1. Write one PROGMEM Keyframe array per track
+ * 2. List the tracks in a ClipTrack array with CLIP_TRACK()
+ * 3. Append an entry to ANIMATION_CLIPS
+ * Each key costs 4 bytes of flash; no new code is needed.
+ */
+
+#include "KeyframeAnimation.h"
+
+// Named positions (normalized, see ChannelTable.h)
+#define POS_FULL    CHANNEL_POS_FULL
+#define POS_OPEN    0
+#define POS_CLOSED  CHANNEL_POS_FULL
+#define POS_LOW     0                    // Eyes: left / down
+#define POS_HIGH    CHANNEL_POS_FULL     // Eyes: right / up
+
+static const int CENTER_H = eyeCenterPosition<HorizontalLimits>();
+static const int CENTER_V = eyeCenterPosition<VerticalLimits>();
+
+// ============================================================================
+// STARTUP (timing from StartupSettings in EyeConfig.h)
+// ============================================================================
+
+static const uint16_t T_CLOSED = StartupSettings::EYES_CLOSE_DURATION;
+static const uint16_t T_OPENING = T_CLOSED + StartupSettings::EYES_CLOSED_HOLD;
+static const uint16_t T_OPEN = T_OPENING + StartupSettings::EYES_OPEN_DURATION;
+static const uint16_t T_LOOK = StartupSettings::LOOK_AROUND_DURATION / 4;  // Per direction
+static const uint16_t T_CENTER = T_OPEN + StartupSettings::LOOK_AROUND_DURATION;
+static const uint16_t T_STARTUP_END = T_CENTER + StartupSettings::RETURN_TO_CENTER;
+
+static const Keyframe STARTUP_LIDS[] PROGMEM = {
+  KEY(0,         POS_OPEN,   EASE_STEP),
+  KEY(T_CLOSED,  POS_CLOSED, EASE_IN_OUT),   // Close
+  KEY(T_OPENING, POS_CLOSED, EASE_STEP),     // Hold
+  KEY(T_OPEN,    POS_OPEN,   EASE_IN_OUT),   // Open
+};
+
+// Look left, right, up, down, then center (targets; the motion engine moves)
+static const Keyframe STARTUP_H[] PROGMEM = {
+  KEY(0,                   CENTER_H, EASE_STEP),
+  KEY(T_OPEN,              POS_LOW,  EASE_STEP),
+  KEY(T_OPEN + T_LOOK,     POS_HIGH, EASE_STEP),
+  KEY(T_CENTER,            CENTER_H, EASE_STEP),
+};
+
+static const Keyframe STARTUP_V[] PROGMEM = {
+  KEY(0,                   CENTER_V, EASE_STEP),
+  KEY(T_OPEN + 2 * T_LOOK, POS_HIGH, EASE_STEP),
+  KEY(T_OPEN + 3 * T_LOOK, POS_LOW,  EASE_STEP),
+  KEY(T_CENTER,            CENTER_V, EASE_STEP),
+};
+
+static const ClipTrack STARTUP_TRACKS[] PROGMEM = {
+  CLIP_TRACK(TRACK_LIDS, STARTUP_LIDS),
+  CLIP_TRACK(CH_HORIZONTAL, STARTUP_H),
+  CLIP_TRACK(CH_VERTICAL, STARTUP_V),
+};
+
+// ============================================================================
+// EXPRESSIONS
+// ============================================================================
+
+// Wink: left eye only
+static const Keyframe WINK_LID[] PROGMEM = {
+  KEY(0,   POS_OPEN,   EASE_STEP),
+  KEY(150, POS_CLOSED, EASE_IN_OUT),
+  KEY(300, POS_CLOSED, EASE_STEP),
+  KEY(600, POS_OPEN,   EASE_OUT),
+};
+
+static const ClipTrack WINK_TRACKS[] PROGMEM = {
+  CLIP_TRACK(CH_L_UPPER, WINK_LID),
+  CLIP_TRACK(CH_L_LOWER, WINK_LID),
+};
+
+// Sleepy: lids droop to ~60% while the gaze sinks, then perk up
+static const Keyframe SLEEPY_LIDS[] PROGMEM = {
+  KEY(0,    POS_OPEN,         EASE_STEP),
+  KEY(1500, POS_FULL * 5 / 8, EASE_IN_OUT),
+  KEY(2800, POS_FULL * 5 / 8, EASE_STEP),
+  KEY(3200, POS_OPEN,         EASE_OUT),
+};
+
+static const Keyframe SLEEPY_V[] PROGMEM = {
+  KEY(0,    CENTER_V,     EASE_STEP),
+  KEY(1500, CENTER_V / 3, EASE_LINEAR),
+  KEY(2800, CENTER_V / 3, EASE_STEP),
+  KEY(3200, CENTER_V,     EASE_STEP),
+};
+
+static const ClipTrack SLEEPY_TRACKS[] PROGMEM = {
+  CLIP_TRACK(TRACK_LIDS, SLEEPY_LIDS),
+  CLIP_TRACK(CH_VERTICAL, SLEEPY_V),
+};
+
+// Double blink
+static const Keyframe DOUBLE_BLINK_LIDS[] PROGMEM = {
+  KEY(0,   POS_OPEN,   EASE_STEP),
+  KEY(80,  POS_CLOSED, EASE_IN_OUT),
+  KEY(200, POS_OPEN,   EASE_OUT),
+  KEY(280, POS_CLOSED, EASE_IN_OUT),
+  KEY(400, POS_OPEN,   EASE_OUT),
+};
+
+static const ClipTrack DOUBLE_BLINK_TRACKS[] PROGMEM = {
+  CLIP_TRACK(TRACK_LIDS, DOUBLE_BLINK_LIDS),
+};
+
+// ============================================================================
+// LIBRARY
+// ============================================================================
+
+static const char NAME_STARTUP[] PROGMEM = "startup";
+static const char NAME_WINK[] PROGMEM = "wink";
+static const char NAME_SLEEPY[] PROGMEM = "sleepy";
+static const char NAME_DOUBLE_BLINK[] PROGMEM = "double_blink";
+
+#define CLIP(name, durationMs, tracks) \
+  { name, (uint16_t)(durationMs), (uint8_t)(sizeof(tracks) / sizeof(ClipTrack)), tracks }
+
+// Entry 0 is the startup sequence; the rest are expressions
+const AnimationClip ANIMATION_CLIPS[] PROGMEM = {
+  CLIP(NAME_STARTUP, T_STARTUP_END, STARTUP_TRACKS),
+  CLIP(NAME_WINK, 600, WINK_TRACKS),
+  CLIP(NAME_SLEEPY, 3200, SLEEPY_TRACKS),
+  CLIP(NAME_DOUBLE_BLINK, 400, DOUBLE_BLINK_TRACKS),
+};
+
+const uint8_t ANIMATION_CLIP_COUNT = sizeof(ANIMATION_CLIPS) / sizeof(AnimationClip);
+
+static_assert(StartupSettings::EYES_CLOSE_DURATION + StartupSettings::EYES_CLOSED_HOLD +
+              StartupSettings::EYES_OPEN_DURATION + StartupSettings::LOOK_AROUND_DURATION +
+              StartupSettings::RETURN_TO_CENTER <= 65535UL,
+              "Startup clip exceeds the 65 s key time range");
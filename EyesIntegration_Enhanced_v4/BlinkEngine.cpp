@@ -0,0 +1,105 @@
+/**
+ * BlinkEngine.cpp
+ *
+ * See BlinkEngine.h
+ */
+
+#include "BlinkEngine.h"
+
+#define CURVE_SHIFT 4                              // 16 segments
+#define CURVE_POINTS ((1 << CURVE_SHIFT) + 1)
+#define CURVE_ONE 4096                             // Q12
+
+/**
+ * Closure (Q12) at 17 evenly spaced points of each phase: integrals of
+ * beta-shaped velocity profiles, closing a 2.4 b 1.6 (peak speed late),
+ * opening a 1.4 b 3.0 (peak speed early, long tail)
+ */
+static const uint16_t CLOSE_CURVE[CURVE_POINTS] PROGMEM = {
+  0, 12, 59, 152, 295, 487, 728, 1014, 1342, 1704, 2092, 2496, 2902, 3295, 3652, 3941, 4096
+};
+
+static const uint16_t OPEN_CURVE[CURVE_POINTS] PROGMEM = {
+  0, 320, 783, 1276, 1761, 2216, 2626, 2986, 3290, 3540, 3736, 3882, 3984, 4048, 4081, 4094, 4096
+};
+
+static_assert(BlinkSettings::CLOSE_MS > 0 && BlinkSettings::OPEN_MS > 0,
+              "BlinkSettings: CLOSE_MS and OPEN_MS must be > 0");
+static_assert(BlinkSettings::PARTIAL_DEPTH_PERCENT <= 100 &&
+              BlinkSettings::UPPER_GAZE_PERCENT <= 100 && BlinkSettings::LOWER_GAZE_PERCENT <= 100,
+              "BlinkSettings: percentages must be 0-100");
+
+// Phase time → Q12 curve position, as a multiply (Q8 step per ms)
+static const uint32_t CLOSE_STEP = ((uint32_t)CURVE_ONE << 8) / BlinkSettings::CLOSE_MS;
+static const uint32_t OPEN_STEP = ((uint32_t)CURVE_ONE << 8) / BlinkSettings::OPEN_MS;
+
+static const unsigned long OPEN_START_MS = BlinkSettings::CLOSE_MS + BlinkSettings::HOLD_MS;
+static const unsigned long BLINK_END_MS = OPEN_START_MS + BlinkSettings::OPEN_MS;
+
+static const int32_t UPPER_GAZE_POS = (int32_t)CHANNEL_POS_FULL * BlinkSettings::UPPER_GAZE_PERCENT / 100;
+static const int32_t LOWER_GAZE_POS = (int32_t)CHANNEL_POS_FULL * BlinkSettings::LOWER_GAZE_PERCENT / 100;
+
+/**
+ * Curve at a Q12 phase position, linear between points
+ */
+static int32_t curveAt(const uint16_t *curve, uint32_t phase) {
+  if (phase >= CURVE_ONE) return CURVE_ONE;
+  uint8_t segment = phase >> (12 - CURVE_SHIFT);
+  int32_t frac = phase & ((1 << (12 - CURVE_SHIFT)) - 1);
+  int32_t a = pgm_read_word(&curve[segment]);
+  int32_t b = pgm_read_word(&curve[segment + 1]);
+  return a + (((b - a) * frac) >> (12 - CURVE_SHIFT));
+}
+
+BlinkEngine::BlinkEngine() : startMs(0), depth(CHANNEL_POS_FULL), held(0), running(false) {
+}
+
+void BlinkEngine::start(unsigned long nowMs, uint16_t blinkDepth) {
+  startMs = nowMs;
+  depth = blinkDepth;
+  running = true;
+}
+
+void BlinkEngine::rest(int16_t gazeQ8, PoseFrame &pose) const {
+  // Gaze tracking, or the held position if that is more closed
+  int32_t upper = gazeQ8 < 0 ? (-(int32_t)gazeQ8 * UPPER_GAZE_POS) >> 8 : 0;
+  int32_t lower = gazeQ8 > 0 ? ((int32_t)gazeQ8 * LOWER_GAZE_POS) >> 8 : 0;
+  if (upper < held) upper = held;
+  if (lower < held) lower = held;
+
+  pose.set(CH_L_UPPER, upper);
+  pose.set(CH_L_LOWER, lower);
+  pose.set(CH_R_UPPER, upper);
+  pose.set(CH_R_LOWER, lower);
+}
+
+void BlinkEngine::apply(unsigned long nowMs, PoseFrame &pose) {
+  if (!running) return;
+
+  unsigned long elapsed = nowMs - startMs;
+  int32_t upper = closure(elapsed);
+  int32_t lower = elapsed >= BlinkSettings::LOWER_LAG_MS
+                    ? closure(elapsed - BlinkSettings::LOWER_LAG_MS) : 0;
+  if (elapsed >= BLINK_END_MS + BlinkSettings::LOWER_LAG_MS) running = false;
+
+  // Depth weighted by closure (Q12 → Q8); a lid already past the depth stays
+  for (uint8_t i = CH_L_UPPER; i <= CH_R_LOWER; i++) {
+    int32_t c = (i == CH_L_UPPER || i == CH_R_UPPER) ? upper : lower;
+    if (pose.value[i] < (int16_t)depth) pose.blend(i, depth, c >> 4);
+  }
+  pose.layers |= 1 << LAYER_BLINK;
+}
+
+/**
+ * Blink closure (Q12) at elapsedMs from its start
+ */
+int32_t BlinkEngine::closure(unsigned long elapsedMs) {
+  if (elapsedMs < BlinkSettings::CLOSE_MS) {
+    return curveAt(CLOSE_CURVE, (elapsedMs * CLOSE_STEP) >> 8);
+  }
+  if (elapsedMs < OPEN_START_MS) return CURVE_ONE;
+  if (elapsedMs < BLINK_END_MS) {
+    return CURVE_ONE - curveAt(OPEN_CURVE, ((elapsedMs - OPEN_START_MS) * OPEN_STEP) >> 8);
+  }
+  return 0;
+}
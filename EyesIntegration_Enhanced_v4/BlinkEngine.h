@@ -0,0 +1,67 @@
+/**
+ * BlinkEngine.h
+ *
+ * Eyelid trajectories: blinks over time, lids following the gaze
+ *
+ * Blinks used to snap all four lids shut, wait BLINK_DURATION and snap
+ * them open - the servos' own slew was the only shape. Now every motion
+ * tick evaluates all four lids from precomputed curves:
+ *
+ *   closure  0 ──CLOSE_MS──▶ 1 ──HOLD_MS── 1 ──OPEN_MS──▶ 0
+ *
+ * - Close: accelerating, lands fast (PROGMEM curve, Q12)
+ * - Open: quick start, long easing tail, slower overall
+ * - Depth: full blinks close to CHANNEL_POS_FULL, partial ones to
+ *   PARTIAL_DEPTH_PERCENT (50 = the calibrated HALF, see ChannelTable.h)
+ * - Lower lids run the same curve LOWER_LAG_MS late
+ * - Rest: upper lids drop as the eyes look down, lower lids rise as they
+ *   look up (UPPER/LOWER_GAZE_PERCENT at full deflection); a held lid
+ *   position (host link) raises the rest further
+ *
+ * In the compositor (PoseCompositor.h) the rest is the gaze layer's lid
+ * pose and the blink is a layer above it: the blink depth weighted by its
+ * closure, so a blink runs from whatever pose lies below (rest, expression)
+ * to its depth and back, never opening a lid past it.
+ *
+ * Times are elapsed milliseconds; per tick it is two curve lookups (upper,
+ * lower) and four multiplies, no divisions.
+ */
+
+#ifndef BLINK_ENGINE_H
+#define BLINK_ENGINE_H
+
+#include <Arduino.h>
+#include "ChannelTable.h"
+#include "PoseCompositor.h"
+
+class BlinkEngine {
+public:
+  BlinkEngine();
+
+  /** Start a blink closing to depth (normalized lid position) */
+  void start(unsigned long nowMs, uint16_t depth);
+
+  bool active() const { return running; }
+
+  /** Lowest position the lids rest at (0 = none) */
+  void hold(uint16_t position) { held = position; }
+
+  /**
+   * Rest pose of the lids (gaze layer)
+   * gazeQ8: vertical gaze, -256 full down .. 256 full up
+   */
+  void rest(int16_t gazeQ8, PoseFrame &pose) const;
+
+  /** Blink layer at nowMs, over the lids already in pose */
+  void apply(unsigned long nowMs, PoseFrame &pose);
+
+private:
+  static int32_t closure(unsigned long elapsedMs);
+
+  unsigned long startMs;
+  uint16_t depth;
+  uint16_t held;
+  bool running;
+};
+
+#endif // BLINK_ENGINE_H
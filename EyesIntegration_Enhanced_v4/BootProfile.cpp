@@ -0,0 +1,35 @@
+/**
+ * BootProfile.cpp
+ *
+ * See BootProfile.h
+ */
+
+#include "BootProfile.h"
+#include "EyeHAL.h"
+
+BootProfile::BootProfile() : count(0) {
+  memset(stages, 0, sizeof(stages));
+}
+
+void BootProfile::mark(const __FlashStringHelper *name) {
+  if (count >= BOOT_PROFILE_MAX_STAGES) return;
+  stages[count].name = name;
+  stages[count].timeUs = halMicros();
+  count++;
+}
+
+void BootProfile::print() const {
+  Serial.println(F("Boot profile (ms since reset):"));
+  for (uint8_t i = 0; i < count; i++) {
+    // ms with one decimal, right-aligned to 6 digits
+    unsigned long tenths = stages[i].timeUs / 100;
+    for (unsigned long width = 10000; width > 1 && tenths / 10 < width; width /= 10) {
+      Serial.print(' ');
+    }
+    Serial.print(tenths / 10);
+    Serial.print('.');
+    Serial.print(tenths % 10);
+    Serial.print(F("  "));
+    Serial.println(stages[i].name);
+  }
+}
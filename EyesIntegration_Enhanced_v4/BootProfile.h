@@ -0,0 +1,49 @@
+/**
+ * BootProfile.h
+ *
+ * Timestamps of the boot stages, from reset to the first control tick
+ *
+ * setup() used to spend a fixed second after Serial.begin, probe the servo
+ * shields, wait for the nunchuck and only then move the eyes, while the
+ * servos sat at whatever pulse they powered up with. Boot now queues the
+ * servo init and the startup pose first; everything else (banner, nunchuck
+ * detection) overlaps with the bus. Each stage is marked as it finishes and
+ * the list is printed once, in ms since reset:
+ *
+ *   Boot profile (ms since reset):
+ *       0.1  serial
+ *       0.9  startup pose queued
+ *      ...
+ */
+
+#ifndef BOOT_PROFILE_H
+#define BOOT_PROFILE_H
+
+#include <Arduino.h>
+
+#define BOOT_PROFILE_MAX_STAGES 10
+
+struct BootStage {
+  const __FlashStringHelper *name;
+  unsigned long timeUs;            // halMicros() when the stage finished
+};
+
+class BootProfile {
+public:
+  BootProfile();
+
+  /** Stage done now (ignored once the table is full) */
+  void mark(const __FlashStringHelper *name);
+
+  /** The stage list to Serial, as text */
+  void print() const;
+
+  uint8_t stageCount() const { return count; }
+  const BootStage &stage(uint8_t index) const { return stages[index]; }
+
+private:
+  BootStage stages[BOOT_PROFILE_MAX_STAGES];
+  uint8_t count;
+};
+
+#endif // BOOT_PROFILE_H
@@ -0,0 +1,157 @@
+/**
+ * CalibrationConsole.cpp
+ *
+ * See CalibrationConsole.h
+ */
+
+#include "CalibrationConsole.h"
+
+// ChannelIndex order
+static const char SERVO_NAMES[CHANNEL_COUNT][3] PROGMEM = { "h", "v", "lu", "ll", "ru", "rl" };
+
+/**
+ * Whole-token unsigned number, false if it isn't one
+ */
+static bool parseNumber(const char *token, long &value) {
+  if (token == NULL) return false;
+  char *end;
+  value = strtol(token, &end, 10);
+  return end != token && *end == '\0' && value >= 0;
+}
+
+CalibrationConsole::CalibrationConsole(CalibrationStore *store)
+  : store(store), commandHandler(NULL), changeHandler(NULL), length(0), overflow(false) {
+}
+
+void CalibrationConsole::feed(uint8_t b) {
+  if (b == '\n' || b == '\r') {
+    line[length] = '\0';
+    if (length > 0 && !overflow) execute(line);
+    length = 0;
+    overflow = false;
+    return;
+  }
+  // Binary that slipped past the frame parser is no command
+  if (b < ' ' || b > '~' || length >= CALIBRATION_LINE_SIZE - 1) {
+    overflow = true;
+    return;
+  }
+  line[length++] = (char)b;
+}
+
+void CalibrationConsole::printSource() const {
+  Serial.print(F("Calibration: "));
+  switch (store->loadStatus()) {
+    case CALIBRATION_LOADED: Serial.print(F("EEPROM")); break;
+    case CALIBRATION_EMPTY: Serial.print(F("EyeConfig.h (EEPROM empty)")); break;
+    case CALIBRATION_BAD_CRC: Serial.print(F("EyeConfig.h (EEPROM CRC error)")); break;
+    case CALIBRATION_BAD_VERSION:
+      Serial.print(F("EyeConfig.h (EEPROM from another firmware version)"));
+      break;
+    case CALIBRATION_BAD_LAYOUT:
+      Serial.print(F("EyeConfig.h (EEPROM saved for another rig layout)"));
+      break;
+    case CALIBRATION_BAD_LIMITS: Serial.print(F("EyeConfig.h (EEPROM limits out of range)")); break;
+  }
+  Serial.println(store->modified() ? F(", modified (not saved)") : F(""));
+}
+
+void CalibrationConsole::execute(char *text) {
+  char *command = strtok(text, " ");
+  if (command == NULL) return;
+  if (strcmp_P(command, PSTR("cal")) != 0) {
+    if (commandHandler != NULL) commandHandler(command, strtok(NULL, ""));
+    return;
+  }
+
+  char *action = strtok(NULL, " ");
+  bool changed = false;
+  if (action == NULL) {
+    printSource();
+    list();
+  } else if (!strcmp_P(action, PSTR("set"))) {
+    changed = setCommand(strtok(NULL, ""));
+    if (!changed) {
+      Serial.println(F("cal set: rejected (usage: cal set RIG SERVO LOW CENTER HIGH [INV])"));
+    }
+  } else if (!strcmp_P(action, PSTR("save"))) {
+    store->save();
+    Serial.println(F("cal: saved to EEPROM"));
+  } else if (!strcmp_P(action, PSTR("load"))) {
+    store->load();
+    printSource();
+    changed = true;
+  } else if (!strcmp_P(action, PSTR("reset"))) {
+    store->erase();
+    printSource();
+    changed = true;
+  } else {
+    Serial.println(F("cal: unknown command (cal, cal set, cal save, cal load, cal reset)"));
+  }
+  if (changed && changeHandler != NULL) changeHandler();
+}
+
+void CalibrationConsole::list() const {
+  for (uint8_t i = 0; i < CALIBRATION_ENTRIES; i++) {
+    CalibrationEntry e = store->entry(i);
+    Serial.print(F("cal set "));
+    Serial.print(i / CHANNEL_COUNT);
+    Serial.print(' ');
+    Serial.print((const __FlashStringHelper *)SERVO_NAMES[i % CHANNEL_COUNT]);
+    Serial.print(' ');
+    Serial.print(e.low);
+    Serial.print(' ');
+    Serial.print(e.center);
+    Serial.print(' ');
+    Serial.print(e.high);
+    Serial.print(' ');
+    Serial.println((e.flags & CALIBRATION_FLAG_INVERTED) ? 1 : 0);
+  }
+}
+
+bool CalibrationConsole::setCommand(char *args) {
+  if (args == NULL) return false;
+  long rig;
+  if (!parseNumber(strtok(args, " "), rig) || rig >= RIG_COUNT) return false;
+
+  char *name = strtok(NULL, " ");
+  if (name == NULL) return false;
+  uint8_t servo = 0;
+  while (servo < CHANNEL_COUNT && strcmp_P(name, SERVO_NAMES[servo]) != 0) servo++;
+  if (servo == CHANNEL_COUNT) return false;
+  uint8_t index = rig * CHANNEL_COUNT + servo;
+
+  long low;
+  long center;
+  long high;
+  if (!parseNumber(strtok(NULL, " "), low) || !parseNumber(strtok(NULL, " "), center) ||
+      !parseNumber(strtok(NULL, " "), high)) {
+    return false;
+  }
+
+  CalibrationEntry e = store->entry(index);
+  char *inverted = strtok(NULL, " ");
+  if (inverted != NULL) {
+    long flag;
+    if (!parseNumber(inverted, flag) || flag > 1) return false;
+    e.flags = flag ? CALIBRATION_FLAG_INVERTED : 0;
+  }
+  if (strtok(NULL, " ") != NULL) return false;
+
+  // Out-of-range values must not wrap into range
+  if (low > SafetyLimits::ABSOLUTE_MAX_PULSE || center > SafetyLimits::ABSOLUTE_MAX_PULSE ||
+      high > SafetyLimits::ABSOLUTE_MAX_PULSE) {
+    return false;
+  }
+  e.low = low;
+  e.center = center;
+  e.high = high;
+  if (!store->set(index, e)) return false;
+
+  Serial.print(F("cal: rig "));
+  Serial.print(rig);
+  Serial.print(' ');
+  Serial.print(name);
+  Serial.println(F(" updated (cal save to keep)"));
+  return true;
+}
@@ -0,0 +1,71 @@
+/**
+ * CalibrationConsole.h
+ *
+ * Serial text commands for the calibration store (CalibrationStore.h)
+ *
+ * Text shares the port with gaze frames: GazeLink hands over every byte
+ * that isn't part of a frame (see GazeLink::setTextHandler), and lines are
+ * assembled here. Type into any serial terminal at 115200, newline ended:
+ *
+ *   cal                          list the live calibration, as commands
+ *   cal set RIG SERVO LOW CENTER HIGH [INV]
+ *                                change one servo now (not saved)
+ *   cal save                     write the live calibration to EEPROM
+ *   cal load                     back to what EEPROM holds (drops changes)
+ *   cal reset                    erase EEPROM, back to EyeConfig.h values
+ *
+ * SERVO is h, v, lu, ll, ru or rl (ChannelIndex order). LOW < HIGH in
+ * pulse units, CENTER is the eye CENTER or lid HALF, INV = 1 when the
+ * pulse must fall as the position rises (eye INVERTED, or a lid that
+ * closes toward LOW); it keeps its current value when left out.
+ *
+ * "cal" prints one "cal set" line per servo, so the listing is also the
+ * backup: paste it back to restore. Rejected limits (the EyeConfig.h rules)
+ * leave the servo unchanged.
+ *
+ * Lines starting with another word go to the command handler, if one is
+ * set (the sketch's "rec" commands). After a set, load or reset the change
+ * handler runs, so whatever was derived from the table follows it.
+ */
+
+#ifndef CALIBRATION_CONSOLE_H
+#define CALIBRATION_CONSOLE_H
+
+#include <Arduino.h>
+#include "CalibrationStore.h"
+
+#define CALIBRATION_LINE_SIZE 32   // "cal set 0 rl 1234 1234 1234 1" is 29
+
+/** A console line that isn't "cal": its first word and the rest (may be NULL) */
+typedef void (*ConsoleCommandHandler)(const char *command, char *args);
+
+/** The live calibration changed (cal set, load, reset) */
+typedef void (*CalibrationChangeHandler)();
+
+class CalibrationConsole {
+public:
+  explicit CalibrationConsole(CalibrationStore *store);
+
+  /** One received byte; a complete line is executed (input group) */
+  void feed(uint8_t b);
+
+  /** Where the calibration came from, one line (boot banner, "cal") */
+  void printSource() const;
+
+  void setCommandHandler(ConsoleCommandHandler handler) { commandHandler = handler; }
+  void setChangeHandler(CalibrationChangeHandler handler) { changeHandler = handler; }
+
+private:
+  void execute(char *line);
+  void list() const;
+  bool setCommand(char *args);
+
+  CalibrationStore *store;
+  ConsoleCommandHandler commandHandler;
+  CalibrationChangeHandler changeHandler;
+  char line[CALIBRATION_LINE_SIZE];
+  uint8_t length;
+  bool overflow;             // Line too long: ignored up to its newline
+};
+
+#endif // CALIBRATION_CONSOLE_H
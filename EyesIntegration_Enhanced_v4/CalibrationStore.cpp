@@ -0,0 +1,101 @@
+/**
+ * CalibrationStore.cpp
+ *
+ * See CalibrationStore.h
+ */
+
+#include "CalibrationStore.h"
+#include "EyeHAL.h"
+#include "SerialFraming.h"
+
+CalibrationStore::CalibrationStore(uint16_t address)
+  : address(address), status(CALIBRATION_EMPTY), dirty(false) {
+}
+
+uint8_t CalibrationStore::begin() {
+  return load();
+}
+
+uint8_t CalibrationStore::load() {
+  channelTableLoadDefaults();
+  dirty = false;
+
+  CalibrationHeader header;
+  halEepromRead(address, &header, sizeof(header));
+  if (header.magic != CALIBRATION_MAGIC) return status = CALIBRATION_EMPTY;
+  if (header.version != CALIBRATION_VERSION) return status = CALIBRATION_BAD_VERSION;
+  if (header.count != CALIBRATION_ENTRIES) return status = CALIBRATION_BAD_LAYOUT;
+
+  // Check everything before touching the table (two passes, no buffer)
+  uint16_t entryAddress = address + sizeof(header);
+  uint16_t crc = FRAME_CRC_INIT;
+  bool limitsOk = true;
+  CalibrationEntry e;
+  for (uint8_t i = 0; i < CALIBRATION_ENTRIES; i++) {
+    halEepromRead(entryAddress + i * sizeof(e), &e, sizeof(e));
+    crc = frameCrc((const uint8_t *)&e, sizeof(e), crc);
+    if (!channelLimitsValid(e.low, e.center, e.high)) limitsOk = false;
+  }
+  if (crc != header.crc) return status = CALIBRATION_BAD_CRC;
+  if (!limitsOk) return status = CALIBRATION_BAD_LIMITS;
+
+  for (uint8_t i = 0; i < CALIBRATION_ENTRIES; i++) {
+    halEepromRead(entryAddress + i * sizeof(e), &e, sizeof(e));
+    ChannelDescriptor &d = channelTable[i];
+    d = channelDescriptor(d.board, d.channel, e.low, e.center, e.high,
+                          (e.flags & CALIBRATION_FLAG_INVERTED) != 0,
+                          i % CHANNEL_COUNT >= CH_L_UPPER, d.plant);
+  }
+  return status = CALIBRATION_LOADED;
+}
+
+CalibrationEntry CalibrationStore::entry(uint8_t index) const {
+  const ChannelDescriptor *d = &channelTable[index];
+  CalibrationEntry e;
+  e.low = calibrationPulse(descriptorMin(d));
+  e.center = calibrationPulse(descriptorCenter(d));
+  e.high = calibrationPulse(descriptorMax(d));
+  e.flags = descriptorInverted(d) ? CALIBRATION_FLAG_INVERTED : 0;
+  return e;
+}
+
+bool CalibrationStore::set(uint8_t index, const CalibrationEntry &limits) {
+  if (index >= CALIBRATION_ENTRIES ||
+      !channelLimitsValid(limits.low, limits.center, limits.high)) {
+    return false;
+  }
+  ChannelDescriptor &d = channelTable[index];
+  d = channelDescriptor(d.board, d.channel, limits.low, limits.center, limits.high,
+                        (limits.flags & CALIBRATION_FLAG_INVERTED) != 0,
+                        index % CHANNEL_COUNT >= CH_L_UPPER, d.plant);
+  dirty = true;
+  return true;
+}
+
+void CalibrationStore::save() {
+  CalibrationHeader header;
+  header.magic = CALIBRATION_MAGIC;
+  header.version = CALIBRATION_VERSION;
+  header.count = CALIBRATION_ENTRIES;
+  header.crc = FRAME_CRC_INIT;
+
+  uint16_t entryAddress = address + sizeof(header);
+  for (uint8_t i = 0; i < CALIBRATION_ENTRIES; i++) {
+    CalibrationEntry e = entry(i);
+    header.crc = frameCrc((const uint8_t *)&e, sizeof(e), header.crc);
+    halEepromWrite(entryAddress + i * sizeof(e), &e, sizeof(e));
+  }
+  // Header last: until it lands, a stale header's CRC fails over the new entries
+  halEepromWrite(address, &header, sizeof(header));
+
+  status = CALIBRATION_LOADED;
+  dirty = false;
+}
+
+void CalibrationStore::erase() {
+  uint16_t blank = 0xFFFF;
+  halEepromWrite(address, &blank, sizeof(blank));
+  channelTableLoadDefaults();
+  status = CALIBRATION_EMPTY;
+  dirty = false;
+}
@@ -0,0 +1,115 @@
+/**
+ * CalibrationStore.h
+ *
+ * Servo calibration kept in EEPROM, with EyeConfig.h as the fallback
+ *
+ * Replacing a servo used to mean editing EyeConfig.h and re-flashing. Now
+ * the limits can be changed over Serial (CalibrationConsole.h) and saved
+ * on the board. At boot, begin() fills channelTable (ChannelTable.h) with
+ * the compiled calibration, then - if EEPROM holds a valid blob - rebuilds
+ * every descriptor from it. That happens once; the control loop only ever
+ * reads the finished RAM descriptors.
+ *
+ * BLOB (at CalibrationStoreSettings::EEPROM_ADDRESS, little-endian):
+ *   CalibrationHeader   magic, version, entry count, CRC16 of the entries
+ *   CalibrationEntry[]  one per channel, channelTable order (rig block +
+ *                       ChannelIndex): low, center, high pulse + flags
+ *
+ * Limits are stored canonically (low < high, plus an inverted flag), so
+ * eye MIN/CENTER/MAX and lid OPEN/HALF/CLOSED both fit. Board and channel
+ * wiring is not part of the blob: that stays in EyeConfig.h.
+ *
+ * The whole blob is ignored - compiled values win - if the magic is
+ * missing (never saved / erased), the CRC fails (e.g. power lost while
+ * saving), the version or entry count differs from this build (firmware
+ * with another layout or rig count) or any entry fails the same checks
+ * EyeConfig.h passes at compile time. The reason is reported by
+ * loadStatus().
+ */
+
+#ifndef CALIBRATION_STORE_H
+#define CALIBRATION_STORE_H
+
+#include <Arduino.h>
+#include "ChannelTable.h"
+
+#define CALIBRATION_MAGIC 0xCA1B
+#define CALIBRATION_VERSION 1
+
+// CalibrationEntry.flags
+#define CALIBRATION_FLAG_INVERTED 0x01   // Pulse falls as the position rises
+
+struct CalibrationHeader {
+  uint16_t magic;
+  uint8_t version;
+  uint8_t count;             // Entries that follow
+  uint16_t crc;              // SerialFraming's CRC16 over the entries
+} __attribute__((packed));
+
+struct CalibrationEntry {
+  uint16_t low;              // Eyes: MIN, lids: the lower of OPEN/CLOSED
+  uint16_t center;           // Eyes: CENTER, lids: HALF
+  uint16_t high;
+  uint8_t flags;             // CALIBRATION_FLAG_*
+} __attribute__((packed));
+
+#define CALIBRATION_ENTRIES (RIG_COUNT * CHANNEL_COUNT)
+#define CALIBRATION_BLOB_SIZE \
+  (sizeof(CalibrationHeader) + CALIBRATION_ENTRIES * sizeof(CalibrationEntry))
+
+#ifdef E2END
+static_assert(CalibrationStoreSettings::EEPROM_ADDRESS + CALIBRATION_BLOB_SIZE <= E2END + 1,
+              "Calibration blob does not fit in EEPROM");
+#endif
+
+/**
+ * What begin() / load() found in EEPROM
+ */
+enum CalibrationLoadStatus {
+  CALIBRATION_LOADED,        // Blob in use
+  CALIBRATION_EMPTY,         // Nothing saved: compiled values
+  CALIBRATION_BAD_CRC,
+  CALIBRATION_BAD_VERSION,
+  CALIBRATION_BAD_LAYOUT,    // Entry count != this build's channel count
+  CALIBRATION_BAD_LIMITS     // An entry fails channelLimitsValid()
+};
+
+class CalibrationStore {
+public:
+  explicit CalibrationStore(uint16_t address);
+
+  /**
+   * Compiled calibration, then EEPROM on top if valid
+   * Call first in setup(): nothing may read channelTable before it.
+   */
+  uint8_t begin();
+
+  /** Reload from EEPROM, dropping unsaved changes (compiled values if invalid) */
+  uint8_t load();
+
+  /** Live limits of a channelTable entry, in blob form */
+  CalibrationEntry entry(uint8_t index) const;
+
+  /**
+   * Apply new limits to one channel now (not saved)
+   * False, and nothing changes, if they fail channelLimitsValid().
+   */
+  bool set(uint8_t index, const CalibrationEntry &limits);
+
+  /** Write the live table to EEPROM (blocks ~3.4 ms per changed byte) */
+  void save();
+
+  /** Invalidate the blob and go back to the compiled calibration */
+  void erase();
+
+  uint8_t loadStatus() const { return status; }
+  bool fromEeprom() const { return status == CALIBRATION_LOADED; }
+  bool modified() const { return dirty; }
+
+private:
+  uint16_t address;
+  uint8_t status;            // CalibrationLoadStatus
+  bool dirty;                // Live table differs from what begin/load/save left
+};
+
+#endif // CALIBRATION_STORE_H
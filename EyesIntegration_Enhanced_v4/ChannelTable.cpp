@@ -0,0 +1,39 @@
+/**
+ * ChannelTable.cpp
+ *
+ * The compiled descriptor table - built entirely at compile time - and
+ * the live copy in RAM
+ * See ChannelTable.h
+ */
+
+#include "ChannelTable.h"
+
+const ChannelDescriptor CHANNEL_DEFAULTS[RIG_COUNT * CHANNEL_COUNT] PROGMEM = {
+  EYE_RIG_LIST(RIG_DESCRIPTORS)
+};
+
+ChannelDescriptor channelTable[RIG_COUNT * CHANNEL_COUNT];
+
+#define CHANNEL_TABLE_ADDRESS(address) address,
+
+const uint8_t SERVO_BOARD_ADDRESSES[SERVO_BOARD_COUNT] PROGMEM = {
+  SERVO_BOARD_LIST(CHANNEL_TABLE_ADDRESS)
+};
+
+void channelTableLoadDefaults() {
+  memcpy_P(channelTable, CHANNEL_DEFAULTS, sizeof(channelTable));
+}
+
+ChannelDescriptor channelDescriptor(uint8_t board, uint8_t channel, uint16_t low,
+                                    uint16_t center, uint16_t high, bool inverted, bool lid,
+                                    ServoPlant plant) {
+  int from = outputPulse(inverted ? high : low);
+  int to = outputPulse(inverted ? low : high);
+  return channel_table::make(board, channel, from, to, outputPulse(center), lid, plant,
+                             channel_table::MakeIndices<CHANNEL_LUT_POINTS>::type());
+}
+
+bool channelLimitsValid(uint16_t low, uint16_t center, uint16_t high) {
+  return low < high && low <= center && center <= high &&
+         channel_table::withinAbsolute(low) && channel_table::withinAbsolute(high);
+}
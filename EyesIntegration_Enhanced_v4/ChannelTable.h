@@ -0,0 +1,448 @@
+/**
+ * ChannelTable.h
+ *
+ * Per-servo channel descriptors: compiled from EyeConfig.h, live in RAM
+ *
+ * The calibration structs (HorizontalLimits, LeftUpperLid, ...) are folded
+ * at compile time into one packed descriptor per servo (CHANNEL_DEFAULTS,
+ * in PROGMEM):
+ * - servo board (index into SERVO_BOARD_LIST) and PCA9685 channel
+ * - direction (inversion already resolved)
+ * - clamp bounds and calibrated center
+ * - normalized position → pulse lookup table (17 points, linear between;
+ *   lid tables bend at HALF, see below)
+ * - the servo's response (lag and speed), for the lead stage
+ *
+ * At boot CalibrationStore copies them into channelTable (RAM) and lays any
+ * valid calibration saved in EEPROM over them, rebuilding those
+ * descriptors with channelDescriptor() - the same folding, at runtime.
+ * Everything after that reads channelTable only, so a field calibration
+ * costs the hot path nothing (a RAM read is no slower than a PROGMEM one).
+ *
+ * Every rig in EYE_RIG_LIST gets CHANNEL_COUNT consecutive descriptors, in
+ * list order; rigChannels(r) points at rig r's block. The first rig's
+ * block starts at 0, so CH_* indices address it directly.
+ *
+ * NORMALIZED POSITION (0 .. CHANNEL_POS_FULL):
+ * - Eyelids: 0 = open, CHANNEL_POS_FULL / 2 = HALF, CHANNEL_POS_FULL = closed
+ *   (OPEN → HALF and HALF → CLOSED are each linear, so a partial blink
+ *   or expression lands on the calibrated HALF whatever the linkage does)
+ * - Eye axes: 0 = joystick low end, CHANNEL_POS_FULL = joystick high end
+ *   (so INVERTED simply reverses the table)
+ *
+ * A pulse is then a table lookup plus one small multiply - no floats,
+ * no per-call inversion logic, no re-deriving min/max.
+ *
+ * OUTPUT COUNTS: EyeConfig.h limits, the "cal" commands and the EEPROM blob
+ * are in 60 Hz calibration counts; descriptors hold output counts at the
+ * configured frame rate (OutputSettings), folded in with the rest. The
+ * motion engine, bus and telemetry only ever see output counts.
+ *
+ * Bad calibration (MIN >= MAX, values outside SafetyLimits::ABSOLUTE_*,
+ * duplicate channels on a board, unknown boards) FAILS THE BUILD via static_assert instead of
+ * halting at runtime in setup(). Runtime limits pass the same range
+ * checks (channelLimitsValid()) before they reach the table.
+ */
+
+#ifndef CHANNEL_TABLE_H
+#define CHANNEL_TABLE_H
+
+#include <Arduino.h>
+#include "EyeConfig.h"
+#include "ServoFrame.h"
+
+// ============================================================================
+// DESCRIPTOR LAYOUT
+// ============================================================================
+
+#define CHANNEL_LUT_SHIFT 4                                // 16 segments
+#define CHANNEL_LUT_POINTS ((1 << CHANNEL_LUT_SHIFT) + 1)  // 17 points
+#define CHANNEL_POS_FULL 256                               // Fully closed / high end
+
+/**
+ * Table index of each servo within a rig's block
+ */
+enum ChannelIndex {
+  CH_HORIZONTAL,
+  CH_VERTICAL,
+  CH_L_UPPER,
+  CH_L_LOWER,
+  CH_R_UPPER,
+  CH_R_LOWER,
+  CHANNEL_COUNT
+};
+
+/**
+ * A servo's identified response (PLANT_* in EyeConfig.h), in the form the
+ * lead stage uses (EyeRig.h)
+ */
+struct ServoPlant {
+  uint8_t tauMs;                    // First-order lag
+  uint16_t maxLead;                 // Most worth commanding ahead: slew × τ, output counts
+};
+
+struct ChannelDescriptor {
+  uint8_t board;                    // Index into SERVO_BOARD_LIST
+  uint8_t channel;                  // PCA9685 output
+  int8_t direction;                 // +1: pulse rises with position, -1: falls
+  uint16_t minPulse;                // Clamp bounds
+  uint16_t maxPulse;
+  uint16_t centerPulse;             // Eyes: CENTER, lids: HALF
+  uint16_t lut[CHANNEL_LUT_POINTS]; // Pulse at position i × 16
+  ServoPlant plant;
+};
+
+// Entry counter for the EyeConfig.h lists
+#define CHANNEL_TABLE_COUNT_ENTRY(X) + 1
+
+enum {
+  RIG_COUNT = 0 EYE_RIG_LIST(CHANNEL_TABLE_COUNT_ENTRY),
+  SERVO_BOARD_COUNT = 0 SERVO_BOARD_LIST(CHANNEL_TABLE_COUNT_ENTRY)
+};
+
+// Compiled calibration (EyeConfig.h) and the live table the firmware drives
+extern const ChannelDescriptor CHANNEL_DEFAULTS[RIG_COUNT * CHANNEL_COUNT] PROGMEM;
+extern ChannelDescriptor channelTable[RIG_COUNT * CHANNEL_COUNT];
+extern const uint8_t SERVO_BOARD_ADDRESSES[SERVO_BOARD_COUNT] PROGMEM;
+
+// ============================================================================
+// OUTPUT UNITS
+// ============================================================================
+
+/**
+ * Calibration counts are counts of the prescale ServoPulseCalibrator sets
+ * for 60 Hz on a nominal oscillator; output counts are counts of the
+ * prescale the boards run at. Both divide the same oscillator, so the
+ * scale between them is the prescale ratio exactly - an oscillator that
+ * is off moves the frame rate, never a calibrated pulse width.
+ */
+static const uint8_t CALIBRATION_PRESCALE = pca9685Prescale(PCA9685_OSCILLATOR_HZ, 60);
+static const uint8_t OUTPUT_PRESCALE =
+  OutputSettings::HIGH_RATE
+    ? pca9685Prescale(OutputSettings::OSCILLATOR_HZ, OutputSettings::MAX_FRAME_HZ)
+    : CALIBRATION_PRESCALE;
+
+/** Calibration counts → output counts, rounded */
+constexpr int outputPulse(long calibrationPulse) {
+  return (int)((calibrationPulse * (CALIBRATION_PRESCALE + 1) + (OUTPUT_PRESCALE + 1) / 2) /
+               (OUTPUT_PRESCALE + 1));
+}
+
+/** Output counts → calibration counts, rounded (exact inverse of outputPulse) */
+constexpr int calibrationPulse(long outputPulse) {
+  return (int)((outputPulse * (OUTPUT_PRESCALE + 1) + (CALIBRATION_PRESCALE + 1) / 2) /
+               (CALIBRATION_PRESCALE + 1));
+}
+
+// Eye motion limits (MotionSettings, SafetyLimits) in output counts per second (²)
+static const long EYE_MAX_VELOCITY =
+  outputPulse((long)SafetyLimits::MAX_DELTA_PER_UPDATE * 1000L / SafetyLimits::MAX_DELTA_INTERVAL_MS);
+static const long EYE_MAX_ACCEL = outputPulse(MotionSettings::EYE_MAX_ACCEL);
+
+static_assert(OUTPUT_PRESCALE >= PCA9685_PRESCALE_MIN && OUTPUT_PRESCALE <= CALIBRATION_PRESCALE,
+              "OutputSettings: MAX_FRAME_HZ must be 60 or more, and within the PCA9685's range");
+static_assert(outputPulse(SafetyLimits::ABSOLUTE_MAX_PULSE) <= PCA9685_COUNTS * 3 / 4,
+              "OutputSettings: frame too short for ABSOLUTE_MAX_PULSE - lower MAX_FRAME_HZ");
+// descriptorPulse() interpolates a LUT segment × fraction in int (16 bits on AVR)
+static_assert((long)outputPulse(SafetyLimits::ABSOLUTE_MAX_PULSE - SafetyLimits::ABSOLUTE_MIN_PULSE) *
+                ((1 << CHANNEL_LUT_SHIFT) - 1) <= 32767,
+              "OutputSettings: pulse span too wide for 16-bit LUT interpolation - lower MAX_FRAME_HZ");
+static_assert(!OutputSettings::HIGH_RATE ||
+              (OutputSettings::CONTROL_HZ >= 50 && OutputSettings::CONTROL_HZ <= 200 &&
+               1000 % OutputSettings::CONTROL_HZ == 0),
+              "OutputSettings: CONTROL_HZ must be 50-200 and divide 1000");
+
+// ============================================================================
+// COMPILE-TIME GENERATION
+// ============================================================================
+
+namespace channel_table {
+
+template <int... I> struct Indices {};
+template <int N, int... I> struct MakeIndices : MakeIndices<N - 1, N - 1, I...> {};
+template <int... I> struct MakeIndices<0, I...> { typedef Indices<I...> type; };
+
+constexpr int lowOf(int a, int b) { return a < b ? a : b; }
+constexpr int highOf(int a, int b) { return a > b ? a : b; }
+
+// Pulse at LUT point i, rounded to nearest (span × i needs long: int is 16 bits on AVR)
+constexpr uint16_t point(int from, int to, int i) {
+  return (uint16_t)(from + ((long)(to - from) * i + (to >= from ? 8 : -8)) / 16);
+}
+
+// Same, through center at the middle point (lids: OPEN → HALF → CLOSED)
+constexpr uint16_t pointVia(int from, int center, int to, int i) {
+  return i <= CHANNEL_LUT_POINTS / 2 ? point(from, center, 2 * i)
+                                     : point(center, to, 2 * (i - CHANNEL_LUT_POINTS / 2));
+}
+
+template <int... I>
+constexpr ChannelDescriptor make(uint8_t board, uint8_t channel, int from, int to, int center,
+                                 bool viaCenter, ServoPlant plant, Indices<I...>) {
+  return ChannelDescriptor{
+    board,
+    channel,
+    (int8_t)(to >= from ? 1 : -1),
+    (uint16_t)lowOf(from, to),
+    (uint16_t)highOf(from, to),
+    (uint16_t)center,
+    { (viaCenter ? pointVia(from, center, to, I) : point(from, to, I))... },
+    plant
+  };
+}
+
+constexpr int bitCount(unsigned int v) {
+  return v == 0 ? 0 : (int)(v & 1) + bitCount(v >> 1);
+}
+
+constexpr bool withinAbsolute(int pulse) {
+  return pulse >= SafetyLimits::ABSOLUTE_MIN_PULSE && pulse <= SafetyLimits::ABSOLUTE_MAX_PULSE;
+}
+
+template <typename Rig>
+constexpr unsigned int rigChannelMask() {
+  return (1U << Rig::HORIZONTAL_CHANNEL) | (1U << Rig::VERTICAL_CHANNEL) |
+         (1U << Rig::L_UPPER_CHANNEL) | (1U << Rig::L_LOWER_CHANNEL) |
+         (1U << Rig::R_UPPER_CHANNEL) | (1U << Rig::R_LOWER_CHANNEL);
+}
+
+#define CHANNEL_TABLE_BOARD_MASK(R) | (R::BOARD == board ? channel_table::rigChannelMask<R>() : 0U)
+#define CHANNEL_TABLE_BOARD_USED(R) + (R::BOARD == board ? (int)CHANNEL_COUNT : 0)
+
+// Every channel on every board claimed by exactly one rig servo
+constexpr bool boardChannelsDistinct(int board) {
+  return board >= SERVO_BOARD_COUNT ||
+         (bitCount(0U EYE_RIG_LIST(CHANNEL_TABLE_BOARD_MASK)) ==
+            0 EYE_RIG_LIST(CHANNEL_TABLE_BOARD_USED) &&
+          boardChannelsDistinct(board + 1));
+}
+
+}  // namespace channel_table
+
+/**
+ * Response of a limits struct (PLANT_TAU_MS, PLANT_SLEW in calibration counts)
+ */
+template <typename Limits>
+constexpr ServoPlant servoPlant() {
+  return ServoPlant{
+    (uint8_t)Limits::PLANT_TAU_MS,
+    (uint16_t)((long)outputPulse(Limits::PLANT_SLEW) * Limits::PLANT_TAU_MS / 1000)
+  };
+}
+
+/**
+ * Eye axis: joystick low end → MIN (or MAX when INVERTED)
+ */
+template <typename Limits>
+constexpr ChannelDescriptor eyeDescriptor(uint8_t board, uint8_t channel) {
+  return channel_table::make(board, channel,
+                             outputPulse(Limits::INVERTED ? Limits::MAX : Limits::MIN),
+                             outputPulse(Limits::INVERTED ? Limits::MIN : Limits::MAX),
+                             outputPulse(Limits::CENTER), false, servoPlant<Limits>(),
+                             typename channel_table::MakeIndices<CHANNEL_LUT_POINTS>::type());
+}
+
+/**
+ * Eyelid: open → HALF → closed (swapped when INVERTED, same as the old
+ * setEyelidPosition() inversion)
+ */
+template <typename Lid>
+constexpr ChannelDescriptor lidDescriptor(uint8_t board, uint8_t channel) {
+  return channel_table::make(board, channel,
+                             outputPulse(Lid::INVERTED ? Lid::CLOSED : Lid::OPEN),
+                             outputPulse(Lid::INVERTED ? Lid::OPEN : Lid::CLOSED),
+                             outputPulse(Lid::HALF), true, servoPlant<Lid>(),
+                             typename channel_table::MakeIndices<CHANNEL_LUT_POINTS>::type());
+}
+
+/**
+ * One rig's block of CHANNEL_COUNT descriptors, in ChannelIndex order
+ */
+#define RIG_DESCRIPTORS(R)                                                          \
+  eyeDescriptor<R::Horizontal>(R::BOARD, R::HORIZONTAL_CHANNEL),                    \
+  eyeDescriptor<R::Vertical>(R::BOARD, R::VERTICAL_CHANNEL),                        \
+  lidDescriptor<R::LeftUpper>(R::BOARD, R::L_UPPER_CHANNEL),                        \
+  lidDescriptor<R::LeftLower>(R::BOARD, R::L_LOWER_CHANNEL),                        \
+  lidDescriptor<R::RightUpper>(R::BOARD, R::R_UPPER_CHANNEL),                       \
+  lidDescriptor<R::RightLower>(R::BOARD, R::R_LOWER_CHANNEL),
+
+/**
+ * Normalized position of an eye axis' calibrated CENTER
+ * (CENTER need not sit at the midpoint of MIN..MAX)
+ */
+template <typename Limits>
+constexpr int eyeCenterPosition() {
+  return Limits::INVERTED
+    ? (int)(((long)(Limits::MAX - Limits::CENTER) * CHANNEL_POS_FULL +
+             (Limits::MAX - Limits::MIN) / 2) / (Limits::MAX - Limits::MIN))
+    : (int)(((long)(Limits::CENTER - Limits::MIN) * CHANNEL_POS_FULL +
+             (Limits::MAX - Limits::MIN) / 2) / (Limits::MAX - Limits::MIN));
+}
+
+// ============================================================================
+// CALIBRATION CHECKS (fail the build, not the boot)
+// ============================================================================
+
+#define PLANT_VALID(L)                                                              \
+  static_assert(L::PLANT_TAU_MS >= 0 && L::PLANT_TAU_MS <= 255 &&                   \
+                L::PLANT_SLEW > 0 && L::PLANT_SLEW <= 20000,                        \
+                #L ": PLANT_TAU_MS must be 0-255, PLANT_SLEW 1-20000")
+
+#define EYE_LIMITS_VALID(L)                                                         \
+  PLANT_VALID(L);                                                                   \
+  static_assert(L::MIN < L::MAX, #L ": MIN must be less than MAX");                 \
+  static_assert(L::MIN <= L::CENTER && L::CENTER <= L::MAX,                         \
+                #L ": CENTER must lie between MIN and MAX");                        \
+  static_assert(channel_table::withinAbsolute(L::MIN) &&                            \
+                channel_table::withinAbsolute(L::MAX),                              \
+                #L ": limits exceed SafetyLimits::ABSOLUTE_MIN/MAX_PULSE")
+
+#define LID_LIMITS_VALID(L)                                                         \
+  PLANT_VALID(L);                                                                   \
+  static_assert(L::OPEN != L::CLOSED, #L ": OPEN and CLOSED must differ");          \
+  static_assert(channel_table::withinAbsolute(L::OPEN) &&                           \
+                channel_table::withinAbsolute(L::CLOSED) &&                         \
+                channel_table::withinAbsolute(L::HALF),                             \
+                #L ": positions exceed SafetyLimits::ABSOLUTE_MIN/MAX_PULSE");      \
+  static_assert(channel_table::lowOf(L::OPEN, L::CLOSED) <= L::HALF &&              \
+                L::HALF <= channel_table::highOf(L::OPEN, L::CLOSED),               \
+                #L ": HALF must lie between OPEN and CLOSED")
+
+#define RIG_LAYOUT_VALID(R)                                                         \
+  EYE_LIMITS_VALID(R::Horizontal);                                                  \
+  EYE_LIMITS_VALID(R::Vertical);                                                    \
+  LID_LIMITS_VALID(R::LeftUpper);                                                   \
+  LID_LIMITS_VALID(R::LeftLower);                                                   \
+  LID_LIMITS_VALID(R::RightUpper);                                                  \
+  LID_LIMITS_VALID(R::RightLower);                                                  \
+  static_assert(R::BOARD >= 0 && R::BOARD < SERVO_BOARD_COUNT,                      \
+                #R ": BOARD is not an index into SERVO_BOARD_LIST");                \
+  static_assert(R::HORIZONTAL_CHANNEL < 16 && R::VERTICAL_CHANNEL < 16 &&           \
+                R::L_UPPER_CHANNEL < 16 && R::L_LOWER_CHANNEL < 16 &&               \
+                R::R_UPPER_CHANNEL < 16 && R::R_LOWER_CHANNEL < 16,                 \
+                #R ": servo channels must be 0-15");
+
+EYE_RIG_LIST(RIG_LAYOUT_VALID)
+
+static_assert(RIG_COUNT >= 1, "EYE_RIG_LIST needs at least one rig");
+static_assert(channel_table::boardChannelsDistinct(0),
+              "Servo channels must be distinct on each board");
+
+// ============================================================================
+// RUNTIME ACCESS
+// ============================================================================
+
+/**
+ * Fill channelTable with the compiled calibration (CHANNEL_DEFAULTS)
+ */
+void channelTableLoadDefaults();
+
+/**
+ * Descriptor built at runtime from limits (calibration counts) with low < high
+ * inverted: pulse falls as the normalized position rises (eye INVERTED,
+ * or a lid that closes toward the low pulse)
+ * lid: the table bends at center (HALF), as lidDescriptor() does
+ * plant: the servo's response, kept from the descriptor being replaced
+ */
+ChannelDescriptor channelDescriptor(uint8_t board, uint8_t channel, uint16_t low,
+                                    uint16_t center, uint16_t high, bool inverted, bool lid,
+                                    ServoPlant plant);
+
+/**
+ * The runtime form of EYE_LIMITS_VALID / LID_LIMITS_VALID:
+ * low < high, center between them, all within SafetyLimits::ABSOLUTE_*
+ */
+bool channelLimitsValid(uint16_t low, uint16_t center, uint16_t high);
+
+/**
+ * Descriptor-level access (any RAM descriptor, e.g. a rig's block)
+ */
+inline uint8_t descriptorBoard(const ChannelDescriptor *d) {
+  return d->board;
+}
+
+inline uint8_t descriptorOutput(const ChannelDescriptor *d) {
+  return d->channel;
+}
+
+inline uint16_t descriptorMin(const ChannelDescriptor *d) {
+  return d->minPulse;
+}
+
+inline uint16_t descriptorMax(const ChannelDescriptor *d) {
+  return d->maxPulse;
+}
+
+inline uint16_t descriptorCenter(const ChannelDescriptor *d) {
+  return d->centerPulse;
+}
+
+inline bool descriptorInverted(const ChannelDescriptor *d) {
+  return d->direction < 0;
+}
+
+/**
+ * Normalized position (0 .. CHANNEL_POS_FULL) → pulse
+ */
+inline uint16_t descriptorPulse(const ChannelDescriptor *d, uint16_t position) {
+  if (position >= CHANNEL_POS_FULL) {
+    return d->lut[CHANNEL_LUT_POINTS - 1];
+  }
+  uint8_t segment = position >> CHANNEL_LUT_SHIFT;
+  int16_t fraction = position & ((1 << CHANNEL_LUT_SHIFT) - 1);
+  int16_t a = d->lut[segment];
+  int16_t b = d->lut[segment + 1];
+  return a + (((b - a) * fraction + (1 << (CHANNEL_LUT_SHIFT - 1))) >> CHANNEL_LUT_SHIFT);
+}
+
+/**
+ * Clamp a pulse to the channel's calibrated bounds
+ */
+inline uint16_t descriptorClamp(const ChannelDescriptor *d, int pulse) {
+  int lo = descriptorMin(d);
+  int hi = descriptorMax(d);
+  return (uint16_t)(pulse < lo ? lo : (pulse > hi ? hi : pulse));
+}
+
+/**
+ * Normalized position of the calibrated center (eyeCenterPosition() for
+ * whatever calibration is live)
+ */
+inline uint16_t descriptorCenterPosition(const ChannelDescriptor *d) {
+  long from = d->lut[0];
+  long span = (long)d->lut[CHANNEL_LUT_POINTS - 1] - from;
+  return (uint16_t)((((long)d->centerPulse - from) * CHANNEL_POS_FULL + span / 2) / span);
+}
+
+/**
+ * Table-level access: index = rig block start + ChannelIndex
+ */
+inline const ChannelDescriptor *rigChannels(uint8_t rig) {
+  return &channelTable[rig * CHANNEL_COUNT];
+}
+
+inline uint8_t channelOutput(uint8_t index) {
+  return descriptorOutput(&channelTable[index]);
+}
+
+inline uint16_t channelMinPulse(uint8_t index) {
+  return descriptorMin(&channelTable[index]);
+}
+
+inline uint16_t channelMaxPulse(uint8_t index) {
+  return descriptorMax(&channelTable[index]);
+}
+
+inline uint16_t channelPulse(uint8_t index, uint16_t position) {
+  return descriptorPulse(&channelTable[index], position);
+}
+
+inline uint16_t channelClamp(uint8_t index, int pulse) {
+  return descriptorClamp(&channelTable[index], pulse);
+}
+
+inline uint8_t servoBoardAddress(uint8_t board) {
+  return pgm_read_byte(&SERVO_BOARD_ADDRESSES[board]);
+}
+
+#endif // CHANNEL_TABLE_H
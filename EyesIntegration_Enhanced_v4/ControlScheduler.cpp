@@ -0,0 +1,88 @@
+/**
+ * ControlScheduler.cpp
+ *
+ * See ControlScheduler.h
+ */
+
+#include "ControlScheduler.h"
+#include "EyeHAL.h"
+
+static uint16_t saturateUs(unsigned long us) {
+  return us > 0xFFFF ? 0xFFFF : (uint16_t)us;
+}
+
+ControlScheduler::ControlScheduler() : count(0) {
+  memset(groups, 0, sizeof(groups));
+}
+
+int8_t ControlScheduler::add(const __FlashStringHelper *name, RateGroupTask task,
+                             unsigned long periodMs, unsigned long offsetUs) {
+  if (count >= SCHEDULER_MAX_GROUPS || periodMs == 0) return -1;
+
+  RateGroup &g = groups[count];
+  g.name = name;
+  g.task = task;
+  g.periodUs = periodMs * 1000UL;
+  g.deadlineUs = offsetUs;            // Relative until start()
+  memset(&g.stats, 0, sizeof(g.stats));
+  return (int8_t)count++;
+}
+
+void ControlScheduler::start() {
+  unsigned long now = halMicros();
+  for (uint8_t i = 0; i < count; i++) {
+    groups[i].deadlineUs += now;
+    groups[i].lastStartUs = groups[i].deadlineUs - groups[i].periodUs;
+  }
+}
+
+void ControlScheduler::run() {
+  for (uint8_t i = 0; i < count; i++) {
+    RateGroup &g = groups[i];
+    unsigned long start = halMicros();
+    long late = (long)(start - g.deadlineUs);
+    if (late < 0) continue;
+
+    RateGroupStats &s = g.stats;
+    s.lastLatencyUs = saturateUs((unsigned long)late);
+    if (s.lastLatencyUs > s.maxLatencyUs) s.maxLatencyUs = s.lastLatencyUs;
+
+    if (s.runs > 0) {
+      long interval = (long)(start - g.lastStartUs);
+      uint16_t jitter = saturateUs((unsigned long)labs(interval - (long)g.periodUs));
+      if (jitter > s.maxJitterUs) s.maxJitterUs = jitter;
+    }
+    g.lastStartUs = start;
+
+    g.task();
+
+    s.lastExecUs = saturateUs(halMicros() - start);
+    if (s.lastExecUs > s.wcetUs) s.wcetUs = s.lastExecUs;
+    s.runs++;
+
+    // Drift compensation: advance from the deadline, not from now.
+    // A whole missed period is skipped rather than replayed.
+    g.deadlineUs += g.periodUs;
+    long behind = (long)(halMicros() - g.deadlineUs);
+    if (behind >= (long)g.periodUs) {
+      unsigned long missed = (unsigned long)behind / g.periodUs;
+      s.overruns += missed;
+      g.deadlineUs += missed * g.periodUs;
+    }
+  }
+
+  // Idle until the earliest deadline
+  unsigned long now = halMicros();
+  long wait = 0x7FFFFFFFL;
+  for (uint8_t i = 0; i < count; i++) {
+    long until = (long)(groups[i].deadlineUs - now);
+    if (until < wait) wait = until;
+  }
+  if (count > 0 && wait > 0) halIdleUntil(now + (unsigned long)wait);
+}
+
+void ControlScheduler::resetStats() {
+  for (uint8_t i = 0; i < count; i++) {
+    memset(&groups[i].stats, 0, sizeof(groups[i].stats));
+  }
+}
@@ -0,0 +1,86 @@
+/**
+ * ControlScheduler.h
+ *
+ * Fixed-rate, drift-compensated scheduler for the control loop
+ *
+ * Replaces "do the work, then delay(20)" - whose real period is 20 ms PLUS
+ * however long the work took - with absolute deadlines:
+ *
+ *   next deadline = previous deadline + period   (never "now + period")
+ *
+ * so execution time and print bursts shift individual ticks but never
+ * accumulate into drift. If a group falls a whole period or more behind,
+ * the missed ticks are counted as an overrun and skipped (no catch-up burst).
+ *
+ * RATE GROUPS:
+ * Each group is a task with its own period and phase. Groups that fall due
+ * at the same moment run in the order they were added, so
+ * input → motion → output keeps its data flow within one tick.
+ *
+ * TIMING COUNTERS (per group, microseconds):
+ * - latency:  how late the task started vs. its deadline
+ * - jitter:   how far the start-to-start interval strayed from the period
+ * - exec/WCET: last and worst-case execution time
+ * Times saturate at 65535 us (a stall that long needs no better figure).
+ */
+
+#ifndef CONTROL_SCHEDULER_H
+#define CONTROL_SCHEDULER_H
+
+#include <Arduino.h>
+
+// input, motion, output, telemetry (34 bytes of RAM each on the UNO)
+#define SCHEDULER_MAX_GROUPS 4
+
+typedef void (*RateGroupTask)();
+
+struct RateGroupStats {
+  unsigned long runs;
+  unsigned long overruns;        // Ticks skipped because the group fell a period behind
+  uint16_t lastLatencyUs;
+  uint16_t maxLatencyUs;
+  uint16_t maxJitterUs;
+  uint16_t lastExecUs;
+  uint16_t wcetUs;
+};
+
+struct RateGroup {
+  const __FlashStringHelper *name;
+  RateGroupTask task;
+  unsigned long periodUs;
+  unsigned long deadlineUs;      // Next release time
+  unsigned long lastStartUs;
+  RateGroupStats stats;
+};
+
+class ControlScheduler {
+public:
+  ControlScheduler();
+
+  /**
+   * Register a group; offsetUs delays its first release (phase, in
+   * microseconds so a group can lead another by less than a millisecond)
+   * Returns the group index, or -1 if the table is full
+   */
+  int8_t add(const __FlashStringHelper *name, RateGroupTask task,
+             unsigned long periodMs, unsigned long offsetUs = 0);
+
+  /** Release every group relative to now (call once after setup work) */
+  void start();
+
+  /**
+   * One scheduler pass: run every due group, then idle until the next
+   * deadline. Call from loop().
+   */
+  void run();
+
+  uint8_t groupCount() const { return count; }
+  const RateGroup &group(uint8_t index) const { return groups[index]; }
+  void resetStats();
+
+private:
+  RateGroup groups[SCHEDULER_MAX_GROUPS];
+  uint8_t count;
+};
+
+#endif // CONTROL_SCHEDULER_H
@@ -9,7 +9,8 @@
  * 
  * WHEN TO UPDATE THIS FILE:
  * - Initial calibration (set all values)
- * - Servo replacement (recalibrate that channel)
+ * - Servo replacement (recalibrate that channel - or over Serial without
+ *   re-flashing, see SERVO REPLACEMENT GUIDE)
  * - Mechanical changes (reassembly, new linkages)
  * - If servo struggles or buzzes (tighten limits)
  * 
@@ -52,6 +53,20 @@
 // CALIBRATED SERVO LIMITS - YOUR VALUES
 // ============================================================================
 
+/**
+ * Servo Response (every struct below)
+ *
+ * Next to its limits each servo carries its identified response: the
+ * shaft follows the pulse like a first-order lag of PLANT_TAU_MS, never
+ * faster than PLANT_SLEW (counts per second, 60 Hz counts like the
+ * limits). The motion path commands ahead by that lag
+ * (MotionSettings::SERVO_LEAD), so the shaft - not just the pulse - is
+ * where the motion wants it.
+ * - Defaults: SG90 at 5 V (60° in 0.1 s ≈ 1600 counts/s, ~20 ms lag)
+ * - Measure: ServoPulseCalibrator 'r' logs a step response, HostSim's
+ *   plantfit fits it and prints the two lines to paste here
+ */
+
 /**
  * Horizontal Eye Movement (Channel 0)
  * 
@@ -77,6 +92,8 @@ struct HorizontalLimits {
   static const int CENTER = 345;
   static const int MAX = 470;
   static const bool INVERTED = true;  // Set true to reverse left/right
+  static const int PLANT_TAU_MS = 20;   // Servo response (see above)
+  static const int PLANT_SLEW = 1600;     // counts/s
 };
 
 /**
@@ -104,6 +121,8 @@ struct VerticalLimits {
   static const int CENTER = 342;
   static const int MAX = 440;
   static const bool INVERTED = false;  // Set true to reverse up/down
+  static const int PLANT_TAU_MS = 20;   // Servo response (see above)
+  static const int PLANT_SLEW = 1600;     // counts/s
 };
 
 /**
@@ -116,6 +135,10 @@ struct VerticalLimits {
  * - HALF: 370 (half-closed for expressions)
  * - Range: 480 pulse units
  * 
+ * HALF is where the lid sits at mid-travel: blinks, partial blinks and
+ * expressions pass through it (see ChannelTable.h). If the linkage makes
+ * the lid look less than half closed at (OPEN+CLOSED)/2, move HALF.
+ * 
  * INVERSION:
  * - Set to true if servo motion is backwards
  * - true = swap OPEN and CLOSED values
@@ -131,6 +154,8 @@ struct LeftUpperLid {
   static const int CLOSED = 410; //410;    // YOUR calibrated value
   static const int HALF = 335;      // Calculated: (260+410)/2
   static const bool INVERTED = false;  // YOUR setting
+  static const int PLANT_TAU_MS = 20;   // Servo response (see above)
+  static const int PLANT_SLEW = 1600;     // counts/s
 };
 
 /**
@@ -148,6 +173,8 @@ struct LeftLowerLid {
   static const int CLOSED = 400;    // YOUR calibrated value
   static const int HALF = 340;      // Calculated: (280+400)/2
   static const bool INVERTED = true;  // YOUR setting - INVERTED!
+  static const int PLANT_TAU_MS = 20;   // Servo response (see above)
+  static const int PLANT_SLEW = 1600;     // counts/s
 };
 
 /**
@@ -169,6 +196,8 @@ struct RightUpperLid {
   static const int CLOSED = 380; //425;    // YOUR calibrated value
   static const int HALF = 340;      // Calculated: (255+425)/2
   static const bool INVERTED = true;  // YOUR setting - INVERTED!
+  static const int PLANT_TAU_MS = 20;   // Servo response (see above)
+  static const int PLANT_SLEW = 1600;     // counts/s
 };
 
 /**
@@ -186,6 +215,156 @@ struct RightLowerLid {
   static const int CLOSED = 395;    // YOUR calibrated value
   static const int HALF = 325;      // Calculated: (255+395)/2
   static const bool INVERTED = false;  // YOUR setting
+  static const int PLANT_TAU_MS = 20;   // Servo response (see above)
+  static const int PLANT_SLEW = 1600;     // counts/s
+};
+
+// ============================================================================
+// EYE RIGS & SERVO BOARDS
+// ============================================================================
+
+/**
+ * Eye Rig Layout
+ *
+ * A rig is one 6-servo eye mechanism: its board, its channels and its
+ * calibration. The sketch runs every rig in EYE_RIG_LIST with its own
+ * motion, blinks and idle behavior; joystick and host gaze steer them all.
+ *
+ * BOARD is an index into SERVO_BOARD_LIST below. Channels must be distinct
+ * on each board - checked at compile time (see ChannelTable.h).
+ */
+struct MainRig {
+  static const int BOARD = 0;
+  static const int HORIZONTAL_CHANNEL = SERVO_HORIZONTAL;
+  static const int VERTICAL_CHANNEL = SERVO_VERTICAL;
+  static const int L_UPPER_CHANNEL = SERVO_L_UPPER;
+  static const int L_LOWER_CHANNEL = SERVO_L_LOWER;
+  static const int R_UPPER_CHANNEL = SERVO_R_UPPER;
+  static const int R_LOWER_CHANNEL = SERVO_R_LOWER;
+  typedef HorizontalLimits Horizontal;
+  typedef VerticalLimits Vertical;
+  typedef LeftUpperLid LeftUpper;
+  typedef LeftLowerLid LeftLower;
+  typedef RightUpperLid RightUpper;
+  typedef RightLowerLid RightLower;
+};
+
+/**
+ * Installed Boards and Rigs
+ *
+ * ADDING A RIG:
+ * 1. Calibrate its servos with ServoPulseCalibrator.ino and add limit
+ *    structs for them (copies of HorizontalLimits etc. under new names)
+ * 2. Describe it, e.g. a second rig on a second board (A0+A2 → 0x45):
+ *
+ *      struct SecondRig : MainRig {
+ *        static const int BOARD = 1;
+ *        typedef SecondHorizontalLimits Horizontal;
+ *        ...
+ *      };
+ *
+ *    Anything not redefined (channels, calibration) is taken from MainRig.
+ *    Two rigs may share a board on different channels.
+ * 3. List the board and the rig:
+ *
+ *      #define SERVO_BOARD_LIST(BOARD) BOARD(SERVO_SHIELD_ADDRESS) BOARD(0x45)
+ *      #define EYE_RIG_LIST(RIG) RIG(MainRig) RIG(SecondRig)
+ *
+ * 4. Check the EEPROM layout: each rig grows the calibration blob by 42
+ *    bytes (6 + 42 per rig: 48, 90, 132, ...). From the third rig on it
+ *    runs into the recording at PerformanceSettings::EEPROM_ADDRESS (128)
+ *    and the build fails on the overlap - move EEPROM_ADDRESS past the
+ *    blob and shrink EEPROM_SIZE by as much (e.g. 3 rigs: 136 / 888).
+ *    Moving it discards a saved recording; calibration is kept.
+ * 5. Check RAM: each rig takes ~530 bytes (its descriptors, motion state
+ *    and current budget), each board ~80. The UNO has room for one rig
+ *    (the build fails on MemorySettings otherwise); more need a Mega.
+ *
+ * The first rig is the one reported in telemetry.
+ */
+#define SERVO_BOARD_LIST(BOARD) \
+  BOARD(SERVO_SHIELD_ADDRESS)
+
+#define EYE_RIG_LIST(RIG) \
+  RIG(MainRig)
+
+/**
+ * Output Rate & Resolution
+ *
+ * The limits above are PCA9685 counts at 60 Hz, the frame rate
+ * ServoPulseCalibrator (and the "cal" commands) work at. A faster frame
+ * makes each count shorter, so the same travel spans more counts:
+ *
+ *   HIGH_RATE = false: 60 Hz frames, 100 kHz I2C, 50 Hz control loop
+ *                      (1 count = 4.07 us; vertical eye ~180 counts)
+ *   HIGH_RATE = true:  ~MAX_FRAME_HZ frames, 400 kHz I2C, CONTROL_HZ loop
+ *                      (200 Hz: 1 count = 1.24 us; vertical eye ~590 counts)
+ *
+ * Everything in this file stays in 60 Hz counts and per-second units; the
+ * firmware rescales it to the output counts and tick (see ChannelTable.h).
+ *
+ * - MAX_FRAME_HZ: the fastest frame the servos accept. The prescale is
+ *   chosen for the fastest frame at or below it. SG90s run up to ~300 Hz
+ *   but get warm and hum at rest near the top; if they do, LOWER this
+ * - OSCILLATOR_HZ: the PCA9685's internal oscillator is 25 MHz +-5%.
+ *   Measure a channel's frame rate with a scope or logic analyzer and set
+ *   OSCILLATOR_HZ = 25000000 × measured / intended Hz, so the frame really
+ *   stays at or below MAX_FRAME_HZ (pulse widths don't depend on it)
+ * - CONTROL_HZ: motion / output / telemetry rate, 100-200 (1000 / CONTROL_HZ
+ *   must be whole milliseconds)
+ */
+struct OutputSettings {
+  static const bool HIGH_RATE = true;
+  static const unsigned long MAX_FRAME_HZ = 200;
+  static const unsigned long OSCILLATOR_HZ = 25000000;
+  static const unsigned long CONTROL_HZ = 100;
+};
+
+/**
+ * Shared I2C Bus
+ *
+ * All boards (and the nunchuck) share one bus. Each output tick sends at
+ * most OUTPUT_BUDGET_US worth of servo bytes; channels that don't fit go
+ * out next tick (see ServoBus.h).
+ *
+ * - I2C_CLOCK_HZ: 100000 is standard mode, 400000 fast mode (PCA9685 and
+ *   nunchuck both support it; HIGH_RATE uses it). With 3+ boards at 50 Hz
+ *   use 400000 too, or the budget will defer writes.
+ *   Writes are queued for the interrupt-driven bus driver (I2CQueue.h);
+ *   with 2+ boards in motion also raise I2C_QUEUE_BYTES there.
+ * - OUTPUT_BUDGET_US: half the motion period leaves room for the nunchuck
+ *   read and the rest of the tick
+ */
+struct ServoBusSettings {
+  static const unsigned long I2C_CLOCK_HZ = OutputSettings::HIGH_RATE ? 400000 : 100000;
+  static const unsigned long OUTPUT_BUDGET_US =
+    OutputSettings::HIGH_RATE ? 500000 / OutputSettings::CONTROL_HZ : 10000;
+};
+
+/**
+ * Servo Power Budget
+ *
+ * Every servo on the supply shares BUDGET_MA; moves that would together
+ * draw more are slowed down, lids served before eyes (see PowerBudget.h).
+ * The estimate per servo, mA at 5 V:
+ * - HOLD_MA: pulse unchanged (SG90: 5-10 idle, more against a lid spring)
+ * - MOVE_MA: moving slowly
+ * - STALL_MA: commanded at its own speed or faster - the motor runs flat
+ *   out, close to stall current (SG90: ~650)
+ * Between MOVE and STALL it scales with the commanded speed.
+ *
+ * - SLEW_PER_SEC: the servo's speed, calibration counts per second
+ *   (SG90: 60° in 0.1 s ≈ 1600)
+ * - BUDGET_MA: what the servos may draw together - the supply's rating
+ *   less the boards and some margin for the model (3000 on a 4 A supply).
+ *   0 = never limit (the estimate is still reported)
+ */
+struct PowerSettings {
+  static const unsigned int BUDGET_MA = 3000;
+  static const unsigned int HOLD_MA = 20;
+  static const unsigned int MOVE_MA = 120;
+  static const unsigned int STALL_MA = 650;
+  static const unsigned int SLEW_PER_SEC = 1600;
 };
 
 // ============================================================================
@@ -217,24 +396,51 @@ struct NunchuckCalibration {
   static const int CENTER = 126;  // (26 + 226) / 2
 };
 
+/**
+ * Nunchuck Detection (runs in the background, see NunchuckLink.h)
+ * 
+ * - RETRY_MS: how often a missing nunchuck is probed, so it can be
+ *   plugged in (or re-plugged) at any time
+ * - MAX_FAILURES: failed reads in a row before it counts as unplugged
+ *   (one bus glitch doesn't drop the joystick)
+ */
+struct NunchuckLinkSettings {
+  static const unsigned long RETRY_MS = 500;
+  static const int MAX_FAILURES = 3;
+};
+
 // ============================================================================
 // MOTION CONTROL PARAMETERS
 // ============================================================================
 
 /**
- * Motion Smoothing
+ * Motion Dynamics
+ * 
+ * Eyes follow their targets with a critically damped spring
+ * (MotionEngine.h) instead of a fixed smoothing divisor
+ * 
+ * EYE_RESPONSE_MS: spring time constant
+ * - Lower = snappier, higher = lazier
+ * - Settles to within a pulse in roughly 6-7 × this value
+ * - Recommended: 30-80
  * 
- * Controls how smoothly servos move to target positions
- * Higher value = smoother, slower movement
- * Lower value = faster, more responsive movement
+ * EYE_MAX_ACCEL: acceleration limit (60 Hz pulses per second²)
+ * - Caps how hard a move starts/stops (jerk-free onset)
+ * - Velocity is capped by SafetyLimits::MAX_DELTA_PER_UPDATE
  * 
- * Recommended ranges:
- * - Eye movement: 6-12 (Disney typically uses 8-10)
- * - Eyelids: 3-6 (faster for snappy blinks)
+ * Eyelids follow their own trajectories (BlinkSettings)
  */
 struct MotionSettings {
-  static const int EYE_SMOOTHING = 8;      // Smoothing for eye movement
-  static const int EYELID_SMOOTHING = 5;   // Smoothing for eyelids (not used in basic test)
+  static const int EYE_RESPONSE_MS = 40;       // Spring time constant
+  static const long EYE_MAX_ACCEL = 40000;     // pulses/s²
+  
+  // Command every servo ahead by its PLANT_TAU_MS lag (false: the pulse is
+  // the motion's position, the shaft trails it)
+  static const bool SERVO_LEAD = true;
+  
+  // Longest step the motion engine will integrate in one tick
+  // (a stalled loop resumes smoothly instead of jumping)
+  static const unsigned long MAX_MOTION_DT_MS = 100;
 };
 
 /**
@@ -251,15 +457,97 @@ struct MotionSettings {
 #define DEADZONE 10
 
 /**
- * Blink Duration
+ * Joystick Input Filter (see JoystickFilter.h)
+ * 
+ * - ASYMMETRIC_RANGE: scale each side of CENTER by its own span, so an
+ *   off-center stick still rests at center and reaches both ends
+ * - FILTER: adaptive low-pass; at rest / slow the cutoff is MIN_CUTOFF,
+ *   each full deflection per second of stick speed adds BETA
+ *   - Eyes shimmer while the stick is held still: LOWER MIN_CUTOFF
+ *   - Eyes trail fast stick moves: RAISE BETA
+ * DEADZONE (above) is radial and scaled: output grows from zero at its
+ * edge instead of jumping
+ */
+struct JoystickSettings {
+  static const bool ASYMMETRIC_RANGE = true;
+  static const bool FILTER = true;
+  static const unsigned int MIN_CUTOFF_MILLIHZ = 1500;
+  static const unsigned int BETA_MILLIHZ = 4000;
+  static const unsigned int SPEED_CUTOFF_MILLIHZ = 3000;
+};
+
+/**
+ * Tilt Gaze (alternate input, see TiltGaze.h)
+ *
+ * Tilting the nunchuck steers the eyes, the joystick adds to it. Hold C
+ * and Z together for CHORD_MS (ACTIVE state) to switch between joystick
+ * and tilt; START_ENABLED picks the mode at boot.
+ *
+ * - ACCEL_ZERO_* / ACCEL_ONE_G: accelerometer counts at 0 g and per g
+ *   (NunchuckCharacterization shows yours: flat, X and Y sit at zero and
+ *   Z at zero + one g)
+ * - RANGE_DECIDEG: tilt (0.1°) that reaches full deflection
+ * - DEADZONE_DECIDEG: tilt ignored around level
+ * - TAU_MS: how slowly tilt follows the accelerometer
+ *   - Eyes tremble with your hand: RAISE TAU_MS
+ *   - Eyes trail the tilt: LOWER TAU_MS
+ * - ACTIVITY_DECIDEG: a tilt change this big keeps the eyes out of idle
+ * - INVERT_X / INVERT_Y: flip a direction
+ */
+struct TiltSettings {
+  static const bool START_ENABLED = false;
+  static const unsigned long CHORD_MS = 1000;
+  static const int ACCEL_ZERO_X = 512;
+  static const int ACCEL_ZERO_Y = 512;
+  static const int ACCEL_ZERO_Z = 512;
+  static const unsigned int ACCEL_ONE_G = 200;
+  static const unsigned int RANGE_DECIDEG = 350;     // 35°
+  static const unsigned int DEADZONE_DECIDEG = 40;   // 4°
+  static const unsigned int TAU_MS = 150;
+  static const unsigned int ACTIVITY_DECIDEG = 50;
+  static const bool INVERT_X = false;
+  static const bool INVERT_Y = false;
+};
+
+/**
+ * Blink & Eyelid Settings (see BlinkEngine.h)
+ * 
+ * A blink closes fast, holds, and opens more slowly; lower lids trail
+ * the upper ones. Natural blink: ~80ms close, ~170ms open
  * 
- * How long eyes stay closed during blink (milliseconds)
+ * Blinks look mechanical: RAISE OPEN_MS, LOWER_LAG_MS
+ * Blinks look sleepy: LOWER OPEN_MS / HOLD_MS
+ * Partial blinks too subtle: RAISE PARTIAL_DEPTH_PERCENT (50 = HALF)
  * 
- * Natural human blink: 100-150ms
- * Cartoon blink: 200-300ms
- * Surprised blink: 50-100ms
+ * Upper lids drop when the eyes look down, lower lids rise when they look
+ * up (percent of full travel at full deflection; 0 = off)
  */
-#define BLINK_DURATION 150  // milliseconds
+struct BlinkSettings {
+  static const unsigned int CLOSE_MS = 80;
+  static const unsigned int HOLD_MS = 30;
+  static const unsigned int OPEN_MS = 170;
+  static const unsigned int LOWER_LAG_MS = 20;
+  
+  // Spontaneous (idle) blinks: this share is partial, closing this far
+  static const uint8_t PARTIAL_PERCENT = 25;
+  static const uint8_t PARTIAL_DEPTH_PERCENT = 50;
+  
+  static const uint8_t UPPER_GAZE_PERCENT = 30;
+  static const uint8_t LOWER_GAZE_PERCENT = 15;
+};
+
+/**
+ * Expression Settings (lid presets, see PoseCompositor.h)
+ * 
+ * Expressions fade in over FADE_MS, hold, and fade out again; in idle a
+ * landed saccade shows one now and then (IDLE_PERCENT)
+ */
+struct ExpressionSettings {
+  static const unsigned int FADE_MS = 300;
+  static const unsigned int HOLD_MIN_MS = 1500;
+  static const unsigned int HOLD_MAX_MS = 4000;
+  static const uint8_t IDLE_PERCENT = 4;
+};
 
 /**
  * Idle Animation Settings
@@ -275,20 +563,59 @@ struct IdleSettings {
   static const unsigned long IDLE_BLINK_MIN = 2000;    // Minimum 2 seconds between blinks
   static const unsigned long IDLE_BLINK_MAX = 6000;    // Maximum 6 seconds between blinks
   
-  // Movement sequence timing
-  static const unsigned long IDLE_SEQUENCE_MIN = 2000;  // Min time for each look sequence
-  static const unsigned long IDLE_SEQUENCE_MAX = 4000;  // Max time for each look sequence
-  
-  // Movement ranges (percentage of full range, 0.0 - 1.0)
+  // Movement ranges (fraction of each side of CENTER, 0.0 - 1.0)
   static constexpr float IDLE_MOVEMENT_RANGE = 0.7;    // Use 70% of available range
 };
 
+/**
+ * Idle Gaze Settings (see SaccadeEngine.h)
+ * 
+ * Idle eyes hold a point, creep slightly, then jump to the next point
+ * with a saccade; larger jumps take longer (DURATION_BASE_MS +
+ * DURATION_X10_MS_PER_DEG / 10 per degree, the human "main sequence")
+ * 
+ * H_RANGE_DEG / V_RANGE_DEG: how far the eye turns from MIN to MAX -
+ * measure it once on the mechanism; it sets how fast a jump looks
+ * 
+ * Eyes look nervous: RAISE FIXATION_MIN_MS / FIXATION_MAX_MS
+ * Eyes stare at the edges: RAISE CENTER_PULL_PERCENT
+ * Too many blinks on big looks: LOWER BLINK_WITH_SACCADE_PERCENT
+ */
+struct SaccadeSettings {
+  static const uint8_t H_RANGE_DEG = 60;
+  static const uint8_t V_RANGE_DEG = 45;
+  
+  // Time between saccades, skewed toward short (mean ~950 ms)
+  static const unsigned int FIXATION_MIN_MS = 300;
+  static const unsigned int FIXATION_MAX_MS = 3000;
+  
+  // Main sequence: 21 ms + 2.2 ms per degree
+  static const uint8_t DURATION_BASE_MS = 21;
+  static const uint8_t DURATION_X10_MS_PER_DEG = 22;
+  
+  // Chance at the field edge (scaled by distance) of returning to center
+  static const uint8_t CENTER_PULL_PERCENT = 60;
+  
+  // Drift during a fixation, and how far before a microsaccade corrects it
+  static const uint8_t DRIFT_X10_DEG_PER_SEC = 5;    // 0.5°/s
+  static const uint8_t DRIFT_LIMIT_X10_DEG = 5;      // 0.5°
+  
+  // Saccades of BLINK_SACCADE_DEG and up start with a blink this often
+  // (the auto-blink timer restarts); auto-blinks wait for a saccade to land
+  static const uint8_t BLINK_SACCADE_DEG = 15;
+  static const uint8_t BLINK_WITH_SACCADE_PERCENT = 40;
+  
+  // Chance that a landed saccade is followed by an expression clip
+  static const uint8_t CLIP_PERCENT = 5;
+};
+
 /**
  * Startup Animation Settings
  * 
  * Defines the boot sequence when system powers on
  */
 struct StartupSettings {
+  static const unsigned long EYES_CLOSE_DURATION = 1000; // Take 1 second to close eyes
   static const unsigned long EYES_CLOSED_HOLD = 1000;   // Hold eyes closed for 1 second
   static const unsigned long EYES_OPEN_DURATION = 800;  // Take 800ms to open eyes
   static const unsigned long LOOK_AROUND_DURATION = 2000; // Look around for 2 seconds
@@ -310,11 +637,114 @@ struct SafetyLimits {
   static const int ABSOLUTE_MIN_PULSE = 100;   // Below this = danger
   static const int ABSOLUTE_MAX_PULSE = 650;   // Above this = danger
   
-  // Maximum position change per update (prevents sudden jerks)
+  // Maximum position change per 20 ms (prevents sudden jerks)
+  // Enforced as the eye velocity limit: 50 per 20ms = 2500 pulses/s,
+  // whatever the control rate
   static const int MAX_DELTA_PER_UPDATE = 50;
+  static const int MAX_DELTA_INTERVAL_MS = 20;
   
   // Update rate limit (minimum ms between servo updates)
-  static const int MIN_UPDATE_INTERVAL_MS = 20;  // 50Hz max
+  static const int MIN_UPDATE_INTERVAL_MS =
+    OutputSettings::HIGH_RATE ? 1000 / OutputSettings::CONTROL_HZ : 20;  // 100-200Hz / 50Hz
+};
+
+// ============================================================================
+// CONTROL SCHEDULER
+// ============================================================================
+
+/**
+ * Rate Group Periods
+ * 
+ * The control loop runs on fixed deadlines instead of delay():
+ * each group's next run = previous deadline + period, so work and Serial
+ * output never stretch the period (see ControlScheduler.h)
+ * 
+ * - Input: nunchuck polling every 10 ms, or every motion tick if that is
+ *   faster, released just early enough for the bus read to land before motion
+ * - Motion: state machine / smoothing - constant dt
+ * - Output: servo frame flush, right after motion in the same tick
+ * - Telemetry: one record per motion tick, offset to land just after output
+ */
+struct SchedulerSettings {
+  static const unsigned long INPUT_PERIOD_MS =
+    SafetyLimits::MIN_UPDATE_INTERVAL_MS < 10 ? SafetyLimits::MIN_UPDATE_INTERVAL_MS : 10;
+  static const unsigned long MOTION_PERIOD_MS = SafetyLimits::MIN_UPDATE_INTERVAL_MS;
+  static const unsigned long OUTPUT_PERIOD_MS = SafetyLimits::MIN_UPDATE_INTERVAL_MS;
+  static const unsigned long TELEMETRY_PERIOD_MS = SafetyLimits::MIN_UPDATE_INTERVAL_MS;
+  static const unsigned long TELEMETRY_OFFSET_MS = SafetyLimits::MIN_UPDATE_INTERVAL_MS / 4;
+  
+  // The input group runs ahead of motion by one nunchuck read plus this,
+  // so each motion tick picks up a sample that has just arrived
+  static const unsigned long INPUT_LEAD_MARGIN_US = 300;
+  
+  // How often the per-group timing counters are reported
+  static const unsigned long TIMING_REPORT_MS = 10000;
+};
+
+/**
+ * Telemetry Output
+ * 
+ * - BINARY = true: every motion tick is logged as a framed binary record
+ *   (decode on the PC with HostSim/build/teledecode → CSV). Never blocks;
+ *   if the link can't keep up, records are dropped and counted.
+ * - BINARY = false: human-readable status line every TEXT_PERIOD_MS,
+ *   for watching in the Serial Monitor (these prints CAN block the loop)
+ */
+struct TelemetrySettings {
+  static const bool BINARY = true;
+  static const unsigned long TEXT_PERIOD_MS = 500;
+};
+
+/**
+ * Host Gaze Control (PC tracker → Serial, see GazeLink.h)
+ * 
+ * - PLAYOUT_DELAY_MS: commands are played this long after their fastest
+ *   possible arrival; link jitter up to this much is absorbed
+ *   (larger = smoother, smaller = more responsive)
+ * - TIMEOUT_MS: the joystick takes over again when the host goes quiet
+ */
+struct HostControlSettings {
+  static const unsigned int PLAYOUT_DELAY_MS = 40;
+  static const unsigned int TIMEOUT_MS = 500;
+};
+
+/**
+ * Field Calibration (EEPROM, see CalibrationStore.h)
+ * 
+ * Servo limits saved on the board with the "cal" Serial commands replace
+ * the values above at boot; an empty or invalid EEPROM falls back to them.
+ * - EEPROM_ADDRESS: start of the calibration blob (6 bytes + 42 per rig)
+ */
+struct CalibrationStoreSettings {
+  static const unsigned int EEPROM_ADDRESS = 0;
+};
+
+/**
+ * Performance Recording ("rec" Serial commands, see PerformanceLog.h)
+ * 
+ * A manual session's nunchuck input, recorded to EEPROM (played back with
+ * "rec play") or streamed out over Serial (any length).
+ * - EEPROM_ADDRESS / EEPROM_SIZE: the recording's EEPROM area, after the
+ *   calibration blob (on the UNO's 1 KB, ~870 bytes of input). 128 leaves
+ *   room for two rigs' calibration; see ADDING A RIG for more.
+ */
+struct PerformanceSettings {
+  static const unsigned int EEPROM_ADDRESS = 128;
+  static const unsigned int EEPROM_SIZE = 896;
+};
+
+/**
+ * RAM (the UNO's 2 KB hold the static data and the stack together)
+ *
+ * The build fails if the static data - every buffer and counter, plus the
+ * Arduino core's Serial rings - leaves less than STACK_RESERVE bytes for
+ * the stack. The deepest path ("cal set" from the console, with the TWI
+ * interrupt on top) needs ~200; the reserve adds a fifth for margin. The
+ * TIMING report's "stack free" is what the deepest stack so far actually
+ * left on the board.
+ */
+struct MemorySettings {
+  static const unsigned int STACK_RESERVE = 240;
 };
 
 // ============================================================================
@@ -349,6 +779,20 @@ struct SafetyLimits {
  * 9. Re-upload EyesIntegrationTest.ino
  * 
  * 10. Test carefully before full operation
+ * 
+ * IN THE FIELD (no toolchain, any serial terminal at 115200):
+ * 
+ * 1. Find the new servo's limits with ServoPulseCalibrator (manual or auto
+ *    mode), or by trying values live with step 2
+ * 
+ * 2. Send "cal" to list the current limits, then for the replaced servo:
+ *      cal set RIG SERVO LOW CENTER HIGH [INV]    (e.g. cal set 0 lu 280 350 420)
+ *    The servo follows the new limits immediately
+ * 
+ * 3. "cal save" keeps them across power cycles; "cal reset" goes back to
+ *    the values in this file (see CalibrationConsole.h)
+ * 
+ * 4. Copy the values into this file at the next firmware update
  */
 
 // ============================================================================
@@ -0,0 +1,144 @@
+/**
+ * EyeHAL.h
+ *
+ * Hardware Abstraction Layer for the Animatronic Eyes controller
+ *
+ * The control code never talks to the TWI hardware, the EEPROM or the
+ * Arduino clock directly - it goes through these functions. Bus traffic is queued on
+ * i2cQueue (I2CQueue.h); the backend's driver runs it in the background.
+ *
+ * BACKENDS:
+ * - EyeHAL_Avr.cpp        → Arduino UNO (interrupt-driven TWI driver)
+ * - HostSim/SimHardware   → Linux simulator (virtual clock, background bus
+ *                           model, mock PCA9685, scriptable fake nunchuck)
+ *
+ * Only one backend is ever compiled: the AVR one is guarded by ARDUINO,
+ * the host one lives outside the sketch folder.
+ */
+
+#ifndef EYE_HAL_H
+#define EYE_HAL_H
+
+#include <Arduino.h>
+
+// ============================================================================
+// INPUT SAMPLE
+// ============================================================================
+
+/**
+ * One nunchuck reading
+ * Raw values as the nunchuck reports them (joystick 0-255, accel 0-1023)
+ */
+struct NunchuckSample {
+  int joyX;
+  int joyY;
+  int accelX;
+  int accelY;
+  int accelZ;
+  bool buttonZ;
+  bool buttonC;
+  bool connected;    // false → joystick centered, buttons released
+};
+
+/**
+ * Report a disconnected nunchuck as "hands off" so an unplugged
+ * controller never looks like activity
+ */
+inline void halNunchuckReleased(NunchuckSample &sample, int joyCenter) {
+  sample.joyX = joyCenter;
+  sample.joyY = joyCenter;
+  sample.buttonZ = false;
+  sample.buttonC = false;
+  sample.connected = false;
+}
+
+// ============================================================================
+// TIME
+// ============================================================================
+
+unsigned long halMillis();
+unsigned long halMicros();
+void halDelay(unsigned long ms);
+
+/**
+ * Wait until halMicros() reaches deadlineUs (wrap-safe)
+ * Used by the scheduler between ticks
+ */
+void halIdleUntil(unsigned long deadlineUs);
+
+// ============================================================================
+// I2C BUS
+// ============================================================================
+
+/**
+ * Enable the bus driver with the SCL clock shared by the servo boards and
+ * the nunchuck (call first in setup())
+ */
+void halBusClock(unsigned long hz);
+
+/**
+ * Start the front transaction of i2cQueue if the bus is idle and its
+ * holdUs has passed; restart a hung bus
+ * Never waits. i2cQueue calls it on every submit and the driver chains
+ * transactions itself, so only holds need the scheduler's idle polling.
+ */
+void halI2CService();
+
+/**
+ * Wait until everything queued has gone out (setup only)
+ */
+void halI2CFlush();
+
+// ============================================================================
+// EEPROM
+// ============================================================================
+
+void halEepromRead(uint16_t address, void *data, uint16_t length);
+
+/**
+ * Only bytes that differ are written (~3.4 ms each on the UNO, and it
+ * blocks: keep it out of the running control loop where possible)
+ */
+void halEepromWrite(uint16_t address, const void *data, uint16_t length);
+
+#define HAL_EEPROM_QUEUE_SIZE 16
+
+// The UNO backend's other static state (TWI, EEPROM queue indices), for
+// the sketch's RAM budget; EyeHAL_Avr.cpp checks it
+#define HAL_STATE_BYTES 14
+
+/**
+ * Background write: up to HAL_EEPROM_QUEUE_SIZE bytes of one contiguous
+ * run wait in the backend and are written one at a time while the loop
+ * idles (halIdleUntil), so the caller never blocks. Returns how many bytes
+ * were taken; a run that doesn't continue the queued one waits until that
+ * has been written. halEepromWrite() finishes the queue first.
+ */
+uint8_t halEepromQueue(uint16_t address, const uint8_t *data, uint8_t length);
+
+/** Bytes queued by halEepromQueue() and not yet written */
+uint8_t halEepromQueued();
+
+// ============================================================================
+// SYSTEM
+// ============================================================================
+
+/**
+ * Entropy for randomSeed() (floating analog pin on the UNO)
+ */
+unsigned long halRandomSeed();
+
+/**
+ * Stop forever after a fatal configuration/hardware error
+ */
+void halHalt();
+
+/**
+ * Stack headroom: bytes between the static data and the deepest the stack
+ * has reached since reset (the UNO paints its free RAM at reset and counts
+ * the paint still untouched - a scan of up to 2 KB, ~0.5 ms: call it
+ * rarely). 0xFFFF where there is no such limit (host).
+ */
+uint16_t halStackFree();
+
+#endif // EYE_HAL_H
@@ -0,0 +1,252 @@
+/**
+ * EyeHAL_Avr.cpp
+ *
+ * Arduino UNO backend for EyeHAL.h
+ * Clock wrappers plus an interrupt-driven TWI driver for i2cQueue.
+ *
+ * The driver replaces Wire (and with it the Adafruit PWM and WiiChuck
+ * libraries, which only ever reached the bus through Wire): both would
+ * claim the TWI interrupt. The PCA9685 and nunchuck protocols now live in
+ * ServoFrame and NunchuckLink, on top of the queue.
+ */
+
+#ifdef ARDUINO
+
+#include <avr/eeprom.h>
+#include <avr/interrupt.h>
+#include <util/twi.h>
+#include "EyeHAL.h"
+#include "EyeConfig.h"
+#include "I2CQueue.h"
+
+// ============================================================================
+// TIME
+// ============================================================================
+
+unsigned long halMillis() {
+  return millis();
+}
+
+unsigned long halMicros() {
+  return micros();
+}
+
+void halDelay(unsigned long ms) {
+  delay(ms);
+}
+
+static void eepromService();
+
+void halIdleUntil(unsigned long deadlineUs) {
+  // Queued transactions with a hold can only be started from here, and
+  // background EEPROM bytes are written one per ready EEPROM
+  while ((long)(deadlineUs - micros()) > 0) {
+    halI2CService();
+    eepromService();
+  }
+}
+
+// ============================================================================
+// I2C BUS (TWI interrupt state machine)
+// ============================================================================
+
+// Longest legal transaction is ~3 ms at 100 kHz; past this the bus is hung
+static const unsigned long TWI_TIMEOUT_US = 10000;
+
+// TWINT cleared, interrupt on: hand the next bus step to the hardware
+#define TWCR_NEXT (_BV(TWEN) | _BV(TWIE) | _BV(TWINT))
+
+static volatile bool twiBusy = false;
+static volatile uint8_t twiIndex = 0;        // Bytes moved in this transaction
+static volatile unsigned long twiStartUs = 0;
+static volatile unsigned long twiStopUs = 0;
+
+/** Send START for i2cQueue.front() (interrupts off) */
+static void twiStart() {
+  twiBusy = true;
+  twiIndex = 0;
+  twiStartUs = micros();
+  TWCR = TWCR_NEXT | _BV(TWSTA);
+}
+
+/** STOP, report the outcome and chain the next transaction (interrupts off) */
+static void twiFinish(uint8_t status) {
+  TWCR = _BV(TWEN) | _BV(TWINT) | _BV(TWSTO);
+  for (uint8_t i = 0; (TWCR & _BV(TWSTO)) && i < 255; i++);
+
+  twiBusy = false;
+  twiStopUs = micros();
+  i2cQueue.complete(status);
+
+  // Back to back unless the next one asks for a pause (halI2CService)
+  const I2CTransaction *next = i2cQueue.front();
+  if (next != NULL && next->holdUs == 0) twiStart();
+}
+
+ISR(TWI_vect) {
+  const I2CTransaction *t = i2cQueue.front();
+
+  switch (TW_STATUS) {
+    case TW_START:
+    case TW_REP_START:
+      TWDR = (t->address << 1) | (t->readBuffer != NULL ? TW_READ : TW_WRITE);
+      TWCR = TWCR_NEXT;
+      break;
+
+    case TW_MT_SLA_ACK:
+    case TW_MT_DATA_ACK:
+      if (twiIndex < t->length) {
+        TWDR = i2cQueue.payload(twiIndex++);
+        TWCR = TWCR_NEXT;
+      } else {
+        twiFinish(I2C_DONE);
+      }
+      break;
+
+    case TW_MR_DATA_ACK:
+      t->readBuffer[twiIndex++] = TWDR;
+      // Fall through: ACK again unless the next byte is the last
+    case TW_MR_SLA_ACK:
+      TWCR = twiIndex + 1 < t->length ? (TWCR_NEXT | _BV(TWEA)) : TWCR_NEXT;
+      break;
+
+    case TW_MR_DATA_NACK:
+      t->readBuffer[twiIndex++] = TWDR;
+      twiFinish(I2C_DONE);
+      break;
+
+    case TW_MT_SLA_NACK:
+    case TW_MR_SLA_NACK:
+    case TW_MT_DATA_NACK:
+      twiFinish(I2C_NACK);
+      break;
+
+    default:   // Bus error or lost arbitration
+      twiFinish(I2C_FAILED);
+      break;
+  }
+}
+
+void halBusClock(unsigned long hz) {
+  // Internal pull-ups (the shield has its own; harmless)
+  digitalWrite(SDA, HIGH);
+  digitalWrite(SCL, HIGH);
+
+  TWSR = 0;                                    // Prescaler 1
+  TWBR = (uint8_t)(((F_CPU / hz) - 16) / 2);
+  TWCR = _BV(TWEN);
+}
+
+void halI2CService() {
+  uint8_t sreg = SREG;
+  cli();
+
+  unsigned long now = micros();
+  if (twiBusy && now - twiStartUs > TWI_TIMEOUT_US) {
+    // A slave holds the bus (unplugged mid-transfer): reset the TWI, drop it
+    TWCR = 0;
+    TWCR = _BV(TWEN);
+    twiBusy = false;
+    twiStopUs = now;
+    i2cQueue.complete(I2C_FAILED);
+  }
+
+  const I2CTransaction *t = i2cQueue.front();
+  if (!twiBusy && t != NULL && now - twiStopUs >= t->holdUs) twiStart();
+
+  SREG = sreg;
+}
+
+void halI2CFlush() {
+  while (!i2cQueue.idle()) halI2CService();
+}
+
+// ============================================================================
+// EEPROM
+// ============================================================================
+
+void halEepromRead(uint16_t address, void *data, uint16_t length) {
+  eeprom_read_block(data, (const void *)address, length);
+}
+
+// Background queue: a ring holding one contiguous run
+static uint8_t eepromQueue[HAL_EEPROM_QUEUE_SIZE];
+static uint8_t eepromHead = 0;               // Front byte
+static uint8_t eepromCount = 0;
+static uint16_t eepromAddress = 0;           // Address of the front byte
+
+static_assert(sizeof(twiBusy) + sizeof(twiIndex) + sizeof(twiStartUs) + sizeof(twiStopUs) +
+                sizeof(eepromHead) + sizeof(eepromCount) + sizeof(eepromAddress) == HAL_STATE_BYTES,
+              "HAL_STATE_BYTES (EyeHAL.h) must match the static state above");
+
+/** Start the front byte if the EEPROM is free (the write runs ~3.4 ms on its own) */
+static void eepromService() {
+  if (eepromCount == 0 || !eeprom_is_ready()) return;
+  eeprom_update_byte((uint8_t *)eepromAddress, eepromQueue[eepromHead]);
+  eepromAddress++;
+  eepromHead = (eepromHead + 1) % HAL_EEPROM_QUEUE_SIZE;
+  eepromCount--;
+}
+
+void halEepromWrite(uint16_t address, const void *data, uint16_t length) {
+  while (eepromCount > 0) eepromService();
+  eeprom_update_block(data, (void *)address, length);
+}
+
+uint8_t halEepromQueue(uint16_t address, const uint8_t *data, uint8_t length) {
+  if (eepromCount == 0) eepromAddress = address;
+  else if (address != eepromAddress + eepromCount) return 0;
+
+  uint8_t taken = 0;
+  while (taken < length && eepromCount < HAL_EEPROM_QUEUE_SIZE) {
+    eepromQueue[(eepromHead + eepromCount) % HAL_EEPROM_QUEUE_SIZE] = data[taken++];
+    eepromCount++;
+  }
+  return taken;
+}
+
+uint8_t halEepromQueued() {
+  return eepromCount;
+}
+
+// ============================================================================
+// SYSTEM
+// ============================================================================
+
+unsigned long halRandomSeed() {
+  return analogRead(A0);
+}
+
+void halHalt() {
+  while (1);
+}
+
+// Free RAM - from the end of the static data (nothing uses the heap) to
+// the top of the stack - painted before main(), in .init3: after the
+// stack pointer is set, before the static data is initialized
+#define STACK_PAINT 0xC5
+
+extern uint8_t __heap_start;
+
+void halStackPaint() __attribute__((naked, used, section(".init3")));
+void halStackPaint() {
+  asm volatile("    ldi r30, lo8(__heap_start)\n"
+               "    ldi r31, hi8(__heap_start)\n"
+               "    ldi r24, %0\n"
+               "    ldi r25, hi8(__stack)\n"
+               "    rjmp 2f\n"
+               "1:  st Z+, r24\n"
+               "2:  cpi r30, lo8(__stack)\n"
+               "    cpc r31, r25\n"
+               "    brlo 1b\n"
+               "    breq 1b\n"
+               :: "M"(STACK_PAINT));
+}
+
+uint16_t halStackFree() {
+  const uint8_t *p = &__heap_start;
+  while (p <= (const uint8_t *)RAMEND && *p == STACK_PAINT) p++;
+  return p - &__heap_start;
+}
+
+#endif // ARDUINO
@@ -0,0 +1,271 @@
+/**
+ * EyeRig.cpp
+ *
+ * See EyeRig.h
+ */
+
+#include "EyeRig.h"
+#include "EyeConfig.h"
+
+#define LEAD_MAX_DELTA 1023 // Per-tick move beyond which the lead is capped anyway
+#define LEAD_RATE_SHIFT 4   // rate[]: pose change per tick, Q4
+#define LEAD_SMOOTH_SHIFT 1 // rate[] follows each tick's change by half
+#define LEAD_MIN_RATE 24    // Below 1.5 counts/tick no lead: slow drift stays as is
+
+EyeRig::EyeRig()
+  : table(NULL), servoBus(NULL), power(NULL), leadOn(MotionSettings::SERVO_LEAD), gazeH(0),
+    gazeV(0), centerH(0), centerV(0), currentH(0), currentV(0), idleActive(false),
+    idleTrack(false), lastLayers(0), nextIdleBlinkTime(0) {
+  memset(aimed, 0, sizeof(aimed));
+  memset(rate, 0, sizeof(rate));
+  memset(eyeStaged, 0, sizeof(eyeStaged));
+}
+
+void EyeRig::begin(const ChannelDescriptor *channels, ServoBus *bus,
+                   const MotionProfile &eyeProfile) {
+  table = channels;
+  servoBus = bus;
+  centerH = descriptorCenterPosition(&table[CH_HORIZONTAL]);
+  centerV = descriptorCenterPosition(&table[CH_VERTICAL]);
+  centerGaze();
+  currentH = center(CH_HORIZONTAL);
+  currentV = center(CH_VERTICAL);
+  axisH.setProfile(eyeProfile);
+  axisV.setProfile(eyeProfile);
+  axisH.reset(currentH);
+  axisV.reset(currentV);
+  compose(0, 0);
+}
+
+void EyeRig::recenter() {
+  bool centered = gazeH == centerH && gazeV == centerV;
+  centerH = descriptorCenterPosition(&table[CH_HORIZONTAL]);
+  centerV = descriptorCenterPosition(&table[CH_VERTICAL]);
+  if (centered) centerGaze();
+  if (idleActive) {
+    saccades.setField(idleField(CH_HORIZONTAL, SaccadeSettings::H_RANGE_DEG),
+                      idleField(CH_VERTICAL, SaccadeSettings::V_RANGE_DEG));
+  }
+}
+
+uint16_t EyeRig::output(uint8_t index) const {
+  const ChannelDescriptor *d = &table[index];
+  return servoBus->get(descriptorBoard(d), descriptorOutput(d));
+}
+
+// ============================================================================
+// COMPOSITION
+// ============================================================================
+
+void EyeRig::compose(unsigned long nowMs, unsigned long dtMs) {
+  PoseFrame pose;
+  pose.layers = 1 << LAYER_GAZE;
+  pose.trackEyes = false;
+
+  // Gaze: the set target, lids resting on where the eyes are
+  pose.set(CH_HORIZONTAL, gazeH);
+  pose.set(CH_VERTICAL, gazeV);
+  blinker.rest(gazeUp(), pose);
+
+  // Idle gaze replaces the eye target; saccades are followed directly (the
+  // spring would turn them into glides), fixations and drift go through it
+  if (idleActive) {
+    pose.set(CH_HORIZONTAL, saccades.positionH());
+    pose.set(CH_VERTICAL, saccades.positionV());
+    pose.trackEyes = idleTrack;
+    pose.layers |= 1 << LAYER_IDLE;
+  }
+
+  expressionLayer.apply(nowMs, pose);
+  blinker.apply(nowMs, pose);
+
+  // Clip: whatever it drives, full weight
+  if (clipPlayer.playing()) {
+    uint8_t driven = clipPlayer.evaluate(nowMs, pose.value);
+    if (driven & ((1 << CH_HORIZONTAL) | (1 << CH_VERTICAL))) pose.trackEyes = false;
+    if (driven) pose.layers |= 1 << LAYER_CLIP;
+  }
+  lastLayers = pose.layers;
+
+  // Eyes through the motion engine, then every channel clamped once
+  int h = pulse(CH_HORIZONTAL, constrain(pose.value[CH_HORIZONTAL], 0, CHANNEL_POS_FULL));
+  int v = pulse(CH_VERTICAL, constrain(pose.value[CH_VERTICAL], 0, CHANNEL_POS_FULL));
+  if (pose.trackEyes) {
+    currentH = axisH.track(h, dtMs);
+    currentV = axisV.track(v, dtMs);
+  } else {
+    axisH.setTarget(h);
+    axisV.setTarget(v);
+    currentH = axisH.update(dtMs);
+    currentV = axisV.update(dtMs);
+  }
+
+  // One division per tick; each servo's lead is then a multiply
+  int32_t perMs = leadOn && dtMs > 0 ? LEAD_ONE / (int32_t)dtMs : 0;
+
+  // Eye step this tick, lead included: the velocity limit (none on the
+  // first pose; a second already covers any travel)
+  int eyeStep = dtMs > 0 ? (int)(EYE_MAX_VELOCITY * (long)min(dtMs, 1000UL) / 1000L) : 0;
+  if (dtMs > 0 && eyeStep < 1) eyeStep = 1;
+  stage(CH_HORIZONTAL, currentH, perMs, eyeStep);
+  stage(CH_VERTICAL, currentV, perMs, eyeStep);
+
+  for (uint8_t i = CH_L_UPPER; i <= CH_R_LOWER; i++) {
+    stage(i, pulse(i, constrain(pose.value[i], 0, CHANNEL_POS_FULL)), perMs, 0);
+  }
+}
+
+/**
+ * Lead, then safety: constrain to configured limits, then stage
+ *
+ * A first-order servo trails a pulse that moves at v by τ·v, so the pulse
+ * is commanded that far ahead of where the motion wants the shaft. Past
+ * slew × τ the servo is at full speed anyway (maxLead). The rate is
+ * smoothed over a couple of ticks - pose pulses move in whole counts, and
+ * a raw difference would flick the lead on and off - and slow drift gets
+ * none: τ·v is a count or two there, and every flick is an extra PWM write.
+ * The eyes' staged pulse, lead included, then moves at most maxStep from
+ * the last one: the lead must not carry an eye past MAX_DELTA_PER_UPDATE.
+ * perMs: 1 / tick length, Q12 (0 = no lead). maxStep: 0 = lids, or the
+ * first pose.
+ */
+void EyeRig::stage(uint8_t index, int pulse, int32_t perMs, int maxStep) {
+  const ChannelDescriptor *d = &table[index];
+  int delta = constrain(pulse - aimed[index], -LEAD_MAX_DELTA, LEAD_MAX_DELTA);
+  aimed[index] = pulse;
+  if (perMs == 0) {
+    rate[index] = 0;
+  } else {
+    rate[index] += ((delta << LEAD_RATE_SHIFT) - rate[index]) >> LEAD_SMOOTH_SHIFT;
+  }
+  pulse += lead(index, perMs);
+  if (maxStep > 0) {
+    pulse = constrain(pulse, eyeStaged[index] - maxStep, eyeStaged[index] + maxStep);
+  }
+  pulse = descriptorClamp(d, pulse);
+  if (index <= CH_VERTICAL) eyeStaged[index] = pulse;
+
+  if (power != NULL) {
+    power->set(d, pulse);
+  } else {
+    servoBus->set(descriptorBoard(d), descriptorOutput(d), pulse);
+  }
+}
+
+/**
+ * τ·rate, up to the plant's maxLead; none for slow drift (see stage())
+ */
+int EyeRig::lead(uint8_t index, int32_t perMs) const {
+  if (perMs == 0 || (rate[index] < LEAD_MIN_RATE && rate[index] > -LEAD_MIN_RATE)) return 0;
+  const ChannelDescriptor *d = &table[index];
+  int32_t ahead = (((int32_t)rate[index] * d->plant.tauMs) >> LEAD_RATE_SHIFT) * perMs / LEAD_ONE;
+  int32_t most = d->plant.maxLead;
+  return (int)constrain(ahead, -most, most);
+}
+
+/**
+ * Vertical eye position as a deflection from center, Q8:
+ * -256 = full down (MIN end of the table), 256 = full up
+ */
+int16_t EyeRig::gazeUp() const {
+  const ChannelDescriptor *d = &table[CH_VERTICAL];
+  int32_t offset = (int32_t)currentV - descriptorCenter(d);
+  int32_t up = (int32_t)descriptorPulse(d, CHANNEL_POS_FULL) - descriptorCenter(d);
+  int32_t down = (int32_t)descriptorPulse(d, 0) - descriptorCenter(d);
+  if (offset == 0) return 0;
+  if ((offset > 0) == (up > 0)) {
+    return up == 0 ? 0 : (int16_t)constrain(offset * 256 / up, 0, 256);
+  }
+  return down == 0 ? 0 : (int16_t)-constrain(offset * 256 / down, 0, 256);
+}
+
+// ============================================================================
+// BLINKS
+// ============================================================================
+
+void EyeRig::startBlink(unsigned long nowMs, bool partial) {
+  static const uint16_t PARTIAL_DEPTH =
+    (uint32_t)CHANNEL_POS_FULL * BlinkSettings::PARTIAL_DEPTH_PERCENT / 100;
+  blinker.start(nowMs, partial ? PARTIAL_DEPTH : CHANNEL_POS_FULL);
+}
+
+// ============================================================================
+// IDLE BEHAVIOR
+// ============================================================================
+
+void EyeRig::enterIdle(unsigned long nowMs) {
+  nextIdleBlinkTime = nowMs + random(IdleSettings::IDLE_BLINK_MIN,
+                                     IdleSettings::IDLE_BLINK_MAX);
+  // Eyes settle to center, first saccade after 500ms
+  saccades.begin(idleField(CH_HORIZONTAL, SaccadeSettings::H_RANGE_DEG),
+                 idleField(CH_VERTICAL, SaccadeSettings::V_RANGE_DEG), 500);
+  idleActive = true;
+  idleTrack = false;
+}
+
+void EyeRig::leaveIdle(unsigned long nowMs) {
+  idleActive = false;
+  idleTrack = false;
+  clipPlayer.stop();
+  expressionLayer.clear(nowMs);
+}
+
+void EyeRig::runIdle(unsigned long nowMs, unsigned long dtMs) {
+  // Expression clip in progress - it owns the lids, so no auto-blink
+  if (clipPlayer.playing()) {
+    idleTrack = false;
+    return;
+  }
+
+  uint8_t events = saccades.update(dtMs);
+  bool saccade = !(events & SACCADE_EVENT_MICRO);
+  idleTrack = saccades.saccading() || (events & SACCADE_EVENT_LAND);
+
+  // Large saccades often come with a blink that starts with them
+  if ((events & SACCADE_EVENT_START) && saccade && !blinking() &&
+      saccades.amplitudeDeg() >= SaccadeSettings::BLINK_SACCADE_DEG &&
+      random(0, 100) < SaccadeSettings::BLINK_WITH_SACCADE_PERCENT) {
+    autoBlink(nowMs);
+  }
+
+  // Auto-blink, held back until a saccade in flight has landed
+  if ((long)(nowMs - nextIdleBlinkTime) >= 0 && !blinking() && !saccades.saccading()) {
+    autoBlink(nowMs);
+  }
+
+  if (!(events & SACCADE_EVENT_LAND) || !saccade || blinking()) return;
+
+  // Now and then after a look: an expression clip (any but startup), or a
+  // lid expression held for a while
+  if (random(0, 100) < SaccadeSettings::CLIP_PERCENT) {
+    clipPlayer.play(&ANIMATION_CLIPS[random(1, ANIMATION_CLIP_COUNT)], nowMs);
+    saccades.fixate(SaccadeSettings::FIXATION_MIN_MS);
+  } else if (expressionLayer.expression() == EXPRESSION_NONE &&
+             random(0, 100) < ExpressionSettings::IDLE_PERCENT) {
+    showExpression(random(EXPRESSION_SLEEPY, EXPRESSION_COUNT), nowMs,
+                   random(ExpressionSettings::HOLD_MIN_MS, ExpressionSettings::HOLD_MAX_MS));
+  }
+}
+
+/**
+ * Spontaneous blink (some partial), restarting the auto-blink timer
+ */
+void EyeRig::autoBlink(unsigned long nowMs) {
+  startBlink(nowMs, random(0, 100) < BlinkSettings::PARTIAL_PERCENT);
+  nextIdleBlinkTime = nowMs + random(IdleSettings::IDLE_BLINK_MIN,
+                                     IdleSettings::IDLE_BLINK_MAX);
+}
+
+/**
+ * Idle field of one eye axis: IDLE_MOVEMENT_RANGE of each side of the
+ * calibrated center, in normalized positions
+ */
+SaccadeField EyeRig::idleField(uint8_t index, uint8_t rangeDeg) const {
+  static const int32_t RANGE_Q8 = (int32_t)(IdleSettings::IDLE_MOVEMENT_RANGE * 256);
+  SaccadeField f;
+  f.center = descriptorCenterPosition(&table[index]);
+  f.low = f.center - (int16_t)((f.center * RANGE_Q8) >> 8);
+  f.high = f.center + (int16_t)(((CHANNEL_POS_FULL - f.center) * RANGE_Q8) >> 8);
+  f.rangeDeg = rangeDeg;
+  return f;
+}
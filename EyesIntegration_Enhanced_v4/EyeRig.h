@@ -0,0 +1,205 @@
+/**
+ * EyeRig.h
+ *
+ * One eye mechanism (2 eye axes + 4 lids) and the behavior state it owns
+ *
+ * An installation runs one EyeRig per entry of EYE_RIG_LIST, spread over
+ * the servo boards of one ServoBus. The sketch's state machine stays
+ * shared - one nunchuck, one host link, one STARTUP/ACTIVE/IDLE state -
+ * but each rig has its own:
+ * - calibration: a block of channel descriptors (ChannelTable.h);
+ *   shared targets are normalized positions, mapped per rig
+ * - motion: eye axes, positions, lid trajectories (BlinkEngine.h)
+ * - behavior: blink timer, idle gaze (SaccadeEngine.h), expression clip -
+ *   so several rigs in idle don't move in lockstep
+ *
+ * Behaviors only feed layers; compose() builds the tick's pose from them
+ * (PoseCompositor.h) and is the one place a rig stages its six channels on
+ * the ServoBus - or on the supply's PowerBudget, which passes them on
+ * within the current budget. The output group sends them.
+ *
+ * SERVO LEAD: the pose says where each shaft should be; a servo lags its
+ * pulse (PLANT_TAU_MS in EyeConfig.h), so stage() commands every channel
+ * ahead of the pose by that lag at the speed it is moving. Eye axes,
+ * saccades and lid trajectories all arrive on time instead of ~τ late;
+ * at rest the command is the pose exactly. On the eyes, motion and lead
+ * together stay within the velocity limit (EYE_MAX_VELOCITY): the lead
+ * builds while an axis accelerates, it never adds a step past the limit.
+ */
+
+#ifndef EYE_RIG_H
+#define EYE_RIG_H
+
+#include <Arduino.h>
+#include "BlinkEngine.h"
+#include "ChannelTable.h"
+#include "KeyframeAnimation.h"
+#include "MotionEngine.h"
+#include "PoseCompositor.h"
+#include "PowerBudget.h"
+#include "SaccadeEngine.h"
+#include "ServoBus.h"
+
+#define LEAD_ONE 4096L      // 1.0 in the Q12 lead scale
+
+// The eye profile within MotionEngine's 32-bit arithmetic
+static_assert(EYE_MAX_VELOCITY <= MOTION_MAX_VELOCITY,
+              "SafetyLimits: MAX_DELTA_PER_UPDATE / MAX_DELTA_INTERVAL_MS too fast for MotionEngine");
+static_assert(EYE_MAX_ACCEL <= MOTION_MAX_ACCEL,
+              "MotionSettings: EYE_MAX_ACCEL too high for MotionEngine");
+static_assert(MotionSettings::EYE_RESPONSE_MS >= 1 &&
+              MotionSettings::EYE_RESPONSE_MS <= MOTION_MAX_RESPONSE_MS,
+              "MotionSettings: EYE_RESPONSE_MS must be 1..250");
+
+class EyeRig {
+public:
+  EyeRig();
+
+  /**
+   * Bind to a descriptor block and the bus; eyes are staged at the
+   * calibrated center, lids open
+   */
+  void begin(const ChannelDescriptor *channels, ServoBus *bus, const MotionProfile &eyeProfile);
+
+  /** Stage through a power budget from now on (NULL: straight on the bus) */
+  void setPowerBudget(PowerBudget *budget) { power = budget; }
+
+  /** Command ahead of each servo's lag (MotionSettings::SERVO_LEAD) */
+  void setServoLead(bool on) { leadOn = on; }
+  bool servoLead() const { return leadOn; }
+
+  /**
+   * The last tick's pulse on a channel before the lead (eyes: the motion
+   * engine's output), and the lead added to it, given that tick's length
+   * (0 with the lead off). Staged = the two summed, then clamped (eyes:
+   * also to the velocity limit from the last staged pulse).
+   */
+  int motionPulse(uint8_t index) const { return aimed[index]; }
+  int leadPulse(uint8_t index, unsigned long dtMs) const {
+    return lead(index, leadOn && dtMs > 0 ? LEAD_ONE / (int32_t)dtMs : 0);
+  }
+
+  /**
+   * Build this tick's pose from the layers, move the eyes toward it over
+   * dtMs, clamp and stage all six channels (once per motion tick)
+   */
+  void compose(unsigned long nowMs, unsigned long dtMs);
+
+  // ---- Channel table ----
+
+  /** Normalized position (0 .. CHANNEL_POS_FULL) → this rig's pulse */
+  uint16_t pulse(uint8_t index, uint16_t position) const {
+    return descriptorPulse(&table[index], position);
+  }
+
+  uint16_t center(uint8_t index) const { return descriptorCenter(&table[index]); }
+
+  /** Pulse currently staged on the bus for a channel */
+  uint16_t output(uint8_t index) const;
+
+  // ---- Gaze layer ----
+
+  /** Eye target, normalized positions */
+  void setGaze(uint16_t h, uint16_t v) { gazeH = h; gazeV = v; }
+
+  /** Gaze at the calibrated center */
+  void centerGaze() { setGaze(centerH, centerV); }
+
+  /**
+   * Calibration changed (cal set / load / reset): re-derive the center and
+   * the idle field; a gaze resting on the old center moves to the new one
+   */
+  void recenter();
+
+  /** Host lid position: the lids rest there (blinks included) until releaseLids() */
+  void holdLids(int position) { blinker.hold(constrain(position, 0, CHANNEL_POS_FULL)); }
+  void releaseLids() { blinker.hold(0); }
+
+  int eyeH() const { return currentH; }
+  int eyeV() const { return currentV; }
+  int targetH() const { return axisH.getTarget(); }
+  int targetV() const { return axisV.getTarget(); }
+
+  /** Layers that contributed to the last pose (bit n = PoseLayer n) */
+  uint8_t poseLayers() const { return lastLayers; }
+
+  // ---- Blink layer ----
+
+  /** Full blink, or partial (BlinkSettings::PARTIAL_DEPTH_PERCENT) */
+  void startBlink(unsigned long nowMs, bool partial = false);
+  bool blinking() const { return blinker.active(); }
+
+  // ---- Expression layer ----
+
+  /** Fade a lid preset in for holdMs (0 = until clearExpression()) */
+  void showExpression(uint8_t expression, unsigned long nowMs, unsigned long holdMs) {
+    expressionLayer.show(expression, nowMs, holdMs);
+  }
+  void clearExpression(unsigned long nowMs) { expressionLayer.clear(nowMs); }
+
+  // ---- Clip layer ----
+
+  /**
+   * Eye tracks become motion targets (axes the clip leaves alone follow
+   * the layers below); lid tracks replace the lids
+   */
+  void playClip(const AnimationClip *clip, unsigned long nowMs) { clipPlayer.play(clip, nowMs); }
+  void stopClip() { clipPlayer.stop(); }
+  bool clipPlaying() const { return clipPlayer.playing(); }
+
+  // ---- Idle layer ----
+
+  void enterIdle(unsigned long nowMs);
+
+  /** Back to the gaze layer: idle gaze, clip and expression end */
+  void leaveIdle(unsigned long nowMs);
+
+  /** One motion tick of idle gaze, auto-blink and expressions (before compose()) */
+  void runIdle(unsigned long nowMs, unsigned long dtMs);
+
+  /** Idle fixation point / saccade target, pulses */
+  int idleTargetH() const { return pulse(CH_HORIZONTAL, saccades.targetH()); }
+  int idleTargetV() const { return pulse(CH_VERTICAL, saccades.targetV()); }
+  const SaccadeEngine &idleGaze() const { return saccades; }
+  unsigned long nextBlinkMs() const { return nextIdleBlinkTime; }
+
+private:
+  SaccadeField idleField(uint8_t index, uint8_t rangeDeg) const;
+  void autoBlink(unsigned long nowMs);
+  int16_t gazeUp() const;
+  void stage(uint8_t index, int pulse, int32_t perMs, int maxStep);
+  int lead(uint8_t index, int32_t perMs) const;
+
+  const ChannelDescriptor *table;   // CHANNEL_COUNT entries
+  ServoBus *servoBus;
+  PowerBudget *power;               // NULL: stage on servoBus directly
+  bool leadOn;
+  int aimed[CHANNEL_COUNT];         // Last pose pulse per channel, before the lead
+  int16_t rate[CHANNEL_COUNT];      // Its change per tick, smoothed, Q4
+  int eyeStaged[2];                 // Eyes: last staged pulse, lead included
+
+  // Gaze layer
+  uint16_t gazeH;
+  uint16_t gazeV;
+  uint16_t centerH;                 // Normalized calibrated center
+  uint16_t centerV;
+
+  // Eyes
+  MotionAxis axisH;
+  MotionAxis axisV;
+  int currentH;
+  int currentV;
+
+  // Layers above gaze
+  bool idleActive;
+  bool idleTrack;                   // A saccade is in flight (or just landed)
+  SaccadeEngine saccades;
+  ExpressionLayer expressionLayer;
+  BlinkEngine blinker;
+  ClipPlayer clipPlayer;
+  uint8_t lastLayers;
+
+  unsigned long nextIdleBlinkTime;
+};
+
+#endif // EYE_RIG_H
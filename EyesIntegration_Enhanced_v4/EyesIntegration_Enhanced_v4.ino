@@ -4,39 +4,107 @@
  * 
  * FEATURES:
  * - Startup animation (eyes close, open, look around, center)
- * - Idle animation (5 random movement sequences when inactive)
+ * - Idle gaze when inactive: saccades between fixations, with fixational
+ *   drift and microsaccades in between (SaccadeEngine.h)
  * - Auto-blink during idle
- * - Manual nunchuck control
+ * - Manual nunchuck control (hot-pluggable, polled in the background)
+ * - Tilt gaze: steer by tilting the nunchuck (TiltSettings, TiltGaze.h)
+ * - Any number of eye rigs across several servo shields (EYE_RIG_LIST)
+ * - Host gaze control over Serial (PC-side tracker, see GazeLink.h)
  * - Smooth eyelid blinks
+ * - Servo current kept under the supply's budget (PowerBudget.h)
  * 
  * IMPORTANT: All servo limits are defined in EyeConfig.h
  * Edit EyeConfig.h to change calibration values, NOT this file!
+ * (Field changes can be saved in EEPROM over Serial: "cal" commands,
+ * see CalibrationConsole.h)
+ * 
+ * Manual sessions can be recorded and played back: "rec" commands, see
+ * performanceCommand() and PerformanceLog.h
  * 
  * Hardware:
  * - Arduino UNO
- * - Adafruit Servo Shield (address set in EyeConfig.h)
+ * - Adafruit Servo Shield(s) (addresses set in EyeConfig.h)
  * - Wii Nunchuck
- * - 6x SG90 Servos (calibrated)
+ * - 6x SG90 Servos per rig (calibrated)
  * - 5V 4A power supply
  * 
+ * All hardware access goes through EyeHAL.h, so this exact file also runs
+ * in the Linux simulator (HostSim/) against a virtual clock.
+ * 
  * CONTROLS:
  * - Joystick: Move eyes (exits idle mode)
  * - Z Button: Blink (exits idle mode)
  * - C Button: Return to center (exits idle mode)
+ * - C + Z held 1 second: joystick / tilt gaze (TiltSettings::CHORD_MS)
  * - Idle 15 seconds: Automatic animation starts
  */
 
-#include <Wire.h>
-#include <WiiChuck.h>
-#include <Adafruit_PWMServoDriver.h>
 #include "EyeConfig.h"  // ALL CONFIGURATION VALUES ARE HERE
+#include "EyeHAL.h"     // Clock and I2C bus driver access
+#include "I2CQueue.h"   // Background I2C transactions (servo boards + nunchuck)
+#include "NunchuckLink.h"  // Nunchuck polling and hot-plug detection
+#include "JoystickFilter.h"  // Joystick range, One-Euro filter, radial deadzone
+#include "TiltGaze.h"   // Accelerometer tilt fused with the joystick (alternate input)
+#include "ServoFrame.h" // Per-tick servo output buffer
+#include "ServoBus.h"   // One output pass over every servo board
+#include "PowerBudget.h" // Estimated servo current, kept under the supply budget
+#include "EyeRig.h"     // Per-rig calibration, motion and behavior
+#include "ControlScheduler.h"  // Fixed-rate input/motion/output/telemetry groups
+#include "MotionEngine.h"      // Fixed-point second-order eye motion
+#include "ChannelTable.h"      // Per-servo descriptors (built from EyeConfig.h)
+#include "CalibrationStore.h"  // EEPROM calibration, loaded over the descriptors at boot
+#include "CalibrationConsole.h"  // "cal" Serial commands
+#include "KeyframeAnimation.h" // PROGMEM keyframe clips (startup, expressions)
+#include "Telemetry.h"         // Non-blocking binary telemetry records
+#include "GazeLink.h"          // Host gaze command stream (Serial RX)
+#include "PerformanceLog.h"    // Nunchuck session record / replay
+#include "BootProfile.h"       // Boot stage timestamps
 
 // ============================================================================
 // OBJECTS
 // ============================================================================
 
-Accessory nunchuck;
-Adafruit_PWMServoDriver pwm = Adafruit_PWMServoDriver(SERVO_SHIELD_ADDRESS);
+// Latest nunchuck reading (polled in the background, see NunchuckLink.h)
+NunchuckLink nunchuckLink;
+NunchuckSample nunchuckInput;
+
+// Joystick → filtered gaze deflection (see JoystickSettings)
+JoystickFilter joystickFilter;
+
+// Tilt + joystick → gaze deflection, in tilt mode (see TiltSettings)
+TiltGaze tiltGaze;
+
+// All servo writes of a tick land here; the output group flushes once
+#define SERVO_FRAME_FOR_BOARD(address) ServoFrame(address),
+ServoFrame servoFrames[SERVO_BOARD_COUNT] = { SERVO_BOARD_LIST(SERVO_FRAME_FOR_BOARD) };
+ServoBus servoBus(servoFrames, SERVO_BOARD_COUNT,
+                  servoBusBudget(ServoBusSettings::I2C_CLOCK_HZ, ServoBusSettings::OUTPUT_BUDGET_US));
+
+// Rigs stage here; the output group passes their moves on to the bus
+// within the servo supply's current budget
+PowerBudget powerBudget(&servoBus, channelTable, PowerSettings::BUDGET_MA);
+
+// Every eye mechanism (EYE_RIG_LIST); rigs[0] is the one in telemetry
+EyeRig rigs[RIG_COUNT];
+
+// Drives every periodic task (see SchedulerSettings in EyeConfig.h)
+ControlScheduler scheduler;
+
+// Binary per-tick log, drained without blocking (see TelemetrySettings)
+TelemetryLink telemetry;
+int8_t motionGroup = -1;
+
+// Gaze commands from a PC-side tracker (alternate input to the joystick)
+GazeLink gazeLink(HostControlSettings::PLAYOUT_DELAY_MS, HostControlSettings::TIMEOUT_MS);
+
+// Servo limits saved in the field, and the Serial commands that edit them
+CalibrationStore calibrationStore(CalibrationStoreSettings::EEPROM_ADDRESS);
+CalibrationConsole calibrationConsole(&calibrationStore);
+
+// Recorded manual sessions (EEPROM, or streamed with the telemetry)
+PerformanceRecorder performance(PerformanceSettings::EEPROM_ADDRESS, PerformanceSettings::EEPROM_SIZE,
+                                &telemetry);
 
 // ============================================================================
 // ANIMATION STATES
@@ -48,72 +116,162 @@ enum SystemState {
   STATE_IDLE               // Idle animation mode
 };
 
-enum StartupPhase {
-  STARTUP_CLOSE_EYES,
-  STARTUP_HOLD_CLOSED,
-  STARTUP_OPEN_EYES,
-  STARTUP_LOOK_AROUND,
-  STARTUP_CENTER,
-  STARTUP_COMPLETE
-};
-
 // ============================================================================
 // GLOBAL VARIABLES
 // ============================================================================
 
 // System state
 SystemState currentState = STATE_STARTUP;
-StartupPhase startupPhase = STARTUP_CLOSE_EYES;
 
-// Current servo positions
-int currentH = HorizontalLimits::CENTER;
-int currentV = VerticalLimits::CENTER;
+// Motion timing (positions, blinks and idle state live in each EyeRig)
+unsigned long lastMotionTime = 0;
+unsigned long motionDtMs = 0;      // Elapsed time this motion tick covers
+
+// Rest gaze, normalized: the first rig's calibrated center
+uint16_t gazeCenterH = CHANNEL_POS_FULL / 2;
+uint16_t gazeCenterV = CHANNEL_POS_FULL / 2;
 
-// Blink state
-bool isBlinking = false;
-unsigned long blinkStartTime = 0;
+// Host-commanded gaze, normalized (ACTIVE state, while the gaze link is live)
+uint16_t hostGazeH = CHANNEL_POS_FULL / 2;
+uint16_t hostGazeV = CHANNEL_POS_FULL / 2;
 
-// Idle state
+// Idle timeout
 unsigned long lastActivityTime = 0;
-unsigned long nextIdleBlinkTime = 0;
-unsigned long nextIdleSequenceTime = 0;
-int currentIdleSequence = 0;
-int idleTargetH = HorizontalLimits::CENTER;
-int idleTargetV = VerticalLimits::CENTER;
 
-// Startup animation state
-unsigned long startupPhaseStartTime = 0;
-float eyelidAnimationProgress = 0.0;
+// Gaze from the nunchuck's tilt instead of the joystick alone
+bool tiltMode = TiltSettings::START_ENABLED;
+
+// DEADZONE (raw counts) as a radial deflection, Q12 of the X half-range
+const uint16_t JOY_DEADZONE = (long)DEADZONE * JOY_FULL /
+  ((NunchuckCalibration::JOY_X_MAX - NunchuckCalibration::JOY_X_MIN) / 2);
+static_assert(DEADZONE * 2 < NunchuckCalibration::JOY_X_MAX - NunchuckCalibration::JOY_X_MIN,
+              "DEADZONE must be smaller than the joystick's half-range");
+static_assert(TiltSettings::DEADZONE_DECIDEG < TiltSettings::RANGE_DECIDEG &&
+              TiltSettings::RANGE_DECIDEG <= 900,
+              "TiltSettings: DEADZONE_DECIDEG < RANGE_DECIDEG <= 900");
+
+// ============================================================================
+// RAM BUDGET
+// ============================================================================
+
+#if defined(ARDUINO) && defined(RAMEND)
+// Static data: the objects and scalars above, the module buffers behind
+// them (I2C queue, descriptor table, EEPROM queue, HAL state) and what no
+// sizeof reaches, counted by hand for avr-gcc (avr-size .data + .bss):
+// - RAM_CORE_BYTES: the Arduino core - Serial 157 (two 64-byte rings,
+//   their indices, six register pointers, Stream's timeout), millis 9,
+//   HardwareSerial's vtable 18
+// - RAM_CONSTANT_BYTES: constants read from RAM - the nunchuck's init
+//   writes and register addresses 6, the recorder's erase marker 2,
+//   strtok()'s delimiters 3
+// - RAM_LOCAL_STATIC_BYTES: function statics - lastConnected 1,
+//   lastTimingReport 4, timingGroup 1, lastTextReport 4
+// A new global or buffer belongs in this sum.
+#define RAM_CORE_BYTES 184
+#define RAM_CONSTANT_BYTES 11
+#define RAM_LOCAL_STATIC_BYTES 10
+static_assert(sizeof(nunchuckLink) + sizeof(nunchuckInput) + sizeof(joystickFilter) +
+                sizeof(tiltGaze) + sizeof(servoFrames) + sizeof(servoBus) +
+                sizeof(powerBudget) + sizeof(rigs) + sizeof(scheduler) + sizeof(telemetry) +
+                sizeof(gazeLink) + sizeof(calibrationStore) + sizeof(calibrationConsole) +
+                sizeof(performance) + sizeof(i2cQueue) + sizeof(channelTable) +
+                sizeof(motionGroup) + sizeof(currentState) + sizeof(lastMotionTime) +
+                sizeof(motionDtMs) + sizeof(gazeCenterH) + sizeof(gazeCenterV) +
+                sizeof(hostGazeH) + sizeof(hostGazeV) + sizeof(lastActivityTime) +
+                sizeof(tiltMode) + HAL_EEPROM_QUEUE_SIZE + HAL_STATE_BYTES +
+                RAM_CORE_BYTES + RAM_CONSTANT_BYTES + RAM_LOCAL_STATIC_BYTES +
+                MemorySettings::STACK_RESERVE <= RAMEND - RAMSTART + 1,
+              "MemorySettings: static RAM leaves less than STACK_RESERVE for the stack");
+#endif
 
 // ============================================================================
 // FORWARD DECLARATIONS
 // ============================================================================
 
-int mapJoystick(int joyValue, int joyMin, int joyMax, int servoMin, int servoMax, bool inverted = false);
-int smooth(int current, int target, int smoothing);
-int getEyelidPosition(int openValue, int closedValue, bool inverted, bool shouldClose);
-void moveEyes(int horizontal, int vertical);
-void setEyelidPosition(float position);
-void openEyes();
-void closeEyes();
+void configureJoystick();
+void configureTilt();
+void setTiltMode(bool enabled);
+void applyGazeCommand(const GazeCommand &command);
 void startBlink();
-void updateBlink();
-void printDebug(int joyX, int joyY, int targetH, int targetV);
+void composeRigs();
+void printDebug(int joyX, int joyY);
+void printTiming();
+void sendTelemetryTick();
+void sendTelemetryTiming(uint8_t group);
+void taskInput();
+void taskMotion();
+void taskOutput();
+void taskTelemetry();
 void runStartupAnimation();
-void runIdleAnimation();
 void checkForActivity();
 void enterIdleMode();
 void exitIdleMode();
-int getIdleTarget(int min, int max, int center);
+void consoleByte(uint8_t b);
+void calibrationChanged();
+void performanceCommand(const char *command, char *args);
+bool nunchuckActive(const NunchuckSample &sample);
 
 // ============================================================================
 // SETUP
 // ============================================================================
 
 void setup() {
+  // Reset → first control tick, printed once at the end (on the stack:
+  // nothing needs it after setup)
+  BootProfile bootProfile;
+  
   Serial.begin(115200);
-  delay(1000);
+  bootProfile.mark(F("serial"));
+  
+  // Calibration before anything reads a descriptor: EyeConfig.h values,
+  // replaced by what was saved in EEPROM if that is valid
+  calibrationStore.begin();
+  gazeCenterH = descriptorCenterPosition(&rigChannels(0)[CH_HORIZONTAL]);
+  gazeCenterV = descriptorCenterPosition(&rigChannels(0)[CH_VERTICAL]);
+  hostGazeH = gazeCenterH;
+  hostGazeV = gazeCenterV;
+  configureJoystick();
+  configureTilt();
+  bootProfile.mark(F("calibration loaded"));
+  
+  // Servos first: their init and the startup pose are queued before
+  // anything else and go out in the background while setup carries on
+  // (one bus for every device, see I2CQueue.h)
+  halBusClock(ServoBusSettings::I2C_CLOCK_HZ);
+  for (uint8_t b = 0; b < SERVO_BOARD_COUNT; b++) {
+    servoBus.board(b).begin(OUTPUT_PRESCALE);
+  }
+  bootProfile.mark(F("servo init queued"));
+  
+  // Seed random number generator
+  randomSeed(halRandomSeed());
   
+  // Eye motion: velocity limit IS MAX_DELTA_PER_UPDATE, expressed per second
+  // (in output counts, see ChannelTable.h)
+  MotionProfile eyeProfile = motionProfile(MotionSettings::EYE_RESPONSE_MS, EYE_MAX_VELOCITY,
+                                           EYE_MAX_ACCEL);
+  
+  // Every rig starts centered and plays the startup animation (clip 0);
+  // its first pose is queued right behind the init
+  currentState = STATE_STARTUP;
+  for (uint8_t r = 0; r < RIG_COUNT; r++) {
+    rigs[r].setPowerBudget(&powerBudget);
+    rigs[r].begin(rigChannels(r), &servoBus, eyeProfile);
+    rigs[r].playClip(&ANIMATION_CLIPS[0], halMillis());
+  }
+  lastMotionTime = halMillis();
+  runStartupAnimation();
+  composeRigs();
+  powerBudget.apply(0);
+  servoBus.flush();
+  bootProfile.mark(F("startup pose queued"));
+  
+  // Nunchuck is found (and re-found after a replug) in the background;
+  // until then the joystick reads as centered
+  nunchuckLink.begin(halMillis());
+  bootProfile.mark(F("nunchuck detect started"));
+  
+  // The UART drains the banner by interrupt while the bus works
   Serial.println(F("\n\n========================================"));
   Serial.println(F("Animatronic Eyes - Enhanced System"));
   Serial.println(F("With Startup & Idle Animations"));
@@ -121,64 +279,79 @@ void setup() {
   
   // Display configuration loaded
   Serial.println(F("Configuration loaded from EyeConfig.h"));
-  Serial.print(F("Servo shield address: 0x"));
-  Serial.println(SERVO_SHIELD_ADDRESS, HEX);
+  calibrationConsole.printSource();
+  Serial.print(F("Eye rigs: "));
+  Serial.print(RIG_COUNT);
+  Serial.print(F(" on "));
+  Serial.print(SERVO_BOARD_COUNT);
+  Serial.println(F(" servo board(s)"));
+  Serial.print(F("Output: "));
+  Serial.print(OutputSettings::OSCILLATOR_HZ / (PCA9685_COUNTS * (OUTPUT_PRESCALE + 1UL)));
+  Serial.print(F(" Hz PWM, "));
+  Serial.print(1000 / SchedulerSettings::MOTION_PERIOD_MS);
+  Serial.print(F(" Hz control, "));
+  Serial.print(ServoBusSettings::I2C_CLOCK_HZ / 1000);
+  Serial.println(F(" kHz I2C"));
+  Serial.print(F("Servo budget: "));
+  Serial.print(PowerSettings::BUDGET_MA);
+  Serial.println(F(" mA"));
   Serial.print(F("Idle timeout: "));
   Serial.print(IdleSettings::IDLE_TIMEOUT_MS / 1000);
   Serial.println(F(" seconds"));
+  Serial.println(F("Nunchuck: detecting in background"));
+  Serial.println(tiltMode ? F("Gaze input: tilt") : F("Gaze input: joystick"));
   Serial.println();
-  
-  // Initialize servo shield
-  Serial.print(F("Initializing servo shield... "));
-  pwm.begin();
-  pwm.setPWMFreq(60);
-  delay(10);
-  
-  Wire.beginTransmission(SERVO_SHIELD_ADDRESS);
-  if (Wire.endTransmission() != 0) {
-    Serial.println(F("FAILED!"));
-    Serial.println(F("Check servo shield connections and address"));
-    while(1);
-  }
-  Serial.println(F("OK"));
-  
-  // Initialize nunchuck
-  Serial.print(F("Initializing nunchuck... "));
-  nunchuck.begin();
-  int timeout = 0;
-  while (nunchuck.type != NUNCHUCK && timeout < 50) {
-    nunchuck.readData();
-    delay(100);
-    timeout++;
-  }
-  
-  if (timeout >= 50) {
-    Serial.println(F("FAILED!"));
-    Serial.println(F("⚠️  Nunchuck not found - idle mode only"));
-  } else {
+  bootProfile.mark(F("banner"));
+  
+  // By now the init has normally finished on its own; a board that
+  // NACKed it is missing
+  halI2CFlush();
+  for (uint8_t b = 0; b < SERVO_BOARD_COUNT; b++) {
+    Serial.print(F("Servo shield 0x"));
+    Serial.print(servoBoardAddress(b), HEX);
+    Serial.print(F("... "));
+    if (servoBus.board(b).initStatus() != I2C_DONE) {
+      Serial.println(F("FAILED!"));
+      Serial.println(F("Check servo shield connections and address"));
+      halHalt();
+    }
     Serial.println(F("OK"));
   }
-  
-  // SAFETY CHECK: Verify limits are sane
-  if (HorizontalLimits::MIN >= HorizontalLimits::MAX ||
-      VerticalLimits::MIN >= VerticalLimits::MAX) {
-    Serial.println(F("\n⚠️  ERROR: Invalid servo limits in EyeConfig.h!"));
-    Serial.println(F("MIN must be less than MAX"));
-    Serial.println(F("Check your configuration file!"));
-    while(1);
-  }
-  
+  bootProfile.mark(F("servo boards ready"));
+  
+  // Servo limits are checked at compile time (see ChannelTable.h), saved
+  // ones when loaded; typed "cal" commands arrive between gaze frames
+  gazeLink.setTextHandler(consoleByte);
+  calibrationConsole.setCommandHandler(performanceCommand);
+  calibrationConsole.setChangeHandler(calibrationChanged);
+  
+  // Rate groups - same-deadline groups run in this order every tick.
+  // Input runs one nunchuck read ahead of motion, so the read finishes in
+  // the background just before the motion tick needs it.
+  unsigned long inputLeadUs = nunchuckPollUs(ServoBusSettings::I2C_CLOCK_HZ) +
+                              SchedulerSettings::INPUT_LEAD_MARGIN_US;
+  scheduler.add(F("input"), taskInput, SchedulerSettings::INPUT_PERIOD_MS,
+                SchedulerSettings::INPUT_PERIOD_MS * 1000UL - inputLeadUs);
+  motionGroup = scheduler.add(F("motion"), taskMotion, SchedulerSettings::MOTION_PERIOD_MS);
+  scheduler.add(F("output"), taskOutput, SchedulerSettings::OUTPUT_PERIOD_MS);
+  scheduler.add(F("telemetry"), taskTelemetry, SchedulerSettings::TELEMETRY_PERIOD_MS,
+                SchedulerSettings::TELEMETRY_OFFSET_MS * 1000UL);
+  bootProfile.mark(F("control loop"));
+  
+  bootProfile.print();
   Serial.println(F("\n========================================"));
-  Serial.println(F("Starting Startup Animation..."));
+  Serial.println(F("Controls:"));
+  Serial.println(F("  Joystick → Move eyes"));
+  Serial.println(F("  Z Button → Blink"));
+  Serial.println(F("  C Button → Return to center"));
+  Serial.println(F("  C + Z held → Joystick / tilt gaze"));
+  Serial.print(F("  Idle "));
+  Serial.print(IdleSettings::IDLE_TIMEOUT_MS / 1000);
+  Serial.println(F(" sec → Auto animation"));
+  Serial.println(F("========================================"));
+  Serial.println(F("Startup Animation running..."));
   Serial.println(F("========================================\n"));
-  
-  // Initialize startup animation
-  currentState = STATE_STARTUP;
-  startupPhase = STARTUP_CLOSE_EYES;
-  startupPhaseStartTime = millis();
-  
-  // Seed random number generator
-  randomSeed(analogRead(A0));
+  scheduler.start();
 }
 
 // ============================================================================
@@ -186,15 +359,78 @@ void setup() {
 // ============================================================================
 
 void loop() {
-  // Update nunchuck
-  nunchuck.readData();
+  // Runs whichever rate groups are due, then idles to the next deadline
+  scheduler.run();
+}
+
+// ============================================================================
+// RATE GROUP TASKS
+// ============================================================================
+
+/**
+ * Input group: collect the last nunchuck poll and queue the next
+ * Activity is checked here, BEFORE the motion group acts on the state
+ */
+void taskInput() {
+  gazeLink.service(halMillis());
+  nunchuckLink.service(halMillis());
+  NunchuckSample live;
+  nunchuckLink.read(live);
+  
+  static bool lastConnected = false;
+  if (live.connected != lastConnected) {
+    Serial.println(live.connected ? F("Nunchuck connected")
+                                  : F("Nunchuck disconnected - joystick released"));
+  }
+  lastConnected = live.connected;
+  
+  // A replay stands in for the nunchuck until a hand takes the stick
+  if (performance.replaying() && nunchuckActive(live)) {
+    performance.stop();
+    Serial.println(F("rec: replay stopped (nunchuck moved)"));
+  }
+  if (!performance.replaying()) nunchuckInput = live;
   
-  // ALWAYS check for activity first (before state processing)
   if (currentState == STATE_ACTIVE || currentState == STATE_IDLE) {
     checkForActivity();
   }
+}
+
+/**
+ * Motion group: state machine, runs at a constant period
+ */
+void taskMotion() {
+  // Real elapsed time, so motion stays correct across overruns
+  unsigned long now = halMillis();
+  motionDtMs = min(now - lastMotionTime, (unsigned long)MotionSettings::MAX_MOTION_DT_MS);
+  lastMotionTime = now;
+  
+  // The poll the input group queued just before this tick (or the
+  // recorded one, with the tick length it had); filtered in every state,
+  // so it is settled on the stick when control returns
+  bool replaying = performance.replaying();
+  if (!performance.next(nunchuckInput, motionDtMs)) {
+    if (replaying) Serial.println(F("rec: replay done"));
+    nunchuckLink.read(nunchuckInput);
+    if (performance.recording()) {
+      performance.add(nunchuckInput, motionDtMs);
+      if (!performance.recording()) {
+        Serial.println(performance.lastEnd() == PERFORMANCE_END_FULL
+                       ? F("rec: EEPROM full, recording stopped")
+                       : F("rec: output fell behind, recording stopped"));
+      }
+    }
+  }
+  joystickFilter.update(nunchuckInput.joyX, nunchuckInput.joyY, motionDtMs);
+  if (tiltMode) {
+    tiltGaze.update(nunchuckInput, joystickFilter.deflectionX(), joystickFilter.deflectionY(),
+                    motionDtMs);
+  }
+  
+  // Host commands due this tick (taken in every state so none go stale)
+  GazeCommand hostCommand;
+  bool hostCommandDue = gazeLink.next(now, hostCommand);
   
-  // State machine
   switch (currentState) {
     case STATE_STARTUP:
       runStartupAnimation();
@@ -202,248 +438,167 @@ void loop() {
       
     case STATE_ACTIVE:
       {
-        // Get joystick values
-        int joyX_raw = nunchuck.getJoyX();
-        int joyY_raw = nunchuck.getJoyY();
+        // Shared gaze as a normalized position; each rig maps it through
+        // its own channel table (inversion baked in)
+        uint16_t gazeH;
+        uint16_t gazeV;
+        if (gazeLink.active(now)) {
+          // Host tracker has control
+          if (hostCommandDue) applyGazeCommand(hostCommand);
+          gazeH = hostGazeH;
+          gazeV = hostGazeV;
+        } else {
+          for (uint8_t r = 0; r < RIG_COUNT; r++) {
+            rigs[r].releaseLids();
+          }
+          
+          int16_t deflectionX = tiltMode ? tiltGaze.deflectionX() : joystickFilter.deflectionX();
+          int16_t deflectionY = tiltMode ? tiltGaze.deflectionY() : joystickFilter.deflectionY();
+          gazeH = joystickPosition(deflectionX, gazeCenterH);
+          gazeV = joystickPosition(deflectionY, gazeCenterV);
+        }
         
-        // Map to servo positions using config values WITH inversion support
-        int targetH = mapJoystick(joyX_raw, 
-                                  NunchuckCalibration::JOY_X_MIN, 
-                                  NunchuckCalibration::JOY_X_MAX, 
-                                  HorizontalLimits::MIN, 
-                                  HorizontalLimits::MAX,
-                                  HorizontalLimits::INVERTED);
-        int targetV = mapJoystick(joyY_raw, 
-                                  NunchuckCalibration::JOY_Y_MIN, 
-                                  NunchuckCalibration::JOY_Y_MAX, 
-                                  VerticalLimits::MIN, 
-                                  VerticalLimits::MAX,
-                                  VerticalLimits::INVERTED);
+        // Handle C + Z held together - switch joystick / tilt gaze
+        static unsigned long chordStart = 0;
+        static bool chordHeld = false;
+        static bool chordDone = false;
+        if (nunchuckInput.buttonC && nunchuckInput.buttonZ) {
+          if (!chordHeld) {
+            chordHeld = true;
+            chordDone = false;
+            chordStart = now;
+          } else if (!chordDone && now - chordStart >= TiltSettings::CHORD_MS) {
+            setTiltMode(!tiltMode);
+            chordDone = true;
+          }
+        } else {
+          chordHeld = false;
+        }
         
-        // Smooth movement using config smoothing value
-        currentH = smooth(currentH, targetH, MotionSettings::EYE_SMOOTHING);
-        currentV = smooth(currentV, targetV, MotionSettings::EYE_SMOOTHING);
+        // Handle C button - Hold to return to center
+        static bool lastC = false;
+        if (nunchuckInput.buttonC && !lastC) {
+          Serial.println(F("Returning to center..."));
+        }
+        lastC = nunchuckInput.buttonC;
         
-        // Update eye position
-        moveEyes(currentH, currentV);
+        // Gaze layer target (motion toward it happens in composeRigs)
+        for (uint8_t r = 0; r < RIG_COUNT; r++) {
+          if (nunchuckInput.buttonC) {
+            rigs[r].centerGaze();
+          } else {
+            rigs[r].setGaze(gazeH, gazeV);
+          }
+        }
         
         // Handle Z button - Blink
         static bool lastZ = false;
-        if (nunchuck.getButtonZ() && !lastZ && !isBlinking) {
+        if (nunchuckInput.buttonZ && !lastZ) {
           startBlink();
         }
-        lastZ = nunchuck.getButtonZ();
-        
-        // Handle C button - Return to center
-        static bool lastC = false;
-        if (nunchuck.getButtonC() && !lastC) {
-          Serial.println(F("Returning to center..."));
-          currentH = HorizontalLimits::CENTER;
-          currentV = VerticalLimits::CENTER;
-        }
-        lastC = nunchuck.getButtonC();
-        
-        // Update blink animation
-        updateBlink();
+        lastZ = nunchuckInput.buttonZ;
         
         // Check if should enter idle mode
-        if (millis() - lastActivityTime > IdleSettings::IDLE_TIMEOUT_MS) {
+        if (halMillis() - lastActivityTime > IdleSettings::IDLE_TIMEOUT_MS) {
           enterIdleMode();
         }
-        
-        // Debug output
-        static unsigned long lastPrint = 0;
-        if (millis() - lastPrint > 500) {
-          lastPrint = millis();
-          printDebug(joyX_raw, joyY_raw, targetH, targetV);
-        }
       }
       break;
       
     case STATE_IDLE:
-      // Run idle animation
-      runIdleAnimation();
-      
-      // Update blink animation
-      updateBlink();
-      
-      // Debug output
-      static unsigned long lastIdlePrint = 0;
-      if (millis() - lastIdlePrint > 1000) {
-        lastIdlePrint = millis();
-        Serial.print(F("IDLE | Sequence: "));
-        Serial.print(currentIdleSequence);
-        Serial.print(F(" | Target H:"));
-        Serial.print(idleTargetH);
-        Serial.print(F(" V:"));
-        Serial.print(idleTargetV);
-        Serial.print(F(" | Current H:"));
-        Serial.print(currentH);
-        Serial.print(F(" V:"));
-        Serial.println(currentV);
+      // Each rig runs its own idle behavior and blinks
+      for (uint8_t r = 0; r < RIG_COUNT; r++) {
+        rigs[r].runIdle(halMillis(), motionDtMs);
       }
       break;
   }
   
-  delay(SafetyLimits::MIN_UPDATE_INTERVAL_MS);
+  // Every state ends in one composed pose per rig
+  composeRigs();
 }
 
-// ============================================================================
-// STARTUP ANIMATION
-// ============================================================================
-
-void runStartupAnimation() {
-  unsigned long elapsed = millis() - startupPhaseStartTime;
-  
-  switch (startupPhase) {
-    case STARTUP_CLOSE_EYES:
-      // Smoothly close eyes
-      eyelidAnimationProgress += 0.05;
-      if (eyelidAnimationProgress >= 1.0) {
-        eyelidAnimationProgress = 1.0;
-        startupPhase = STARTUP_HOLD_CLOSED;
-        startupPhaseStartTime = millis();
-        Serial.println(F("Eyes closed..."));
-      }
-      setEyelidPosition(eyelidAnimationProgress);  // 1.0 = closed
-      break;
-      
-    case STARTUP_HOLD_CLOSED:
-      // Hold eyes closed
-      if (elapsed >= StartupSettings::EYES_CLOSED_HOLD) {
-        startupPhase = STARTUP_OPEN_EYES;
-        startupPhaseStartTime = millis();
-        eyelidAnimationProgress = 1.0;
-        Serial.println(F("Opening eyes..."));
-      }
-      break;
-      
-    case STARTUP_OPEN_EYES:
-      // Slowly open eyes
-      eyelidAnimationProgress -= 0.02;
-      if (eyelidAnimationProgress <= 0.0) {
-        eyelidAnimationProgress = 0.0;
-        startupPhase = STARTUP_LOOK_AROUND;
-        startupPhaseStartTime = millis();
-        Serial.println(F("Looking around..."));
-      }
-      setEyelidPosition(eyelidAnimationProgress);  // 0.0 = open
-      break;
-      
-    case STARTUP_LOOK_AROUND:
-      // Look left, then right, then up, then down
-      if (elapsed < 500) {
-        // Look left
-        currentH = smooth(currentH, HorizontalLimits::MIN, 5);
-      } else if (elapsed < 1000) {
-        // Look right
-        currentH = smooth(currentH, HorizontalLimits::MAX, 5);
-      } else if (elapsed < 1500) {
-        // Look up
-        currentV = smooth(currentV, VerticalLimits::MAX, 5);
-      } else if (elapsed < 2000) {
-        // Look down
-        currentV = smooth(currentV, VerticalLimits::MIN, 5);
-      } else {
-        startupPhase = STARTUP_CENTER;
-        startupPhaseStartTime = millis();
-        Serial.println(F("Centering..."));
-      }
-      moveEyes(currentH, currentV);
-      break;
-      
-    case STARTUP_CENTER:
-      // Return to center
-      currentH = smooth(currentH, HorizontalLimits::CENTER, 8);
-      currentV = smooth(currentV, VerticalLimits::CENTER, 8);
-      moveEyes(currentH, currentV);
-      
-      if (elapsed >= StartupSettings::RETURN_TO_CENTER) {
-        startupPhase = STARTUP_COMPLETE;
-        Serial.println(F("\n========================================"));
-        Serial.println(F("Startup Complete!"));
-        Serial.println(F("========================================"));
-        Serial.println(F("Controls:"));
-        Serial.println(F("  Joystick → Move eyes"));
-        Serial.println(F("  Z Button → Blink"));
-        Serial.println(F("  C Button → Return to center"));
-        Serial.print(F("  Idle "));
-        Serial.print(IdleSettings::IDLE_TIMEOUT_MS / 1000);
-        Serial.println(F(" sec → Auto animation"));
-        Serial.println(F("========================================\n"));
-        
-        // Transition to active state
-        currentState = STATE_ACTIVE;
-        lastActivityTime = millis();
-      }
-      break;
-      
-    case STARTUP_COMPLETE:
-      // Should never reach here
-      break;
-  }
+/**
+ * Output group: pass the rigs' moves on within the servo current budget,
+ * then queue this tick's changed channels, across all boards, in as few
+ * I2C bursts as possible (they go out while the loop moves on)
+ */
+void taskOutput() {
+  powerBudget.apply(SchedulerSettings::OUTPUT_PERIOD_MS);
+  servoBus.flush();
 }
 
-// ============================================================================
-// IDLE ANIMATION
-// ============================================================================
-
-void runIdleAnimation() {
-  unsigned long currentTime = millis();
-  
-  // Auto-blink
-  if (currentTime >= nextIdleBlinkTime && !isBlinking) {
-    startBlink();
-    nextIdleBlinkTime = currentTime + random(IdleSettings::IDLE_BLINK_MIN, 
-                                              IdleSettings::IDLE_BLINK_MAX);
+/**
+ * Telemetry group: status line, plus scheduler timing every few seconds
+ */
+void taskTelemetry() {
+  static unsigned long lastTimingReport = 0;
+  static uint8_t timingGroup = SCHEDULER_MAX_GROUPS;   // Next timing record to send
+  bool timingDue = halMillis() - lastTimingReport >= SchedulerSettings::TIMING_REPORT_MS;
+  if (timingDue) lastTimingReport = halMillis();
+  
+  // Recording bytes first: a full ring drops a tick record, not them
+  performance.service();
+  
+  if (TelemetrySettings::BINARY) {
+    sendTelemetryTick();
+    // One group per tick: the whole table at once would need twice the ring
+    if (timingDue) timingGroup = 0;
+    if (timingGroup < scheduler.groupCount()) sendTelemetryTiming(timingGroup++);
+    telemetry.drain();
+    return;
   }
+  telemetry.drain();
   
-  // Movement sequences
-  if (currentTime >= nextIdleSequenceTime) {
-    // Pick a new random sequence
-    currentIdleSequence = random(0, 5);
+  static unsigned long lastTextReport = 0;
+  if (halMillis() - lastTextReport >= TelemetrySettings::TEXT_PERIOD_MS) {
+    lastTextReport = halMillis();
     
-    // Generate new target positions based on sequence
-    switch (currentIdleSequence) {
-      case 0:  // Look left
-        idleTargetH = getIdleTarget(HorizontalLimits::MIN, HorizontalLimits::CENTER, HorizontalLimits::CENTER);
-        idleTargetV = VerticalLimits::CENTER;  // FIXED: was HorizontalLimits::CENTER
-        break;
-        
-      case 1:  // Look right
-        idleTargetH = getIdleTarget(HorizontalLimits::CENTER, HorizontalLimits::MAX, HorizontalLimits::CENTER);
-        idleTargetV = VerticalLimits::CENTER;
+    switch (currentState) {
+      case STATE_STARTUP:
         break;
         
-      case 2:  // Look up
-        idleTargetH = HorizontalLimits::CENTER;
-        idleTargetV = getIdleTarget(VerticalLimits::CENTER, VerticalLimits::MAX, VerticalLimits::CENTER);
+      case STATE_ACTIVE:
+        printDebug(nunchuckInput.joyX, nunchuckInput.joyY);
         break;
         
-      case 3:  // Look down
-        idleTargetH = HorizontalLimits::CENTER;
-        idleTargetV = getIdleTarget(VerticalLimits::MIN, VerticalLimits::CENTER, VerticalLimits::CENTER);
-        break;
-        
-      case 4:  // Look diagonal (random corner)
-        idleTargetH = random(0, 2) ? 
-          getIdleTarget(HorizontalLimits::MIN, HorizontalLimits::CENTER, HorizontalLimits::CENTER) :
-          getIdleTarget(HorizontalLimits::CENTER, HorizontalLimits::MAX, HorizontalLimits::CENTER);
-        idleTargetV = random(0, 2) ?
-          getIdleTarget(VerticalLimits::MIN, VerticalLimits::CENTER, VerticalLimits::CENTER) :
-          getIdleTarget(VerticalLimits::CENTER, VerticalLimits::MAX, VerticalLimits::CENTER);
+      case STATE_IDLE:
+        Serial.print(F("IDLE | Saccades: "));
+        Serial.print(rigs[0].idleGaze().count());
+        Serial.print(F(" (last "));
+        Serial.print(rigs[0].idleGaze().amplitudeDeg());
+        Serial.print(F(" deg) | Target H:"));
+        Serial.print(rigs[0].idleTargetH());
+        Serial.print(F(" V:"));
+        Serial.print(rigs[0].idleTargetV());
+        Serial.print(F(" | Current H:"));
+        Serial.print(rigs[0].eyeH());
+        Serial.print(F(" V:"));
+        Serial.println(rigs[0].eyeV());
         break;
     }
-    
-    // Schedule next sequence
-    nextIdleSequenceTime = currentTime + random(IdleSettings::IDLE_SEQUENCE_MIN, 
-                                                 IdleSettings::IDLE_SEQUENCE_MAX);
   }
   
-  // Smoothly move toward idle target
-  currentH = smooth(currentH, idleTargetH, MotionSettings::EYE_SMOOTHING);
-  currentV = smooth(currentV, idleTargetV, MotionSettings::EYE_SMOOTHING);
-  moveEyes(currentH, currentV);
+  if (timingDue) printTiming();
+}
+
+// ============================================================================
+// STARTUP ANIMATION
+// ============================================================================
+
+void runStartupAnimation() {
+  // Choreography lives in the startup clip; timing follows StartupSettings
+  // (the clip layer plays in composeRigs, over centered eyes)
+  for (uint8_t r = 0; r < RIG_COUNT; r++) {
+    if (rigs[r].clipPlaying()) return;
+  }
+  
+  // One line: this runs in the motion group, and a longer one would block
+  // it on the UART past its period (the controls went out with the banner)
+  Serial.println(F("Startup complete"));
+  
+  // Transition to active state
+  currentState = STATE_ACTIVE;
+  lastActivityTime = halMillis();
 }
 
 // ============================================================================
@@ -451,57 +606,63 @@ void runIdleAnimation() {
 // ============================================================================
 
 void enterIdleMode() {
-  Serial.println(F("\n>>> ENTERING IDLE MODE <<<"));
-  Serial.println(F("Eyes will look around automatically"));
-  Serial.println(F("Move joystick or press button to exit\n"));
-  
   currentState = STATE_IDLE;
   
-  // Initialize idle timers
-  unsigned long currentTime = millis();
-  nextIdleBlinkTime = currentTime + random(IdleSettings::IDLE_BLINK_MIN, 
-                                            IdleSettings::IDLE_BLINK_MAX);
-  nextIdleSequenceTime = currentTime + 500;  // Start first sequence after 500ms
-  currentIdleSequence = 0;
-  
-  // Set initial idle targets
-  idleTargetH = HorizontalLimits::CENTER;
-  idleTargetV = VerticalLimits::CENTER;
+  // Initialize idle timers (each rig draws its own)
+  unsigned long currentTime = halMillis();
+  for (uint8_t r = 0; r < RIG_COUNT; r++) {
+    rigs[r].enterIdle(currentTime);
+  }
   
-  Serial.print(F("Next blink in: "));
-  Serial.print((nextIdleBlinkTime - currentTime) / 1000);
-  Serial.println(F(" seconds"));
-  Serial.println(F("Starting idle sequences...\n"));
+  // Short: called from a rate group (see runStartupAnimation)
+  Serial.print(F(">>> IDLE MODE, next blink in "));
+  Serial.print((rigs[0].nextBlinkMs() - currentTime) / 1000);
+  Serial.println(F(" s"));
 }
 
 void exitIdleMode() {
   if (currentState == STATE_IDLE) {
-    Serial.println(F("\n>>> EXITING IDLE MODE <<<\n"));
+    Serial.println(F(">>> IDLE MODE exited"));
+    for (uint8_t r = 0; r < RIG_COUNT; r++) {
+      rigs[r].leaveIdle(halMillis());
+    }
     currentState = STATE_ACTIVE;
-    lastActivityTime = millis();
+    lastActivityTime = halMillis();
   }
 }
 
-void checkForActivity() {
-  // Read nunchuck
-  int joyX = nunchuck.getJoyX();
-  int joyY = nunchuck.getJoyY();
+/**
+ * Joystick out of the deadzone, or a button down
+ */
+bool nunchuckActive(const NunchuckSample &sample) {
   int joyCenter = NunchuckCalibration::CENTER;
+  return abs(sample.joyX - joyCenter) > DEADZONE || abs(sample.joyY - joyCenter) > DEADZONE ||
+         sample.buttonZ || sample.buttonC;
+}
+
+void checkForActivity() {
+  // Joystick moved or a button pressed (live, or replayed)
+  if (nunchuckActive(nunchuckInput)) {
+    if (currentState == STATE_IDLE) {
+      exitIdleMode();
+    }
+    lastActivityTime = halMillis();
+  }
   
-  // Check if joystick moved
-  if (abs(joyX - joyCenter) > DEADZONE || abs(joyY - joyCenter) > DEADZONE) {
+  // So does handling the nunchuck, in tilt mode
+  if (tiltMode && tiltGaze.moved()) {
     if (currentState == STATE_IDLE) {
       exitIdleMode();
     }
-    lastActivityTime = millis();
+    lastActivityTime = halMillis();
   }
   
-  // Check if any button pressed
-  if (nunchuck.getButtonZ() || nunchuck.getButtonC()) {
+  // A live host gaze stream counts as activity too
+  if (gazeLink.active(halMillis())) {
     if (currentState == STATE_IDLE) {
       exitIdleMode();
     }
-    lastActivityTime = millis();
+    lastActivityTime = halMillis();
   }
 }
 
@@ -510,155 +671,190 @@ void checkForActivity() {
 // ============================================================================
 
 /**
- * Get idle target position within a range
- * Uses IDLE_MOVEMENT_RANGE to limit how far eyes wander
- */
-int getIdleTarget(int min, int max, int center) {
-  int range = max - min;
-  int limitedRange = range * IdleSettings::IDLE_MOVEMENT_RANGE;
-  int limitedMin = center - (limitedRange / 2);
-  int limitedMax = center + (limitedRange / 2);
-  return random(limitedMin, limitedMax);
-}
-
-/**
- * Set eyelid position (0.0 = open, 1.0 = closed)
- * Used for smooth animations
+ * Serial text between gaze frames → calibration commands
  */
-void setEyelidPosition(float position) {
-  // Clamp position
-  position = constrain(position, 0.0, 1.0);
-  
-  // Calculate pulse values for each eyelid
-  int luPos = LeftUpperLid::OPEN + (LeftUpperLid::CLOSED - LeftUpperLid::OPEN) * position;
-  int llPos = LeftLowerLid::OPEN + (LeftLowerLid::CLOSED - LeftLowerLid::OPEN) * position;
-  int ruPos = RightUpperLid::OPEN + (RightUpperLid::CLOSED - RightUpperLid::OPEN) * position;
-  int rlPos = RightLowerLid::OPEN + (RightLowerLid::CLOSED - RightLowerLid::OPEN) * position;
-  
-  // Apply inversion
-  if (LeftUpperLid::INVERTED) luPos = LeftUpperLid::CLOSED - (luPos - LeftUpperLid::OPEN);
-  if (LeftLowerLid::INVERTED) llPos = LeftLowerLid::CLOSED - (llPos - LeftLowerLid::OPEN);
-  if (RightUpperLid::INVERTED) ruPos = RightUpperLid::CLOSED - (ruPos - RightUpperLid::OPEN);
-  if (RightLowerLid::INVERTED) rlPos = RightLowerLid::CLOSED - (rlPos - RightLowerLid::OPEN);
-  
-  // Set servos
-  pwm.setPWM(SERVO_L_UPPER, 0, luPos);
-  pwm.setPWM(SERVO_L_LOWER, 0, llPos);
-  pwm.setPWM(SERVO_R_UPPER, 0, ruPos);
-  pwm.setPWM(SERVO_R_LOWER, 0, rlPos);
+void consoleByte(uint8_t b) {
+  calibrationConsole.feed(b);
 }
 
 /**
- * Map joystick value to servo position with deadzone and inversion support
+ * Live calibration changed (cal set / load / reset): the centers derived
+ * from it at boot follow - rest gaze, C-button center, a host gaze still on
+ * the old center
  */
-int mapJoystick(int joyValue, int joyMin, int joyMax, int servoMin, int servoMax, bool inverted) {
-  // Apply deadzone around center
-  int joyCenter = (joyMin + joyMax) / 2;
-  if (abs(joyValue - joyCenter) < DEADZONE) {
-    // In deadzone - return servo center
-    return (servoMin + servoMax) / 2;
+void calibrationChanged() {
+  bool hostCentered = hostGazeH == gazeCenterH && hostGazeV == gazeCenterV;
+  gazeCenterH = descriptorCenterPosition(&rigChannels(0)[CH_HORIZONTAL]);
+  gazeCenterV = descriptorCenterPosition(&rigChannels(0)[CH_VERTICAL]);
+  if (hostCentered) {
+    hostGazeH = gazeCenterH;
+    hostGazeV = gazeCenterV;
   }
-  
-  // Map joystick range to servo range
-  int servoPos;
-  if (inverted) {
-    // Inverted: reverse the mapping
-    servoPos = map(joyValue, joyMin, joyMax, servoMax, servoMin);
-  } else {
-    // Normal: standard mapping
-    servoPos = map(joyValue, joyMin, joyMax, servoMin, servoMax);
+  for (uint8_t r = 0; r < RIG_COUNT; r++) {
+    rigs[r].recenter();
   }
-  
-  return constrain(servoPos, min(servoMin, servoMax), max(servoMin, servoMax));
 }
 
 /**
- * Simple smoothing function
+ * "rec" console commands (PerformanceLog.h):
+ *   rec                 status, and what EEPROM holds
+ *   rec start [serial]  record the nunchuck to EEPROM, or stream it out
+ *                       (HostSim teledecode --performance saves it)
+ *   rec stop            end the recording or replay
+ *   rec play [loop]     replay the EEPROM recording in place of the
+ *                       nunchuck; touching the stick ends it
  */
-int smooth(int current, int target, int smoothing) {
-  int delta = target - current;
-  return current + (delta / smoothing);
+void performanceCommand(const char *command, char *args) {
+  if (strcmp_P(command, PSTR("rec")) != 0) return;
+  
+  char *action = args ? strtok(args, " ") : NULL;
+  char *option = action ? strtok(NULL, " ") : NULL;
+  PerformanceHeader saved;
+  if (action == NULL) {
+    Serial.print(F("rec: "));
+    switch (performance.mode()) {
+      case PERFORMANCE_RECORDING: Serial.print(F("recording to EEPROM")); break;
+      case PERFORMANCE_STREAMING: Serial.print(F("streaming")); break;
+      case PERFORMANCE_FINISHING: Serial.print(F("finishing")); break;
+      case PERFORMANCE_REPLAYING: Serial.print(F("replaying")); break;
+      default: Serial.print(F("idle")); break;
+    }
+    if (performance.recording()) {
+      Serial.print(F(", "));
+      Serial.print(performance.ticks());
+      Serial.print(F(" ticks in "));
+      Serial.print(performance.bytes());
+      Serial.print(F(" bytes"));
+    }
+    Serial.print(F(" | EEPROM: "));
+    if (performance.saved(saved)) {
+      Serial.print(saved.ticks * saved.tickMs / 1000);
+      Serial.print(F(" s, "));
+      Serial.print(saved.length);
+      Serial.print('/');
+      Serial.print(performance.capacity());
+      Serial.println(F(" bytes"));
+    } else {
+      Serial.println(F("empty"));
+    }
+  } else if (!strcmp_P(action, PSTR("start"))) {
+    bool toSerial = option != NULL && !strcmp_P(option, PSTR("serial"));
+    if (performance.record(toSerial, SchedulerSettings::MOTION_PERIOD_MS)) {
+      Serial.println(toSerial ? F("rec: streaming") : F("rec: recording to EEPROM"));
+    } else {
+      Serial.println(F("rec: busy"));
+    }
+  } else if (!strcmp_P(action, PSTR("stop"))) {
+    bool wasRecording = performance.recording();
+    performance.stop();
+    if (wasRecording) {
+      Serial.print(F("rec: stopped, "));
+      Serial.print(performance.ticks());
+      Serial.print(F(" ticks in "));
+      Serial.print(performance.bytes());
+      Serial.println(F(" bytes"));
+    }
+  } else if (!strcmp_P(action, PSTR("play"))) {
+    // One sample per tick: a recording made at another control rate would
+    // replay faster or slower than it was played
+    if (performance.saved(saved) && saved.tickMs != SchedulerSettings::MOTION_PERIOD_MS) {
+      Serial.print(F("rec: recorded at "));
+      Serial.print(saved.tickMs);
+      Serial.println(F(" ms ticks, not this control rate"));
+    } else if (performance.play(option != NULL && !strcmp_P(option, PSTR("loop")))) {
+      Serial.println(F("rec: replaying"));
+      exitIdleMode();
+      lastActivityTime = halMillis();
+    } else {
+      Serial.println(F("rec: nothing to play (or busy)"));
+    }
+  } else {
+    Serial.println(F("rec: unknown command (rec, rec start [serial], rec stop, rec play [loop])"));
+  }
 }
 
 /**
- * Get eyelid position with inversion support
+ * Joystick pipeline from NunchuckCalibration / JoystickSettings
  */
-int getEyelidPosition(int openValue, int closedValue, bool inverted, bool shouldClose) {
-  if (inverted) {
-    // Inverted: swap open and closed
-    return shouldClose ? openValue : closedValue;
-  } else {
-    // Normal orientation
-    return shouldClose ? closedValue : openValue;
-  }
+void configureJoystick() {
+  JoystickAxisRange x = {NunchuckCalibration::JOY_X_MIN, NunchuckCalibration::CENTER,
+                         NunchuckCalibration::JOY_X_MAX};
+  JoystickAxisRange y = {NunchuckCalibration::JOY_Y_MIN, NunchuckCalibration::CENTER,
+                         NunchuckCalibration::JOY_Y_MAX};
+  JoystickFilterSettings settings = {
+    JOY_DEADZONE, JoystickSettings::ASYMMETRIC_RANGE, JoystickSettings::FILTER,
+    JoystickSettings::MIN_CUTOFF_MILLIHZ, JoystickSettings::BETA_MILLIHZ,
+    JoystickSettings::SPEED_CUTOFF_MILLIHZ
+  };
+  joystickFilter.configure(x, y, settings);
 }
 
 /**
- * Move eyes to position
+ * Tilt pipeline from TiltSettings
  */
-void moveEyes(int horizontal, int vertical) {
-  // Safety: constrain to configured limits
-  horizontal = constrain(horizontal, HorizontalLimits::MIN, HorizontalLimits::MAX);
-  vertical = constrain(vertical, VerticalLimits::MIN, VerticalLimits::MAX);
-  
-  pwm.setPWM(SERVO_HORIZONTAL, 0, horizontal);
-  pwm.setPWM(SERVO_VERTICAL, 0, vertical);
+void configureTilt() {
+  TiltGazeSettings settings = {
+    {TiltSettings::ACCEL_ZERO_X, TiltSettings::ACCEL_ZERO_Y, TiltSettings::ACCEL_ZERO_Z},
+    TiltSettings::ACCEL_ONE_G, TiltSettings::RANGE_DECIDEG, TiltSettings::DEADZONE_DECIDEG,
+    TiltSettings::TAU_MS, TiltSettings::ACTIVITY_DECIDEG,
+    TiltSettings::INVERT_X, TiltSettings::INVERT_Y
+  };
+  tiltGaze.configure(settings);
 }
 
 /**
- * Open eyes (with inversion support)
+ * Joystick or tilt gaze (the tilt filter restarts on the next sample)
  */
-void openEyes() {
-  pwm.setPWM(SERVO_L_UPPER, 0, 
-    getEyelidPosition(LeftUpperLid::OPEN, LeftUpperLid::CLOSED, LeftUpperLid::INVERTED, false));
-  pwm.setPWM(SERVO_L_LOWER, 0, 
-    getEyelidPosition(LeftLowerLid::OPEN, LeftLowerLid::CLOSED, LeftLowerLid::INVERTED, false));
-  pwm.setPWM(SERVO_R_UPPER, 0, 
-    getEyelidPosition(RightUpperLid::OPEN, RightUpperLid::CLOSED, RightUpperLid::INVERTED, false));
-  pwm.setPWM(SERVO_R_LOWER, 0, 
-    getEyelidPosition(RightLowerLid::OPEN, RightLowerLid::CLOSED, RightLowerLid::INVERTED, false));
+void setTiltMode(bool enabled) {
+  tiltMode = enabled;
+  tiltGaze.reset();
+  Serial.println(enabled ? F("Gaze input: tilt (C + Z to switch back)")
+                         : F("Gaze input: joystick"));
 }
 
 /**
- * Close eyes (with inversion support)
+ * Take over a host gaze command (normalized positions, mapped per rig)
  */
-void closeEyes() {
-  pwm.setPWM(SERVO_L_UPPER, 0, 
-    getEyelidPosition(LeftUpperLid::OPEN, LeftUpperLid::CLOSED, LeftUpperLid::INVERTED, true));
-  pwm.setPWM(SERVO_L_LOWER, 0, 
-    getEyelidPosition(LeftLowerLid::OPEN, LeftLowerLid::CLOSED, LeftLowerLid::INVERTED, true));
-  pwm.setPWM(SERVO_R_UPPER, 0, 
-    getEyelidPosition(RightUpperLid::OPEN, RightUpperLid::CLOSED, RightUpperLid::INVERTED, true));
-  pwm.setPWM(SERVO_R_LOWER, 0, 
-    getEyelidPosition(RightLowerLid::OPEN, RightLowerLid::CLOSED, RightLowerLid::INVERTED, true));
+void applyGazeCommand(const GazeCommand &command) {
+  if (command.flags & GAZE_FLAG_GAZE) {
+    hostGazeH = command.gazeH;
+    hostGazeV = command.gazeV;
+  }
+  
+  if (command.flags & GAZE_FLAG_BLINK) {
+    startBlink();
+  }
+  
+  // Lids rest at the host's position (blinks run from it)
+  if (command.flags & GAZE_FLAG_LID) {
+    for (uint8_t r = 0; r < RIG_COUNT; r++) {
+      rigs[r].holdLids(command.lid);
+    }
+  }
 }
 
 /**
- * Start blink animation
+ * Blink every rig that isn't mid-blink already
  */
 void startBlink() {
-  isBlinking = true;
-  blinkStartTime = millis();
-  closeEyes();
+  for (uint8_t r = 0; r < RIG_COUNT; r++) {
+    if (!rigs[r].blinking()) rigs[r].startBlink(halMillis());
+  }
 }
 
 /**
- * Update blink animation
+ * Build and stage every rig's pose for this tick (PoseCompositor.h)
  */
-void updateBlink() {
-  if (isBlinking) {
-    unsigned long elapsed = millis() - blinkStartTime;
-    if (elapsed >= BLINK_DURATION) {
-      openEyes();
-      isBlinking = false;
-    }
+void composeRigs() {
+  for (uint8_t r = 0; r < RIG_COUNT; r++) {
+    rigs[r].compose(halMillis(), motionDtMs);
   }
 }
 
 /**
  * Print debug info
  */
-void printDebug(int joyX, int joyY, int targetH, int targetV) {
+void printDebug(int joyX, int joyY) {
   Serial.print(F("State: "));
   switch (currentState) {
     case STATE_STARTUP: Serial.print(F("STARTUP")); break;
@@ -670,13 +866,25 @@ void printDebug(int joyX, int joyY, int targetH, int targetV) {
   Serial.print(joyX);
   Serial.print(F(" Y:"));
   Serial.print(joyY);
+  if (tiltMode) {
+    Serial.print(F(" | Tilt X:"));
+    Serial.print(tiltGaze.tiltX());
+    Serial.print(F(" Y:"));
+    Serial.print(tiltGaze.tiltY());
+  }
   Serial.print(F(" | Eye H:"));
-  Serial.print(currentH);
+  Serial.print(rigs[0].eyeH());
   Serial.print(F(" V:"));
-  Serial.print(currentV);
+  Serial.print(rigs[0].eyeV());
+  Serial.print(F(" | I2C:"));
+  Serial.print(servoBus.lastFlush().busBytes);
+  Serial.print(F("B/tick"));
+  Serial.print(F(" | Servos:"));
+  Serial.print(powerBudget.stats().drawMa);
+  Serial.print(powerBudget.limited() ? F("mA (limited)") : F("mA"));
   
   if (currentState == STATE_ACTIVE) {
-    unsigned long timeUntilIdle = IdleSettings::IDLE_TIMEOUT_MS - (millis() - lastActivityTime);
+    unsigned long timeUntilIdle = IdleSettings::IDLE_TIMEOUT_MS - (halMillis() - lastActivityTime);
     if (timeUntilIdle < IdleSettings::IDLE_TIMEOUT_MS) {
       Serial.print(F(" | Idle in: "));
       Serial.print(timeUntilIdle / 1000);
@@ -686,3 +894,83 @@ void printDebug(int joyX, int joyY, int targetH, int targetV) {
   
   Serial.println();
 }
+
+/**
+ * Print per-group scheduler timing (microseconds) and the stack headroom
+ */
+void printTiming() {
+  for (uint8_t i = 0; i < scheduler.groupCount(); i++) {
+    const RateGroup &g = scheduler.group(i);
+    Serial.print(F("TIMING | "));
+    Serial.print(g.name);
+    Serial.print(F(" | runs:"));
+    Serial.print(g.stats.runs);
+    Serial.print(F(" exec:"));
+    Serial.print(g.stats.lastExecUs);
+    Serial.print(F(" wcet:"));
+    Serial.print(g.stats.wcetUs);
+    Serial.print(F(" late:"));
+    Serial.print(g.stats.maxLatencyUs);
+    Serial.print(F(" jitter:"));
+    Serial.print(g.stats.maxJitterUs);
+    Serial.print(F(" overruns:"));
+    Serial.println(g.stats.overruns);
+  }
+  Serial.print(F("MEMORY | stack free:"));
+  Serial.println(halStackFree());
+}
+
+/**
+ * Queue this tick's telemetry record (binary mode)
+ */
+void sendTelemetryTick() {
+  TelemetryTick rec;
+  rec.timeMs = halMillis();
+  rec.state = currentState;
+  rec.flags = (nunchuckInput.buttonZ ? TELEMETRY_FLAG_BUTTON_Z : 0) |
+              (nunchuckInput.buttonC ? TELEMETRY_FLAG_BUTTON_C : 0) |
+              (nunchuckInput.connected ? TELEMETRY_FLAG_CONNECTED : 0) |
+              (rigs[0].blinking() ? TELEMETRY_FLAG_BLINKING : 0) |
+              (performance.recording() ? TELEMETRY_FLAG_RECORDING : 0) |
+              (performance.replaying() ? TELEMETRY_FLAG_REPLAYING : 0) |
+              (powerBudget.limited() ? TELEMETRY_FLAG_POWER_LIMITED : 0) |
+              (tiltMode ? TELEMETRY_FLAG_TILT : 0);
+  rec.joyX = constrain(nunchuckInput.joyX, 0, 255);
+  rec.joyY = constrain(nunchuckInput.joyY, 0, 255);
+  rec.targetH = rigs[0].targetH();
+  rec.targetV = rigs[0].targetV();
+  rec.currentH = rigs[0].eyeH();
+  rec.currentV = rigs[0].eyeV();
+  for (uint8_t i = 0; i < 4; i++) {
+    rec.lids[i] = rigs[0].output(CH_L_UPPER + i);
+  }
+  
+  rec.motionExecUs = 0;
+  rec.motionLateUs = 0;
+  if (motionGroup >= 0) {
+    const RateGroupStats &m = scheduler.group(motionGroup).stats;
+    rec.motionExecUs = m.lastExecUs;
+    rec.motionLateUs = m.lastLatencyUs;
+  }
+  rec.busBytes = servoBus.lastFlush().busBytes;
+  rec.drops = min(telemetry.stats().drops, 65535UL);
+  
+  telemetry.send(FRAME_TELEMETRY_TICK, &rec, sizeof(rec));
+}
+
+/**
+ * Queue one rate group's timing record (binary mode)
+ */
+void sendTelemetryTiming(uint8_t group) {
+  const RateGroupStats &g = scheduler.group(group).stats;
+  TelemetryTiming rec;
+  rec.group = group;
+  rec.groupCount = scheduler.groupCount();
+  rec.runs = g.runs;
+  rec.overruns = g.overruns;
+  rec.execUs = g.lastExecUs;
+  rec.wcetUs = g.wcetUs;
+  rec.lateUs = g.maxLatencyUs;
+  rec.jitterUs = g.maxJitterUs;
+  telemetry.send(FRAME_TELEMETRY_TIMING, &rec, sizeof(rec));
+}
@@ -0,0 +1,126 @@
+/**
+ * GazeLink.cpp
+ *
+ * See GazeLink.h
+ */
+
+#include "GazeLink.h"
+
+#define GAZE_QUEUE_MASK (GAZE_QUEUE_SIZE - 1)
+#define GAZE_RESYNC_MS 1000      // Offset jump that means the sender restarted
+#define GAZE_CREEP_MS 1000       // Offset creeps up 1 ms per this interval
+
+GazeLink::GazeLink(uint16_t playoutDelayMs, uint16_t timeoutMs)
+  : received(0), head(0), tail(0), synced(false), offsetMs(0), lastCreepMs(0),
+    lastArrivalMs(0), expectedSequence(0), playoutDelay(playoutDelayMs), timeout(timeoutMs),
+    textHandler(NULL) {
+  memset(&counters, 0, sizeof(counters));
+}
+
+void GazeLink::service(unsigned long nowMs) {
+  // Only what is already buffered - never wait for more
+  int available = Serial.available();
+  while (available-- > 0) {
+    uint8_t b = Serial.read();
+
+    // Hunt for sync + type
+    if (received == 0) {
+      if (b == FRAME_SYNC0) frame[received++] = b;
+      else if (textHandler != NULL) textHandler(b);
+      continue;
+    }
+    if (received == 1) {
+      if (b == FRAME_SYNC1) frame[received++] = b;
+      else if (b != FRAME_SYNC0) received = 0;
+      continue;
+    }
+    if (received == 2 && b != FRAME_GAZE_COMMAND) {
+      received = b == FRAME_SYNC0 ? 1 : 0;
+      continue;
+    }
+
+    frame[received++] = b;
+    if (received == sizeof(frame)) {
+      accept(frame, nowMs);
+      received = 0;
+    }
+  }
+}
+
+void GazeLink::accept(const uint8_t *data, unsigned long nowMs) {
+  const uint8_t payloadLength = sizeof(GazeCommandPayload);
+  uint16_t crc = frameCrc(&data[2], 2 + payloadLength);
+  uint16_t sent = data[FRAME_HEADER_SIZE + payloadLength] |
+                  ((uint16_t)data[FRAME_HEADER_SIZE + payloadLength + 1] << 8);
+  if (crc != sent) {
+    counters.crcErrors++;
+    return;
+  }
+
+  // Sequence: forward gaps are losses, anything behind is stale
+  uint8_t sequence = data[3];
+  if (counters.frames > 0) {
+    uint8_t ahead = sequence - expectedSequence;
+    if (ahead >= 128) {
+      counters.stale++;
+      return;
+    }
+    counters.lost += ahead;
+  }
+  expectedSequence = sequence + 1;
+
+  GazeCommandPayload payload;
+  memcpy(&payload, &data[FRAME_HEADER_SIZE], payloadLength);
+
+  // Clock offset = fastest observed path
+  int32_t delay = (int32_t)(nowMs - payload.timeMs);
+  if (!synced || delay < offsetMs || delay - offsetMs > GAZE_RESYNC_MS) {
+    offsetMs = delay;
+    lastCreepMs = nowMs;
+    synced = true;
+  } else if (nowMs - lastCreepMs >= GAZE_CREEP_MS) {
+    offsetMs++;
+    lastCreepMs = nowMs;
+  }
+
+  lastArrivalMs = nowMs;
+  counters.frames++;
+
+  if ((uint8_t)(head - tail) >= GAZE_QUEUE_SIZE) {
+    counters.overflows++;
+    return;
+  }
+
+  GazeCommand &command = queue[head & GAZE_QUEUE_MASK];
+  command.playoutMs = payload.timeMs + offsetMs + playoutDelay;
+  command.gazeH = payload.gazeH;
+  command.gazeV = payload.gazeV;
+  command.lid = payload.lid;
+  command.flags = payload.flags;
+  if ((long)(command.playoutMs - nowMs) < 0) counters.late++;
+  head++;
+}
+
+bool GazeLink::next(unsigned long nowMs, GazeCommand &command) {
+  bool found = false;
+  uint8_t blink = 0;
+
+  while (head != tail) {
+    const GazeCommand &due = queue[tail & GAZE_QUEUE_MASK];
+    long wait = (long)(due.playoutMs - nowMs);
+    if (wait > 0) break;
+
+    if ((unsigned long)-wait > counters.maxJitterMs) counters.maxJitterMs = -wait;
+    blink |= due.flags & GAZE_FLAG_BLINK;
+    command = due;
+    found = true;
+    tail++;
+  }
+
+  if (found) command.flags |= blink;
+  return found;
+}
+
+bool GazeLink::active(unsigned long nowMs) const {
+  return counters.frames > 0 && nowMs - lastArrivalMs < timeout;
+}
@@ -0,0 +1,129 @@
+/**
+ * GazeLink.h
+ *
+ * Host-driven gaze commands over Serial (PC-side tracker → eyes)
+ *
+ * FRAME (SerialFraming.h, type FRAME_GAZE_COMMAND, 17 bytes):
+ *   timeMs  - sender's clock when the command was generated
+ *   gazeH/V - normalized eye position (0 .. CHANNEL_POS_FULL, like clips)
+ *   lid     - normalized lid position (0 = open, CHANNEL_POS_FULL / 2 = HALF)
+ *   flags   - GAZE_FLAG_*: which fields are valid, blink trigger
+ *
+ * RECEIVE PATH (no blocking, no dynamic memory):
+ *   UART RX buffer → byte-wise frame parser (input group, every 10 ms)
+ *   → CRC + sequence check → playout ring → motion group
+ *
+ * LATENCY-COMPENSATED PLAYOUT:
+ * Arrival times jitter with the PC's scheduler and USB polling. Each
+ * command is instead played at
+ *
+ *   sender time + clock offset + PLAYOUT_DELAY_MS
+ *
+ * where the offset is the smallest (arrival - sender time) seen, i.e. the
+ * fastest path through the link. It creeps up 1 ms/s so clock drift
+ * between PC and board can't build up; a jump of more than a second
+ * (sender restarted) resyncs it. Commands arriving up to PLAYOUT_DELAY_MS
+ * late are therefore still played evenly spaced - jitter is bounded by
+ * the motion tick, not by the link.
+ *
+ * Sequence numbers detect lost frames (counted) and duplicates or
+ * reordered frames (dropped as stale).
+ *
+ * Bytes outside frames (typed text commands) go to the text handler, if
+ * one is set; the sync byte is never printable, so text can't start a frame.
+ */
+
+#ifndef GAZE_LINK_H
+#define GAZE_LINK_H
+
+#include <Arduino.h>
+#include "SerialFraming.h"
+
+// Playout ring (power of two)
+#define GAZE_QUEUE_SIZE 8
+
+// GazeCommandPayload.flags
+#define GAZE_FLAG_GAZE  0x01     // gazeH/gazeV valid
+#define GAZE_FLAG_LID   0x02     // lid valid
+#define GAZE_FLAG_BLINK 0x04     // Blink now
+
+struct GazeCommandPayload {
+  uint32_t timeMs;
+  uint16_t gazeH;
+  uint16_t gazeV;
+  uint16_t lid;
+  uint8_t flags;
+} __attribute__((packed));
+
+/**
+ * A command due for playout
+ */
+struct GazeCommand {
+  unsigned long playoutMs;   // Local time to apply it
+  uint16_t gazeH;
+  uint16_t gazeV;
+  uint16_t lid;
+  uint8_t flags;
+};
+
+/** Receives each byte that isn't part of a frame */
+typedef void (*GazeTextHandler)(uint8_t b);
+
+struct GazeLinkStats {
+  unsigned long frames;      // Accepted commands
+  unsigned long crcErrors;
+  unsigned long lost;        // Missing sequence numbers
+  unsigned long stale;       // Duplicate / reordered, dropped
+  unsigned long late;        // Arrived after their playout time
+  unsigned long overflows;   // Playout ring full, dropped
+  uint16_t maxJitterMs;      // Worst |applied - scheduled|
+};
+
+class GazeLink {
+public:
+  GazeLink(uint16_t playoutDelayMs, uint16_t timeoutMs);
+
+  /** Parse whatever the UART has received (input group) */
+  void service(unsigned long nowMs);
+
+  /**
+   * Take every command due by nowMs (motion group)
+   * The newest one is returned; blink triggers of skipped commands are
+   * merged into it so none is lost. False if nothing was due.
+   */
+  bool next(unsigned long nowMs, GazeCommand &command);
+
+  /** A command arrived within the timeout: the host has control */
+  bool active(unsigned long nowMs) const;
+
+  /** Hand non-frame bytes to handler (NULL: discard them) */
+  void setTextHandler(GazeTextHandler handler) { textHandler = handler; }
+
+  const GazeLinkStats &stats() const { return counters; }
+
+private:
+  void accept(const uint8_t *frame, unsigned long nowMs);
+
+  // Parser
+  uint8_t frame[FRAME_OVERHEAD + sizeof(GazeCommandPayload)];
+  uint8_t received;
+
+  // Playout ring
+  GazeCommand queue[GAZE_QUEUE_SIZE];
+  uint8_t head;
+  uint8_t tail;
+
+  // Clock / sequence tracking
+  bool synced;
+  int32_t offsetMs;          // arrival - sender time, fastest seen
+  unsigned long lastCreepMs;
+  unsigned long lastArrivalMs;
+  uint8_t expectedSequence;
+
+  uint16_t playoutDelay;
+  uint16_t timeout;
+  GazeTextHandler textHandler;
+  GazeLinkStats counters;
+};
+
+#endif // GAZE_LINK_H
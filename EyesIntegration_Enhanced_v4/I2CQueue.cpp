@@ -0,0 +1,91 @@
+/**
+ * I2CQueue.cpp
+ *
+ * See I2CQueue.h
+ */
+
+#include "I2CQueue.h"
+#include "EyeHAL.h"
+
+I2CQueue i2cQueue;
+
+I2CQueue::I2CQueue()
+  : head(0), tail(0), count(0), byteTail(0), byteCount(0) {
+  memset(slots, 0, sizeof(slots));
+  memset(&counters, 0, sizeof(counters));
+}
+
+uint16_t I2CQueue::freeBytes() const {
+  // Restore, don't enable: callable with interrupts already off
+  uint8_t sreg = SREG;
+  cli();
+  uint16_t used = byteCount;
+  SREG = sreg;
+  return I2C_QUEUE_BYTES - used;
+}
+
+bool I2CQueue::write(uint8_t address, const uint8_t *data, uint8_t length,
+                     volatile uint8_t *status, uint16_t holdUs) {
+  return push(address, length, NULL, status, holdUs, data);
+}
+
+bool I2CQueue::read(uint8_t address, uint8_t *buffer, uint8_t length,
+                    volatile uint8_t *status, uint16_t holdUs) {
+  if (length == 0) return false;
+  return push(address, length, buffer, status, holdUs, NULL);
+}
+
+bool I2CQueue::push(uint8_t address, uint8_t length, uint8_t *readBuffer,
+                    volatile uint8_t *status, uint16_t holdUs, const uint8_t *data) {
+  // The driver only ever frees space, so these checks can't go stale
+  uint8_t payloadLength = readBuffer == NULL ? length : 0;
+  if (count >= I2C_QUEUE_SLOTS || payloadLength > freeBytes()) {
+    counters.rejected++;
+    return false;
+  }
+
+  // Fill the free slot and payload space first; the driver can't see them yet
+  I2CTransaction &t = slots[tail];
+  t.address = address;
+  t.length = length;
+  t.offset = byteTail;
+  t.holdUs = holdUs;
+  t.readBuffer = readBuffer;
+  t.status = status;
+  for (uint8_t i = 0; i < payloadLength; i++) {
+    bytes[byteTail] = data[i];
+    byteTail = (byteTail + 1) & (I2C_QUEUE_BYTES - 1);
+  }
+  tail = (tail + 1) & (I2C_QUEUE_SLOTS - 1);
+  if (status != NULL) *status = I2C_QUEUED;
+
+  // Publish
+  uint8_t sreg = SREG;
+  cli();
+  count++;
+  byteCount += payloadLength;
+  uint16_t used = byteCount;
+  SREG = sreg;
+
+  if (count > counters.peakSlots) counters.peakSlots = count;
+  if (used > counters.peakBytes) counters.peakBytes = used;
+
+  // Start it now if the bus is idle
+  halI2CService();
+  return true;
+}
+
+void I2CQueue::complete(uint8_t status) {
+  if (count == 0) return;
+
+  const I2CTransaction &t = slots[head];
+  if (t.readBuffer == NULL) byteCount -= t.length;
+  if (t.status != NULL) *t.status = status;
+
+  counters.transactions++;
+  if (status == I2C_NACK) counters.nacks++;
+  if (status == I2C_FAILED) counters.failures++;
+
+  head = (head + 1) & (I2C_QUEUE_SLOTS - 1);
+  count--;
+}
@@ -0,0 +1,129 @@
+/**
+ * I2CQueue.h
+ *
+ * Interrupt-driven I2C transaction queue shared by every bus device
+ *
+ * Wire blocks the CPU for the whole transfer: a 26-byte servo burst is
+ * ~2.4 ms at 100 kHz, a nunchuck read ~1 ms, every tick. Here callers only
+ * QUEUE transactions - writes are copied into a byte ring, reads name a
+ * destination buffer - and the HAL's bus driver (a TWI interrupt state
+ * machine on the UNO) runs them back to back in the background, in
+ * submission order. The CPU is free while bytes are on the wire.
+ *
+ * A transaction reports its outcome through an optional status byte
+ * (I2CStatus) that the driver sets when the STOP has gone out. holdUs
+ * keeps the bus idle for a minimum time before the START - for devices
+ * that need a pause after the previous transfer (nunchuck conversion).
+ *
+ * Nothing waits on a full queue: write()/read() return false and the
+ * caller keeps its data for the next tick (ServoFrame leaves the channels
+ * dirty). halI2CFlush() is the only blocking call, for setup().
+ */
+
+#ifndef I2C_QUEUE_H
+#define I2C_QUEUE_H
+
+#include <Arduino.h>
+
+// Transactions in flight; a power of two so the indices wrap by mask
+#define I2C_QUEUE_SLOTS 8
+
+// Write payload ring, a power of two (one rig's six channels take 25
+// bytes, a fully changed PCA9685 67; with 2+ rigs use 128, with 2+ boards
+// in motion at 400 kHz 256, or one tick's bursts will not all fit and the
+// rest wait a tick)
+#ifndef I2C_QUEUE_BYTES
+#define I2C_QUEUE_BYTES 64
+#endif
+
+#if (I2C_QUEUE_BYTES & (I2C_QUEUE_BYTES - 1)) != 0
+#error "I2C_QUEUE_BYTES must be a power of two"
+#endif
+
+enum I2CStatus {
+  I2C_IDLE = 0,      // Nothing outstanding (a caller's initial value)
+  I2C_QUEUED,        // Waiting or on the wire
+  I2C_DONE,          // Every byte ACKed
+  I2C_NACK,          // Address or data NACK (device absent or busy)
+  I2C_FAILED         // Bus error, lost arbitration or driver timeout
+};
+
+/**
+ * Bus time of one transaction carrying bytes payload bytes
+ * START + address + payload at 9 clocks per byte (with ACK) + STOP
+ */
+inline unsigned long i2cTransferUs(unsigned long clockHz, uint8_t bytes) {
+  return ((2UL + 9UL * (bytes + 1)) * 1000000UL + clockHz - 1) / clockHz;
+}
+
+struct I2CTransaction {
+  uint8_t address;
+  uint8_t length;              // Bytes to write (from the ring) or read
+  uint16_t offset;             // Write payload start in the byte ring
+  uint16_t holdUs;             // Minimum idle bus time before the START
+  uint8_t *readBuffer;         // NULL for a write
+  volatile uint8_t *status;    // Optional outcome (I2CStatus)
+};
+
+struct I2CQueueStats {
+  unsigned long transactions;  // Completed (any outcome)
+  unsigned long nacks;
+  unsigned long failures;
+  unsigned long rejected;      // Submissions refused, queue full
+  uint8_t peakSlots;           // High-water marks
+  uint16_t peakBytes;
+};
+
+class I2CQueue {
+public:
+  I2CQueue();
+
+  /** Queue a write of length bytes (copied); false if it does not fit */
+  bool write(uint8_t address, const uint8_t *data, uint8_t length,
+             volatile uint8_t *status = NULL, uint16_t holdUs = 0);
+
+  /** Queue a read into buffer (must stay valid until done); false if full */
+  bool read(uint8_t address, uint8_t *buffer, uint8_t length,
+            volatile uint8_t *status = NULL, uint16_t holdUs = 0);
+
+  /** Room for that many more transactions carrying payloadBytes in total */
+  bool fits(uint8_t transactions, uint16_t payloadBytes) const {
+    return count + transactions <= I2C_QUEUE_SLOTS && payloadBytes <= freeBytes();
+  }
+
+  bool idle() const { return count == 0; }
+  uint8_t queued() const { return count; }
+  uint16_t freeBytes() const;
+  const I2CQueueStats &stats() const { return counters; }
+
+  // ---- Bus driver side (HAL backend; may run in interrupt context) ----
+
+  /** Transaction to run next, or NULL */
+  const I2CTransaction *front() const { return count ? &slots[head] : NULL; }
+
+  /** Byte index of the front transaction's write payload */
+  uint8_t payload(uint8_t index) const {
+    return bytes[(slots[head].offset + index) & (I2C_QUEUE_BYTES - 1)];
+  }
+
+  /** Front transaction finished with status (I2CStatus); drop it */
+  void complete(uint8_t status);
+
+private:
+  bool push(uint8_t address, uint8_t length, uint8_t *readBuffer,
+            volatile uint8_t *status, uint16_t holdUs, const uint8_t *data);
+
+  I2CTransaction slots[I2C_QUEUE_SLOTS];
+  uint8_t bytes[I2C_QUEUE_BYTES];
+  uint8_t head;                // Front slot (driver side)
+  uint8_t tail;                // Next free slot (caller side)
+  volatile uint8_t count;      // Slots in use
+  uint16_t byteTail;           // Next free payload byte
+  volatile uint16_t byteCount; // Payload bytes in use (two bytes: read it atomically)
+  I2CQueueStats counters;
+};
+
+// The one bus queue (the HAL driver consumes it)
+extern I2CQueue i2cQueue;
+
+#endif // I2C_QUEUE_H
@@ -0,0 +1,112 @@
+/**
+ * JoystickFilter.cpp
+ *
+ * See JoystickFilter.h
+ */
+
+#include "JoystickFilter.h"
+
+// 1 / (2π) s in 1/16 ms, per mHz: τ = JOY_TAU_Q4 / cutoff
+#define JOY_TAU_Q4 2546479UL
+#define JOY_MAX_CUTOFF_MHZ 100000UL      // Past this the filter is a wire
+#define JOY_MAX_SPEED (128L << 8)        // Q8 deflection/s: a flick end to end in 15 ms
+#define JOY_MAX_DT_MS 255
+
+/**
+ * Smoothing factor for a first-order low-pass at cutoff, Q12
+ */
+static int32_t joyAlpha(uint32_t cutoffMilliHz, uint16_t dtQ4) {
+  if (cutoffMilliHz > JOY_MAX_CUTOFF_MHZ) cutoffMilliHz = JOY_MAX_CUTOFF_MHZ;
+  uint32_t tauQ4 = JOY_TAU_Q4 / (cutoffMilliHz > 0 ? cutoffMilliHz : 1);
+  return (int32_t)(((uint32_t)dtQ4 << 12) / (dtQ4 + tauQ4));
+}
+
+static uint16_t joyIsqrt(uint32_t v) {
+  uint32_t root = 0;
+  uint32_t bit = 1UL << 30;
+  while (bit > v) bit >>= 2;
+  while (bit != 0) {
+    if (v >= root + bit) {
+      v -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return (uint16_t)root;
+}
+
+static int16_t joyClamp(int32_t v) {
+  return (int16_t)(v > JOY_FULL ? JOY_FULL : (v < -JOY_FULL ? -JOY_FULL : v));
+}
+
+JoystickFilter::JoystickFilter()
+  : primed(false), outX(0), outY(0) {
+  memset(&rangeX, 0, sizeof(rangeX));
+  memset(&rangeY, 0, sizeof(rangeY));
+  memset(&settings, 0, sizeof(settings));
+  memset(&filterX, 0, sizeof(filterX));
+  memset(&filterY, 0, sizeof(filterY));
+}
+
+void JoystickFilter::configure(const JoystickAxisRange &x, const JoystickAxisRange &y,
+                               const JoystickFilterSettings &config) {
+  rangeX = x;
+  rangeY = y;
+  settings = config;
+  primed = false;
+}
+
+int32_t JoystickFilter::normalize(int raw, const JoystickAxisRange &range) const {
+  int32_t offset = raw - range.center;
+  int32_t span = settings.asymmetricRange
+    ? (offset >= 0 ? range.max - range.center : range.center - range.min)
+    : (range.max - range.min) / 2;
+  if (span <= 0) return 0;
+  return joyClamp(offset * JOY_FULL / span);
+}
+
+int32_t JoystickFilter::smooth(JoystickAxisFilter &f, int32_t input, uint16_t dtQ4) const {
+  // Speed from the last filtered value, Q8 deflection per second
+  int32_t rawSpeed = (input - f.value) * 1000L / ((int32_t)dtQ4 * 16);
+  if (rawSpeed > JOY_MAX_SPEED) rawSpeed = JOY_MAX_SPEED;
+  if (rawSpeed < -JOY_MAX_SPEED) rawSpeed = -JOY_MAX_SPEED;
+  f.speed += (rawSpeed - f.speed) * joyAlpha(settings.speedCutoffMilliHz, dtQ4) / (1L << 12);
+
+  uint32_t speed = f.speed >= 0 ? f.speed : -f.speed;
+  uint32_t cutoff = settings.minCutoffMilliHz + ((uint32_t)settings.betaMilliHz * speed >> 8);
+  f.value += (input - f.value) * joyAlpha(cutoff, dtQ4) / (1L << 12);
+  return f.value;
+}
+
+void JoystickFilter::update(int rawX, int rawY, unsigned long dtMs) {
+  // Q16 inside the filter, Q12 out
+  int32_t x = normalize(rawX, rangeX) << 4;
+  int32_t y = normalize(rawY, rangeY) << 4;
+
+  if (!primed || !settings.filter) {
+    filterX.value = x;
+    filterY.value = y;
+    filterX.speed = 0;
+    filterY.speed = 0;
+    primed = true;
+  } else {
+    uint16_t dtQ4 = (dtMs == 0 ? 1 : (dtMs > JOY_MAX_DT_MS ? JOY_MAX_DT_MS : dtMs)) * 16;
+    x = smooth(filterX, x, dtQ4);
+    y = smooth(filterY, y, dtQ4);
+  }
+  x = (x + 8) >> 4;
+  y = (y + 8) >> 4;
+
+  // Radial deadzone, magnitude rescaled so the output starts at 0 on its edge
+  uint16_t r = joyIsqrt((uint32_t)(x * x + y * y));
+  if (r <= settings.deadzone) {
+    outX = 0;
+    outY = 0;
+    return;
+  }
+  int32_t magnitude = (int32_t)(r - settings.deadzone) * JOY_FULL / (JOY_FULL - settings.deadzone);
+  outX = joyClamp(x * magnitude / r);
+  outY = joyClamp(y * magnitude / r);
+}
@@ -0,0 +1,111 @@
+/**
+ * JoystickFilter.h
+ *
+ * Nunchuck joystick → gaze deflection, fixed point
+ *
+ * The old mapJoystick() snapped everything within DEADZONE of center to
+ * the servo center and mapped the rest linearly from the range ends, so
+ * leaving the deadzone jumped the eyes by the deadzone's worth of travel,
+ * and raw ADC noise went straight to the servos. Per input sample:
+ *
+ *   1. RANGE   raw → signed deflection, Q12 (±4096 = full throw). With
+ *              ASYMMETRIC_RANGE each half is scaled by its own span
+ *              (MIN..CENTER, CENTER..MAX): a stick that rests off-center
+ *              still reaches both ends and rests at 0.
+ *   2. FILTER  One-Euro low-pass per axis: the cutoff rises with the
+ *              (filtered) speed of the stick,
+ *                cutoff = MIN_CUTOFF + BETA × |speed|
+ *              so a resting or slowly moving stick is smoothed hard and a
+ *              fast flick passes almost unfiltered - the lag is only paid
+ *              where it can't be seen.
+ *   3. DEADZONE radial (the stick's rest noise isn't aligned with the
+ *              axes) and scaled: the magnitude is remapped from
+ *              [deadzone, full] to [0, full], so output starts from 0 at
+ *              the deadzone edge - continuous, no jump.
+ *
+ * Filter coefficients follow the real time between samples, so the
+ * response is the same whatever rate update() is called at.
+ * No floats: an integer square root and a dozen 32-bit divisions per
+ * sample (motion group, 50 Hz).
+ */
+
+#ifndef JOYSTICK_FILTER_H
+#define JOYSTICK_FILTER_H
+
+#include <Arduino.h>
+#include "ChannelTable.h"
+
+#define JOY_Q 12
+#define JOY_FULL (1L << JOY_Q)     // Full deflection, Q12
+
+/**
+ * One axis' raw range (NunchuckCalibration)
+ */
+struct JoystickAxisRange {
+  int min;
+  int center;
+  int max;
+};
+
+struct JoystickFilterSettings {
+  uint16_t deadzone;             // Radial, Q12 of full deflection
+  bool asymmetricRange;          // Scale each half separately (else (MAX - MIN) / 2)
+  bool filter;                   // One-Euro stage on/off
+  uint16_t minCutoffMilliHz;     // Cutoff at rest
+  uint16_t betaMilliHz;          // Added cutoff per full deflection per second of speed
+  uint16_t speedCutoffMilliHz;   // Low-pass on the speed estimate
+};
+
+/**
+ * One-Euro stage of one axis (state in Q16 deflection)
+ */
+struct JoystickAxisFilter {
+  int32_t value;
+  int32_t speed;                 // Q8 deflection per second, filtered
+};
+
+class JoystickFilter {
+public:
+  JoystickFilter();
+
+  void configure(const JoystickAxisRange &x, const JoystickAxisRange &y,
+                 const JoystickFilterSettings &settings);
+
+  /** Restart from the next sample (no history; e.g. after a replug) */
+  void reset() { primed = false; }
+
+  /** One raw sample, taken dtMs after the previous one */
+  void update(int rawX, int rawY, unsigned long dtMs);
+
+  /** Filtered deflection, Q12, 0 inside the deadzone */
+  int16_t deflectionX() const { return outX; }
+  int16_t deflectionY() const { return outY; }
+
+private:
+  int32_t normalize(int raw, const JoystickAxisRange &range) const;
+  int32_t smooth(JoystickAxisFilter &f, int32_t input, uint16_t dtQ4) const;
+
+  JoystickAxisRange rangeX;
+  JoystickAxisRange rangeY;
+  JoystickFilterSettings settings;
+  JoystickAxisFilter filterX;
+  JoystickAxisFilter filterY;
+  bool primed;
+  int16_t outX;
+  int16_t outY;
+};
+
+/**
+ * Deflection → normalized position (0 .. CHANNEL_POS_FULL), around a rest
+ * position: -JOY_FULL → 0, 0 → centerPosition, JOY_FULL → CHANNEL_POS_FULL
+ * Each half scales separately, so the eyes rest on the calibrated CENTER
+ * even where that isn't the middle of MIN..MAX.
+ */
+inline uint16_t joystickPosition(int16_t deflection, uint16_t centerPosition) {
+  int32_t scaled = (int32_t)deflection *
+                   (deflection >= 0 ? CHANNEL_POS_FULL - centerPosition : centerPosition);
+  scaled += scaled >= 0 ? JOY_FULL / 2 : -JOY_FULL / 2;
+  return (uint16_t)(centerPosition + scaled / JOY_FULL);
+}
+
+#endif // JOYSTICK_FILTER_H
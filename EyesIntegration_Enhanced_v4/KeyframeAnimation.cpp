@@ -0,0 +1,101 @@
+/**
+ * KeyframeAnimation.cpp
+ *
+ * See KeyframeAnimation.h
+ */
+
+#include "KeyframeAnimation.h"
+
+#define KEY_VALUE_MASK 0x0FFF
+#define KEY_EASE_SHIFT 12
+
+/**
+ * Shape a Q8 segment fraction (0..256)
+ */
+static uint16_t applyEasing(uint8_t ease, uint16_t f) {
+  switch (ease) {
+    case EASE_IN_OUT:
+      // f²·(3 - 2f)
+      return (uint16_t)(((uint32_t)f * f >> 8) * (768 - 2 * f) >> 8);
+    case EASE_OUT:
+      // f·(2 - f)
+      return (uint16_t)((uint32_t)f * (512 - f) >> 8);
+    default:
+      return f;
+  }
+}
+
+/**
+ * Value of one track at t ms into the clip
+ */
+static int16_t sampleTrack(const Keyframe *keys, uint8_t count, uint16_t t) {
+  uint16_t prevTime = pgm_read_word(&keys[0].timeMs);
+  int16_t prevValue = pgm_read_word(&keys[0].valueEase) & KEY_VALUE_MASK;
+  if (t <= prevTime) return prevValue;
+
+  for (uint8_t k = 1; k < count; k++) {
+    uint16_t time = pgm_read_word(&keys[k].timeMs);
+    uint16_t packed = pgm_read_word(&keys[k].valueEase);
+    int16_t value = packed & KEY_VALUE_MASK;
+
+    if (t < time) {
+      uint8_t ease = packed >> KEY_EASE_SHIFT;
+      if (ease == EASE_STEP) return prevValue;
+      uint16_t f = (uint16_t)(((uint32_t)(t - prevTime) << 8) / (time - prevTime));
+      f = applyEasing(ease, f);
+      return prevValue + (int16_t)(((int32_t)(value - prevValue) * f + 128) >> 8);
+    }
+
+    prevTime = time;
+    prevValue = value;
+  }
+  return prevValue;
+}
+
+const AnimationClip *findClip(const char *name) {
+  for (uint8_t i = 0; i < ANIMATION_CLIP_COUNT; i++) {
+    const char *clipName = (const char *)pgm_read_ptr(&ANIMATION_CLIPS[i].name);
+    if (strcmp_P(name, clipName) == 0) return &ANIMATION_CLIPS[i];
+  }
+  return NULL;
+}
+
+ClipPlayer::ClipPlayer() : current(NULL), startMs(0) {}
+
+void ClipPlayer::play(const AnimationClip *clip, unsigned long nowMs) {
+  current = clip;
+  startMs = nowMs;
+}
+
+uint8_t ClipPlayer::evaluate(unsigned long nowMs, int16_t pose[CHANNEL_COUNT]) {
+  if (current == NULL) return 0;
+
+  uint16_t duration = pgm_read_word(&current->durationMs);
+  unsigned long elapsed = nowMs - startMs;
+  bool done = elapsed >= duration;
+  uint16_t t = done ? duration : (uint16_t)elapsed;
+
+  uint8_t trackCount = pgm_read_byte(&current->trackCount);
+  const ClipTrack *tracks = (const ClipTrack *)pgm_read_ptr(&current->tracks);
+  uint8_t driven = 0;
+
+  for (uint8_t i = 0; i < trackCount; i++) {
+    uint8_t target = pgm_read_byte(&tracks[i].target);
+    uint8_t keyCount = pgm_read_byte(&tracks[i].keyCount);
+    const Keyframe *keys = (const Keyframe *)pgm_read_ptr(&tracks[i].keys);
+    int16_t value = sampleTrack(keys, keyCount, t);
+
+    if (target == TRACK_LIDS) {
+      for (uint8_t lid = CH_L_UPPER; lid <= CH_R_LOWER; lid++) {
+        pose[lid] = value;
+        driven |= 1 << lid;
+      }
+    } else if (target < CHANNEL_COUNT) {
+      pose[target] = value;
+      driven |= 1 << target;
+    }
+  }
+
+  if (done) current = NULL;
+  return driven;
+}
@@ -0,0 +1,103 @@
+/**
+ * KeyframeAnimation.h
+ *
+ * Time-parameterized keyframe clips stored in PROGMEM
+ *
+ * A clip is a set of tracks; each track drives one channel (or all four
+ * lids) through a list of keys. Values are normalized channel positions
+ * (0 .. CHANNEL_POS_FULL, see ChannelTable.h), so clips are independent
+ * of calibration and inversion:
+ * - Eyes: 0 = joystick low end (left / down), CHANNEL_POS_FULL = high end
+ * - Lids: 0 = open, CHANNEL_POS_FULL = closed
+ *
+ * KEY FORMAT (4 bytes):
+ *   timeMs  - from clip start
+ *   value   - bits 0-11, normalized position
+ *   easing  - bits 12-15, how the track gets TO this key from the previous one
+ *
+ * The player is evaluated by elapsed time, never by tick count, so a clip
+ * takes exactly as long at 25 Hz as at 200 Hz. No floats; one division
+ * per active track per evaluation.
+ *
+ * Eye tracks are motion TARGETS (the motion engine still shapes and rate
+ * limits the movement); lid tracks are positions written directly.
+ */
+
+#ifndef KEYFRAME_ANIMATION_H
+#define KEYFRAME_ANIMATION_H
+
+#include <Arduino.h>
+#include "ChannelTable.h"
+
+// ============================================================================
+// CLIP FORMAT
+// ============================================================================
+
+enum Easing {
+  EASE_STEP,      // Hold previous value, jump at key time
+  EASE_LINEAR,
+  EASE_IN_OUT,    // Smoothstep
+  EASE_OUT        // Fast start, gentle landing
+};
+
+// Track target: a ChannelIndex, or all four lids together
+#define TRACK_LIDS CHANNEL_COUNT
+
+struct Keyframe {
+  uint16_t timeMs;
+  uint16_t valueEase;
+};
+
+#define KEY(timeMs, value, ease) \
+  { (uint16_t)(timeMs), (uint16_t)(((uint16_t)(ease) << 12) | (uint16_t)(value)) }
+
+struct ClipTrack {
+  uint8_t target;            // ChannelIndex or TRACK_LIDS
+  uint8_t keyCount;
+  const Keyframe *keys;      // PROGMEM
+};
+
+struct AnimationClip {
+  const char *name;          // PROGMEM
+  uint16_t durationMs;
+  uint8_t trackCount;
+  const ClipTrack *tracks;   // PROGMEM
+};
+
+// Declare a track from a PROGMEM key array
+#define CLIP_TRACK(target, keys) { (uint8_t)(target), (uint8_t)(sizeof(keys) / sizeof(Keyframe)), keys }
+
+// Clip library (AnimationClips.cpp)
+extern const AnimationClip ANIMATION_CLIPS[] PROGMEM;
+extern const uint8_t ANIMATION_CLIP_COUNT;
+
+/** Clip by name, or NULL */
+const AnimationClip *findClip(const char *name);
+
+// ============================================================================
+// PLAYER
+// ============================================================================
+
+class ClipPlayer {
+public:
+  ClipPlayer();
+
+  void play(const AnimationClip *clip, unsigned long nowMs);
+  void stop() { current = NULL; }
+  bool playing() const { return current != NULL; }
+  const AnimationClip *clip() const { return current; }
+
+  /**
+   * Pose at nowMs
+   * Writes normalized positions of the channels the clip drives into pose
+   * and returns them as a bit mask (bit n = ChannelIndex n). Once the clip
+   * has run its duration the final pose is returned and playback stops.
+   */
+  uint8_t evaluate(unsigned long nowMs, int16_t pose[CHANNEL_COUNT]);
+
+private:
+  const AnimationClip *current;
+  unsigned long startMs;
+};
+
+#endif // KEYFRAME_ANIMATION_H
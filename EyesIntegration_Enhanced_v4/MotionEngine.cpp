@@ -0,0 +1,85 @@
+/**
+ * MotionEngine.cpp
+ *
+ * See MotionEngine.h
+ */
+
+#include "MotionEngine.h"
+
+// Snap onto the target when this close and this slow
+static const int32_t SNAP_POSITION = MOTION_ONE / 2;     // 0.5 pulse
+static const int32_t SNAP_VELOCITY = MOTION_ONE / 50;    // 0.02 pulse/ms
+
+MotionAxis::MotionAxis() : maxStepMs(1), pos(0), vel(0), target(0) {
+  prof.responseMs = 1;
+  prof.maxVelocity = MOTION_ONE;
+  prof.maxAccel = MOTION_ONE;
+}
+
+void MotionAxis::setProfile(const MotionProfile &profile) {
+  prof = profile;
+  if (prof.responseMs < 1) prof.responseMs = 1;
+  maxStepMs = prof.responseMs / 4;
+  if (maxStepMs < 1) maxStepMs = 1;
+}
+
+void MotionAxis::reset(int pulse) {
+  pos = (int32_t)pulse * MOTION_ONE;
+  target = pos;
+  vel = 0;
+}
+
+int MotionAxis::update(unsigned long dtMs) {
+  while (dtMs > 0) {
+    int32_t h = dtMs > (unsigned long)maxStepMs ? maxStepMs : (int32_t)dtMs;
+    step(h);
+    dtMs -= h;
+  }
+
+  int32_t error = target - pos;
+  if (error > -SNAP_POSITION && error < SNAP_POSITION &&
+      vel > -SNAP_VELOCITY && vel < SNAP_VELOCITY) {
+    pos = target;
+    vel = 0;
+  }
+
+  return position();
+}
+
+int MotionAxis::track(int pulse, unsigned long dtMs) {
+  // A second covers any travel, and keeps the product within 32 bits
+  int32_t limit = prof.maxVelocity * (int32_t)constrain(dtMs, 1UL, 1000UL);
+  pos += constrain((int32_t)pulse * MOTION_ONE - pos, -limit, limit);
+  target = pos;
+  vel = 0;
+  return position();
+}
+
+void MotionAxis::step(int32_t dtMs) {
+  const int32_t tau = prof.responseMs;
+  int32_t error = target - pos;
+
+  // Critically damped spring
+  int32_t accel = (error - 2 * tau * vel) / (tau * tau);
+
+  // Braking guard: moving toward the target faster than maxAccel can stop
+  // in the remaining distance (v² > 2·a·d; v in Q8, d in Q4 to stay within
+  // 32 bits over the PCA9685's whole 4096 counts)
+  bool braking = false;
+  if ((vel > 0 && error > 0) || (vel < 0 && error < 0)) {
+    int32_t v8 = vel >> 8;
+    int32_t distance4 = (error < 0 ? -error : error) >> 12;
+    if (v8 * v8 > (2 * prof.maxAccel * distance4) >> 4) {
+      accel = vel > 0 ? -prof.maxAccel : prof.maxAccel;
+      braking = true;
+    }
+  }
+
+  accel = constrain(accel, -prof.maxAccel, prof.maxAccel);
+  int32_t newVel = constrain(vel + accel * dtMs, -prof.maxVelocity, prof.maxVelocity);
+
+  // Braking stops the axis; it never reverses it (no bang-bang chatter)
+  if (braking && ((vel > 0 && newVel < 0) || (vel < 0 && newVel > 0))) newVel = 0;
+  vel = newVel;
+  pos += vel * dtMs;
+}
@@ -0,0 +1,105 @@
+/**
+ * MotionEngine.h
+ *
+ * Fixed-point, second-order motion for one servo axis
+ *
+ * Replaces smooth() ("current + delta / smoothing"), which stalls up to
+ * smoothing-1 pulses short of target because the integer division
+ * truncates to zero, and which never enforced MAX_DELTA_PER_UPDATE.
+ *
+ * MODEL:
+ * A critically damped spring pulls the axis toward its target:
+ *
+ *   accel = (error - 2·τ·velocity) / τ²        τ = responseMs
+ *
+ * then acceleration and velocity are clamped, and a braking guard switches
+ * to full deceleration when the axis could not otherwise stop at the target.
+ * Within half a pulse of target at near-zero speed the axis snaps exactly
+ * onto it - no residual error, no creeping.
+ *
+ * FIXED POINT (no floats - the UNO has no FPU):
+ * - position:     Q16.16 pulses
+ * - velocity:     Q16.16 pulses per millisecond
+ * - acceleration: Q16.16 pulses per millisecond²
+ * One 32-bit division per substep; all products fit in 32 bits within
+ * MOTION_MAX_* below. The tightest is motionProfile()'s pulses/s × MOTION_ONE,
+ * ~32.7 pulses/ms; HIGH_RATE eyes reach ~8.2 (EYE_MAX_VELOCITY, asserted in
+ * EyeRig.h). The spring's error - 2·τ·velocity alone would allow ~57, the
+ * braking guard's 2·maxAccel·distance caps acceleration at 0.25 pulses/ms².
+ *
+ * TICK-RATE INDEPENDENCE:
+ * update() takes the elapsed time and integrates in substeps of at most τ/4,
+ * so the trajectory is (to integration accuracy) the same at 50 Hz or 200 Hz.
+ */
+
+#ifndef MOTION_ENGINE_H
+#define MOTION_ENGINE_H
+
+#include <Arduino.h>
+
+#define MOTION_ONE 65536L   // 1.0 in Q16.16
+
+// Overflow limits of the 32-bit arithmetic (see FIXED POINT above)
+#define MOTION_MAX_RESPONSE_MS 250      // τ
+#define MOTION_MAX_VELOCITY 32767L      // pulses/s
+#define MOTION_MAX_ACCEL 250000L        // pulses/s²
+
+/**
+ * Dynamics for an axis, in fixed-point per-millisecond units
+ * Build with motionProfile() from human units
+ */
+struct MotionProfile {
+  int32_t responseMs;    // Spring time constant τ
+  int32_t maxVelocity;   // Q16 pulses/ms
+  int32_t maxAccel;      // Q16 pulses/ms²
+};
+
+/**
+ * Profile from pulses/second and pulses/second²
+ */
+inline MotionProfile motionProfile(int32_t responseMs, int32_t maxPulsesPerSec,
+                                   int32_t maxPulsesPerSec2) {
+  MotionProfile p;
+  p.responseMs = responseMs;
+  p.maxVelocity = (int32_t)((maxPulsesPerSec * MOTION_ONE) / 1000L);
+  p.maxAccel = (int32_t)((maxPulsesPerSec2 * (MOTION_ONE / 1000L)) / 1000L);
+  return p;
+}
+
+class MotionAxis {
+public:
+  MotionAxis();
+
+  void setProfile(const MotionProfile &profile);
+
+  /** Place the axis at rest on a pulse (no motion) */
+  void reset(int pulse);
+
+  void setTarget(int pulse) { target = (int32_t)pulse * MOTION_ONE; }
+  int getTarget() const { return (int)(target / MOTION_ONE); }
+
+  /** Advance by dtMs and return the rounded pulse to command */
+  int update(unsigned long dtMs);
+
+  /**
+   * Follow a precomputed trajectory instead of the spring: move straight to
+   * pulse, limited only by maxVelocity over dtMs, and rest there (a later
+   * update() starts from standstill)
+   */
+  int track(int pulse, unsigned long dtMs);
+
+  int position() const { return (int)((pos + MOTION_ONE / 2) >> 16); }
+  int32_t velocity() const { return vel; }
+  bool settled() const { return pos == target && vel == 0; }
+
+private:
+  void step(int32_t dtMs);
+
+  MotionProfile prof;
+  int32_t maxStepMs;
+  int32_t pos;
+  int32_t vel;
+  int32_t target;
+};
+
+#endif // MOTION_ENGINE_H
@@ -0,0 +1,134 @@
+/**
+ * NunchuckLink.cpp
+ *
+ * See NunchuckLink.h
+ */
+
+#include "NunchuckLink.h"
+#include "EyeConfig.h"
+
+enum NunchuckLinkState {
+  NUNCHUCK_ABSENT,       // Waiting to retry the handshake
+  NUNCHUCK_HANDSHAKE,    // Init + ID read queued
+  NUNCHUCK_POLLING       // Found; one poll in flight per input tick
+};
+
+// Unencrypted-mode init, then the ID register
+static const uint8_t INIT_1[] = {0xF0, 0x55};
+static const uint8_t INIT_2[] = {0xFB, 0x00};
+static const uint8_t ID_REGISTER = 0xFA;
+static const uint8_t REPORT_REGISTER = 0x00;
+
+// Nunchuck ID (bytes 2-5; clones differ in the first two)
+static const uint8_t NUNCHUCK_ID[] PROGMEM = {0xA4, 0x20, 0x00, 0x00};
+
+NunchuckLink::NunchuckLink()
+  : state(NUNCHUCK_ABSENT), transfer(I2C_IDLE), failures(0), probeMs(0), lastServiceMs(0) {
+  memset(report, 0, sizeof(report));
+  memset(&counters, 0, sizeof(counters));
+  current.accelX = 0;
+  current.accelY = 0;
+  current.accelZ = 0;
+  halNunchuckReleased(current, NunchuckCalibration::CENTER);
+}
+
+void NunchuckLink::begin(unsigned long nowMs) {
+  queueHandshake(nowMs);
+}
+
+void NunchuckLink::service(unsigned long nowMs) {
+  lastServiceMs = nowMs;
+  collect(nowMs);
+
+  switch (state) {
+    case NUNCHUCK_ABSENT:
+      if (nowMs - probeMs >= NunchuckLinkSettings::RETRY_MS) queueHandshake(nowMs);
+      break;
+
+    case NUNCHUCK_HANDSHAKE:
+      break;
+
+    case NUNCHUCK_POLLING:
+      if (transfer == I2C_QUEUED) {
+        counters.busy++;
+      } else {
+        queuePoll();
+      }
+      break;
+  }
+}
+
+void NunchuckLink::read(NunchuckSample &sample) {
+  collect(lastServiceMs);
+  sample = current;
+}
+
+void NunchuckLink::collect(unsigned long nowMs) {
+  uint8_t status = transfer;
+  if (status == I2C_IDLE || status == I2C_QUEUED) return;
+  transfer = I2C_IDLE;
+
+  if (state == NUNCHUCK_HANDSHAKE) {
+    if (status == I2C_DONE && memcmp_P(&report[2], NUNCHUCK_ID, sizeof(NUNCHUCK_ID)) == 0) {
+      // Found: arm the first report, polls start next input tick
+      state = NUNCHUCK_POLLING;
+      failures = 0;
+      counters.connects++;
+      i2cQueue.write(NUNCHUCK_ADDRESS, &REPORT_REGISTER, 1);
+    } else {
+      state = NUNCHUCK_ABSENT;
+    }
+    return;
+  }
+
+  if (state != NUNCHUCK_POLLING) return;
+
+  if (status == I2C_DONE) {
+    failures = 0;
+    decode();
+    counters.reports++;
+    return;
+  }
+
+  counters.errors++;
+  if (++failures >= NunchuckLinkSettings::MAX_FAILURES) {
+    counters.disconnects++;
+    release(nowMs);
+  }
+}
+
+void NunchuckLink::queueHandshake(unsigned long nowMs) {
+  probeMs = nowMs;
+  if (!i2cQueue.fits(4, sizeof(INIT_1) + sizeof(INIT_2) + 1)) return;
+
+  i2cQueue.write(NUNCHUCK_ADDRESS, INIT_1, sizeof(INIT_1));
+  i2cQueue.write(NUNCHUCK_ADDRESS, INIT_2, sizeof(INIT_2));
+  i2cQueue.write(NUNCHUCK_ADDRESS, &ID_REGISTER, 1);
+  i2cQueue.read(NUNCHUCK_ADDRESS, report, sizeof(report), &transfer, NUNCHUCK_CONVERSION_US);
+  state = NUNCHUCK_HANDSHAKE;
+}
+
+void NunchuckLink::queuePoll() {
+  // Read and re-arm go together or not at all, or the pointer drifts
+  if (!i2cQueue.fits(2, 1)) return;
+
+  i2cQueue.read(NUNCHUCK_ADDRESS, report, sizeof(report), &transfer);
+  i2cQueue.write(NUNCHUCK_ADDRESS, &REPORT_REGISTER, 1);
+}
+
+void NunchuckLink::decode() {
+  current.joyX = report[0];
+  current.joyY = report[1];
+  current.accelX = (report[2] << 2) | ((report[5] >> 2) & 3);
+  current.accelY = (report[3] << 2) | ((report[5] >> 4) & 3);
+  current.accelZ = (report[4] << 2) | ((report[5] >> 6) & 3);
+  current.buttonZ = !(report[5] & 1);
+  current.buttonC = !(report[5] & 2);
+  current.connected = true;
+}
+
+void NunchuckLink::release(unsigned long nowMs) {
+  state = NUNCHUCK_ABSENT;
+  probeMs = nowMs;
+  halNunchuckReleased(current, NunchuckCalibration::CENTER);
+}
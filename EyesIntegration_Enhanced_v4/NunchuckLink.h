@@ -0,0 +1,88 @@
+/**
+ * NunchuckLink.h
+ *
+ * Background nunchuck driver on the shared I2C queue
+ *
+ * The old setup() polled for up to 5 s until a nunchuck answered, and
+ * every input tick read it synchronously (pointer write, conversion wait,
+ * 6-byte read - ~1 ms of CPU spent waiting on the bus). Here nothing
+ * waits:
+ *
+ *   service()  (input group)   takes the report of the last poll and
+ *                              queues the next one
+ *   read()     (any task)      copies the newest sample, picking up a
+ *                              poll that finished since service()
+ *
+ * A poll is [6-byte read][pointer write]: the write that arms the NEXT
+ * report trails the read, so its conversion time passes between ticks and
+ * the read ahead of each motion tick is the only thing on its path.
+ *
+ * HOT-PLUG:
+ * While nothing answers, the handshake (unencrypted init + ID check) is
+ * retried every NunchuckLinkSettings::RETRY_MS in the background. After
+ * MAX_FAILURES failed polls in a row the nunchuck counts as unplugged and
+ * reads as "hands off" (see halNunchuckReleased) until it is found again.
+ */
+
+#ifndef NUNCHUCK_LINK_H
+#define NUNCHUCK_LINK_H
+
+#include <Arduino.h>
+#include "EyeHAL.h"
+#include "I2CQueue.h"
+
+#define NUNCHUCK_ADDRESS 0x52
+#define NUNCHUCK_REPORT_SIZE 6
+
+// Nunchuck needs this long between a register write and reading it back
+#define NUNCHUCK_CONVERSION_US 200
+
+/**
+ * Bus time of the read that precedes each motion tick
+ */
+inline unsigned long nunchuckPollUs(unsigned long clockHz) {
+  return i2cTransferUs(clockHz, NUNCHUCK_REPORT_SIZE);
+}
+
+struct NunchuckStats {
+  unsigned long reports;     // Samples decoded
+  unsigned long errors;      // Polls that NACKed or failed
+  unsigned long busy;        // Input ticks that found the last poll still queued
+  unsigned int connects;     // Handshakes that found a nunchuck (replugs too)
+  unsigned int disconnects;
+};
+
+class NunchuckLink {
+public:
+  NunchuckLink();
+
+  /** Start looking for a nunchuck; returns immediately */
+  void begin(unsigned long nowMs);
+
+  /** Input group step: collect the finished poll, queue the next */
+  void service(unsigned long nowMs);
+
+  /** Newest sample (hands off while disconnected); never waits */
+  void read(NunchuckSample &sample);
+
+  bool connected() const { return current.connected; }
+  const NunchuckStats &stats() const { return counters; }
+
+private:
+  void collect(unsigned long nowMs);
+  void queueHandshake(unsigned long nowMs);
+  void queuePoll();
+  void decode();
+  void release(unsigned long nowMs);
+
+  uint8_t state;                   // NunchuckLinkState
+  uint8_t report[NUNCHUCK_REPORT_SIZE];
+  volatile uint8_t transfer;       // I2CStatus of the read in flight
+  uint8_t failures;                // Failed polls in a row
+  unsigned long probeMs;           // Last handshake attempt
+  unsigned long lastServiceMs;
+  NunchuckSample current;
+  NunchuckStats counters;
+};
+
+#endif // NUNCHUCK_LINK_H
@@ -0,0 +1,384 @@
+/**
+ * PerformanceLog.cpp
+ *
+ * See PerformanceLog.h
+ */
+
+#include "PerformanceLog.h"
+#include "EyeConfig.h"
+#include "CalibrationStore.h"
+
+#define TOKEN_STEP 0x00
+#define TOKEN_HOLD 0x40
+#define TOKEN_SAMPLE 0x80
+#define TOKEN_TYPE_MASK 0xC0
+#define SAMPLE_RESERVED 0x20
+
+#define SAMPLE_HAS_X 0x04
+#define SAMPLE_HAS_Y 0x08
+#define SAMPLE_HAS_DT 0x10
+
+#define HOLD_MAX 64
+
+static_assert(sizeof(PerformanceHeader) <= HAL_EEPROM_QUEUE_SIZE,
+              "PerformanceHeader must fit the EEPROM background queue");
+static_assert(CalibrationStoreSettings::EEPROM_ADDRESS + CALIBRATION_BLOB_SIZE <=
+                PerformanceSettings::EEPROM_ADDRESS ||
+              PerformanceSettings::EEPROM_ADDRESS + PerformanceSettings::EEPROM_SIZE <=
+                CalibrationStoreSettings::EEPROM_ADDRESS,
+              "PerformanceSettings: EEPROM area overlaps the calibration blob "
+              "(6 + 42 bytes per rig) - move EEPROM_ADDRESS, see ADDING A RIG");
+static_assert(PerformanceSettings::EEPROM_SIZE > sizeof(PerformanceHeader) + PERFORMANCE_TOKEN_MAX,
+              "PerformanceSettings: EEPROM_SIZE too small");
+#ifdef E2END
+static_assert(PerformanceSettings::EEPROM_ADDRESS + PerformanceSettings::EEPROM_SIZE <= E2END + 1,
+              "PerformanceSettings: EEPROM area does not fit in EEPROM");
+#endif
+
+uint8_t performanceVarint(int16_t value, uint8_t *out) {
+  uint16_t zigzag = value < 0 ? (uint16_t)(((uint16_t)-(value + 1) << 1) | 1) : (uint16_t)value << 1;
+  uint8_t n = 0;
+  while (zigzag >= 0x80) {
+    out[n++] = (uint8_t)(zigzag | 0x80);
+    zigzag >>= 7;
+  }
+  out[n++] = (uint8_t)zigzag;
+  return n;
+}
+
+static bool sameSample(const PerformanceSample &a, const PerformanceSample &b) {
+  return a.joyX == b.joyX && a.joyY == b.joyY && a.buttons == b.buttons && a.dtMs == b.dtMs;
+}
+
+static PerformanceSample restSample(uint8_t tickMs) {
+  PerformanceSample s = { NunchuckCalibration::CENTER, NunchuckCalibration::CENTER, 0, tickMs };
+  return s;
+}
+
+// ============================================================================
+// ENCODER
+// ============================================================================
+
+PerformanceEncoder::PerformanceEncoder() : last(restSample(0)), hold(0) {
+}
+
+void PerformanceEncoder::begin(uint8_t tickMs) {
+  last = restSample(tickMs);
+  hold = 0;
+}
+
+uint8_t PerformanceEncoder::add(const PerformanceSample &sample, uint8_t *out) {
+  uint8_t n = 0;
+  if (sameSample(sample, last)) {
+    if (++hold < HOLD_MAX) return 0;
+    out[n++] = TOKEN_HOLD | (hold - 1);
+    hold = 0;
+    return n;
+  }
+  n = finish(out);
+
+  int16_t dx = (int16_t)sample.joyX - last.joyX;
+  int16_t dy = (int16_t)sample.joyY - last.joyY;
+  if (sample.buttons == last.buttons && sample.dtMs == last.dtMs &&
+      dx >= -4 && dx <= 3 && dy >= -4 && dy <= 3) {
+    out[n++] = TOKEN_STEP | ((dx & 7) << 3) | (dy & 7);
+  } else {
+    uint8_t *token = &out[n++];
+    *token = TOKEN_SAMPLE | (sample.buttons & (PERFORMANCE_BUTTON_Z | PERFORMANCE_BUTTON_C));
+    if (dx != 0) {
+      *token |= SAMPLE_HAS_X;
+      n += performanceVarint(dx, &out[n]);
+    }
+    if (dy != 0) {
+      *token |= SAMPLE_HAS_Y;
+      n += performanceVarint(dy, &out[n]);
+    }
+    if (sample.dtMs != last.dtMs) {
+      *token |= SAMPLE_HAS_DT;
+      n += performanceVarint((int16_t)sample.dtMs - last.dtMs, &out[n]);
+    }
+  }
+  last = sample;
+  return n;
+}
+
+uint8_t PerformanceEncoder::finish(uint8_t *out) {
+  if (hold == 0) return 0;
+  out[0] = TOKEN_HOLD | (hold - 1);
+  hold = 0;
+  return 1;
+}
+
+// ============================================================================
+// DECODER
+// ============================================================================
+
+PerformanceDecoder::PerformanceDecoder()
+  : reader(NULL), readContext(NULL), offset(0), length(0), ticksLeft(0),
+    last(restSample(0)), hold(0) {
+}
+
+void PerformanceDecoder::begin(const PerformanceHeader &header, ReadFn read, void *context) {
+  reader = read;
+  readContext = context;
+  offset = 0;
+  length = header.length;
+  ticksLeft = header.ticks;
+  last = restSample(header.tickMs);
+  hold = 0;
+}
+
+bool PerformanceDecoder::readByte(uint8_t &b) {
+  if (offset >= length) return false;
+  b = reader(offset++, readContext);
+  return true;
+}
+
+bool PerformanceDecoder::readVarint(int16_t &value) {
+  uint16_t zigzag = 0;
+  for (uint8_t shift = 0; shift < 16; shift += 7) {
+    uint8_t b;
+    if (!readByte(b)) return false;
+    zigzag |= (uint16_t)(b & 0x7F) << shift;
+    if (!(b & 0x80)) {
+      value = (zigzag & 1) ? -(int16_t)(zigzag >> 1) - 1 : (int16_t)(zigzag >> 1);
+      return true;
+    }
+  }
+  return false;
+}
+
+bool PerformanceDecoder::next(PerformanceSample &sample) {
+  if (ticksLeft == 0) return false;
+
+  if (hold == 0) {
+    uint8_t token;
+    if (!readByte(token)) return false;
+
+    switch (token & TOKEN_TYPE_MASK) {
+      case TOKEN_STEP:
+        // 3-bit two's complement fields
+        last.joyX += (int8_t)((token >> 3) & 7) - (((token >> 3) & 4) ? 8 : 0);
+        last.joyY += (int8_t)(token & 7) - ((token & 4) ? 8 : 0);
+        break;
+
+      case TOKEN_HOLD:
+        hold = (token & 0x3F) + 1;
+        break;
+
+      case TOKEN_SAMPLE:
+        {
+          if (token & SAMPLE_RESERVED) return false;
+          int16_t delta;
+          if (token & SAMPLE_HAS_X) {
+            if (!readVarint(delta)) return false;
+            last.joyX += delta;
+          }
+          if (token & SAMPLE_HAS_Y) {
+            if (!readVarint(delta)) return false;
+            last.joyY += delta;
+          }
+          if (token & SAMPLE_HAS_DT) {
+            if (!readVarint(delta)) return false;
+            last.dtMs += delta;
+          }
+          last.buttons = token & (PERFORMANCE_BUTTON_Z | PERFORMANCE_BUTTON_C);
+        }
+        break;
+
+      default:
+        return false;
+    }
+  }
+  if (hold > 0) hold--;
+
+  ticksLeft--;
+  sample = last;
+  return true;
+}
+
+// ============================================================================
+// RECORDER
+// ============================================================================
+
+static uint8_t eepromByte(uint32_t offset, void *context) {
+  uint8_t b;
+  halEepromRead(*(uint16_t *)context + offset, &b, 1);
+  return b;
+}
+
+PerformanceRecorder::PerformanceRecorder(uint16_t address, uint16_t size, TelemetryLink *link)
+  : address(address), areaSize(size), telemetry(link),
+    dataAddress(address + sizeof(PerformanceHeader)), current(PERFORMANCE_IDLE),
+    ended(PERFORMANCE_END_NONE), toSerial(false), looping(false), fifoHead(0), fifoCount(0),
+    sent(0) {
+  memset(&header, 0, sizeof(header));
+}
+
+bool PerformanceRecorder::record(bool serial, uint8_t tickMs) {
+  if (current != PERFORMANCE_IDLE) return false;
+
+  memset(&header, 0, sizeof(header));
+  header.magic = PERFORMANCE_MAGIC;
+  header.version = PERFORMANCE_VERSION;
+  header.tickMs = tickMs;
+  header.crc = FRAME_CRC_INIT;
+  encoder.begin(tickMs);
+  fifoHead = 0;
+  fifoCount = 0;
+  sent = 0;
+  toSerial = serial;
+  ended = PERFORMANCE_END_NONE;
+
+  // The saved recording is void from its first overwritten byte on: the
+  // erased magic goes out ahead of the data
+  if (!toSerial) {
+    static const uint8_t ERASED[2] = { 0xFF, 0xFF };
+    if (halEepromQueue(address, ERASED, sizeof(ERASED)) != sizeof(ERASED)) return false;
+  }
+  current = toSerial ? PERFORMANCE_STREAMING : PERFORMANCE_RECORDING;
+  return true;
+}
+
+void PerformanceRecorder::stop() {
+  if (current == PERFORMANCE_REPLAYING) {
+    current = PERFORMANCE_IDLE;
+  } else if (recording()) {
+    end(PERFORMANCE_END_STOPPED);
+  }
+}
+
+/**
+ * Close the last hold; service() sends the rest and the header
+ */
+void PerformanceRecorder::end(uint8_t reason) {
+  uint8_t token[PERFORMANCE_TOKEN_MAX];
+  push(token, encoder.finish(token));
+  ended = reason;
+  current = PERFORMANCE_FINISHING;
+}
+
+bool PerformanceRecorder::saved(PerformanceHeader &out) const {
+  halEepromRead(address, &out, sizeof(out));
+  if (out.magic != PERFORMANCE_MAGIC || out.version != PERFORMANCE_VERSION ||
+      out.length > capacity() || out.tickMs == 0) {
+    return false;
+  }
+  uint16_t crc = FRAME_CRC_INIT;
+  uint16_t data = dataAddress;
+  for (uint16_t i = 0; i < out.length; i++) crc = frameCrcUpdate(crc, eepromByte(i, &data));
+  return crc == out.crc;
+}
+
+bool PerformanceRecorder::play(bool loop) {
+  if (current != PERFORMANCE_IDLE || halEepromQueued() > 0 || !saved(header)) return false;
+  decoder.begin(header, eepromByte, &dataAddress);
+  looping = loop;
+  current = PERFORMANCE_REPLAYING;
+  return true;
+}
+
+void PerformanceRecorder::add(const NunchuckSample &sample, unsigned long dtMs) {
+  if (!recording()) return;
+
+  PerformanceSample s;
+  s.joyX = constrain(sample.joyX, 0, 255);
+  s.joyY = constrain(sample.joyY, 0, 255);
+  s.buttons = (sample.buttonZ ? PERFORMANCE_BUTTON_Z : 0) | (sample.buttonC ? PERFORMANCE_BUTTON_C : 0);
+  s.dtMs = dtMs < 255 ? dtMs : 255;
+
+  // A token goes in whole, with room for the closing hold behind it
+  uint8_t token[PERFORMANCE_TOKEN_MAX];
+  PerformanceEncoder before = encoder;
+  uint8_t n = encoder.add(s, token);
+  if (!toSerial && header.length + n + 1 > capacity()) {
+    encoder = before;
+    end(PERFORMANCE_END_FULL);
+    return;
+  }
+  if (fifoCount + n + 1 > PERFORMANCE_FIFO_SIZE) {
+    encoder = before;
+    end(PERFORMANCE_END_OVERRUN);
+    return;
+  }
+  push(token, n);
+  header.ticks++;
+}
+
+void PerformanceRecorder::push(const uint8_t *data, uint8_t length) {
+  for (uint8_t i = 0; i < length; i++) {
+    fifo[(fifoHead + fifoCount++) % PERFORMANCE_FIFO_SIZE] = data[i];
+    header.crc = frameCrcUpdate(header.crc, data[i]);
+  }
+  header.length += length;
+}
+
+bool PerformanceRecorder::next(NunchuckSample &sample, unsigned long &dtMs) {
+  if (current != PERFORMANCE_REPLAYING) return false;
+
+  PerformanceSample s;
+  bool more = decoder.next(s);
+  if (!more && looping) {
+    decoder.begin(header, eepromByte, &dataAddress);
+    more = decoder.next(s);
+  }
+  if (!more) {
+    current = PERFORMANCE_IDLE;
+    return false;
+  }
+
+  sample.joyX = s.joyX;
+  sample.joyY = s.joyY;
+  sample.buttonZ = (s.buttons & PERFORMANCE_BUTTON_Z) != 0;
+  sample.buttonC = (s.buttons & PERFORMANCE_BUTTON_C) != 0;
+  sample.connected = true;
+  dtMs = s.dtMs;
+  return true;
+}
+
+void PerformanceRecorder::service() {
+  if (current == PERFORMANCE_RECORDING || current == PERFORMANCE_STREAMING) {
+    drain(toSerial ? PERFORMANCE_CHUNK_SIZE : 1);
+    return;
+  }
+  if (current != PERFORMANCE_FINISHING || !drain(1)) return;
+
+  // Everything is out: the header makes the recording valid
+  if (toSerial) {
+    if (!telemetry->send(FRAME_PERFORMANCE_END, &header, sizeof(header))) return;
+  } else {
+    if (halEepromQueued() > 0) return;
+    halEepromQueue(address, (const uint8_t *)&header, sizeof(header));
+  }
+  current = PERFORMANCE_IDLE;
+}
+
+/**
+ * Move FIFO bytes out while at least minimum are waiting; true once it is
+ * empty
+ */
+bool PerformanceRecorder::drain(uint8_t minimum) {
+  while (fifoCount > 0 && fifoCount >= minimum) {
+    uint8_t run = fifoCount;
+    if (toSerial) {
+      PerformanceChunk chunk;
+      chunk.offset = sent;
+      chunk.length = run < PERFORMANCE_CHUNK_SIZE ? run : PERFORMANCE_CHUNK_SIZE;
+      memset(chunk.data, 0, sizeof(chunk.data));
+      for (uint8_t i = 0; i < chunk.length; i++) {
+        chunk.data[i] = fifo[(fifoHead + i) % PERFORMANCE_FIFO_SIZE];
+      }
+      if (!telemetry->send(FRAME_PERFORMANCE_DATA, &chunk, sizeof(chunk))) break;
+      run = chunk.length;
+    } else {
+      // Contiguous part of the ring
+      if (fifoHead + run > PERFORMANCE_FIFO_SIZE) run = PERFORMANCE_FIFO_SIZE - fifoHead;
+      run = halEepromQueue(dataAddress + sent, &fifo[fifoHead], run);
+      if (run == 0) break;
+    }
+    fifoHead = (fifoHead + run) % PERFORMANCE_FIFO_SIZE;
+    fifoCount -= run;
+    sent += run;
+  }
+  return fifoCount == 0;
+}
@@ -0,0 +1,215 @@
+/**
+ * PerformanceLog.h
+ *
+ * Record and replay of manual nunchuck performances
+ *
+ * A session is logged as the nunchuck input the motion group read, one
+ * sample per tick - not as servo output. A replay feeds those samples back
+ * in place of the nunchuck, so it runs through the same control path
+ * (joystick filter, buttons, idle timeout, compositor) and the same log
+ * replayed in the host simulator shows what a firmware change does to a
+ * real performance.
+ *
+ * TOKENS (deltas to the previous sample; the first one is compared with
+ * a centered, released stick at the nominal tick length):
+ *
+ *   00xxxyyy              step: X and Y moved by -4..3, nothing else did
+ *   01nnnnnn              hold: the previous sample n + 1 more ticks (1-64)
+ *   100tYXcz ...          sample: buttons C and Z as given, then zigzag
+ *                         varints (7 bits a byte, low first) for a changed
+ *                         X, Y and tick length, in that order
+ *   101xxxxx 11xxxxxx     reserved (a log ends at one)
+ *
+ * A stick left alone costs a byte per 1.3 s (a jittery one ~17 B/s),
+ * slow movement a byte a tick, fast sweeps and button play 2-4. The UNO's
+ * EEPROM area holds tens of seconds of steady movement, minutes with the
+ * usual pauses; streamed over Serial (a few hundred B/s at worst) any
+ * length fits.
+ *
+ * LOG (in EEPROM at PerformanceSettings::EEPROM_ADDRESS; teledecode
+ * --performance writes the same layout to a file):
+ *   PerformanceHeader   magic, version, tick length, ticks, data length,
+ *                       CRC16 of the data
+ *   data                the tokens
+ *
+ * Recording never blocks: tokens wait in a small RAM FIFO and go out once
+ * a tick, to the EEPROM's background queue (halEepromQueue) or as
+ * FRAME_PERFORMANCE_DATA frames on the telemetry link. The header is
+ * written (or sent as FRAME_PERFORMANCE_END) after the last byte, so a
+ * recording cut short by a reset is never replayed.
+ */
+
+#ifndef PERFORMANCE_LOG_H
+#define PERFORMANCE_LOG_H
+
+#include <Arduino.h>
+#include "EyeHAL.h"
+#include "Telemetry.h"
+
+#define PERFORMANCE_MAGIC 0x9E7F
+#define PERFORMANCE_VERSION 1
+
+#define PERFORMANCE_TOKEN_MAX 8         // Longest add() output: hold + sample
+#define PERFORMANCE_CHUNK_SIZE 16       // Data bytes per Serial frame
+#define PERFORMANCE_FIFO_SIZE 32
+
+// PerformanceSample.buttons
+#define PERFORMANCE_BUTTON_Z 0x01
+#define PERFORMANCE_BUTTON_C 0x02
+
+struct PerformanceHeader {
+  uint16_t magic;
+  uint8_t version;
+  uint8_t tickMs;            // Nominal motion tick (the first sample's dt)
+  uint32_t ticks;
+  uint32_t length;           // Data bytes that follow
+  uint16_t crc;              // SerialFraming's CRC16 over the data
+} __attribute__((packed));
+
+/**
+ * Data bytes at offset (FRAME_PERFORMANCE_DATA)
+ */
+struct PerformanceChunk {
+  uint32_t offset;
+  uint8_t length;
+  uint8_t data[PERFORMANCE_CHUNK_SIZE];
+} __attribute__((packed));
+
+/**
+ * What the motion group read in one tick
+ */
+struct PerformanceSample {
+  uint8_t joyX;
+  uint8_t joyY;
+  uint8_t buttons;           // PERFORMANCE_BUTTON_*
+  uint8_t dtMs;              // Tick length
+};
+
+class PerformanceEncoder {
+public:
+  PerformanceEncoder();
+
+  void begin(uint8_t tickMs);
+
+  /** One tick's sample → token bytes in out; 0 while a hold builds up */
+  uint8_t add(const PerformanceSample &sample, uint8_t *out);
+
+  /** The hold still building, if any (end of the log) */
+  uint8_t finish(uint8_t *out);
+
+private:
+  PerformanceSample last;
+  uint8_t hold;              // Repeats of last not yet written
+};
+
+class PerformanceDecoder {
+public:
+  /** Data byte at offset */
+  typedef uint8_t (*ReadFn)(uint32_t offset, void *context);
+
+  PerformanceDecoder();
+
+  void begin(const PerformanceHeader &header, ReadFn read, void *context);
+
+  /** Next tick's sample; false once the log (or a corrupt token) ends */
+  bool next(PerformanceSample &sample);
+
+private:
+  bool readByte(uint8_t &b);
+  bool readVarint(int16_t &value);
+
+  ReadFn reader;
+  void *readContext;
+  uint32_t offset;
+  uint32_t length;
+  uint32_t ticksLeft;
+  PerformanceSample last;
+  uint8_t hold;
+};
+
+/**
+ * Zigzag varint (sign in bit 0) → out; returns its length (1-3 bytes)
+ */
+uint8_t performanceVarint(int16_t value, uint8_t *out);
+
+enum PerformanceMode {
+  PERFORMANCE_IDLE,
+  PERFORMANCE_RECORDING,     // To EEPROM
+  PERFORMANCE_STREAMING,     // To Serial
+  PERFORMANCE_FINISHING,     // Stopped, last bytes and header going out
+  PERFORMANCE_REPLAYING
+};
+
+/**
+ * How the last recording ended
+ */
+enum PerformanceEnd {
+  PERFORMANCE_END_NONE,      // Still running, or never started
+  PERFORMANCE_END_STOPPED,   // stop()
+  PERFORMANCE_END_FULL,      // EEPROM area full
+  PERFORMANCE_END_OVERRUN    // Output fell behind (FIFO full)
+};
+
+class PerformanceRecorder {
+public:
+  PerformanceRecorder(uint16_t address, uint16_t size, TelemetryLink *link);
+
+  /** Start recording, to EEPROM or streamed over Serial; false while busy */
+  bool record(bool toSerial, uint8_t tickMs);
+
+  /** End the recording (its last bytes still go out) or the replay */
+  void stop();
+
+  /** Replay the EEPROM recording; false if there is no valid one */
+  bool play(bool loop);
+
+  /** Motion tick while recording: the sample the nunchuck gave */
+  void add(const NunchuckSample &sample, unsigned long dtMs);
+
+  /**
+   * Motion tick while replaying: the recorded sample in place of the
+   * nunchuck, and the tick length it had. False once the replay is over.
+   */
+  bool next(NunchuckSample &sample, unsigned long &dtMs);
+
+  /** Move recorded bytes on (EEPROM queue or Serial frames), once a tick */
+  void service();
+
+  uint8_t mode() const { return current; }
+  bool recording() const { return current == PERFORMANCE_RECORDING || current == PERFORMANCE_STREAMING; }
+  bool replaying() const { return current == PERFORMANCE_REPLAYING; }
+  uint8_t lastEnd() const { return ended; }
+
+  /** Current (or last) recording */
+  uint32_t ticks() const { return header.ticks; }
+  uint32_t bytes() const { return header.length; }
+  uint16_t capacity() const { return areaSize - sizeof(PerformanceHeader); }
+
+  /** Header of the recording saved in EEPROM; false if none is valid */
+  bool saved(PerformanceHeader &out) const;
+
+private:
+  void push(const uint8_t *data, uint8_t length);
+  void end(uint8_t reason);
+  bool drain(uint8_t minimum);
+
+  uint16_t address;
+  uint16_t areaSize;
+  TelemetryLink *telemetry;
+
+  uint16_t dataAddress;      // EEPROM address of the data (decoder context)
+  uint8_t current;
+  uint8_t ended;
+  bool toSerial;             // Recording streams (else: EEPROM)
+  bool looping;
+  PerformanceHeader header;  // Of the recording being made / replayed
+  PerformanceEncoder encoder;
+  PerformanceDecoder decoder;
+
+  uint8_t fifo[PERFORMANCE_FIFO_SIZE];
+  uint8_t fifoHead;          // Oldest byte
+  uint8_t fifoCount;
+  uint32_t sent;             // Data bytes out of the FIFO
+};
+
+#endif // PERFORMANCE_LOG_H
@@ -0,0 +1,69 @@
+/**
+ * PoseCompositor.cpp
+ *
+ * See PoseCompositor.h
+ */
+
+#include "PoseCompositor.h"
+
+#define HALF_POS (CHANNEL_POS_FULL / 2)
+
+/**
+ * Lid pose per expression: left upper, left lower, right upper, right lower
+ */
+static const uint8_t EXPRESSION_LIDS[EXPRESSION_COUNT][4] PROGMEM = {
+  { 0, 0, 0, 0 },                      // NONE (never applied)
+  { HALF_POS, 30, HALF_POS, 30 },      // SLEEPY
+  { 80, 90, 80, 90 },                  // SQUINT
+  { 0, 0, 0, 0 },                      // WIDE
+  { HALF_POS, 20, 0, 0 },              // SKEPTIC
+};
+
+static_assert(ExpressionSettings::FADE_MS > 0, "ExpressionSettings: FADE_MS must be > 0");
+
+// Fade time → Q8 weight, as a multiply (Q8 step per ms)
+static const uint32_t FADE_STEP = ((uint32_t)POSE_WEIGHT_FULL << 8) / ExpressionSettings::FADE_MS;
+
+ExpressionLayer::ExpressionLayer() : current(EXPRESSION_NONE), startMs(0), endMs(0) {
+}
+
+void ExpressionLayer::show(uint8_t expression, unsigned long nowMs, unsigned long holdMs) {
+  if (expression >= EXPRESSION_COUNT) return;
+  current = expression;
+  startMs = nowMs;
+  endMs = holdMs ? nowMs + ExpressionSettings::FADE_MS + holdMs : 0;
+}
+
+void ExpressionLayer::clear(unsigned long nowMs) {
+  if (current != EXPRESSION_NONE && (endMs == 0 || (long)(endMs - nowMs) > 0)) endMs = nowMs;
+}
+
+/**
+ * Fade-in ramp, capped by the fade-out ramp once that has begun (a clear
+ * during the fade-in turns it around without a jump)
+ */
+uint16_t ExpressionLayer::weight(unsigned long nowMs) {
+  uint32_t in = ((uint32_t)(nowMs - startMs) * FADE_STEP) >> 8;
+  uint32_t w = in < POSE_WEIGHT_FULL ? in : POSE_WEIGHT_FULL;
+
+  if (endMs != 0 && (long)(nowMs - endMs) >= 0) {
+    uint32_t out = ((uint32_t)(nowMs - endMs) * FADE_STEP) >> 8;
+    if (out >= POSE_WEIGHT_FULL) {
+      current = EXPRESSION_NONE;
+      return 0;
+    }
+    if (POSE_WEIGHT_FULL - out < w) w = POSE_WEIGHT_FULL - out;
+  }
+  return (uint16_t)w;
+}
+
+void ExpressionLayer::apply(unsigned long nowMs, PoseFrame &pose) {
+  if (current == EXPRESSION_NONE) return;
+  uint16_t w = weight(nowMs);
+  if (w == 0) return;
+
+  for (uint8_t i = 0; i < 4; i++) {
+    pose.blend(CH_L_UPPER + i, pgm_read_byte(&EXPRESSION_LIDS[current][i]), w);
+  }
+  pose.layers |= 1 << LAYER_EXPRESSION;
+}
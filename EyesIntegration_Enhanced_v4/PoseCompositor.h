@@ -0,0 +1,101 @@
+/**
+ * PoseCompositor.h
+ *
+ * One pose per rig per tick, built from behavior layers
+ *
+ * Gaze, idle, blinks and clips used to stage servos on their own, in
+ * whatever order the sketch happened to call them, so the last writer won
+ * and a channel could be set several times in one tick. Now behaviors only
+ * contribute to a PoseFrame; EyeRig::compose() stacks the layers bottom
+ * to top, then runs the eyes through the motion engine, clamps every
+ * channel once and stages the six outputs - the only place a rig touches
+ * the ServoBus.
+ *
+ *   LAYER_GAZE        eyes: joystick / host / center target
+ *                     lids: rest on the vertical gaze, or the host's hold
+ *   LAYER_IDLE        eyes: idle gaze (SaccadeEngine.h), saccades tracked
+ *   LAYER_EXPRESSION  lids: preset pose, faded in and out by weight
+ *   LAYER_BLINK       lids: blink depth, weighted by the blink's closure
+ *   LAYER_CLIP        whatever the playing clip drives, full weight
+ *
+ * A layer either sets a channel or blends it toward its own value by a
+ * Q8 weight (256 = replace): value += (target - value) · weight / 256.
+ * Adding a behavior is one more layer in compose(), not another writer.
+ *
+ * Values are normalized positions (0 .. CHANNEL_POS_FULL, ChannelTable.h).
+ */
+
+#ifndef POSE_COMPOSITOR_H
+#define POSE_COMPOSITOR_H
+
+#include <Arduino.h>
+#include "ChannelTable.h"
+
+#define POSE_WEIGHT_FULL 256        // Q8
+
+enum PoseLayer {
+  LAYER_GAZE,
+  LAYER_IDLE,
+  LAYER_EXPRESSION,
+  LAYER_BLINK,
+  LAYER_CLIP,
+  LAYER_COUNT
+};
+
+struct PoseFrame {
+  int16_t value[CHANNEL_COUNT];
+  uint8_t layers;                   // Bit n = PoseLayer n contributed
+  bool trackEyes;                   // Eyes follow the values directly (MotionAxis::track)
+
+  void set(uint8_t channel, int16_t v) { value[channel] = v; }
+
+  void blend(uint8_t channel, int16_t target, uint16_t weight) {
+    value[channel] += (int16_t)(((int32_t)(target - value[channel]) * weight) >> 8);
+  }
+};
+
+// ============================================================================
+// EXPRESSIONS
+// ============================================================================
+
+/**
+ * Lid presets (PoseCompositor.cpp). Positions are normalized, so
+ * CHANNEL_POS_FULL / 2 is each lid's calibrated HALF.
+ */
+enum Expression {
+  EXPRESSION_NONE,
+  EXPRESSION_SLEEPY,      // Upper lids at HALF
+  EXPRESSION_SQUINT,      // Both lids partly in
+  EXPRESSION_WIDE,        // Lids fully open, whatever the gaze
+  EXPRESSION_SKEPTIC,     // One upper lid at HALF
+  EXPRESSION_COUNT
+};
+
+/**
+ * Expression layer: fades a preset in, holds it, fades it out
+ * (ExpressionSettings::FADE_MS each way)
+ */
+class ExpressionLayer {
+public:
+  ExpressionLayer();
+
+  /** Show expression for holdMs (0 = until cleared), starting now */
+  void show(uint8_t expression, unsigned long nowMs, unsigned long holdMs);
+
+  /** Fade the current expression out */
+  void clear(unsigned long nowMs);
+
+  uint8_t expression() const { return current; }
+
+  /** Blend the preset over the lids at nowMs */
+  void apply(unsigned long nowMs, PoseFrame &pose);
+
+private:
+  uint16_t weight(unsigned long nowMs);
+
+  uint8_t current;
+  unsigned long startMs;
+  unsigned long endMs;            // Fade-out start, 0 = held until cleared
+};
+
+#endif // POSE_COMPOSITOR_H
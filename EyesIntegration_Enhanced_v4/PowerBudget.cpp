@@ -0,0 +1,139 @@
+/**
+ * PowerBudget.cpp
+ *
+ * See PowerBudget.h
+ */
+
+#include "PowerBudget.h"
+
+// Servo no-load speed in output counts per second
+static const unsigned long SLEW_COUNTS_PER_SEC = outputPulse(PowerSettings::SLEW_PER_SEC);
+
+static uint16_t saturate16(unsigned long value) {
+  return value > 0xFFFF ? 0xFFFF : (uint16_t)value;
+}
+
+PowerBudget::PowerBudget(ServoBus *bus, const ChannelDescriptor *servos, uint16_t budgetMa)
+  : bus(bus), servos(servos), budgetMa(budgetMa), lastLimited(false), slewStep(1),
+    moveScale(0) {
+  memset(target, 0, sizeof(target));
+  memset(sent, 0, sizeof(sent));
+  memset(demand, 0, sizeof(demand));
+  memset(behind, 0, sizeof(behind));
+  memset(&counters, 0, sizeof(counters));
+}
+
+void PowerBudget::set(const ChannelDescriptor *d, uint16_t pulse) {
+  if (d >= servos && d < servos + POWER_SERVOS) {
+    target[d - servos] = pulse;
+  } else {
+    bus->set(descriptorBoard(d), descriptorOutput(d), pulse);
+  }
+}
+
+void PowerBudget::apply(unsigned long dtMs) {
+  lastLimited = false;
+  if (dtMs == 0) {
+    for (uint8_t i = 0; i < POWER_SERVOS; i++) {
+      if (target[i] == 0) continue;
+      sent[i] = target[i];
+      bus->set(descriptorBoard(&servos[i]), descriptorOutput(&servos[i]), sent[i]);
+    }
+    return;
+  }
+
+  // The model for this tick length: one division, then multiplies only
+  unsigned long slew = SLEW_COUNTS_PER_SEC * dtMs / 1000;
+  slewStep = slew < 1 ? 1 : slew > 0x7FFF ? 0x7FFF : (uint16_t)slew;
+  moveScale = ((unsigned long)(PowerSettings::STALL_MA - PowerSettings::MOVE_MA) << 8) / slewStep;
+  unsigned long velocity = (unsigned long)EYE_MAX_VELOCITY * dtMs / 1000;
+  uint16_t catchUp = velocity < 1 ? 1 : velocity > 0x7FFF ? 0x7FFF : (uint16_t)velocity;
+
+  // An eye that was held back catches up no faster than it may move
+  // (SafetyLimits::MAX_DELTA_PER_UPDATE), not in one jump
+  uint8_t channel = 0;
+  for (uint8_t i = 0; i < POWER_SERVOS; i++) {
+    if (sent[i] == 0) sent[i] = target[i];
+    demand[i] = target[i] > sent[i] ? target[i] - sent[i] : sent[i] - target[i];
+    if (behind[i] && channel < CH_L_UPPER && demand[i] > catchUp) demand[i] = catchUp;
+    if (++channel == CHANNEL_COUNT) channel = 0;
+  }
+
+  uint16_t lidCap = POWER_NO_CAP;
+  uint16_t eyeCap = POWER_NO_CAP;
+  unsigned long lidMa = total(true, lidCap);
+  unsigned long eyeMa = total(false, eyeCap);
+  unsigned long wanted = lidMa + eyeMa;
+  if (budgetMa != 0 && wanted > budgetMa) {
+    // Lids first, against the eyes' smallest step; the eyes get the rest
+    lidCap = largestCap(true, total(false, 1));
+    lidMa = total(true, lidCap);
+    eyeCap = largestCap(false, lidMa);
+    eyeMa = total(false, eyeCap);
+    lastLimited = true;
+    counters.limitedTicks++;
+  }
+
+  channel = 0;
+  for (uint8_t i = 0; i < POWER_SERVOS; i++) {
+    uint16_t cap = channel >= CH_L_UPPER ? lidCap : eyeCap;
+    if (++channel == CHANNEL_COUNT) channel = 0;
+    uint16_t step = demand[i] < cap ? demand[i] : cap;
+    uint16_t distance = target[i] > sent[i] ? target[i] - sent[i] : sent[i] - target[i];
+    behind[i] = step < distance;
+    if (step == 0) continue;
+
+    sent[i] = target[i] > sent[i] ? sent[i] + step : sent[i] - step;
+    bus->set(descriptorBoard(&servos[i]), descriptorOutput(&servos[i]), sent[i]);
+  }
+
+  counters.demandMa = saturate16(wanted);
+  counters.drawMa = saturate16(lidMa + eyeMa);
+  if (counters.drawMa > counters.peakMa) counters.peakMa = counters.drawMa;
+  if (counters.demandMa > counters.peakDemandMa) counters.peakDemandMa = counters.demandMa;
+}
+
+/**
+ * One servo moving step counts this tick, mA
+ */
+uint16_t PowerBudget::current(uint16_t step) const {
+  if (step == 0) return PowerSettings::HOLD_MA;
+  if (step >= slewStep) return PowerSettings::STALL_MA;
+  return PowerSettings::MOVE_MA + (uint16_t)((step * moveScale) >> 8);
+}
+
+/**
+ * The lids' (or eyes') current, each step capped at cap, mA
+ */
+unsigned long PowerBudget::total(bool lids, uint16_t cap) const {
+  uint8_t first = lids ? CH_L_UPPER : CH_HORIZONTAL;
+  uint8_t last = lids ? CH_R_LOWER : CH_VERTICAL;
+  unsigned long sum = 0;
+  for (uint8_t rig = 0; rig < POWER_SERVOS; rig += CHANNEL_COUNT) {
+    for (uint8_t i = rig + first; i <= rig + last; i++) {
+      sum += current(demand[i] < cap ? demand[i] : cap);
+    }
+  }
+  return sum;
+}
+
+/**
+ * Largest cap on the lids' (or eyes') step that keeps the total in budget
+ * with the other group drawing otherMa: POWER_NO_CAP if running flat out
+ * fits, at least 1. Binary search - the total only grows with the cap.
+ */
+uint16_t PowerBudget::largestCap(bool lids, unsigned long otherMa) const {
+  uint16_t fits = 1;
+  uint16_t over = slewStep;
+  if (total(lids, over) + otherMa <= budgetMa) return POWER_NO_CAP;
+
+  while (over - fits > 1) {
+    uint16_t cap = fits + (over - fits) / 2;
+    if (total(lids, cap) + otherMa <= budgetMa) {
+      fits = cap;
+    } else {
+      over = cap;
+    }
+  }
+  return fits;
+}
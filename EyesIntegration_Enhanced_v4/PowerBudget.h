@@ -0,0 +1,109 @@
+/**
+ * PowerBudget.h
+ *
+ * Keeps the estimated servo supply current under a budget
+ *
+ * All servos share one 5 V supply, and the moments everything moves at
+ * once - four lids slamming shut, both eye axes starting a look-around -
+ * are when it sags: brownouts, I2C glitches. Rigs stage their pulses here
+ * instead of on the ServoBus; once per output tick apply() estimates what
+ * every servo would draw moving to its staged pulse and, if the total is
+ * over budget, moves the busiest ones less far this tick. They catch up on
+ * the ticks after - rigs restage every channel every motion tick.
+ *
+ * CURRENT MODEL (per servo, PowerSettings in EyeConfig.h):
+ *
+ *   step 0 (holding)               HOLD_MA
+ *   step 1 .. slew (moving)        MOVE_MA → STALL_MA, linear in the step
+ *   step ≥ slew (flat out)         STALL_MA
+ *
+ * step: output counts the pulse moves this tick; slew: how far the servo
+ * itself gets in a tick (SLEW_PER_SEC). A servo commanded at or past its
+ * own speed runs its motor flat out, close to stall current.
+ *
+ * LIMITING: a common cap on the step, largest that fits the budget. Small
+ * moves stay untouched, only the large ones slow down - most motion per
+ * milliamp. Lids are capped first with the eyes at their smallest step,
+ * then the eyes share what the lids left: blinks keep their snap and the
+ * eyes wait out the few ticks a blink closes, then catch up at their
+ * velocity limit (EYE_MAX_VELOCITY), not in one jump. No servo stops
+ * entirely (the cap is at least one count), so a budget too small for a
+ * tick's demand slows it down instead of freezing it.
+ *
+ * With the budget at 0 nothing is limited; the estimate is still made.
+ */
+
+#ifndef POWER_BUDGET_H
+#define POWER_BUDGET_H
+
+#include <Arduino.h>
+#include "ChannelTable.h"
+#include "ServoBus.h"
+
+#define POWER_SERVOS (RIG_COUNT * CHANNEL_COUNT)
+#define POWER_NO_CAP 0xFFFF
+
+// One tick at least: every servo holding, one running flat out
+static_assert(PowerSettings::BUDGET_MA == 0 ||
+              PowerSettings::BUDGET_MA >=
+                (unsigned long)POWER_SERVOS * PowerSettings::HOLD_MA + PowerSettings::STALL_MA,
+              "PowerSettings: BUDGET_MA too small for the servos in EYE_RIG_LIST");
+static_assert(PowerSettings::HOLD_MA <= PowerSettings::MOVE_MA &&
+              PowerSettings::MOVE_MA <= PowerSettings::STALL_MA,
+              "PowerSettings: HOLD_MA <= MOVE_MA <= STALL_MA");
+
+struct PowerStats {
+  uint16_t drawMa;           // Last tick, as sent
+  uint16_t demandMa;         // Last tick, had every servo moved as staged
+  uint16_t peakMa;           // Highest drawMa since boot
+  uint16_t peakDemandMa;     // Highest demandMa since boot
+  unsigned long limitedTicks;
+};
+
+class PowerBudget {
+public:
+  /** servos: descriptors of every servo on the supply (channelTable) */
+  PowerBudget(ServoBus *bus, const ChannelDescriptor *servos, uint16_t budgetMa);
+
+  /** Stage a pulse (EyeRig); descriptors outside servos go to the bus as is */
+  void set(const ChannelDescriptor *d, uint16_t pulse);
+
+  /**
+   * Move every servo toward its staged pulse, within the budget, and stage
+   * that on the bus (once per output tick, before flush). dtMs 0: the first
+   * pose - where the servos are is unknown, so it goes out as staged.
+   */
+  void apply(unsigned long dtMs);
+
+  /** 0 = estimate only */
+  void setBudget(uint16_t ma) { budgetMa = ma; }
+  uint16_t budget() const { return budgetMa; }
+
+  /** The last tick was slowed down */
+  bool limited() const { return lastLimited; }
+
+  const PowerStats &stats() const { return counters; }
+
+private:
+  uint16_t current(uint16_t step) const;
+  unsigned long total(bool lids, uint16_t cap) const;
+  uint16_t largestCap(bool lids, unsigned long otherMa) const;
+
+  ServoBus *bus;
+  const ChannelDescriptor *servos;
+  uint16_t budgetMa;
+  bool lastLimited;
+
+  uint16_t target[POWER_SERVOS];    // Staged by the rigs
+  uint16_t sent[POWER_SERVOS];      // Staged on the bus (0 = none yet)
+  uint16_t demand[POWER_SERVOS];    // This tick's step, output counts
+  bool behind[POWER_SERVOS];        // Held back short of target last tick
+
+  // This tick's current model: MOVE_MA + step × moveScale / 256 up to slew
+  uint16_t slewStep;
+  unsigned long moveScale;
+
+  PowerStats counters;
+};
+
+#endif // POWER_BUDGET_H
@@ -0,0 +1,256 @@
+/**
+ * SaccadeEngine.cpp
+ *
+ * See SaccadeEngine.h
+ */
+
+#include "SaccadeEngine.h"
+#include "ChannelTable.h"
+
+static_assert(SaccadeSettings::H_RANGE_DEG > 0 && SaccadeSettings::V_RANGE_DEG > 0,
+              "SaccadeSettings: eye range must be at least 1 degree");
+static_assert(SaccadeSettings::FIXATION_MIN_MS > 0 &&
+              SaccadeSettings::FIXATION_MIN_MS <= SaccadeSettings::FIXATION_MAX_MS,
+              "SaccadeSettings: FIXATION_MIN_MS must be > 0 and <= FIXATION_MAX_MS");
+static_assert(SaccadeSettings::DURATION_BASE_MS > 0, "SaccadeSettings: DURATION_BASE_MS must be > 0");
+
+// ============================================================================
+// TABLES
+// ============================================================================
+
+#define PROFILE_SHIFT 4                            // 16 segments
+#define PROFILE_POINTS ((1 << PROFILE_SHIFT) + 1)
+#define PROFILE_ONE 4096                           // Q12
+
+/**
+ * Cumulative displacement (Q12) at 17 evenly spaced points of the
+ * saccade's duration: integrals of beta-shaped velocity profiles
+ * v(u) ∝ u^(a-1)·(1-u)^(b-1), symmetric (a = b = 3) for the smallest
+ * class, peaking earlier with a longer tail as amplitude grows.
+ */
+static const uint16_t SACCADE_PROFILES[][PROFILE_POINTS] PROGMEM = {
+  // ≤ 2°     a 3.0  b 3.0
+  { 0, 9, 66, 200, 424, 737, 1127, 1573, 2048, 2523, 2969, 3359, 3672, 3896, 4030, 4087, 4096 },
+  // ≤ 5°     a 2.8  b 3.2
+  { 0, 17, 103, 288, 572, 944, 1380, 1853, 2333, 2789, 3196, 3533, 3789, 3961, 4055, 4091, 4096 },
+  // ≤ 10°    a 2.6  b 3.4
+  { 0, 29, 159, 404, 753, 1181, 1654, 2141, 2610, 3034, 3394, 3677, 3880, 4007, 4071, 4093, 4096 },
+  // ≤ 20°    a 2.4  b 3.6
+  { 0, 51, 238, 554, 970, 1446, 1943, 2428, 2872, 3254, 3562, 3792, 3948, 4039, 4082, 4095, 4096 },
+  // > 20°    a 2.2  b 3.8
+  { 0, 86, 347, 743, 1221, 1733, 2239, 2706, 3113, 3446, 3701, 3882, 3997, 4060, 4088, 4095, 4096 },
+};
+
+// Upper amplitude of each class but the last, Q4 degrees
+static const uint16_t PROFILE_CLASS_Q4[] PROGMEM = { 2 * 16, 5 * 16, 10 * 16, 20 * 16 };
+#define PROFILE_CLASSES (sizeof(SACCADE_PROFILES) / sizeof(SACCADE_PROFILES[0]))
+
+/**
+ * Saccade amplitude at 17 evenly spaced quantiles, Q4 degrees:
+ * 1° + exponential with a 6° mean, capped at 30°
+ */
+static const uint16_t AMPLITUDE_QUANTILES[PROFILE_POINTS] PROGMEM = {
+  16, 22, 29, 36, 44, 52, 61, 71, 83, 95, 110, 128, 149, 177, 216, 282, 480
+};
+
+/**
+ * Saccade / drift directions (cos, sin in Q7), biased toward horizontal:
+ * 0°, ±12°, ±28°, ±50°, 90° on each side
+ */
+static const int8_t DIRECTIONS[][2] PROGMEM = {
+  { 127, 0 }, { 124, 26 }, { 112, 60 }, { 82, 97 }, { 0, 127 },
+  { -82, 97 }, { -112, 60 }, { -124, 26 }, { -127, 0 }, { -124, -26 },
+  { -112, -60 }, { -82, -97 }, { 0, -127 }, { 82, -97 }, { 112, -60 }, { 124, -26 },
+};
+#define DIRECTION_COUNT (sizeof(DIRECTIONS) / sizeof(DIRECTIONS[0]))
+
+// ============================================================================
+// ENGINE
+// ============================================================================
+
+SaccadeEngine::SaccadeEngine()
+  : profile(SACCADE_PROFILES[0]), elapsedMs(0), durationMs(0), timeStepQ8(0),
+    amplitudeQ4(0), micro(false), fixationLeftMs(0), saccadeCount(0) {
+  for (uint8_t i = 0; i < 2; i++) {
+    field[i].low = field[i].center = field[i].high = CHANNEL_POS_FULL / 2;
+    field[i].rangeDeg = 1;
+    unitsPerDegQ8[i] = 0;
+    pos[i] = fixation[i] = start[i] = delta[i] = drift[i] = 0;
+    driftVelocity[i] = 0;
+  }
+}
+
+void SaccadeEngine::begin(const SaccadeField &h, const SaccadeField &v,
+                          unsigned int firstFixationMs) {
+  setField(h, v);
+  for (uint8_t i = 0; i < 2; i++) {
+    pos[i] = (int32_t)field[i].center << 8;
+    fixation[i] = pos[i];
+  }
+  durationMs = 0;
+  amplitudeQ4 = 0;
+  saccadeCount = 0;
+  startFixation(firstFixationMs);
+}
+
+void SaccadeEngine::setField(const SaccadeField &h, const SaccadeField &v) {
+  field[0] = h;
+  field[1] = v;
+  for (uint8_t i = 0; i < 2; i++) {
+    unitsPerDegQ8[i] = ((uint32_t)CHANNEL_POS_FULL << 8) / field[i].rangeDeg;
+  }
+}
+
+void SaccadeEngine::fixate(unsigned int ms) {
+  durationMs = 0;
+  fixation[0] = pos[0];
+  fixation[1] = pos[1];
+  startFixation(ms);
+}
+
+uint8_t SaccadeEngine::update(unsigned long dtMs) {
+  uint8_t events = 0;
+
+  if (durationMs == 0) {
+    // Fixation: drift, corrected by a microsaccade once it strays too far
+    for (uint8_t i = 0; i < 2; i++) {
+      drift[i] += (int32_t)driftVelocity[i] * (int32_t)dtMs;
+      pos[i] = fixation[i] + (drift[i] >> 8);
+    }
+    fixationLeftMs -= (long)dtMs;
+
+    if (fixationLeftMs <= 0) {
+      plan();
+      events = SACCADE_EVENT_START;
+    } else {
+      int32_t limitH = ((int32_t)unitsPerDegQ8[0] * SaccadeSettings::DRIFT_LIMIT_X10_DEG) / 10;
+      int32_t limitV = ((int32_t)unitsPerDegQ8[1] * SaccadeSettings::DRIFT_LIMIT_X10_DEG) / 10;
+      if (abs(pos[0] - fixation[0]) > limitH || abs(pos[1] - fixation[1]) > limitV) {
+        startSaccade(fixation[0], fixation[1], true);
+        events = SACCADE_EVENT_START | SACCADE_EVENT_MICRO;
+      }
+    }
+    if (durationMs == 0) return events;
+    dtMs = 0;   // The saccade starts from here; its first step is next tick
+  }
+
+  // Saccade: profile lookup at normalized time
+  elapsedMs += dtMs;
+  if (elapsedMs >= durationMs) {
+    pos[0] = start[0] + delta[0];
+    pos[1] = start[1] + delta[1];
+    durationMs = 0;
+    events |= SACCADE_EVENT_LAND | (micro ? SACCADE_EVENT_MICRO : 0);
+    if (!micro) {
+      startFixation(SaccadeSettings::FIXATION_MIN_MS +
+                    (random(0, 64) * random(0, 64) *
+                     (long)(SaccadeSettings::FIXATION_MAX_MS - SaccadeSettings::FIXATION_MIN_MS) >> 12));
+    } else {
+      // A microsaccade continues the fixation it corrected, drifting anew
+      startFixation(fixationLeftMs);
+    }
+    return events;
+  }
+
+  uint16_t u = (uint16_t)(((uint32_t)elapsedMs * timeStepQ8) >> 8);   // Q12
+  uint8_t segment = u >> (12 - PROFILE_SHIFT);
+  int32_t frac = u & ((1 << (12 - PROFILE_SHIFT)) - 1);
+  int32_t p0 = pgm_read_word(&profile[segment]);
+  int32_t p1 = pgm_read_word(&profile[segment + 1]);
+  int32_t p = p0 + (((p1 - p0) * frac) >> (12 - PROFILE_SHIFT));
+
+  pos[0] = start[0] + ((delta[0] * p) >> 12);
+  pos[1] = start[1] + ((delta[1] * p) >> 12);
+  return events;
+}
+
+/**
+ * Next fixation point, from the amplitude/direction tables or back toward
+ * center, kept inside the field
+ */
+void SaccadeEngine::plan() {
+  // Eccentricity: how far out toward the field edge, percent (larger axis)
+  uint8_t eccentricity = 0;
+  for (uint8_t i = 0; i < 2; i++) {
+    int32_t offset = pos[i] - ((int32_t)field[i].center << 8);
+    int32_t span = (int32_t)(offset > 0 ? field[i].high - field[i].center
+                                        : field[i].center - field[i].low) << 8;
+    if (span <= 0) continue;
+    int32_t percent = (abs(offset) * 100) / span;
+    if (percent > eccentricity) eccentricity = percent > 100 ? 100 : percent;
+  }
+
+  int32_t to[2];
+  if (random(0, 100) < (long)eccentricity * SaccadeSettings::CENTER_PULL_PERCENT / 100) {
+    // Back to near center (within 1°)
+    for (uint8_t i = 0; i < 2; i++) {
+      to[i] = ((int32_t)field[i].center << 8) +
+              random(-(long)unitsPerDegQ8[i], (long)unitsPerDegQ8[i] + 1);
+    }
+  } else {
+    // Amplitude quantile, linear between table points
+    uint16_t q = random(0, 4096);
+    uint8_t k = q >> (12 - PROFILE_SHIFT);
+    int32_t a0 = pgm_read_word(&AMPLITUDE_QUANTILES[k]);
+    int32_t a1 = pgm_read_word(&AMPLITUDE_QUANTILES[k + 1]);
+    int32_t amplitude = a0 + (((a1 - a0) * (q & 0xFF)) >> 8);   // Q4 degrees
+
+    uint8_t d = random(0, DIRECTION_COUNT);
+    for (uint8_t i = 0; i < 2; i++) {
+      int32_t step = (amplitude * (int8_t)pgm_read_byte(&DIRECTIONS[d][i]) *
+                      (int32_t)unitsPerDegQ8[i]) >> 11;             // Q4 · Q7
+      // Mirror a jump that would leave the field, then keep it inside
+      to[i] = pos[i] + step;
+      if (to[i] != fieldClamp(i, to[i])) to[i] = pos[i] - step;
+    }
+  }
+
+  to[0] = fieldClamp(0, to[0]);
+  to[1] = fieldClamp(1, to[1]);
+  startSaccade(to[0], to[1], false);
+  saccadeCount++;
+}
+
+void SaccadeEngine::startSaccade(int32_t toH, int32_t toV, bool isMicro) {
+  start[0] = pos[0];
+  start[1] = pos[1];
+  delta[0] = toH - pos[0];
+  delta[1] = toV - pos[1];
+  fixation[0] = toH;
+  fixation[1] = toV;
+  micro = isMicro;
+
+  // Amplitude in Q4 degrees: max + 3/8 min of the axis angles (within ~7%)
+  uint32_t degH = ((uint32_t)abs(delta[0]) << 4) / unitsPerDegQ8[0];
+  uint32_t degV = ((uint32_t)abs(delta[1]) << 4) / unitsPerDegQ8[1];
+  uint32_t amplitude = degH > degV ? degH + (3 * degV >> 3) : degV + (3 * degH >> 3);
+  amplitudeQ4 = amplitude > 0xFFFF ? 0xFFFF : amplitude;
+
+  uint8_t row = 0;
+  while (row < PROFILE_CLASSES - 1 && amplitudeQ4 > pgm_read_word(&PROFILE_CLASS_Q4[row])) row++;
+  profile = SACCADE_PROFILES[row];
+
+  durationMs = SaccadeSettings::DURATION_BASE_MS +
+               (amplitude * SaccadeSettings::DURATION_X10_MS_PER_DEG) / 160;
+  timeStepQ8 = ((uint32_t)PROFILE_ONE << 8) / durationMs;
+  elapsedMs = 0;
+}
+
+void SaccadeEngine::startFixation(unsigned int ms) {
+  fixationLeftMs = ms;
+
+  // Drift: constant speed, random direction, for the whole fixation
+  uint8_t d = random(0, DIRECTION_COUNT);
+  for (uint8_t i = 0; i < 2; i++) {
+    drift[i] = 0;
+    driftVelocity[i] = ((int32_t)SaccadeSettings::DRIFT_X10_DEG_PER_SEC *
+                        (int8_t)pgm_read_byte(&DIRECTIONS[d][i]) * unitsPerDegQ8[i]) /
+                       (10L * 1000L / 2);                            // Q8 · Q7 / s → Q16 / ms
+  }
+}
+
+int32_t SaccadeEngine::fieldClamp(uint8_t axis, int32_t value) const {
+  int32_t low = (int32_t)field[axis].low << 8;
+  int32_t high = (int32_t)field[axis].high << 8;
+  return value < low ? low : (value > high ? high : value);
+}
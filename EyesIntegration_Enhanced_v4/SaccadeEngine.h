@@ -0,0 +1,120 @@
+/**
+ * SaccadeEngine.h
+ *
+ * Idle gaze: fixations, drift and main-sequence saccades, fixed point
+ *
+ * The old idle picked one of five look directions every 2-4 s and glided
+ * there through the joystick's spring - the same slow, even move every
+ * time. Real eyes hold still (fixate), creep slightly (drift), and jump to
+ * the next point with a saccade whose duration and speed follow the
+ * amplitude ("main sequence": small jumps are short, large ones longer
+ * but faster at peak, with a longer braking phase).
+ *
+ * MODEL (SaccadeSettings in EyeConfig.h):
+ * - Fixation: time drawn between FIXATION_MIN_MS and FIXATION_MAX_MS,
+ *   skewed toward short; the eye drifts at DRIFT_X10_DEG_PER_SEC in a
+ *   random direction, and a microsaccade snaps it back once it has
+ *   strayed DRIFT_LIMIT_X10_DEG
+ * - Next target: amplitude from a PROGMEM inverse-CDF (mostly small
+ *   jumps, mean ~7°), direction from a horizontally biased table; the
+ *   farther out the eye is, the likelier (CENTER_PULL_PERCENT) it returns
+ *   to near center instead. Targets stay inside the idle field
+ *   (IdleSettings::IDLE_MOVEMENT_RANGE of each half of the calibrated range)
+ * - Saccade: duration = DURATION_BASE_MS + DURATION_X10_MS_PER_DEG × A,
+ *   shape from SACCADE_PROFILES (cumulative displacement over normalized
+ *   time, one row per amplitude class, skew growing with amplitude)
+ *
+ * EXECUTION:
+ * Everything with a division happens once per saccade (planning). A tick
+ * during a saccade is one multiply for the normalized time, one profile
+ * lookup with linear interpolation and one multiply per axis; a fixation
+ * tick is two multiply-adds. Time is elapsed milliseconds, never tick
+ * count, so a saccade takes as long at 50 Hz as at 200 Hz - at 50 Hz a
+ * short saccade is just one or two samples of its profile.
+ *
+ * Positions are normalized (0 .. CHANNEL_POS_FULL, see ChannelTable.h),
+ * kept in Q8 so drift accumulates below one unit; EyeRig maps them to
+ * pulses and runs saccades through MotionAxis::track(), fixations through
+ * the spring.
+ */
+
+#ifndef SACCADE_ENGINE_H
+#define SACCADE_ENGINE_H
+
+#include <Arduino.h>
+
+// update() events
+#define SACCADE_EVENT_START 0x01
+#define SACCADE_EVENT_LAND  0x02
+#define SACCADE_EVENT_MICRO 0x04    // With START / LAND: a drift correction
+
+/**
+ * One axis of the idle field, normalized positions
+ */
+struct SaccadeField {
+  int16_t low;
+  int16_t center;
+  int16_t high;
+  uint8_t rangeDeg;                 // Eye rotation over 0 .. CHANNEL_POS_FULL
+};
+
+class SaccadeEngine {
+public:
+  SaccadeEngine();
+
+  /** Start at the field's center, fixating for firstFixationMs */
+  void begin(const SaccadeField &h, const SaccadeField &v, unsigned int firstFixationMs);
+
+  /** Replace the field (recalibrated); the next target is picked inside it */
+  void setField(const SaccadeField &h, const SaccadeField &v);
+
+  /** Advance by dtMs; returns SACCADE_EVENT_* bits */
+  uint8_t update(unsigned long dtMs);
+
+  /** End any saccade and fixate where the eye is for ms (e.g. after a clip) */
+  void fixate(unsigned int ms);
+
+  uint16_t positionH() const { return (uint16_t)((pos[0] + 128) >> 8); }
+  uint16_t positionV() const { return (uint16_t)((pos[1] + 128) >> 8); }
+  uint16_t targetH() const { return (uint16_t)((fixation[0] + 128) >> 8); }
+  uint16_t targetV() const { return (uint16_t)((fixation[1] + 128) >> 8); }
+
+  bool saccading() const { return durationMs != 0; }
+
+  /** Amplitude of the current / last saccade, degrees */
+  uint8_t amplitudeDeg() const { return (uint8_t)((amplitudeQ4 + 8) >> 4); }
+
+  /** Saccades since begin() (microsaccades not counted) */
+  uint16_t count() const { return saccadeCount; }
+
+private:
+  void plan();
+  void startSaccade(int32_t toH, int32_t toV, bool micro);
+  void startFixation(unsigned int ms);
+  int32_t fieldClamp(uint8_t axis, int32_t value) const;
+
+  SaccadeField field[2];
+  uint16_t unitsPerDegQ8[2];        // Q8 normalized units per degree
+
+  int32_t pos[2];                   // Q8 normalized
+  int32_t fixation[2];              // Q8, fixation point / saccade target
+
+  // Saccade in flight (durationMs == 0: fixating)
+  int32_t start[2];
+  int32_t delta[2];
+  const uint16_t *profile;          // PROGMEM row of SACCADE_PROFILES
+  uint16_t elapsedMs;
+  uint16_t durationMs;
+  uint16_t timeStepQ8;              // Q12 normalized time per ms, Q8
+  uint16_t amplitudeQ4;
+  bool micro;
+
+  // Fixation
+  long fixationLeftMs;
+  int32_t drift[2];                 // Q16 normalized, offset from fixation
+  int16_t driftVelocity[2];         // Q16 normalized per ms
+
+  uint16_t saccadeCount;
+};
+
+#endif // SACCADE_ENGINE_H
@@ -0,0 +1,54 @@
+/**
+ * SerialFraming.h
+ *
+ * Frame format for binary data on the Serial port
+ *
+ *   0xA5 0x5A | type | seq | payload (fixed size per type) | CRC16 (LE)
+ *
+ * - seq counts frames per direction, so a receiver can spot gaps
+ * - types 0x01-0x0F go board → host, 0x10 and up host → board
+ * - CRC-16/CCITT, same as avr-libc's _crc_ccitt_update (init 0xFFFF),
+ *   computed over type, seq and payload
+ *
+ * Receivers hunt for the sync pair and check the CRC, so text printed to
+ * the same port between frames is skipped rather than misread.
+ * All multi-byte fields are little-endian (native on AVR and x86).
+ */
+
+#ifndef SERIAL_FRAMING_H
+#define SERIAL_FRAMING_H
+
+#include <Arduino.h>
+
+#define FRAME_SYNC0 0xA5
+#define FRAME_SYNC1 0x5A
+#define FRAME_HEADER_SIZE 4      // sync, sync, type, seq
+#define FRAME_CRC_SIZE 2
+#define FRAME_OVERHEAD (FRAME_HEADER_SIZE + FRAME_CRC_SIZE)
+#define FRAME_CRC_INIT 0xFFFF
+
+/**
+ * Frame types (one payload layout each)
+ */
+enum FrameType {
+  FRAME_TELEMETRY_TICK = 0x01,     // TelemetryTick, every motion tick
+  FRAME_TELEMETRY_TIMING = 0x02,   // TelemetryTiming, one per rate group
+  FRAME_PERFORMANCE_DATA = 0x03,   // PerformanceChunk, while streaming a recording
+  FRAME_PERFORMANCE_END = 0x04,    // PerformanceHeader, after the last chunk
+  FRAME_CHUCK_SESSION = 0x05,      // NunchuckCharacterization: NunchuckSessionStats
+  FRAME_CHUCK_AXIS = 0x06,         // NunchuckCharacterization: NunchuckAxisStats, one per axis
+  FRAME_GAZE_COMMAND = 0x10        // GazeCommandPayload, host → board
+};
+
+inline uint16_t frameCrcUpdate(uint16_t crc, uint8_t data) {
+  data ^= (uint8_t)crc;
+  data ^= data << 4;
+  return ((((uint16_t)data << 8) | (crc >> 8)) ^ (uint8_t)(data >> 4) ^ ((uint16_t)data << 3));
+}
+
+inline uint16_t frameCrc(const uint8_t *data, uint8_t length, uint16_t crc = FRAME_CRC_INIT) {
+  for (uint8_t i = 0; i < length; i++) crc = frameCrcUpdate(crc, data[i]);
+  return crc;
+}
+
+#endif // SERIAL_FRAMING_H
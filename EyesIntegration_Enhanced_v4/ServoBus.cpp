@@ -0,0 +1,50 @@
+/**
+ * ServoBus.cpp
+ *
+ * See ServoBus.h
+ */
+
+#include "ServoBus.h"
+
+ServoBus::ServoBus(ServoFrame *frames, uint8_t count, uint16_t budgetBytes)
+  : frames(frames), boardTotal(count), nextBoard(0),
+    budgetBytes(budgetBytes < SERVO_BUS_MIN_BUDGET ? SERVO_BUS_MIN_BUDGET : budgetBytes) {
+  memset(&stats, 0, sizeof(stats));
+}
+
+uint16_t ServoBus::flush() {
+  stats.boards = 0;
+  stats.transactions = 0;
+  stats.channels = 0;
+  stats.busBytes = 0;
+
+  for (uint8_t i = 0; i < boardTotal; i++) {
+    uint8_t b = nextBoard + i;
+    if (b >= boardTotal) b -= boardTotal;
+
+    ServoFrame &frame = frames[b];
+    frame.flush(budgetBytes - stats.busBytes);
+    const ServoFrameStats &f = frame.lastFlush();
+    if (f.transactions > 0) stats.boards++;
+    stats.transactions += f.transactions;
+    stats.channels += f.channels;
+    stats.busBytes += f.busBytes;
+
+    if (frame.pending()) {
+      // Budget spent: this board resumes first next tick
+      nextBoard = b;
+      stats.deferred++;
+      return stats.busBytes;
+    }
+  }
+
+  nextBoard = 0;
+  return stats.busBytes;
+}
+
+bool ServoBus::pending() const {
+  for (uint8_t i = 0; i < boardTotal; i++) {
+    if (frames[i].pending()) return true;
+  }
+  return false;
+}
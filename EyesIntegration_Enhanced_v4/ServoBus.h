@@ -0,0 +1,80 @@
+/**
+ * ServoBus.h
+ *
+ * Output scheduler for every PCA9685 sharing the I2C bus
+ *
+ * Holds one ServoFrame per board (SERVO_BOARD_LIST in EyeConfig.h). Rigs
+ * stage pulses by (board, channel) during the motion tick; the output group
+ * calls flush() once, which walks the boards and sends each one's changed
+ * channels as auto-increment bursts - one pass over the bus per tick, not
+ * one per rig or per servo.
+ *
+ * BUS BUDGET:
+ * A fully changed board costs 70 bytes (3 bursts) - about 6.5 ms at
+ * 100 kHz - so four boards no longer fit a 20 ms tick. flush() stops before
+ * the first burst that would exceed the budget (or that the I2C queue has
+ * no room for - bursts are queued, not sent inline). Unsent channels stay
+ * dirty and go out next tick with their newest value; the next pass starts
+ * at the board and channel where this one stopped, so no board starves.
+ */
+
+#ifndef SERVO_BUS_H
+#define SERVO_BUS_H
+
+#include <Arduino.h>
+#include "ServoFrame.h"
+
+// Largest single burst: address + register + SERVO_FRAME_MAX_BURST channels
+#define SERVO_BUS_MIN_BUDGET (2 + 4 * SERVO_FRAME_MAX_BURST)
+
+/**
+ * Bytes the bus moves in budgetUs at clockHz (9 clocks per byte with ACK)
+ */
+inline uint16_t servoBusBudget(unsigned long clockHz, unsigned long budgetUs) {
+  unsigned long bytes = budgetUs * (clockHz / 1000) / 9000;
+  if (bytes < SERVO_BUS_MIN_BUDGET) return SERVO_BUS_MIN_BUDGET;
+  return bytes > 0xFFFF ? 0xFFFF : (uint16_t)bytes;
+}
+
+struct ServoBusStats {
+  uint8_t boards;          // Boards written by the last flush
+  uint8_t transactions;    // I2C transactions used by the last flush
+  uint8_t channels;        // Channels written by the last flush
+  uint16_t busBytes;       // Bytes on the wire
+  unsigned long deferred;  // Flushes that hit the budget (since boot)
+};
+
+class ServoBus {
+public:
+  /** frames: one per board, in SERVO_BOARD_LIST order */
+  ServoBus(ServoFrame *frames, uint8_t count, uint16_t budgetBytes);
+
+  /** Stage a pulse; unknown boards/channels are ignored */
+  void set(uint8_t board, uint8_t channel, uint16_t pulse) {
+    if (board < boardTotal) frames[board].set(channel, pulse);
+  }
+
+  uint16_t get(uint8_t board, uint8_t channel) const {
+    return board < boardTotal && channel < SERVO_FRAME_CHANNELS ? frames[board].get(channel) : 0;
+  }
+
+  /** Send changed channels across all boards, within the budget */
+  uint16_t flush();
+
+  /** Changed channels not sent yet */
+  bool pending() const;
+
+  uint8_t boardCount() const { return boardTotal; }
+  ServoFrame &board(uint8_t index) { return frames[index]; }
+  uint16_t budget() const { return budgetBytes; }
+  const ServoBusStats &lastFlush() const { return stats; }
+
+private:
+  ServoFrame *frames;
+  uint8_t boardTotal;
+  uint8_t nextBoard;       // Where the next pass starts
+  uint16_t budgetBytes;
+  ServoBusStats stats;
+};
+
+#endif // SERVO_BUS_H
@@ -0,0 +1,145 @@
+/**
+ * ServoFrame.cpp
+ *
+ * See ServoFrame.h
+ */
+
+#include "ServoFrame.h"
+#include "EyeHAL.h"
+#include "I2CQueue.h"
+
+// PCA9685 registers
+static const uint8_t PCA9685_MODE1 = 0x00;
+static const uint8_t PCA9685_LED0_ON_L = 0x06;
+static const uint8_t PCA9685_PRESCALE = 0xFE;
+
+// MODE1 bits
+static const uint8_t MODE1_RESTART = 0x80;
+static const uint8_t MODE1_AI = 0x20;
+static const uint8_t MODE1_SLEEP = 0x10;
+
+// Settling times of the Adafruit driver's begin() + setPWMFreq(), as bus holds
+static const uint16_t RESET_HOLD_US = 10000;
+static const uint16_t WAKE_HOLD_US = 5000;
+
+// Register writes in the init sequence
+static const uint8_t INIT_WRITES = 5;
+
+static_assert(I2C_QUEUE_BYTES >= 1 + 4 * SERVO_FRAME_MAX_BURST,
+              "I2C_QUEUE_BYTES must hold one SERVO_FRAME_MAX_BURST burst");
+
+static void writeRegister(uint8_t address, uint8_t reg, uint8_t value,
+                          uint16_t holdUs = 0, volatile uint8_t *status = NULL) {
+  uint8_t data[2] = {reg, value};
+  i2cQueue.write(address, data, sizeof(data), status, holdUs);
+}
+
+ServoFrame::ServoFrame(uint8_t address)
+  : i2cAddress(address), dirty(0), used(0), known(0), resume(0), init(I2C_IDLE) {
+  memset(staged, 0, sizeof(staged));
+  memset(sent, 0, sizeof(sent));
+  memset(&stats, 0, sizeof(stats));
+}
+
+void ServoFrame::begin(uint8_t prescale) {
+  // More boards than the queue holds at once: let the previous ones finish
+  if (!i2cQueue.fits(INIT_WRITES, 2 * INIT_WRITES)) halI2CFlush();
+
+  // Same sequence as Adafruit_PWMServoDriver begin() + setPWMFreq()
+  writeRegister(i2cAddress, PCA9685_MODE1, MODE1_RESTART);
+  writeRegister(i2cAddress, PCA9685_MODE1, MODE1_SLEEP, RESET_HOLD_US);
+  writeRegister(i2cAddress, PCA9685_PRESCALE,
+                prescale < PCA9685_PRESCALE_MIN ? PCA9685_PRESCALE_MIN : prescale);
+  writeRegister(i2cAddress, PCA9685_MODE1, 0);
+
+  // Bursts need register auto-increment; the last write reports the outcome
+  init = I2C_QUEUED;
+  writeRegister(i2cAddress, PCA9685_MODE1, MODE1_RESTART | MODE1_AI, WAKE_HOLD_US, &init);
+  invalidate();
+}
+
+void ServoFrame::invalidate() {
+  known = 0;
+  dirty = used;
+}
+
+void ServoFrame::set(uint8_t channel, uint16_t pulse) {
+  if (channel >= SERVO_FRAME_CHANNELS) return;
+
+  uint16_t bit = (uint16_t)1 << channel;
+  staged[channel] = pulse;
+  used |= bit;
+
+  // A value set back to what the chip already holds is clean again
+  if (!(known & bit) || pulse != sent[channel]) {
+    dirty |= bit;
+  } else {
+    dirty &= ~bit;
+  }
+}
+
+uint16_t ServoFrame::flush(uint16_t maxBytes) {
+  stats.channels = 0;
+  stats.transactions = 0;
+  stats.busBytes = 0;
+
+  // Scan from the resume point to the top, then from 0 up to it
+  uint8_t start = resume;
+  resume = 0;
+  for (uint8_t pass = 0; pass < 2 && dirty != 0; pass++) {
+    uint8_t channel = pass == 0 ? start : 0;
+    uint8_t end = pass == 0 ? SERVO_FRAME_CHANNELS : start;
+
+    while (channel < end && dirty != 0) {
+      if (!(dirty & ((uint16_t)1 << channel))) {
+        channel++;
+        continue;
+      }
+
+      // Extend the run over adjacent dirty channels, up to one burst
+      uint8_t first = channel;
+      uint8_t count = 0;
+      while (channel < end && count < SERVO_FRAME_MAX_BURST &&
+             (dirty & ((uint16_t)1 << channel))) {
+        channel++;
+        count++;
+      }
+
+      // Over budget or the bus queue is full: resume here next flush
+      uint16_t bytes = 2 + 4 * count;   // Address + register + data
+      if (stats.busBytes + bytes > maxBytes ||
+          !queueBurst(first, count)) {
+        resume = first;
+        return stats.busBytes;
+      }
+
+      for (uint8_t c = first; c < first + count; c++) {
+        sent[c] = staged[c];
+        known |= (uint16_t)1 << c;
+        dirty &= ~((uint16_t)1 << c);
+      }
+      stats.channels += count;
+      stats.transactions++;
+      stats.busBytes += bytes;
+    }
+  }
+
+  return stats.busBytes;
+}
+
+/**
+ * One auto-increment write: LEDn_ON_L of the first channel, then ON = 0
+ * and OFF = pulse for each channel
+ */
+bool ServoFrame::queueBurst(uint8_t first, uint8_t count) {
+  uint8_t data[1 + 4 * SERVO_FRAME_MAX_BURST];
+  data[0] = PCA9685_LED0_ON_L + 4 * first;
+  for (uint8_t i = 0; i < count; i++) {
+    uint16_t pulse = staged[first + i];
+    data[1 + 4 * i] = 0;
+    data[2 + 4 * i] = 0;
+    data[3 + 4 * i] = pulse & 0xFF;
+    data[4 + 4 * i] = pulse >> 8;
+  }
+  return i2cQueue.write(i2cAddress, data, 1 + 4 * count);
+}
@@ -0,0 +1,111 @@
+/**
+ * ServoFrame.h
+ *
+ * Dirty-tracked, burst-coalesced frame writer for one PCA9685
+ *
+ * The control code sets channel targets as often as it likes during a tick;
+ * nothing touches the bus until flush(). Flush sends only channels whose
+ * value changed since the last flush, and sends each run of adjacent
+ * changed channels as ONE auto-increment I2C transaction:
+ *
+ *   per-channel writes:  6 × (addr + reg + 4 data) = 36 bytes, 6 STARTs
+ *   one burst (ch 0-5):  addr + reg + 6 × 4 data   = 26 bytes, 1 START
+ *   eyes parked:         nothing                   =  0 bytes
+ *
+ * Bursts are queued on i2cQueue and go out in the background; a burst the
+ * queue can't take stays dirty for the next flush. Bus bytes of the last
+ * flush are kept for reporting (bytes per tick).
+ *
+ * A flush may be given a byte budget (ServoBus shares one bus between
+ * boards): it stops before the first burst that wouldn't fit, and the next
+ * flush resumes at that channel so high channels can't starve.
+ */
+
+#ifndef SERVO_FRAME_H
+#define SERVO_FRAME_H
+
+#include <Arduino.h>
+
+// PCA9685 has 16 channels
+#define SERVO_FRAME_CHANNELS 16
+
+// Register + 7 channels × 4 bytes = 29 bytes: fits the 32-byte TWI buffer of
+// other drivers and keeps one burst a small slice of the I2CQueue ring
+#define SERVO_FRAME_MAX_BURST 7
+
+// Frame = 4096 counts of (prescale + 1) oscillator cycles
+#define PCA9685_COUNTS 4096
+#define PCA9685_OSCILLATOR_HZ 25000000UL   // Nominal; each chip is off by a few %
+#define PCA9685_PRESCALE_MIN 3
+
+/**
+ * Prescale of the fastest frame rate at or below maxHz
+ */
+constexpr uint8_t pca9685Prescale(unsigned long oscillatorHz, unsigned long maxHz) {
+  return (uint8_t)((oscillatorHz + PCA9685_COUNTS * maxHz - 1) / (PCA9685_COUNTS * maxHz) - 1);
+}
+
+struct ServoFrameStats {
+  uint8_t channels;        // Channels written by the last flush
+  uint8_t transactions;    // I2C transactions used by the last flush
+  uint16_t busBytes;       // Bytes on the wire (address + register + data)
+};
+
+class ServoFrame {
+public:
+  explicit ServoFrame(uint8_t address);
+
+  /**
+   * Queue the PCA9685 init (frame rate from prescale, register
+   * auto-increment on)
+   * Does not wait: the reset and oscillator delays are bus holds, so bursts
+   * flushed right after go out as soon as the chip is ready. initStatus()
+   * reports the outcome (I2C_NACK: no board at this address)
+   */
+  void begin(uint8_t prescale);
+
+  /** I2CStatus of the init: I2C_QUEUED until the chip is running */
+  uint8_t initStatus() const { return init; }
+
+  /**
+   * Forget what the chip holds so the next flush sends every set channel
+   * (call after the shield is (re)initialized)
+   */
+  void invalidate();
+
+  /** Stage a channel's pulse for the next flush */
+  void set(uint8_t channel, uint16_t pulse);
+
+  /** Last staged pulse for a channel */
+  uint16_t get(uint8_t channel) const { return staged[channel]; }
+
+  /** Send changed channels; returns bus bytes used */
+  uint16_t flush() { return flush(0xFFFF); }
+
+  /**
+   * Send changed channels, as many bursts as fit in maxBytes
+   * The rest stay dirty for the next flush
+   */
+  uint16_t flush(uint16_t maxBytes);
+
+  /** Changed channels not sent yet */
+  bool pending() const { return dirty != 0; }
+
+  uint8_t address() const { return i2cAddress; }
+  const ServoFrameStats &lastFlush() const { return stats; }
+
+private:
+  bool queueBurst(uint8_t first, uint8_t count);
+
+  uint8_t i2cAddress;
+  uint16_t staged[SERVO_FRAME_CHANNELS];
+  uint16_t sent[SERVO_FRAME_CHANNELS];
+  uint16_t dirty;          // Bit n = channel n differs from the chip
+  uint16_t used;           // Bit n = channel n has ever been set
+  uint16_t known;          // Bit n = sent[n] is what the chip holds
+  uint8_t resume;          // First channel to scan (after a budget cut)
+  volatile uint8_t init;   // I2CStatus of the last init write
+  ServoFrameStats stats;
+};
+
+#endif // SERVO_FRAME_H
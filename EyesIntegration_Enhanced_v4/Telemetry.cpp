@@ -0,0 +1,57 @@
+/**
+ * Telemetry.cpp
+ *
+ * See Telemetry.h
+ */
+
+#include "Telemetry.h"
+
+TelemetryLink::TelemetryLink() : head(0), tail(0), sequence(0) {
+  counters.frames = 0;
+  counters.drops = 0;
+  counters.peakUsed = 0;
+}
+
+bool TelemetryLink::send(uint8_t type, const void *payload, uint8_t length) {
+  // One slot stays empty so head == tail always means "empty"
+  uint8_t space = (TELEMETRY_BUFFER_SIZE - 1) - pending();
+  if ((uint16_t)length + FRAME_OVERHEAD > space) {
+    counters.drops++;
+    return false;
+  }
+
+  const uint8_t *bytes = (const uint8_t *)payload;
+  uint16_t crc = frameCrcUpdate(FRAME_CRC_INIT, type);
+  crc = frameCrcUpdate(crc, sequence);
+  crc = frameCrc(bytes, length, crc);
+
+  put(FRAME_SYNC0);
+  put(FRAME_SYNC1);
+  put(type);
+  put(sequence++);
+  for (uint8_t i = 0; i < length; i++) put(bytes[i]);
+  put((uint8_t)crc);
+  put((uint8_t)(crc >> 8));
+
+  counters.frames++;
+  if (pending() > counters.peakUsed) counters.peakUsed = pending();
+  return true;
+}
+
+uint8_t TelemetryLink::drain() {
+  uint8_t moved = 0;
+  int room = Serial.availableForWrite();
+
+  // At most two contiguous chunks (before and after the wrap)
+  while (room > 0 && head != tail) {
+    uint8_t at = tail & TELEMETRY_BUFFER_MASK;
+    int chunk = TELEMETRY_BUFFER_SIZE - at;
+    if (chunk > pending()) chunk = pending();
+    if (chunk > room) chunk = room;
+    Serial.write(&buffer[at], chunk);
+    tail += chunk;
+    moved += chunk;
+    room -= chunk;
+  }
+  return moved;
+}
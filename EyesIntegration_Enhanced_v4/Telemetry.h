@@ -0,0 +1,109 @@
+/**
+ * Telemetry.h
+ *
+ * Non-blocking binary telemetry over Serial
+ *
+ * printDebug() used ~15 Serial.print calls of text per line; once the
+ * 64-byte UART buffer filled, every further print blocked the control
+ * loop. Here each tick becomes ONE fixed-size framed record (see
+ * SerialFraming.h), queued into a RAM ring buffer and drained only as far
+ * as Serial.availableForWrite() allows - never a blocking write.
+ *
+ * A record is queued whole or not at all: when the ring is full it is
+ * dropped and counted (the count rides along in every tick record), so
+ * the stream never contains half frames and logging can never slow the
+ * motion down.
+ *
+ * 38 bytes per tick at 50 Hz = 1900 B/s, ~17% of 115200 baud.
+ * Decode on the PC with HostSim's teledecode (→ CSV).
+ */
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <Arduino.h>
+#include "SerialFraming.h"
+
+// Ring size, a power of two up to 256: the uint8_t indices run free and
+// are masked (a tick record is 40 bytes, one timing record 24)
+#define TELEMETRY_BUFFER_SIZE 128
+#define TELEMETRY_BUFFER_MASK (TELEMETRY_BUFFER_SIZE - 1)
+
+#if TELEMETRY_BUFFER_SIZE > 256 || (TELEMETRY_BUFFER_SIZE & TELEMETRY_BUFFER_MASK) != 0
+#error "TELEMETRY_BUFFER_SIZE must be a power of two up to 256"
+#endif
+
+// TelemetryTick.flags
+#define TELEMETRY_FLAG_BUTTON_Z  0x01
+#define TELEMETRY_FLAG_BUTTON_C  0x02
+#define TELEMETRY_FLAG_CONNECTED 0x04
+#define TELEMETRY_FLAG_BLINKING  0x08
+#define TELEMETRY_FLAG_RECORDING 0x10   // Input is being recorded (PerformanceLog.h)
+#define TELEMETRY_FLAG_REPLAYING 0x20   // Input comes from a recording
+#define TELEMETRY_FLAG_POWER_LIMITED 0x40  // Moves slowed to the current budget (PowerBudget.h)
+#define TELEMETRY_FLAG_TILT      0x80   // Gaze input is the nunchuck's tilt (TiltGaze.h)
+
+/**
+ * One motion tick (FRAME_TELEMETRY_TICK)
+ */
+struct TelemetryTick {
+  uint32_t timeMs;
+  uint8_t state;             // SystemState
+  uint8_t flags;             // TELEMETRY_FLAG_*
+  uint8_t joyX;
+  uint8_t joyY;
+  uint16_t targetH;          // Commanded gaze
+  uint16_t targetV;
+  uint16_t currentH;         // Staged pulses
+  uint16_t currentV;
+  uint16_t lids[4];          // L upper, L lower, R upper, R lower
+  uint16_t motionExecUs;     // Motion group execution time
+  uint16_t motionLateUs;     // Motion group release latency
+  uint16_t busBytes;         // I2C bytes of the last servo flush
+  uint16_t drops;            // Records dropped so far (saturates)
+} __attribute__((packed));
+
+/**
+ * One rate group's counters (FRAME_TELEMETRY_TIMING)
+ */
+struct TelemetryTiming {
+  uint8_t group;             // Scheduler group index
+  uint8_t groupCount;
+  uint32_t runs;
+  uint32_t overruns;
+  uint16_t execUs;
+  uint16_t wcetUs;
+  uint16_t lateUs;           // Worst release latency
+  uint16_t jitterUs;
+} __attribute__((packed));
+
+struct TelemetryStats {
+  unsigned long frames;      // Queued
+  unsigned long drops;       // Rejected for lack of ring space
+  uint8_t peakUsed;          // Ring high-water mark (bytes)
+};
+
+class TelemetryLink {
+public:
+  TelemetryLink();
+
+  /** Frame and queue a record; false (and counted) if it does not fit */
+  bool send(uint8_t type, const void *payload, uint8_t length);
+
+  /** Move queued bytes into the UART without blocking; returns bytes moved */
+  uint8_t drain();
+
+  uint8_t pending() const { return (uint8_t)(head - tail); }
+  const TelemetryStats &stats() const { return counters; }
+
+private:
+  void put(uint8_t b) { buffer[head++ & TELEMETRY_BUFFER_MASK] = b; }
+
+  uint8_t buffer[TELEMETRY_BUFFER_SIZE];
+  uint8_t head;              // Next write (unmasked)
+  uint8_t tail;              // Next byte to send (unmasked)
+  uint8_t sequence;
+  TelemetryStats counters;
+};
+
+#endif // TELEMETRY_H
@@ -0,0 +1,149 @@
+/**
+ * TiltGaze.cpp
+ *
+ * See TiltGaze.h
+ */
+
+#include "TiltGaze.h"
+
+#define TILT_LUT_SHIFT 5                          // 32 segments over 0..45°
+#define TILT_LUT_POINTS ((1 << TILT_LUT_SHIFT) + 1)
+#define TILT_RIGHT_ANGLE 900                      // 0.1°
+#define TILT_STRAIGHT 1800
+#define TILT_MAX_DT_MS 255
+
+/**
+ * atan(i / 32) in 0.1°, i = 0..32
+ */
+static const uint16_t ATAN_TABLE[TILT_LUT_POINTS] PROGMEM = {
+  0, 18, 36, 54, 71, 89, 106, 123, 140, 157, 174, 190, 206, 221, 236, 251, 266,
+  280, 294, 307, 320, 333, 345, 357, 369, 380, 391, 402, 412, 422, 432, 441, 450
+};
+
+/**
+ * atan(ratio) for ratio 0..1 in Q8, 0.1°
+ */
+static int16_t tiltAtan(uint16_t ratio) {
+  uint8_t i = ratio >> (8 - TILT_LUT_SHIFT);
+  uint8_t frac = ratio & ((1 << (8 - TILT_LUT_SHIFT)) - 1);
+  int16_t a = pgm_read_word(&ATAN_TABLE[i]);
+  if (frac == 0) return a;
+  int16_t b = pgm_read_word(&ATAN_TABLE[i + 1]);
+  return a + (((b - a) * frac) >> (8 - TILT_LUT_SHIFT));
+}
+
+int16_t tiltAtan2(int16_t y, int16_t x) {
+  uint16_t ay = y >= 0 ? y : -y;
+  uint16_t ax = x >= 0 ? x : -x;
+  if (ax == 0 && ay == 0) return 0;
+
+  // First octant: the smaller over the larger, both under 256 so the Q8
+  // ratio is a 16-bit division
+  uint16_t lo = ay < ax ? ay : ax;
+  uint16_t hi = ay < ax ? ax : ay;
+  while (hi > 255) {
+    hi >>= 1;
+    lo >>= 1;
+  }
+  int16_t angle = tiltAtan((uint16_t)(lo * 256U / hi));
+
+  if (ay > ax) angle = TILT_RIGHT_ANGLE - angle;
+  if (x < 0) angle = TILT_STRAIGHT - angle;
+  return y < 0 ? -angle : angle;
+}
+
+static int16_t tiltClamp(int32_t v) {
+  return (int16_t)(v > JOY_FULL ? JOY_FULL : (v < -JOY_FULL ? -JOY_FULL : v));
+}
+
+TiltGaze::TiltGaze()
+  : scaleQ8(0), minMagnitudeSq(0), maxMagnitudeSq(0), gainDtMs(0), gain(0), primed(false),
+    stateX(0), stateY(0), lastJoyX(0), lastJoyY(0), angleX(0), angleY(0),
+    restAngleX(0), restAngleY(0), tiltOutX(0), tiltOutY(0), outX(0), outY(0) {
+  memset(&settings, 0, sizeof(settings));
+}
+
+void TiltGaze::configure(const TiltGazeSettings &config) {
+  settings = config;
+  uint16_t span = settings.rangeDeciDeg > settings.deadzoneDeciDeg
+                  ? settings.rangeDeciDeg - settings.deadzoneDeciDeg : 1;
+  scaleQ8 = (JOY_FULL << 8) / span;
+
+  // Between half and one and a half g
+  uint32_t half = settings.oneG / 2;
+  uint32_t oneAndHalf = settings.oneG + half;
+  minMagnitudeSq = half * half;
+  maxMagnitudeSq = oneAndHalf * oneAndHalf;
+  gainDtMs = 0;
+  primed = false;
+}
+
+int16_t TiltGaze::scale(int16_t angle, bool invert) const {
+  int16_t excess;
+  if (angle > (int16_t)settings.deadzoneDeciDeg) excess = angle - settings.deadzoneDeciDeg;
+  else if (angle < -(int16_t)settings.deadzoneDeciDeg) excess = angle + settings.deadzoneDeciDeg;
+  else return 0;
+  int16_t deflection = tiltClamp((int32_t)excess * scaleQ8 >> 8);
+  return invert ? -deflection : deflection;
+}
+
+void TiltGaze::fuse(int32_t &state, int16_t tilt, int16_t joy, int16_t lastJoy,
+                    int32_t k) const {
+  // Fast branch: the joystick's change goes straight through; slow branch:
+  // pulled toward tilt + joystick
+  state += (int32_t)(joy - lastJoy) << 4;
+  state += (((int32_t)tilt + joy) * 16 - state) * k / (1L << 12);
+  if (state > JOY_FULL * 16) state = JOY_FULL * 16;
+  if (state < -JOY_FULL * 16) state = -JOY_FULL * 16;
+}
+
+void TiltGaze::update(const NunchuckSample &sample, int16_t joyX, int16_t joyY,
+                      unsigned long dtMs) {
+  if (!sample.connected) {
+    angleX = 0;
+    angleY = 0;
+  } else {
+    int16_t x = sample.accelX - settings.accelZero[0];
+    int16_t y = sample.accelY - settings.accelZero[1];
+    int16_t z = sample.accelZ - settings.accelZero[2];
+    uint32_t magnitudeSq = (int32_t)x * x + (int32_t)y * y + (int32_t)z * z;
+    if (magnitudeSq >= minMagnitudeSq && magnitudeSq <= maxMagnitudeSq) {
+      angleX = tiltAtan2(x, z);
+      angleY = tiltAtan2(y, z);
+    }
+  }
+  tiltOutX = scale(angleX, settings.invertX);
+  tiltOutY = scale(angleY, settings.invertY);
+
+  if (!primed) {
+    stateX = ((int32_t)tiltOutX + joyX) * 16;
+    stateY = ((int32_t)tiltOutY + joyY) * 16;
+    restAngleX = angleX;
+    restAngleY = angleY;
+    primed = true;
+  } else {
+    if (dtMs == 0) dtMs = 1;
+    if (dtMs > TILT_MAX_DT_MS) dtMs = TILT_MAX_DT_MS;
+    if (dtMs != gainDtMs) {
+      gain = ((int32_t)dtMs << 12) / ((int32_t)dtMs + settings.tauMs);
+      gainDtMs = dtMs;
+    }
+    fuse(stateX, tiltOutX, joyX, lastJoyX, gain);
+    fuse(stateY, tiltOutY, joyY, lastJoyY, gain);
+  }
+  lastJoyX = joyX;
+  lastJoyY = joyY;
+  outX = tiltClamp((stateX + 8) >> 4);
+  outY = tiltClamp((stateY + 8) >> 4);
+}
+
+bool TiltGaze::moved() {
+  int16_t dx = angleX - restAngleX;
+  int16_t dy = angleY - restAngleY;
+  if (abs(dx) <= (int16_t)settings.activityDeciDeg && abs(dy) <= (int16_t)settings.activityDeciDeg) {
+    return false;
+  }
+  restAngleX = angleX;
+  restAngleY = angleY;
+  return true;
+}
@@ -0,0 +1,111 @@
+/**
+ * TiltGaze.h
+ *
+ * Nunchuck tilt + joystick → gaze deflection, fixed point (alternate input)
+ *
+ * The accelerometer reads gravity: tilting the nunchuck left/right (roll)
+ * or nose up/down (pitch) steers the eyes, and the joystick still adds to
+ * it. Per input sample:
+ *
+ *   1. TILT    centered accel counts → roll = atan2(X, Z), pitch =
+ *              atan2(Y, Z) in 0.1° (octant reduction, 16-bit ratio, a
+ *              33-entry PROGMEM atan table, linear interpolation: error
+ *              under 0.1°). A sample whose magnitude is far from 1 g is a
+ *              jolt or a swing, not tilt, and leaves the tilt where it was;
+ *              an unplugged nunchuck reads level.
+ *   2. SCALE   per-axis deadzone (a nunchuck held roughly flat rests
+ *              centered), then ±(RANGE - DEADZONE) → ±full deflection.
+ *   3. FUSE    complementary filter with the joystick deflection:
+ *                out = α·(out + Δjoystick) + (1 - α)·(tilt + joystick)
+ *              α = τ / (τ + dt). The joystick (already filtered, and
+ *              noise-free at rest) carries the fast part and passes
+ *              straight through; the accelerometer, absolute but shaky
+ *              (every hand tremor reads as tilt), only sets the slow part.
+ *              At rest out = tilt + joystick.
+ *
+ * Output is the JoystickFilter scale (Q12, ±JOY_FULL), so it maps into the
+ * Horizontal/Vertical limits through joystickPosition() like the stick.
+ *
+ * No floats, no trig: per sample two 16-bit divisions, about ten
+ * multiplies and a few table reads (a 32-bit division only when the tick
+ * length changes).
+ */
+
+#ifndef TILT_GAZE_H
+#define TILT_GAZE_H
+
+#include <Arduino.h>
+#include "EyeHAL.h"
+#include "JoystickFilter.h"
+
+struct TiltGazeSettings {
+  int accelZero[3];              // Counts at 0 g, X Y Z
+  uint16_t oneG;                 // Counts per g
+  uint16_t rangeDeciDeg;         // Tilt for full deflection, 0.1°
+  uint16_t deadzoneDeciDeg;      // Per axis, 0.1°
+  uint16_t tauMs;                // Fusion time constant (accelerometer low-pass)
+  uint16_t activityDeciDeg;      // Tilt change that counts as activity
+  bool invertX;
+  bool invertY;
+};
+
+class TiltGaze {
+public:
+  TiltGaze();
+
+  void configure(const TiltGazeSettings &settings);
+
+  /** Restart from the next sample (e.g. when the mode is switched on) */
+  void reset() { primed = false; }
+
+  /**
+   * One nunchuck sample and this tick's joystick deflection (Q12),
+   * dtMs after the previous one
+   */
+  void update(const NunchuckSample &sample, int16_t joyX, int16_t joyY, unsigned long dtMs);
+
+  /** Fused deflection, Q12 */
+  int16_t deflectionX() const { return outX; }
+  int16_t deflectionY() const { return outY; }
+
+  /** Tilt alone (scaled, before fusion), Q12 */
+  int16_t tiltX() const { return tiltOutX; }
+  int16_t tiltY() const { return tiltOutY; }
+
+  /**
+   * Tilted more than activityDeciDeg since the last time this said so
+   * (the nunchuck being handled keeps the eyes out of idle)
+   */
+  bool moved();
+
+private:
+  int16_t scale(int16_t angle, bool invert) const;
+  void fuse(int32_t &state, int16_t tilt, int16_t joy, int16_t lastJoy, int32_t k) const;
+
+  TiltGazeSettings settings;
+  int32_t scaleQ8;               // Full deflection per 0.1° past the deadzone, Q8
+  uint32_t minMagnitudeSq;       // Plausible gravity, counts²
+  uint32_t maxMagnitudeSq;
+  unsigned long gainDtMs;        // Tick length gain was computed for
+  int32_t gain;                  // 1 - α, Q12
+  bool primed;
+  int32_t stateX;                // Q16
+  int32_t stateY;
+  int16_t lastJoyX;
+  int16_t lastJoyY;
+  int16_t angleX;                // Last plausible tilt, 0.1°
+  int16_t angleY;
+  int16_t restAngleX;            // Where moved() last fired
+  int16_t restAngleY;
+  int16_t tiltOutX;
+  int16_t tiltOutY;
+  int16_t outX;
+  int16_t outY;
+};
+
+/**
+ * atan2(y, x) in 0.1° (-1800 .. 1800), table based
+ */
+int16_t tiltAtan2(int16_t y, int16_t x);
+
+#endif // TILT_GAZE_H
@@ -0,0 +1,630 @@
+/**
+ * AnimRender.cpp
+ *
+ * Offline animation renderer and limit verifier
+ *
+ * Runs the whole sketch (setup()/loop(), as in eyesim) with no hand on the
+ * nunchuck - startup clip, then ACTIVE until the idle timeout, then idle
+ * saccades, blinks and expressions for the rest of the run - once per
+ * random seed, far faster than real time, each seed in its own forked
+ * process (--jobs at a time). Every channel write the mock PCA9685s see is
+ * taken at its bus timestamp and the servo outputs are sampled once per
+ * motion tick: a frame is every channel's pulse at that instant.
+ *
+ * Every write (limits, absolute) and motion tick (the rest) is checked
+ * against:
+ *   limits    the channel's calibrated range (EyeConfig.h, as folded into
+ *             CHANNEL_DEFAULTS)
+ *   absolute  SafetyLimits::ABSOLUTE_MIN_PULSE .. ABSOLUTE_MAX_PULSE
+ *   delta     SafetyLimits::MAX_DELTA_PER_UPDATE per MAX_DELTA_INTERVAL_MS,
+ *             motion tick to motion tick that far apart, on what the board
+ *             got from those ticks - servo lead included, no allowance
+ *   lead      the lead added to the pulse within the plant's maxLead
+ * and, as a diagnostic that is reported but fails nothing:
+ *   motion    the delta window on the pulse the rig staged BEFORE the
+ *             servo lead (eye axes: the motion engine's output)
+ * Lids move on their blink trajectories, not under the eye velocity
+ * limit: their largest steps are reported, and checked only with
+ * --strict-lids. A channel is checked from its first write on (before it,
+ * the board outputs nothing).
+ *
+ * Per motion tick the rig's pulse and lead are read right after the pass
+ * that ran the tick, the board's value right before the pass that runs
+ * the next one (by then the tick's writes are out on the bus).
+ *
+ * Pulses are output counts (what the boards are sent, see ChannelTable.h),
+ * limits converted the same way the firmware converts them; 0 until the
+ * channel's first write.
+ *
+ * OUTPUT (--out DIR), one file per seed:
+ *   seed_N.bin   RenderHeader, then per frame the state (1 byte) and every
+ *                channel's pulse (uint16, little-endian), rig by rig in
+ *                ChannelIndex order
+ *   seed_N.csv   with --csv: time_ms,state,<channel>... rows
+ *
+ * USAGE:
+ *   animrender [--seeds N] [--first-seed S] [--minutes M] [--jobs J]
+ *              [--script FILE] [--out DIR] [--csv] [--strict-lids]
+ *   Defaults: 8 seeds from 1, 10 minutes, one job per CPU.
+ *   Exit status 1 if any frame broke a limit.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include "ChannelTable.h"
+#include "SimFirmware.h"
+#include "SimHardware.h"
+
+#define RENDER_MAGIC 0x52455945UL       // "EYER"
+#define RENDER_VERSION 1
+#define RENDER_CHANNELS (RIG_COUNT * CHANNEL_COUNT)
+#define RENDER_NONE 0xFFFFFFFFUL
+
+static const uint32_t FRAME_MS = SchedulerSettings::MOTION_PERIOD_MS;
+static const uint32_t LOOP_OVERHEAD_US = 20;    // As eyesim
+
+// Motion ticks between the two ends of a MAX_DELTA_INTERVAL_MS window
+static const uint32_t DELTA_FRAMES =
+  SafetyLimits::MAX_DELTA_INTERVAL_MS > FRAME_MS ? SafetyLimits::MAX_DELTA_INTERVAL_MS / FRAME_MS : 1;
+
+static const char *const CHANNEL_NAMES[CHANNEL_COUNT] = {"h", "v", "lu", "ll", "ru", "rl"};
+
+/** h, v, lu... for the first rig, r1_h, r1_v... after it */
+static void channelName(uint8_t c, char *name, size_t size) {
+  if (c < CHANNEL_COUNT) snprintf(name, size, "%s", CHANNEL_NAMES[c]);
+  else snprintf(name, size, "r%u_%s", c / CHANNEL_COUNT, CHANNEL_NAMES[c % CHANNEL_COUNT]);
+}
+
+struct RenderHeader {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t channels;
+  uint32_t seed;
+  uint16_t frameMs;
+  uint8_t outputPrescale;
+  uint8_t calibrationPrescale;
+  uint32_t frames;
+} __attribute__((packed));
+
+struct RenderOptions {
+  int seeds;
+  int firstSeed;
+  double minutes;
+  int jobs;
+  const char *scriptPath;
+  const char *outDir;
+  bool csv;
+  bool strictLids;
+};
+
+/**
+ * One channel over one seed
+ */
+struct ChannelResult {
+  uint16_t min;
+  uint16_t max;
+  uint16_t maxDelta;              // At the board, over one delta window
+  uint16_t maxMotionDelta;        // Before the lead, over one delta window
+  uint16_t maxLead;               // Largest lead, either way
+  uint32_t limitViolations;       // Writes outside the calibrated range
+  uint32_t absoluteViolations;    // Writes outside SafetyLimits::ABSOLUTE_*
+  uint32_t deltaViolations;       // Windows over the limit at the board
+  uint32_t motionOver;            // Windows over the limit before the lead (diagnostic)
+  uint32_t leadViolations;        // Ticks with the lead past maxLead
+  uint32_t firstViolationMs;      // RENDER_NONE: none
+};
+
+/**
+ * One seed, passed from its process to the parent through a pipe
+ */
+struct SeedResult {
+  int seed;
+  bool rendered;                  // The child got to the end
+  uint32_t frames;
+  uint32_t writes;
+  uint32_t blinks;                // Rig 0's left upper lid leaving open
+  uint64_t stateUs[4];
+  double wallS;
+  ChannelResult channels[RENDER_CHANNELS];
+};
+
+// ============================================================================
+// RENDERING (one seed, in its own process)
+// ============================================================================
+
+struct RenderChannel {
+  ChannelDescriptor descriptor;
+  uint16_t deltaLimit;
+  bool checkDelta;
+  bool written;
+  uint16_t value;                 // At the board now
+};
+
+/**
+ * One channel at one motion tick
+ */
+struct TickSample {
+  int16_t motion;                 // Staged before the lead
+  uint16_t value;                 // At the board once the tick's writes were out
+  bool written;
+};
+
+struct Renderer {
+  const RenderOptions *opt;
+  SeedResult *result;
+  RenderChannel channels[RENDER_CHANNELS];
+  int8_t channelAt[SERVO_BOARD_COUNT][SERVO_FRAME_CHANNELS];   // -1: unused
+  std::vector<MockPCA9685 *> boards;
+  TickSample ticks[DELTA_FRAMES + 1][RENDER_CHANNELS];
+  uint32_t tick;                  // Motion ticks sampled
+  unsigned long firmwareTicks;    // simFirmwareMotionTicks() at the last sample
+  uint64_t nextFrameUs;
+  uint32_t frame;
+  bool lidOpen;
+  FILE *bin;
+  FILE *csv;
+};
+
+static uint16_t absoluteMin() { return outputPulse(SafetyLimits::ABSOLUTE_MIN_PULSE); }
+static uint16_t absoluteMax() { return outputPulse(SafetyLimits::ABSOLUTE_MAX_PULSE); }
+
+static void violation(Renderer &r, uint8_t c, uint32_t &count, uint64_t timeUs) {
+  ChannelResult &cr = r.result->channels[c];
+  count++;
+  if (cr.firstViolationMs == RENDER_NONE) cr.firstViolationMs = (uint32_t)(timeUs / 1000);
+}
+
+static void applyWrite(Renderer &r, const PwmWrite &w) {
+  uint8_t board = 0;
+  while (board < SERVO_BOARD_COUNT && servoBoardAddress(board) != w.address) board++;
+  if (board == SERVO_BOARD_COUNT || w.channel >= SERVO_FRAME_CHANNELS) return;
+  int8_t c = r.channelAt[board][w.channel];
+  if (c < 0) return;
+
+  RenderChannel &ch = r.channels[c];
+  ChannelResult &cr = r.result->channels[c];
+  ch.value = w.off;
+  ch.written = true;
+  r.result->writes++;
+  if (w.off < cr.min) cr.min = w.off;
+  if (w.off > cr.max) cr.max = w.off;
+  if (w.off < ch.descriptor.minPulse || w.off > ch.descriptor.maxPulse) {
+    violation(r, c, cr.limitViolations, w.timeUs);
+  }
+  if (w.off < absoluteMin() || w.off > absoluteMax()) {
+    violation(r, c, cr.absoluteViolations, w.timeUs);
+  }
+}
+
+static void writeFrame(Renderer &r, uint8_t state) {
+  if (r.bin) {
+    fputc(state, r.bin);
+    for (uint8_t c = 0; c < RENDER_CHANNELS; c++) {
+      uint16_t v = r.channels[c].value;
+      fputc(v & 0xFF, r.bin);
+      fputc(v >> 8, r.bin);
+    }
+  }
+  if (r.csv) {
+    fprintf(r.csv, "%lu,%s", (unsigned long)(r.frame * FRAME_MS), simFirmwareStateName(state));
+    for (uint8_t c = 0; c < RENDER_CHANNELS; c++) fprintf(r.csv, ",%u", r.channels[c].value);
+    fputc('\n', r.csv);
+  }
+}
+
+/**
+ * Frames due before untilUs, from what the boards held at each
+ */
+static void emitFrames(Renderer &r, uint64_t untilUs) {
+  uint8_t state = (uint8_t)simFirmwareState();
+  while (r.nextFrameUs < untilUs) {
+    // Blinks: the first lid leaving its open end
+    const RenderChannel &lid = r.channels[CH_L_UPPER];
+    uint16_t open = lid.descriptor.lut[0];
+    bool isOpen = abs((int)lid.value - (int)open) * 4 <
+                  abs((int)lid.descriptor.lut[CHANNEL_LUT_POINTS - 1] - (int)open);
+    if (r.lidOpen && !isOpen) r.result->blinks++;
+    r.lidOpen = isOpen;
+
+    writeFrame(r, state);
+    r.frame++;
+    r.nextFrameUs += FRAME_MS * 1000ULL;
+  }
+}
+
+/**
+ * A motion tick just ran: what every rig channel was staged from, checked
+ * against the tick DELTA_FRAMES back
+ */
+static void sampleTick(Renderer &r) {
+  uint32_t slot = r.tick % (DELTA_FRAMES + 1);
+  uint32_t back = (r.tick + 1) % (DELTA_FRAMES + 1);    // DELTA_FRAMES ago
+  for (uint8_t c = 0; c < RENDER_CHANNELS; c++) {
+    const RenderChannel &ch = r.channels[c];
+    ChannelResult &cr = r.result->channels[c];
+    TickSample &t = r.ticks[slot][c];
+    int motion, lead;
+    simFirmwareMotion(c / CHANNEL_COUNT, c % CHANNEL_COUNT, &motion, &lead);
+    t.motion = (int16_t)motion;
+    t.written = false;
+
+    if ((uint16_t)abs(lead) > cr.maxLead) cr.maxLead = (uint16_t)abs(lead);
+    if (abs(lead) > ch.descriptor.plant.maxLead) violation(r, c, cr.leadViolations, simNowUs());
+    if (r.tick < DELTA_FRAMES) continue;
+    uint16_t delta = (uint16_t)abs(motion - r.ticks[back][c].motion);
+    if (delta > cr.maxMotionDelta) cr.maxMotionDelta = delta;
+    if (ch.checkDelta && delta > ch.deltaLimit) cr.motionOver++;
+  }
+  r.tick++;
+}
+
+/**
+ * The last sampled tick's writes are out: what the boards hold is what
+ * that tick sent, checked against the tick DELTA_FRAMES back
+ */
+static void sampleTickOutput(Renderer &r, const uint16_t *value, const bool *written) {
+  if (r.tick == 0) return;
+  uint32_t slot = (r.tick - 1) % (DELTA_FRAMES + 1);
+  uint32_t back = r.tick % (DELTA_FRAMES + 1);
+  for (uint8_t c = 0; c < RENDER_CHANNELS; c++) {
+    const RenderChannel &ch = r.channels[c];
+    ChannelResult &cr = r.result->channels[c];
+    TickSample &t = r.ticks[slot][c];
+    const TickSample &then = r.ticks[back][c];
+    t.value = value[c];
+    t.written = written[c];
+    if (r.tick <= DELTA_FRAMES || !t.written || !then.written) continue;
+
+    uint16_t delta = (uint16_t)abs((int)t.value - (int)then.value);
+    if (delta > cr.maxDelta) cr.maxDelta = delta;
+    if (ch.checkDelta && delta > ch.deltaLimit) violation(r, c, cr.deltaViolations, simNowUs());
+  }
+}
+
+static void drainWrites(Renderer &r) {
+  for (size_t b = 0; b < r.boards.size(); b++) {
+    const std::vector<PwmWrite> &log = r.boards[b]->log();
+    for (size_t i = 0; i < log.size(); i++) {
+      emitFrames(r, log[i].timeUs + 1);
+      applyWrite(r, log[i]);
+    }
+    r.boards[b]->clearLog();
+  }
+}
+
+static FILE *openOutput(const RenderOptions &opt, int seed, const char *extension) {
+  char path[512];
+  snprintf(path, sizeof(path), "%s/seed_%d.%s", opt.outDir, seed, extension);
+  FILE *f = fopen(path, "wb");
+  if (f == NULL) fprintf(stderr, "animrender: cannot write %s\n", path);
+  return f;
+}
+
+static bool renderSeed(const RenderOptions &opt, int seed, SeedResult &result) {
+  static Renderer r;
+  memset(&result, 0, sizeof(result));
+  result.seed = seed;
+  r.opt = &opt;
+  r.result = &result;
+  r.tick = 0;
+  r.firmwareTicks = 0;
+  r.nextFrameUs = 0;
+  r.frame = 0;
+  r.lidOpen = true;
+  r.bin = NULL;
+  r.csv = NULL;
+  memset(r.ticks, 0, sizeof(r.ticks));
+  memset(r.channelAt, -1, sizeof(r.channelAt));
+
+  // Limits as compiled (no EEPROM image: the sketch runs on these too)
+  ChannelDescriptor table[RENDER_CHANNELS];
+  memcpy_P(table, CHANNEL_DEFAULTS, sizeof(table));
+  uint16_t velocityLimit = outputPulse(SafetyLimits::MAX_DELTA_PER_UPDATE *
+                                       (long)(DELTA_FRAMES * FRAME_MS) /
+                                       SafetyLimits::MAX_DELTA_INTERVAL_MS);
+  for (uint8_t c = 0; c < RENDER_CHANNELS; c++) {
+    RenderChannel &ch = r.channels[c];
+    uint8_t index = c % CHANNEL_COUNT;
+    bool eye = index == CH_HORIZONTAL || index == CH_VERTICAL;
+    ch.descriptor = table[c];
+    ch.checkDelta = eye || opt.strictLids;
+    ch.deltaLimit = velocityLimit;
+    ch.written = false;
+    ch.value = 0;
+    r.channelAt[table[c].board][table[c].channel] = (int8_t)c;
+    result.channels[c].min = 0xFFFF;
+    result.channels[c].firstViolationMs = RENDER_NONE;
+  }
+
+  for (uint8_t b = 0; b < SERVO_BOARD_COUNT; b++) {
+    r.boards.push_back(simAddPCA9685(servoBoardAddress(b)));
+  }
+  simAddNunchuck();
+  if (opt.scriptPath != NULL && !simNunchuckLoadScript(opt.scriptPath)) {
+    fprintf(stderr, "animrender: cannot load script %s\n", opt.scriptPath);
+    return false;
+  }
+  simAnalogSet(A0, seed);
+  simSerialSetSink(NULL);
+
+  RenderHeader header = {RENDER_MAGIC, RENDER_VERSION, RENDER_CHANNELS, (uint32_t)seed,
+                         (uint16_t)FRAME_MS, OUTPUT_PRESCALE, CALIBRATION_PRESCALE, 0};
+  if (opt.outDir != NULL) {
+    if ((r.bin = openOutput(opt, seed, "bin")) == NULL) return false;
+    fwrite(&header, sizeof(header), 1, r.bin);
+    if (opt.csv) {
+      if ((r.csv = openOutput(opt, seed, "csv")) == NULL) return false;
+      fprintf(r.csv, "time_ms,state");
+      for (uint8_t c = 0; c < RENDER_CHANNELS; c++) {
+          char name[16];
+        channelName(c, name, sizeof(name));
+        fprintf(r.csv, ",%s", name);
+      }
+      fputc('\n', r.csv);
+    }
+  }
+
+  struct timespec wallStart, wallEnd;
+  clock_gettime(CLOCK_MONOTONIC, &wallStart);
+
+  setup();
+  drainWrites(r);
+  r.firmwareTicks = simFirmwareMotionTicks();
+  const uint64_t endUs = (uint64_t)(opt.minutes * 60e6);
+  uint16_t before[RENDER_CHANNELS];
+  bool writtenBefore[RENDER_CHANNELS];
+  while (simNowUs() < endUs) {
+    uint64_t start = simNowUs();
+    int state = simFirmwareState();
+    for (uint8_t c = 0; c < RENDER_CHANNELS; c++) {
+      before[c] = r.channels[c].value;
+      writtenBefore[c] = r.channels[c].written;
+    }
+    loop();
+    simAdvanceUs(LOOP_OVERHEAD_US);
+    drainWrites(r);
+    if (simFirmwareMotionTicks() != r.firmwareTicks) {
+      r.firmwareTicks = simFirmwareMotionTicks();
+      sampleTickOutput(r, before, writtenBefore);
+      sampleTick(r);
+    }
+    if (state >= 0 && state < 4) result.stateUs[state] += simNowUs() - start;
+  }
+  for (uint8_t c = 0; c < RENDER_CHANNELS; c++) {
+    before[c] = r.channels[c].value;
+    writtenBefore[c] = r.channels[c].written;
+  }
+  sampleTickOutput(r, before, writtenBefore);
+  emitFrames(r, endUs);
+
+  clock_gettime(CLOCK_MONOTONIC, &wallEnd);
+  result.wallS = (wallEnd.tv_sec - wallStart.tv_sec) + (wallEnd.tv_nsec - wallStart.tv_nsec) / 1e9;
+  result.frames = r.frame;
+
+  if (r.bin) {
+    header.frames = r.frame;
+    fseek(r.bin, 0, SEEK_SET);
+    fwrite(&header, sizeof(header), 1, r.bin);
+    fclose(r.bin);
+  }
+  if (r.csv) fclose(r.csv);
+  result.rendered = true;
+  return true;
+}
+
+// ============================================================================
+// SEEDS IN PARALLEL
+// ============================================================================
+
+struct RenderJob {
+  pid_t pid;
+  int fd;
+  int seed;
+};
+
+static pid_t startSeed(const RenderOptions &opt, int seed, int &fd) {
+  int pipeFds[2];
+  if (pipe(pipeFds) != 0) return -1;
+  fflush(stdout);
+  fflush(stderr);
+  pid_t pid = fork();
+  if (pid == 0) {
+    // A fresh copy of the sketch: nothing ran in the parent
+    close(pipeFds[0]);
+    SeedResult result;
+    bool ok = renderSeed(opt, seed, result);
+    ssize_t sent = write(pipeFds[1], &result, sizeof(result));
+    _exit(ok && sent == (ssize_t)sizeof(result) ? 0 : 1);
+  }
+  close(pipeFds[1]);
+  if (pid < 0) {
+    close(pipeFds[0]);
+    return -1;
+  }
+  fd = pipeFds[0];
+  return pid;
+}
+
+static bool collectSeed(const RenderJob &job, SeedResult &result) {
+  size_t got = 0;
+  uint8_t *bytes = (uint8_t *)&result;
+  while (got < sizeof(result)) {
+    ssize_t n = read(job.fd, bytes + got, sizeof(result) - got);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) break;
+    got += (size_t)n;
+  }
+  close(job.fd);
+  int status = 0;
+  waitpid(job.pid, &status, 0);
+  if (got != sizeof(result) || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+    memset(&result, 0, sizeof(result));
+    result.seed = job.seed;
+    return false;
+  }
+  return true;
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+static uint32_t violations(const ChannelResult &c) {
+  return c.limitViolations + c.absoluteViolations + c.deltaViolations + c.leadViolations;
+}
+
+static void usage() {
+  fprintf(stderr,
+          "usage: animrender [--seeds N] [--first-seed S] [--minutes M] [--jobs J]\n"
+          "                  [--script FILE] [--out DIR] [--csv] [--strict-lids]\n");
+  exit(1);
+}
+
+int main(int argc, char **argv) {
+  RenderOptions opt = {8, 1, 10.0, (int)sysconf(_SC_NPROCESSORS_ONLN), NULL, NULL, false, false};
+  for (int i = 1; i < argc; i++) {
+    const char *arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (!strcmp(arg, "--seeds") && hasValue) opt.seeds = atoi(argv[++i]);
+    else if (!strcmp(arg, "--first-seed") && hasValue) opt.firstSeed = atoi(argv[++i]);
+    else if (!strcmp(arg, "--minutes") && hasValue) opt.minutes = atof(argv[++i]);
+    else if (!strcmp(arg, "--jobs") && hasValue) opt.jobs = atoi(argv[++i]);
+    else if (!strcmp(arg, "--script") && hasValue) opt.scriptPath = argv[++i];
+    else if (!strcmp(arg, "--out") && hasValue) opt.outDir = argv[++i];
+    else if (!strcmp(arg, "--csv")) opt.csv = true;
+    else if (!strcmp(arg, "--strict-lids")) opt.strictLids = true;
+    else usage();
+  }
+  if (opt.seeds < 1 || opt.minutes <= 0) usage();
+  if (opt.jobs < 1) opt.jobs = 1;
+  if (opt.outDir != NULL && mkdir(opt.outDir, 0777) != 0 && errno != EEXIST) {
+    fprintf(stderr, "animrender: cannot create %s\n", opt.outDir);
+    return 1;
+  }
+
+  printf("animrender: %d seed(s) x %.1f min, %u ms frames, %d job(s)\n", opt.seeds, opt.minutes,
+         FRAME_MS, opt.jobs);
+  printf("%6s %8s %8s %7s %8s %8s %10s\n", "seed", "frames", "idle_s", "blinks", "writes",
+         "x_real", "violations");
+
+  int idleState = -1;
+  for (int s = 0; s < simFirmwareStateCount() && s < 4; s++) {
+    if (!strcmp(simFirmwareStateName(s), "IDLE")) idleState = s;
+  }
+
+  struct timespec wallStart, wallEnd;
+  clock_gettime(CLOCK_MONOTONIC, &wallStart);
+
+  std::vector<SeedResult> results;
+  std::vector<RenderJob> running;
+  int next = 0;
+  bool failed = false;
+  while (next < opt.seeds || !running.empty()) {
+    while (next < opt.seeds && (int)running.size() < opt.jobs) {
+      RenderJob job;
+      job.seed = opt.firstSeed + next++;
+      job.pid = startSeed(opt, job.seed, job.fd);
+      if (job.pid < 0) {
+        fprintf(stderr, "animrender: cannot start seed %d\n", job.seed);
+        failed = true;
+        continue;
+      }
+      running.push_back(job);
+    }
+    if (running.empty()) break;
+
+    // Oldest first: results come out in seed order
+    SeedResult result;
+    if (!collectSeed(running.front(), result)) {
+      fprintf(stderr, "animrender: seed %d did not finish\n", running.front().seed);
+      failed = true;
+    }
+    running.erase(running.begin());
+    if (!result.rendered) continue;
+
+    uint32_t total = 0;
+    int first = -1;
+    for (uint8_t c = 0; c < RENDER_CHANNELS; c++) {
+      total += violations(result.channels[c]);
+      if (violations(result.channels[c]) > 0 &&
+          (first < 0 || result.channels[c].firstViolationMs < result.channels[first].firstViolationMs)) {
+        first = c;
+      }
+    }
+    printf("%6d %8u %8.1f %7u %8u %8.0f %10u", result.seed, result.frames,
+           idleState >= 0 ? result.stateUs[idleState] / 1e6 : 0.0, result.blinks, result.writes,
+           result.wallS > 0 ? opt.minutes * 60 / result.wallS : 0.0, total);
+    if (first >= 0) {
+      char name[16];
+      channelName(first, name, sizeof(name));
+      printf("  first: %s at %.2f s", name, result.channels[first].firstViolationMs / 1000.0);
+    }
+    printf("\n");
+    results.push_back(result);
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &wallEnd);
+  double wall = (wallEnd.tv_sec - wallStart.tv_sec) + (wallEnd.tv_nsec - wallStart.tv_nsec) / 1e9;
+
+  // Every seed together, per channel
+  ChannelDescriptor table[RENDER_CHANNELS];
+  memcpy_P(table, CHANNEL_DEFAULTS, sizeof(table));
+  printf("\n%-7s %9s %9s %9s %9s %7s %7s %7s %5s %5s %6s %6s %6s %6s %6s\n", "channel", "min", "max",
+         "limit_min", "limit_max", "motion", "delta", "d_limit", "lead", "l_max", "limit", "abs",
+         "delta", "lead", "m_over");
+  uint32_t total = 0;
+  for (uint8_t c = 0; c < RENDER_CHANNELS; c++) {
+    ChannelResult all;
+    memset(&all, 0, sizeof(all));
+    all.min = 0xFFFF;
+    for (size_t s = 0; s < results.size(); s++) {
+      const ChannelResult &cr = results[s].channels[c];
+      if (cr.min < all.min) all.min = cr.min;
+      if (cr.max > all.max) all.max = cr.max;
+      if (cr.maxDelta > all.maxDelta) all.maxDelta = cr.maxDelta;
+      if (cr.maxMotionDelta > all.maxMotionDelta) all.maxMotionDelta = cr.maxMotionDelta;
+      if (cr.maxLead > all.maxLead) all.maxLead = cr.maxLead;
+      all.limitViolations += cr.limitViolations;
+      all.absoluteViolations += cr.absoluteViolations;
+      all.deltaViolations += cr.deltaViolations;
+      all.motionOver += cr.motionOver;
+      all.leadViolations += cr.leadViolations;
+    }
+    uint8_t index = c % CHANNEL_COUNT;
+    bool delta = index == CH_HORIZONTAL || index == CH_VERTICAL || opt.strictLids;
+    char name[16];
+    channelName(c, name, sizeof(name));
+    uint16_t deltaLimit = outputPulse(SafetyLimits::MAX_DELTA_PER_UPDATE *
+                                      (long)(DELTA_FRAMES * FRAME_MS) /
+                                      SafetyLimits::MAX_DELTA_INTERVAL_MS);
+    char deltaText[16];
+    if (delta) snprintf(deltaText, sizeof(deltaText), "%u", deltaLimit);
+    else snprintf(deltaText, sizeof(deltaText), "-");
+    printf("%-7s %9u %9u %9u %9u %7u %7u %7s %5u %5u %6u %6u %6u %6u %6u\n", name, all.min,
+           all.max, table[c].minPulse, table[c].maxPulse, all.maxMotionDelta, all.maxDelta,
+           deltaText, all.maxLead, table[c].plant.maxLead, all.limitViolations,
+           all.absoluteViolations, all.deltaViolations, all.leadViolations, all.motionOver);
+    total += violations(all);
+  }
+
+  printf("(delta: at the board, lead included, within d_limit; lead: within l_max; motion and\n"
+         " m_over: the same window before the lead - diagnostic only, not a violation)\n");
+
+  double frames = 0;
+  for (size_t s = 0; s < results.size(); s++) frames += results[s].frames;
+  printf("\n%.0f frames (%.1f h of animation) in %.2f s wall: %.0fx real time\n", frames,
+         frames * FRAME_MS / 3.6e6, wall, wall > 0 ? frames * FRAME_MS / 1000.0 / wall : 0.0);
+  if (opt.outDir != NULL) printf("trajectories in %s/\n", opt.outDir);
+  bool pass = !failed && total == 0 && (int)results.size() == opt.seeds;
+  printf("animrender: %s (%u violations)\n", pass ? "PASS" : "FAIL", total);
+  return pass ? 0 : 1;
+}
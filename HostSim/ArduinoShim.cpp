@@ -0,0 +1,205 @@
+/**
+ * ArduinoShim.cpp
+ *
+ * Host implementation of the Arduino core subset declared in shim/Arduino.h
+ */
+
+#include <Arduino.h>
+
+#include <deque>
+
+#include "SimHardware.h"
+
+// ============================================================================
+// TIME
+// ============================================================================
+
+unsigned long millis() {
+  return halMillis();
+}
+
+unsigned long micros() {
+  return halMicros();
+}
+
+void delay(unsigned long ms) {
+  halDelay(ms);
+}
+
+void delayMicroseconds(unsigned int us) {
+  simAdvanceUs(us);
+}
+
+// ============================================================================
+// RANDOM
+// ============================================================================
+
+// Park-Miller minimal standard generator, same as avr-libc random()
+static uint32_t randomState = 1;
+
+void randomSeed(unsigned long seed) {
+  if (seed != 0) randomState = (uint32_t)seed;
+}
+
+static long nextRandom() {
+  int32_t hi, lo, x;
+  x = (int32_t)(randomState % 0x7ffffffe) + 1;
+  hi = x / 127773;
+  lo = x % 127773;
+  x = 16807 * lo - 2836 * hi;
+  if (x < 0) x += 0x7fffffff;
+  randomState = (uint32_t)(x - 1);
+  return x - 1;
+}
+
+long random(long howBig) {
+  if (howBig == 0) return 0;
+  return nextRandom() % howBig;
+}
+
+long random(long howSmall, long howBig) {
+  if (howSmall >= howBig) return howSmall;
+  return random(howBig - howSmall) + howSmall;
+}
+
+// ============================================================================
+// DIGITAL I/O (no-op on the host)
+// ============================================================================
+
+volatile uint8_t SREG = 0;
+
+void pinMode(uint8_t, uint8_t) {}
+void digitalWrite(uint8_t, uint8_t) {}
+int digitalRead(uint8_t) { return LOW; }
+
+// ============================================================================
+// SERIAL
+// ============================================================================
+
+HardwareSerial Serial;
+
+static const size_t SERIAL_TX_BUFFER_SIZE = 64;   // UNO core default
+static const size_t SERIAL_RX_BUFFER_SIZE = 64;
+static unsigned long serialBaud = 115200;
+static uint64_t serialNextDrainUs = 0;
+static std::deque<uint8_t> txBuffer;
+static std::deque<uint8_t> rxBuffer;
+static FILE *serialSink = NULL;
+static SimSerialStats serialStats = {0, 0, 0, 0};
+
+static uint32_t byteTimeUs() {
+  return (uint32_t)(10000000UL / serialBaud);   // 8N1 = 10 bits per byte
+}
+
+void simSerialService() {
+  uint64_t now = simNowUs();
+  while (!txBuffer.empty() && serialNextDrainUs <= now) {
+    if (serialSink != NULL) fputc(txBuffer.front(), serialSink);
+    txBuffer.pop_front();
+    serialNextDrainUs += byteTimeUs();
+  }
+  if (txBuffer.empty() && serialNextDrainUs < now) serialNextDrainUs = now;
+}
+
+void simSerialSetSink(FILE *sink) {
+  serialSink = sink;
+}
+
+void simSerialInject(const uint8_t *data, size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    // Ring keeps one slot free, as in the UNO core
+    if (rxBuffer.size() >= SERIAL_RX_BUFFER_SIZE - 1) {
+      serialStats.rxOverflows++;
+      continue;
+    }
+    rxBuffer.push_back(data[i]);
+    serialStats.bytesReceived++;
+  }
+}
+
+const SimSerialStats &simSerialStats() {
+  return serialStats;
+}
+
+void HardwareSerial::begin(unsigned long baud) {
+  serialBaud = baud;
+  serialNextDrainUs = simNowUs();
+}
+
+int HardwareSerial::available() {
+  return (int)rxBuffer.size();
+}
+
+int HardwareSerial::read() {
+  if (rxBuffer.empty()) return -1;
+  int c = rxBuffer.front();
+  rxBuffer.pop_front();
+  return c;
+}
+
+int HardwareSerial::peek() {
+  return rxBuffer.empty() ? -1 : rxBuffer.front();
+}
+
+int HardwareSerial::availableForWrite() {
+  simSerialService();
+  return (int)(SERIAL_TX_BUFFER_SIZE - 1 - txBuffer.size());
+}
+
+void HardwareSerial::flush() {
+  while (!txBuffer.empty()) {
+    uint64_t wait = serialNextDrainUs > simNowUs() ? serialNextDrainUs - simNowUs() : 0;
+    serialStats.blockedUs += wait;
+    simAdvanceUs(wait);
+  }
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+  simSerialService();
+
+  // Blocking write: wait for the ISR to free a slot, just like the UNO core
+  while (txBuffer.size() >= SERIAL_TX_BUFFER_SIZE - 1) {
+    uint64_t wait = serialNextDrainUs > simNowUs() ? serialNextDrainUs - simNowUs() : 0;
+    serialStats.blockedUs += wait;
+    simAdvanceUs(wait);
+  }
+
+  if (txBuffer.empty() && serialNextDrainUs < simNowUs() + byteTimeUs()) {
+    serialNextDrainUs = simNowUs() + byteTimeUs();
+  }
+  txBuffer.push_back(c);
+  serialStats.bytesWritten++;
+  return 1;
+}
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size) {
+  for (size_t i = 0; i < size; i++) write(buffer[i]);
+  return size;
+}
+
+size_t HardwareSerial::print(long n, int base) {
+  if (base == DEC && n < 0) {
+    write('-');
+    return print((unsigned long)(-n), base) + 1;
+  }
+  return print((unsigned long)n, base);
+}
+
+size_t HardwareSerial::print(unsigned long n, int base) {
+  char buf[8 * sizeof(long) + 1];
+  char *p = &buf[sizeof(buf) - 1];
+  *p = '\0';
+  if (base < 2) base = 10;
+  do {
+    unsigned long digit = n % base;
+    *--p = (char)(digit < 10 ? '0' + digit : 'A' + digit - 10);
+    n /= base;
+  } while (n != 0);
+  return write(p);
+}
+
+size_t HardwareSerial::print(double n, int digits) {
+  char buf[32];
+  snprintf(buf, sizeof(buf), "%.*f", digits, n);
+  return write(buf);
+}
@@ -0,0 +1,189 @@
+/**
+ * CalSim.cpp
+ *
+ * Host run of the calibrator's auto mode (ServoPulseCalibrator/AutoCalibrator)
+ * against binding servos
+ *
+ * Each channel of AUTO_CHANNEL_LIST gets an SG90-like servo with its own
+ * mechanical stops, placed at random inside (or, sometimes, outside) the
+ * channel's search window. Servos slew toward the commanded pulse at a
+ * fixed rate; the current probe reads the rail:
+ *   idle draw per servo + travel current while moving
+ *   + stall current growing with how far the servo is pushed past a stop
+ *     (beyond a small deadband), capped
+ *   + ADC noise
+ * on the virtual clock, so a session's duration is what the board would take.
+ *
+ * The calibrator's Serial output (progress, paste-ready EyeConfig.h block)
+ * goes to stdout; then every found limit is checked against the true stop:
+ * no stall AT the limit, and no more range lost than margin + resolution.
+ *
+ * USAGE:
+ *   calsim [--seed N]
+ *   Exit status 0 when every limit checks out.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "AutoCalibrator.h"
+#include "CalibratorConfig.h"
+#include "SimHardware.h"
+
+// ============================================================================
+// BINDING SERVO MODEL
+// ============================================================================
+
+static const double SLEW_UNITS_PER_MS = 1.6;  // SG90: 60 deg / 0.1 s at 4.07 us/unit
+static const int IDLE_COUNTS = 8;             // Holding current per servo
+static const int RAIL_OFFSET_COUNTS = 30;     // Sensor offset
+static const int MOVING_COUNTS = 60;
+static const int STALL_DEADBAND = 2;          // Units past a stop before it pushes
+static const int STALL_COUNTS_PER_UNIT = 20;
+static const int STALL_MAX_COUNTS = 250;
+static const int NOISE_COUNTS = 4;            // Uniform +-
+
+#define CALSIM_CHANNEL(name, channel, floor, ceiling, kind, inverted) \
+  { name, channel, floor, ceiling, kind, inverted },
+static const AutoChannel CHANNELS[] = { AUTO_CHANNEL_LIST(CALSIM_CHANNEL) };
+static const uint8_t CHANNEL_COUNT = sizeof(CHANNELS) / sizeof(CHANNELS[0]);
+
+struct ModelServo {
+  int stopLow;
+  int stopHigh;
+  int commanded;               // 0 = never driven (limp)
+  double position;
+  uint64_t updatedUs;
+  uint32_t stalledMs;          // Longest continuous stall
+  uint64_t stallSinceUs;
+  bool stalled;
+};
+
+static ModelServo servos[16];
+
+static int overshoot(const ModelServo &s) {
+  if (s.commanded == 0) return 0;
+  if (s.commanded < s.stopLow) return s.stopLow - s.commanded;
+  if (s.commanded > s.stopHigh) return s.commanded - s.stopHigh;
+  return 0;
+}
+
+static void advance(ModelServo &s) {
+  uint64_t now = simNowUs();
+  if (s.commanded != 0) {
+    double target = s.commanded < s.stopLow ? s.stopLow
+                  : s.commanded > s.stopHigh ? s.stopHigh : s.commanded;
+    double step = SLEW_UNITS_PER_MS * (now - s.updatedUs) / 1000.0;
+    if (s.position < target) s.position = s.position + step < target ? s.position + step : target;
+    else s.position = s.position - step > target ? s.position - step : target;
+  }
+  s.updatedUs = now;
+}
+
+static void trackStall(ModelServo &s) {
+  bool pushing = overshoot(s) > STALL_DEADBAND;
+  uint64_t now = simNowUs();
+  if (pushing && !s.stalled) s.stallSinceUs = now;
+  if (s.stalled) {
+    uint32_t ms = (uint32_t)((now - s.stallSinceUs) / 1000);
+    if (ms > s.stalledMs) s.stalledMs = ms;
+  }
+  s.stalled = pushing;
+}
+
+void calibratorWritePulse(uint8_t channel, uint16_t pulse) {
+  ModelServo &s = servos[channel & 15];
+  advance(s);
+  trackStall(s);
+  if (s.commanded == 0) s.position = pulse;   // First pulse: assume it starts there
+  s.commanded = pulse;
+  trackStall(s);
+}
+
+int calibratorReadProbe() {
+  int counts = RAIL_OFFSET_COUNTS;
+  for (uint8_t i = 0; i < CHANNEL_COUNT; i++) {
+    ModelServo &s = servos[CHANNELS[i].channel];
+    advance(s);
+    trackStall(s);
+    if (s.commanded == 0) continue;
+
+    counts += IDLE_COUNTS;
+    double target = s.commanded < s.stopLow ? s.stopLow
+                  : s.commanded > s.stopHigh ? s.stopHigh : s.commanded;
+    if (s.position != target) counts += MOVING_COUNTS;
+    int push = overshoot(s) - STALL_DEADBAND;
+    if (push > 0) {
+      counts += push * STALL_COUNTS_PER_UNIT < STALL_MAX_COUNTS ? push * STALL_COUNTS_PER_UNIT
+                                                                : STALL_MAX_COUNTS;
+    }
+  }
+  simAdvanceUs(112);   // One AVR conversion
+  return counts + (int)random(-NOISE_COUNTS, NOISE_COUNTS + 1);
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+int main(int argc, char **argv) {
+  unsigned long seed = 1;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--seed") && i + 1 < argc) seed = strtoul(argv[++i], NULL, 10);
+    else {
+      fprintf(stderr, "usage: calsim [--seed N]\n");
+      return 1;
+    }
+  }
+
+  // Stops 8-48 units inside the window; one side in four outside it
+  randomSeed(seed);
+  for (uint8_t i = 0; i < CHANNEL_COUNT; i++) {
+    const AutoChannel &c = CHANNELS[i];
+    ModelServo &s = servos[c.channel];
+    memset(&s, 0, sizeof(s));
+    s.stopLow = random(4) == 0 ? c.floor - 20 : c.floor + 8 + random(40);
+    s.stopHigh = random(4) == 0 ? c.ceiling + 20 : c.ceiling - 8 - random(40);
+  }
+
+  simSerialSetSink(stdout);
+  const AutoProbeSettings probe = {
+    PROBE_STALL_RISE, PROBE_SETTLE_MS, PROBE_SAMPLES, AUTO_MARGIN, AUTO_RESOLUTION
+  };
+  AutoCalibrator calibrator(CHANNELS, CHANNEL_COUNT, probe);
+  bool ran = calibrator.run();
+  calibrator.printConfig();
+  fflush(stdout);
+
+  // A limit must not stall the servo, and must not give away more than
+  // margin + resolution of the real range. Stops outside the window must
+  // come back as the window edge.
+  const int slack = AUTO_MARGIN + AUTO_RESOLUTION;
+  bool pass = ran;
+  printf("\n=== calsim (seed %lu) ===\n", seed);
+  printf("%-18s %13s %13s %10s %10s %7s %s\n", "channel", "stops", "limits", "lost low",
+         "lost high", "probes", "max stall ms");
+  for (uint8_t i = 0; i < CHANNEL_COUNT; i++) {
+    const AutoChannel &c = CHANNELS[i];
+    const ModelServo &s = servos[c.channel];
+    const AutoResult &r = calibrator.result(i);
+    int expectLow = s.stopLow < c.floor ? c.floor : s.stopLow;
+    int expectHigh = s.stopHigh > c.ceiling ? c.ceiling : s.stopHigh;
+    int lostLow = r.low - expectLow;
+    int lostHigh = expectHigh - r.high;
+    bool ok = r.ok && lostLow >= -STALL_DEADBAND && lostLow <= slack &&
+              lostHigh >= -STALL_DEADBAND && lostHigh <= slack &&
+              r.lowFound == (s.stopLow >= c.floor) && r.highFound == (s.stopHigh <= c.ceiling);
+    if (!ok) pass = false;
+    char stops[32];
+    char limits[32];
+    snprintf(stops, sizeof(stops), "%d-%d", s.stopLow, s.stopHigh);
+    snprintf(limits, sizeof(limits), "%d-%d", r.low, r.high);
+    printf("%-18s %13s %13s %10d %10d %7u %12u%s\n", c.name, stops, limits, lostLow, lostHigh,
+           r.probes, s.stalledMs, ok ? "" : "  FAIL");
+  }
+  printf("session %.1f s (virtual), %s\n", calibrator.sessionMs() / 1000.0,
+         pass ? "PASS" : "FAIL");
+  return pass ? 0 : 1;
+}
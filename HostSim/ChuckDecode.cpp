@@ -0,0 +1,127 @@
+/**
+ * ChuckDecode.cpp
+ *
+ * Decodes NunchuckCharacterization's binary statistics dump ('b') and
+ * proposes the eye sketch's NunchuckCalibration / DEADZONE
+ *
+ * Reads a raw capture of the Serial port (e.g. `cat /dev/ttyACM0 >
+ * chuck.bin` while sending 'b', or chucksim --dump). Text between frames
+ * is skipped. The proposal is NunchuckStats' own, so it matches what 's'
+ * prints on the board; on top of that every axis' RANGE histogram is drawn.
+ *
+ * USAGE:
+ *   chuckdecode [CAPTURE]      (stdin if no CAPTURE)
+ *   Exit status 1 if the capture holds no complete dump.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "FrameReader.h"
+#include "NunchuckStats.h"
+#include "SimHardware.h"
+
+static_assert(STATS_FRAME_SESSION == FRAME_CHUCK_SESSION && STATS_FRAME_AXIS == FRAME_CHUCK_AXIS,
+              "NunchuckStats.h frame types must match SerialFraming.h");
+
+static const char *const AXIS_NAMES[STATS_AXES] = {"joy X", "joy Y", "acc X", "acc Y", "acc Z"};
+static const int BAR_WIDTH = 50;
+
+// NunchuckStats' sample hook: the decoder never captures
+bool chuckReadSample(ChuckReading &sample) {
+  return false;
+}
+
+static uint8_t payloadSize(uint8_t type) {
+  switch (type) {
+    case FRAME_CHUCK_SESSION: return sizeof(NunchuckSessionStats);
+    case FRAME_CHUCK_AXIS: return sizeof(NunchuckAxisStats);
+  }
+  return 0;
+}
+
+static void printHistogram(const NunchuckAxisStats &a) {
+  uint16_t peak = 0;
+  for (int i = 0; i < STATS_BINS; i++) {
+    if (a.bins[i] > peak) peak = a.bins[i];
+  }
+  printf("\n%s  RANGE %u-%u\n", AXIS_NAMES[a.axis], a.min, a.max);
+  if (peak == 0) {
+    printf("  (no RANGE samples)\n");
+    return;
+  }
+  int shift = a.axis < STATS_ACC_X ? STATS_JOY_BIN_SHIFT : STATS_ACCEL_BIN_SHIFT;
+  for (int i = 0; i < STATS_BINS; i++) {
+    if (a.bins[i] == 0) continue;
+    int width = (int)((long)a.bins[i] * BAR_WIDTH / peak);
+    printf("  %4d-%-4d %6u %.*s\n", i << shift, ((i + 1) << shift) - 1, a.bins[i],
+           width > 0 ? width : 1, "##################################################");
+  }
+}
+
+int main(int argc, char **argv) {
+  const char *capturePath = NULL;
+  for (int i = 1; i < argc; i++) {
+    if (argv[i][0] != '-' && capturePath == NULL) capturePath = argv[i];
+    else {
+      fprintf(stderr, "usage: chuckdecode [CAPTURE]\n");
+      return 1;
+    }
+  }
+
+  FILE *in = capturePath ? fopen(capturePath, "rb") : stdin;
+  if (in == NULL) {
+    fprintf(stderr, "chuckdecode: cannot read %s\n", capturePath);
+    return 1;
+  }
+
+  // The last complete dump wins: a session record starts one
+  FrameReader reader(payloadSize);
+  NunchuckStats stats;
+  bool haveSession = false;
+  uint8_t haveAxes = 0;
+
+  uint8_t chunk[4096];
+  size_t got;
+  while ((got = fread(chunk, 1, sizeof(chunk), in)) > 0) {
+    reader.feed(chunk, got);
+
+    uint8_t type, sequence;
+    const uint8_t *payload;
+    while (reader.next(type, sequence, payload)) {
+      if (type == FRAME_CHUCK_SESSION) {
+        NunchuckSessionStats s;
+        memcpy(&s, payload, sizeof(s));
+        stats.reset();
+        stats.load(s);
+        haveSession = true;
+        haveAxes = 0;
+      } else if (type == FRAME_CHUCK_AXIS && haveSession) {
+        NunchuckAxisStats a;
+        memcpy(&a, payload, sizeof(a));
+        if (a.axis >= STATS_AXES) continue;
+        stats.load(a);
+        haveAxes |= 1 << a.axis;
+      }
+    }
+  }
+  if (in != stdin) fclose(in);
+
+  const FrameReaderStats &frames = reader.stats();
+  fprintf(stderr, "chuckdecode: %lu frames, %lu CRC errors, %lu bytes skipped\n", frames.frames,
+          frames.crcErrors, frames.skippedBytes);
+  if (!haveSession || haveAxes != (1 << STATS_AXES) - 1) {
+    fprintf(stderr, "chuckdecode: no complete statistics dump in the capture ('b' sent?)\n");
+    return 1;
+  }
+
+  for (uint8_t i = 0; i < STATS_AXES; i++) printHistogram(stats.axisStats(i));
+
+  // The board's own summary, through the Serial shim
+  simSerialSetSink(stdout);
+  Serial.begin(115200);
+  stats.printSummary();
+  Serial.flush();
+  return 0;
+}
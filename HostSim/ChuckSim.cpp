@@ -0,0 +1,193 @@
+/**
+ * ChuckSim.cpp
+ *
+ * Host run of NunchuckCharacterization's statistics (NunchuckStats) against
+ * a modelled nunchuck with known properties
+ *
+ * The nunchuck has its own joystick range, a rest center that lands a
+ * little differently after every flick of the stick, Gaussian rest noise
+ * on every axis and the odd failed read. A session is what the README
+ * suggests: four REST captures with a flick between them, one RANGE
+ * capture rolling the stick around its rim, then the summary - on the
+ * virtual clock, one read per NUNCHUCK read time.
+ *
+ * The proposed NunchuckCalibration / DEADZONE are checked against the
+ * model: range within the inset of the true extremes, center on the true
+ * rest center, a deadzone that covers every rest reading without being
+ * much wider, accelerometer noise within 20%.
+ *
+ * USAGE:
+ *   chucksim [--seed N] [--dump FILE]
+ *     --dump FILE  the binary dump ('b') into FILE, for chuckdecode
+ *   Exit status 0 when every proposal checks out.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "NunchuckStats.h"
+#include "SimHardware.h"
+
+// ============================================================================
+// NUNCHUCK MODEL
+// ============================================================================
+
+static const uint32_t READ_US = 450;          // 400 kHz: address + 6 bytes + conversion
+static const double RANGE_CIRCLES_PER_S = 1.5;
+static const int FAIL_ONE_IN = 200;
+static const int REST_CAPTURES = 4;
+
+struct ModelChuck {
+  int minX, maxX, minY, maxY;
+  double centerX, centerY;   // Where the stick rests on average
+  double restX, restY;       // Where it rests this time
+  double joySigma;
+  double accRest[3];
+  double accSigma[3];
+  bool rolling;              // RANGE capture: stick around the rim
+};
+
+static ModelChuck chuck;
+
+static double gaussian() {
+  // Box-Muller
+  double u = (random(1, 1000000) / 1000000.0);
+  double v = (random(1, 1000000) / 1000000.0);
+  return sqrt(-2.0 * log(u)) * cos(2 * M_PI * v);
+}
+
+static int clampInt(double value, int low, int high) {
+  int v = (int)lround(value);
+  return v < low ? low : v > high ? high : v;
+}
+
+bool chuckReadSample(ChuckReading &sample) {
+  simAdvanceUs(READ_US);
+  if (random(FAIL_ONE_IN) == 0) {
+    memset(&sample, 0xFF, sizeof(sample));
+    return false;
+  }
+
+  double x, y;
+  if (chuck.rolling) {
+    double turn = 2 * M_PI * RANGE_CIRCLES_PER_S * simNowUs() / 1e6;
+    // Past the gate: the rim clips it
+    x = chuck.restX + 1.3 * (chuck.maxX - chuck.minX) / 2 * cos(turn);
+    y = chuck.restY + 1.3 * (chuck.maxY - chuck.minY) / 2 * sin(turn);
+  } else {
+    x = chuck.restX + chuck.joySigma * gaussian();
+    y = chuck.restY + chuck.joySigma * gaussian();
+  }
+  sample.joyX = clampInt(x, chuck.minX, chuck.maxX);
+  sample.joyY = clampInt(y, chuck.minY, chuck.maxY);
+  for (int i = 0; i < 3; i++) {
+    double tilt = chuck.rolling ? 200 * sin(simNowUs() / 3e5 + i) : 0;
+    sample.acc[i] = clampInt(chuck.accRest[i] + tilt + chuck.accSigma[i] * gaussian(), 0, 1023);
+  }
+  // Buttons: pressed for 200 ms every second while rolling
+  bool press = chuck.rolling && (simNowUs() / 1000) % 1000 < 200;
+  sample.buttonZ = press && (simNowUs() / 1000000) % 2 == 0;
+  sample.buttonC = press && (simNowUs() / 1000000) % 2 == 1;
+  return true;
+}
+
+static void flick() {
+  chuck.restX = chuck.centerX + random(-20, 21) / 10.0;
+  chuck.restY = chuck.centerY + random(-20, 21) / 10.0;
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+static bool check(const char *what, double value, double low, double high) {
+  bool ok = value >= low && value <= high;
+  printf("%-22s %8.2f   expected %7.2f .. %-7.2f %s\n", what, value, low, high,
+         ok ? "" : "FAIL");
+  return ok;
+}
+
+int main(int argc, char **argv) {
+  unsigned long seed = 1;
+  const char *dumpPath = NULL;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--seed") && i + 1 < argc) seed = strtoul(argv[++i], NULL, 10);
+    else if (!strcmp(argv[i], "--dump") && i + 1 < argc) dumpPath = argv[++i];
+    else {
+      fprintf(stderr, "usage: chucksim [--seed N] [--dump FILE]\n");
+      return 1;
+    }
+  }
+
+  // A nunchuck a bit off from the textbook 0-255 / 128
+  randomSeed(seed);
+  chuck.minX = 20 + random(15);
+  chuck.maxX = 220 + random(15);
+  chuck.minY = 20 + random(15);
+  chuck.maxY = 220 + random(15);
+  chuck.centerX = 124 + random(0, 80) / 10.0;
+  chuck.centerY = 124 + random(0, 80) / 10.0;
+  chuck.joySigma = 0.4 + random(0, 60) / 100.0;
+  for (int i = 0; i < 3; i++) {
+    chuck.accRest[i] = i == 2 ? 720 : 500 + random(30);
+    chuck.accSigma[i] = 1.5 + random(0, 250) / 100.0;
+  }
+
+  simSerialSetSink(stdout);
+  Serial.begin(115200);
+  NunchuckStats stats;
+  for (int i = 0; i < REST_CAPTURES; i++) {
+    flick();
+    stats.capture(STATS_REST, 2000);
+  }
+  flick();
+  chuck.rolling = true;
+  stats.capture(STATS_RANGE, 6000);
+  chuck.rolling = false;
+  stats.printSummary();
+  Serial.flush();
+
+  if (dumpPath) {
+    FILE *dump = fopen(dumpPath, "wb");
+    if (!dump) {
+      perror(dumpPath);
+      return 1;
+    }
+    simSerialSetSink(dump);
+    stats.writeDump();
+    Serial.flush();
+    simSerialSetSink(stdout);
+    fclose(dump);
+  }
+  fflush(stdout);
+
+  // The farthest any rest reading can be from the true center: the
+  // flicks' ±2 plus the noise tail
+  NunchuckProposal p;
+  stats.propose(p);
+  double center = (chuck.centerX + chuck.centerY) / 2;
+  double reach = 2 + 4.5 * chuck.joySigma + fabs(chuck.centerX - chuck.centerY) / 2;
+
+  printf("\n=== chucksim (seed %lu) ===\n", seed);
+  bool pass = true;
+  pass &= check("JOY_X_MIN", p.joyXMin, chuck.minX, chuck.minX + STATS_RANGE_INSET);
+  pass &= check("JOY_X_MAX", p.joyXMax, chuck.maxX - STATS_RANGE_INSET, chuck.maxX);
+  pass &= check("JOY_Y_MIN", p.joyYMin, chuck.minY, chuck.minY + STATS_RANGE_INSET);
+  pass &= check("JOY_Y_MAX", p.joyYMax, chuck.maxY - STATS_RANGE_INSET, chuck.maxY);
+  pass &= check("CENTER", p.center, center - 1.5, center + 1.5);
+  pass &= check("DEADZONE", p.deadzone, 2 + 3 * chuck.joySigma, reach + 4);
+  for (int i = 0; i < 3; i++) {
+    char name[24];
+    snprintf(name, sizeof(name), "acc %c sigma", 'X' + i);
+    pass &= check(name, p.restSigma[STATS_ACC_X + i], chuck.accSigma[i] * 0.8,
+                  chuck.accSigma[i] * 1.2);
+  }
+  pass &= check("rest moved", p.restMoved, 0, 0);
+  const NunchuckSessionStats &s = stats.sessionStats();
+  pass &= check("Z presses", s.pressesZ, 2, 4);
+  pass &= check("C presses", s.pressesC, 2, 4);
+  printf("session %.1f s (virtual), %s\n", simNowUs() / 1e6, pass ? "PASS" : "FAIL");
+  return pass ? 0 : 1;
+}
@@ -0,0 +1,456 @@
+/**
+ * EyeSim.cpp
+ *
+ * Host-side simulator for EyesIntegration_Enhanced_v4
+ *
+ * Runs the real setup()/loop() against the virtual clock, a mock PCA9685
+ * per servo board in SERVO_BOARD_LIST and a scripted nunchuck, then reports
+ * where the time went - and what the servos drew, per animation.
+ *
+ * USAGE:
+ *   eyesim [options]
+ *     --duration S        Virtual seconds to simulate (default 60)
+ *     --script FILE       Nunchuck script (see SimHardware.h for format)
+ *     --no-nunchuck       Nunchuck unplugged for the whole run
+ *     --trace FILE        CSV of every PCA9685 channel write
+ *     --serial            Echo firmware Serial output to stdout
+ *     --serial-log FILE   Raw Serial output to FILE (binary telemetry → teledecode)
+ *     --seed N            Value returned by analogRead(A0) (random seed)
+ *     --loop-overhead US  CPU time charged per loop() call (default 20)
+ *     --pty               Attach Serial to a new pseudo-terminal (path printed on
+ *                         stderr) and run in real time, so host tools such as
+ *                         gazesend can talk to the firmware like to a real board
+ *     --eeprom FILE       EEPROM image: loaded before setup() if it exists,
+ *                         written back at the end (saved calibration survives)
+ *     --send MS:TEXT      Type TEXT + newline into Serial at virtual time MS
+ *                         (repeatable; e.g. --send "3000:cal set 0 h 230 345 460")
+ *     --replay MS:FILE    From virtual time MS the nunchuck plays a recorded
+ *                         performance (PerformanceLog.h, from teledecode
+ *                         --performance) instead of the script, then rests
+ *     --power-budget MA   Servo current budget instead of PowerSettings::BUDGET_MA
+ *                         (0 = never limit; the estimate is reported either way)
+ *     --max-overruns N    Exit status 1 if the rate groups skipped more than N
+ *                         ticks between them (make sim-check: 0)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <string>
+
+#include "ChannelTable.h"
+#include "PerformanceLog.h"
+#include "SimFirmware.h"
+#include "SimHardware.h"
+
+// ============================================================================
+// OPTIONS
+// ============================================================================
+
+// One --send: text typed into the Serial port at a virtual time
+struct SimTypedLine {
+  uint64_t timeUs;
+  std::string text;
+};
+
+struct SimOptions {
+  double durationS;
+  const char *scriptPath;
+  bool noNunchuck;
+  const char *tracePath;
+  bool echoSerial;
+  const char *serialLogPath;
+  int seed;
+  uint32_t loopOverheadUs;
+  bool pty;
+  const char *eepromPath;
+  std::vector<SimTypedLine> sends;
+  uint32_t replayMs;
+  const char *replayPath;
+  long powerBudgetMa;           // -1: the firmware's
+  long maxOverruns;             // -1: not checked
+};
+
+static void usage() {
+  fprintf(stderr,
+          "usage: eyesim [--duration S] [--script FILE] [--no-nunchuck] [--trace FILE]\n"
+          "              [--serial | --serial-log FILE | --pty] [--seed N] [--loop-overhead US]\n"
+          "              [--eeprom FILE] [--send MS:TEXT]... [--replay MS:FILE]\n"
+          "              [--power-budget MA] [--max-overruns N]\n");
+  exit(1);
+}
+
+static SimOptions parseOptions(int argc, char **argv) {
+  SimOptions opt = {60.0, NULL, false, NULL, false, NULL, 42, 20, false, NULL,
+                    std::vector<SimTypedLine>(), 0, NULL, -1, -1};
+  for (int i = 1; i < argc; i++) {
+    const char *arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (!strcmp(arg, "--duration") && hasValue) opt.durationS = atof(argv[++i]);
+    else if (!strcmp(arg, "--script") && hasValue) opt.scriptPath = argv[++i];
+    else if (!strcmp(arg, "--no-nunchuck")) opt.noNunchuck = true;
+    else if (!strcmp(arg, "--trace") && hasValue) opt.tracePath = argv[++i];
+    else if (!strcmp(arg, "--serial")) opt.echoSerial = true;
+    else if (!strcmp(arg, "--serial-log") && hasValue) opt.serialLogPath = argv[++i];
+    else if (!strcmp(arg, "--seed") && hasValue) opt.seed = atoi(argv[++i]);
+    else if (!strcmp(arg, "--loop-overhead") && hasValue) opt.loopOverheadUs = (uint32_t)atoi(argv[++i]);
+    else if (!strcmp(arg, "--pty")) opt.pty = true;
+    else if (!strcmp(arg, "--eeprom") && hasValue) opt.eepromPath = argv[++i];
+    else if (!strcmp(arg, "--send") && hasValue) {
+      const char *value = argv[++i];
+      const char *colon = strchr(value, ':');
+      if (colon == NULL) usage();
+      SimTypedLine line = {(uint64_t)(atof(value) * 1000), std::string(colon + 1) + "\n"};
+      opt.sends.push_back(line);
+    }
+    else if (!strcmp(arg, "--replay") && hasValue) {
+      const char *value = argv[++i];
+      const char *colon = strchr(value, ':');
+      if (colon == NULL) usage();
+      opt.replayMs = (uint32_t)atol(value);
+      opt.replayPath = colon + 1;
+    }
+    else if (!strcmp(arg, "--power-budget") && hasValue) opt.powerBudgetMa = atol(argv[++i]);
+    else if (!strcmp(arg, "--max-overruns") && hasValue) opt.maxOverruns = atol(argv[++i]);
+    else usage();
+  }
+  if ((opt.echoSerial ? 1 : 0) + (opt.serialLogPath ? 1 : 0) + (opt.pty ? 1 : 0) > 1) usage();
+  return opt;
+}
+
+// ============================================================================
+// PERFORMANCE REPLAY
+// ============================================================================
+
+static uint8_t memoryByte(uint32_t offset, void *context) {
+  return (*(std::vector<uint8_t> *)context)[offset];
+}
+
+/**
+ * A recorded performance as nunchuck script steps from startMs on, one per
+ * recorded tick; the stick rests after the last. Returns the ticks, or -1.
+ */
+static long loadReplay(const char *path, uint32_t startMs) {
+  FILE *f = fopen(path, "rb");
+  if (f == NULL) return -1;
+  PerformanceHeader header;
+  std::vector<uint8_t> data;
+  bool ok = fread(&header, sizeof(header), 1, f) == 1 && header.magic == PERFORMANCE_MAGIC &&
+            header.version == PERFORMANCE_VERSION;
+  if (ok) {
+    data.resize(header.length);
+    ok = header.length == 0 || fread(data.data(), header.length, 1, f) == 1;
+  }
+  fclose(f);
+  if (!ok) return -1;
+  uint16_t crc = FRAME_CRC_INIT;
+  for (size_t i = 0; i < data.size(); i++) crc = frameCrcUpdate(crc, data[i]);
+  if (crc != header.crc) return -1;
+
+  PerformanceDecoder decoder;
+  decoder.begin(header, memoryByte, &data);
+  simNunchuckClearScriptFrom(startMs);
+  NunchuckScriptStep step = {startMs, simNunchuckSampleAt((uint64_t)startMs * 1000)};
+  step.sample.connected = true;
+  long ticks = 0;
+  PerformanceSample sample;
+  while (decoder.next(sample)) {
+    step.sample.joyX = sample.joyX;
+    step.sample.joyY = sample.joyY;
+    step.sample.buttonZ = (sample.buttons & PERFORMANCE_BUTTON_Z) != 0;
+    step.sample.buttonC = (sample.buttons & PERFORMANCE_BUTTON_C) != 0;
+    simNunchuckAddStep(step);
+    step.timeMs += sample.dtMs;
+    ticks++;
+  }
+  step.sample.joyX = NunchuckCalibration::CENTER;
+  step.sample.joyY = NunchuckCalibration::CENTER;
+  step.sample.buttonZ = false;
+  step.sample.buttonC = false;
+  simNunchuckAddStep(step);
+  return ticks;
+}
+
+// ============================================================================
+// PSEUDO-TERMINAL (real-time Serial link for host tools)
+// ============================================================================
+
+struct SimPty {
+  int master;
+  int slave;               // Held open so reads don't fail between clients
+  FILE *tx;
+  char path[128];
+};
+
+static bool ptyOpen(SimPty &pty) {
+  pty.master = posix_openpt(O_RDWR | O_NOCTTY);
+  if (pty.master < 0 || grantpt(pty.master) != 0 || unlockpt(pty.master) != 0) return false;
+  snprintf(pty.path, sizeof(pty.path), "%s", ptsname(pty.master));
+
+  // Raw bytes both ways (no echo, no line editing)
+  pty.slave = open(pty.path, O_RDWR | O_NOCTTY);
+  if (pty.slave < 0) return false;
+  struct termios raw;
+  tcgetattr(pty.slave, &raw);
+  cfmakeraw(&raw);
+  tcsetattr(pty.slave, TCSANOW, &raw);
+
+  // Never block the simulation: unread output is simply lost
+  fcntl(pty.master, F_SETFL, fcntl(pty.master, F_GETFL) | O_NONBLOCK);
+  pty.tx = fdopen(dup(pty.master), "w");
+  if (pty.tx == NULL) return false;
+  setvbuf(pty.tx, NULL, _IONBF, 0);
+  return true;
+}
+
+static void ptyReceive(SimPty &pty) {
+  uint8_t buffer[256];
+  ssize_t got;
+  while ((got = read(pty.master, buffer, sizeof(buffer))) > 0) {
+    simSerialInject(buffer, (size_t)got);
+  }
+}
+
+static double wallSeconds() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static bool typedEarlier(const SimTypedLine &a, const SimTypedLine &b) {
+  return a.timeUs < b.timeUs;
+}
+
+static bool pwmWriteEarlier(const PwmWrite &a, const PwmWrite &b) {
+  return a.timeUs < b.timeUs;
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+// ============================================================================
+// SERVO CURRENT
+// ============================================================================
+
+// Estimated servo current while one animation ran, time-weighted
+struct SimPowerStats {
+  uint64_t us;
+  double chargeMaUs;
+  unsigned peakMa;
+  unsigned peakDemandMa;       // Before the budget slowed anything down
+  uint64_t limitedUs;
+};
+
+static void powerAdd(SimPowerStats &p, uint64_t us, unsigned drawMa, unsigned demandMa,
+                     bool limited) {
+  p.us += us;
+  p.chargeMaUs += (double)drawMa * us;
+  if (drawMa > p.peakMa) p.peakMa = drawMa;
+  if (demandMa > p.peakDemandMa) p.peakDemandMa = demandMa;
+  if (limited) p.limitedUs += us;
+}
+
+static void powerPrint(const char *name, const SimPowerStats &p) {
+  printf("  %-10s %9.3f %8.0f %8u %10u %8.1f\n", name, p.us / 1e6,
+         p.us ? p.chargeMaUs / p.us : 0.0, p.peakMa, p.peakDemandMa,
+         p.us ? 100.0 * p.limitedUs / p.us : 0.0);
+}
+
+int main(int argc, char **argv) {
+  SimOptions opt = parseOptions(argc, argv);
+
+  std::vector<MockPCA9685 *> shields;
+  for (uint8_t b = 0; b < SERVO_BOARD_COUNT; b++) {
+    shields.push_back(simAddPCA9685(servoBoardAddress(b)));
+    shields.back()->setLogging(opt.tracePath != NULL);
+  }
+  simAddNunchuck();
+
+  if (opt.scriptPath != NULL && !simNunchuckLoadScript(opt.scriptPath)) {
+    fprintf(stderr, "eyesim: cannot load script %s\n", opt.scriptPath);
+    return 1;
+  }
+  long replayTicks = 0;
+  if (opt.replayPath != NULL && (replayTicks = loadReplay(opt.replayPath, opt.replayMs)) < 0) {
+    fprintf(stderr, "eyesim: cannot replay %s (not a valid recording)\n", opt.replayPath);
+    return 1;
+  }
+  if (opt.noNunchuck) {
+    NunchuckScriptStep unplugged = {0, simNunchuckSampleAt(0)};
+    unplugged.sample.connected = false;
+    simNunchuckClearScript();
+    simNunchuckAddStep(unplugged);
+  }
+
+  simAnalogSet(A0, opt.seed);
+  FILE *serialLog = NULL;
+  if (opt.serialLogPath != NULL && (serialLog = fopen(opt.serialLogPath, "wb")) == NULL) {
+    fprintf(stderr, "eyesim: cannot write %s\n", opt.serialLogPath);
+    return 1;
+  }
+  SimPty pty;
+  if (opt.pty) {
+    if (!ptyOpen(pty)) {
+      fprintf(stderr, "eyesim: cannot create pseudo-terminal\n");
+      return 1;
+    }
+    fprintf(stderr, "eyesim: pty %s\n", pty.path);
+    fflush(stderr);
+  }
+  simSerialSetSink(opt.echoSerial ? stdout : opt.pty ? pty.tx : serialLog);
+  if (opt.eepromPath != NULL) simEepromLoad(opt.eepromPath);
+  std::stable_sort(opt.sends.begin(), opt.sends.end(), typedEarlier);
+  size_t nextSend = 0;
+
+  double wallStart = wallSeconds();
+
+  if (opt.powerBudgetMa >= 0) simFirmwareSetPowerBudget((unsigned)opt.powerBudgetMa);
+  setup();
+  uint64_t setupUs = simNowUs();
+  simBusStatsReset();
+  uint32_t setupWrites = 0;
+  uint32_t setupRedundant = 0;
+  for (size_t b = 0; b < shields.size(); b++) {
+    setupWrites += shields[b]->channelWrites();
+    setupRedundant += shields[b]->redundantWrites();
+  }
+
+  const uint64_t endUs = (uint64_t)(opt.durationS * 1e6);
+  const int stateCount = simFirmwareStateCount();
+  uint64_t stateUs[8] = {0};
+  uint64_t loops = 0;
+  uint64_t maxPeriodUs = 0;
+  const int animationCount = simFirmwareAnimationCount();
+  SimPowerStats power[8];
+  SimPowerStats powerTotal;
+  memset(power, 0, sizeof(power));
+  memset(&powerTotal, 0, sizeof(powerTotal));
+
+  while (simNowUs() < endUs) {
+    uint64_t start = simNowUs();
+    int state = simFirmwareState();
+
+    loop();
+    simAdvanceUs(opt.loopOverheadUs);
+
+    while (nextSend < opt.sends.size() && opt.sends[nextSend].timeUs <= simNowUs()) {
+      const std::string &text = opt.sends[nextSend++].text;
+      simSerialInject((const uint8_t *)text.data(), text.size());
+    }
+
+    if (opt.pty) {
+      // Hold virtual time to the wall clock, then take what the host sent
+      uint64_t wallUs = (uint64_t)((wallSeconds() - wallStart) * 1e6);
+      if (simNowUs() > wallUs + 500) usleep((useconds_t)(simNowUs() - wallUs));
+      ptyReceive(pty);
+    }
+
+    uint64_t period = simNowUs() - start;
+    if (period > maxPeriodUs) maxPeriodUs = period;
+    if (state >= 0 && state < stateCount) stateUs[state] += period;
+    int animation = simFirmwareAnimation();
+    unsigned drawMa, demandMa;
+    bool limited;
+    simFirmwarePower(&drawMa, &demandMa, &limited);
+    if (animation >= 0 && animation < animationCount) {
+      powerAdd(power[animation], period, drawMa, demandMa, limited);
+    }
+    powerAdd(powerTotal, period, drawMa, demandMa, limited);
+    loops++;
+  }
+
+  double wall = wallSeconds() - wallStart;
+  double simS = simNowUs() / 1e6;
+  const SimBusStats &bus = simBusStats();
+  const SimSerialStats &serial = simSerialStats();
+  uint32_t loopWrites = 0;
+  uint32_t loopRedundant = 0;
+  for (size_t b = 0; b < shields.size(); b++) {
+    loopWrites += shields[b]->channelWrites();
+    loopRedundant += shields[b]->redundantWrites();
+  }
+  loopWrites -= setupWrites;
+  loopRedundant -= setupRedundant;
+  double perLoop = loops ? 1.0 / loops : 0.0;
+
+  if (opt.echoSerial) printf("\n");
+  printf("=== eyesim summary ===\n");
+  printf("virtual time      %.3f s (setup %.3f s)\n", simS, setupUs / 1e6);
+  printf("wall time         %.3f s (%.0fx real time)\n", wall, wall > 0 ? simS / wall : 0.0);
+  printf("loop passes       %llu\n", (unsigned long long)loops);
+  printf("loop period       mean %.2f ms, max %.2f ms\n",
+         loops ? (simNowUs() - setupUs) / 1000.0 * perLoop : 0.0, maxPeriodUs / 1000.0);
+  for (int s = 0; s < stateCount; s++) {
+    printf("state %-11s %.3f s\n", simFirmwareStateName(s), stateUs[s] / 1e6);
+  }
+  printf("pwm writes        %u (%.2f/loop, %u unchanged) on %zu board(s)\n",
+         loopWrites, loopWrites * perLoop, loopRedundant, shields.size());
+  printf("i2c bus           %u transactions, %u bytes (%.1f bytes/loop), busy %.1f%%\n",
+         bus.transactions, bus.bytes, bus.bytes * perLoop,
+         simS > 0 ? 100.0 * bus.busyUs / (simNowUs() - setupUs) : 0.0);
+  printf("i2c wait          %.3f s (loop blocked on the bus)\n", bus.waitUs / 1e6);
+  printf("serial            %u bytes out, blocked %.3f s; %u bytes in, %u lost to RX overflow\n",
+         serial.bytesWritten, serial.blockedUs / 1e6, serial.bytesReceived, serial.rxOverflows);
+  simFirmwarePrintTelemetry(stdout);
+  simFirmwarePrintGazeLink(stdout);
+  simFirmwarePrintI2C(stdout);
+  simFirmwarePrintTiming(stdout);
+  if (simFirmwarePowerBudget() > 0) {
+    printf("servo current     estimated, budget %u mA\n", simFirmwarePowerBudget());
+  } else {
+    printf("servo current     estimated, no budget\n");
+  }
+  printf("  %-10s %9s %8s %8s %10s %8s\n", "animation", "time_s", "mean_mA", "peak_mA",
+         "demand_mA", "limited%");
+  for (int a = 0; a < animationCount; a++) {
+    if (power[a].us > 0) powerPrint(simFirmwareAnimationName(a), power[a]);
+  }
+  powerPrint("all", powerTotal);
+  if (simEepromStats().bytesWritten > 0) {
+    printf("eeprom            %u bytes written (%u in the background), %.1f ms blocked\n",
+           simEepromStats().bytesWritten, simEepromStats().backgroundBytes,
+           simEepromStats().writeUs / 1000.0);
+  }
+  if (opt.replayPath != NULL) {
+    printf("replay            %ld ticks from %s at %.3f s\n", replayTicks, opt.replayPath,
+           opt.replayMs / 1000.0);
+  }
+  if (serialLog != NULL) fclose(serialLog);
+  if (opt.eepromPath != NULL && !simEepromSave(opt.eepromPath)) {
+    fprintf(stderr, "eyesim: cannot write %s\n", opt.eepromPath);
+    return 1;
+  }
+
+  if (opt.tracePath != NULL) {
+    FILE *trace = fopen(opt.tracePath, "w");
+    if (trace == NULL) {
+      fprintf(stderr, "eyesim: cannot write %s\n", opt.tracePath);
+      return 1;
+    }
+    fprintf(trace, "time_us,address,channel,on,off\n");
+    std::vector<PwmWrite> log;
+    for (size_t b = 0; b < shields.size(); b++) {
+      log.insert(log.end(), shields[b]->log().begin(), shields[b]->log().end());
+    }
+    std::stable_sort(log.begin(), log.end(), pwmWriteEarlier);
+    for (size_t i = 0; i < log.size(); i++) {
+      fprintf(trace, "%llu,0x%02X,%u,%u,%u\n", (unsigned long long)log[i].timeUs,
+              log[i].address, log[i].channel, log[i].on, log[i].off);
+    }
+    fclose(trace);
+  }
+
+  if (opt.maxOverruns >= 0 && simFirmwareOverruns() > (unsigned long)opt.maxOverruns) {
+    fprintf(stderr, "eyesim: FAIL - %lu scheduler overruns (at most %ld allowed)\n",
+            simFirmwareOverruns(), opt.maxOverruns);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,132 @@
+/**
+ * Firmware.cpp
+ *
+ * Compiles the real EyesIntegration_Enhanced_v4 sketch for the host.
+ * The .ino is included verbatim; the accessors below give the simulator
+ * read-only visibility into sketch-level state without touching the sketch.
+ */
+
+#include <Arduino.h>
+
+#include "EyesIntegration_Enhanced_v4.ino"
+
+#include "SimFirmware.h"
+
+int simFirmwareState() {
+  return (int)currentState;
+}
+
+const char *simFirmwareStateName(int state) {
+  switch (state) {
+    case STATE_STARTUP: return "STARTUP";
+    case STATE_ACTIVE: return "ACTIVE";
+    case STATE_IDLE: return "IDLE";
+  }
+  return "?";
+}
+
+int simFirmwareStateCount() {
+  return 3;
+}
+
+enum SimAnimation {
+  SIM_ANIMATION_STARTUP,
+  SIM_ANIMATION_BLINK,
+  SIM_ANIMATION_CLIP,
+  SIM_ANIMATION_IDLE_GAZE,
+  SIM_ANIMATION_MANUAL,
+  SIM_ANIMATION_COUNT
+};
+
+int simFirmwareAnimation() {
+  if (currentState == STATE_STARTUP) return SIM_ANIMATION_STARTUP;
+  for (uint8_t r = 0; r < RIG_COUNT; r++) {
+    if (rigs[r].blinking()) return SIM_ANIMATION_BLINK;
+  }
+  for (uint8_t r = 0; r < RIG_COUNT; r++) {
+    if (rigs[r].clipPlaying()) return SIM_ANIMATION_CLIP;
+  }
+  return currentState == STATE_IDLE ? SIM_ANIMATION_IDLE_GAZE : SIM_ANIMATION_MANUAL;
+}
+
+const char *simFirmwareAnimationName(int animation) {
+  switch (animation) {
+    case SIM_ANIMATION_STARTUP: return "startup";
+    case SIM_ANIMATION_BLINK: return "blink";
+    case SIM_ANIMATION_CLIP: return "clip";
+    case SIM_ANIMATION_IDLE_GAZE: return "idle gaze";
+    case SIM_ANIMATION_MANUAL: return "manual";
+  }
+  return "?";
+}
+
+int simFirmwareAnimationCount() {
+  return SIM_ANIMATION_COUNT;
+}
+
+void simFirmwarePower(unsigned *drawMa, unsigned *demandMa, bool *limited) {
+  *drawMa = powerBudget.stats().drawMa;
+  *demandMa = powerBudget.stats().demandMa;
+  *limited = powerBudget.limited();
+}
+
+unsigned simFirmwarePowerBudget() {
+  return powerBudget.budget();
+}
+
+void simFirmwareSetPowerBudget(unsigned ma) {
+  powerBudget.setBudget(ma > 0xFFFF ? 0xFFFF : (uint16_t)ma);
+}
+
+void simFirmwarePrintTelemetry(FILE *out) {
+  const TelemetryStats &t = telemetry.stats();
+  fprintf(out, "telemetry         %s, %lu frames, %lu dropped, ring peak %u/%u bytes\n",
+          TelemetrySettings::BINARY ? "binary" : "text", t.frames, t.drops, t.peakUsed,
+          TELEMETRY_BUFFER_SIZE);
+}
+
+void simFirmwarePrintGazeLink(FILE *out) {
+  const GazeLinkStats &g = gazeLink.stats();
+  fprintf(out, "gaze link         %lu commands, %lu CRC errors, %lu lost, %lu stale, %lu late, "
+          "%lu overflows, jitter max %u ms\n",
+          g.frames, g.crcErrors, g.lost, g.stale, g.late, g.overflows, g.maxJitterMs);
+}
+
+void simFirmwarePrintI2C(FILE *out) {
+  const I2CQueueStats &q = i2cQueue.stats();
+  fprintf(out, "i2c queue         %lu transactions, %lu NACKs, %lu failures, %lu rejected, "
+          "peak %u/%u slots %u/%u bytes\n",
+          q.transactions, q.nacks, q.failures, q.rejected, q.peakSlots, I2C_QUEUE_SLOTS,
+          q.peakBytes, I2C_QUEUE_BYTES);
+  const NunchuckStats &n = nunchuckLink.stats();
+  fprintf(out, "nunchuck link     %s, %lu reports, %lu errors, %lu busy, %u connects, "
+          "%u disconnects\n",
+          nunchuckLink.connected() ? "connected" : "absent", n.reports, n.errors, n.busy,
+          n.connects, n.disconnects);
+}
+
+void simFirmwarePrintTiming(FILE *out) {
+  fprintf(out, "%-10s %8s %9s %9s %9s %9s %9s\n", "group", "runs", "period_ms", "wcet_us",
+          "late_us", "jitter_us", "overruns");
+  for (uint8_t i = 0; i < scheduler.groupCount(); i++) {
+    const RateGroup &g = scheduler.group(i);
+    fprintf(out, "%-10s %8lu %9.1f %9u %9u %9u %9lu\n", (const char *)g.name, g.stats.runs,
+            g.periodUs / 1000.0, g.stats.wcetUs, g.stats.maxLatencyUs, g.stats.maxJitterUs,
+            g.stats.overruns);
+  }
+}
+
+unsigned long simFirmwareMotionTicks() {
+  return motionGroup >= 0 ? scheduler.group(motionGroup).stats.runs : 0;
+}
+
+void simFirmwareMotion(uint8_t rig, uint8_t channel, int *motion, int *lead) {
+  *motion = rigs[rig].motionPulse(channel);
+  *lead = rigs[rig].leadPulse(channel, motionDtMs);
+}
+
+unsigned long simFirmwareOverruns() {
+  unsigned long overruns = 0;
+  for (uint8_t i = 0; i < scheduler.groupCount(); i++) overruns += scheduler.group(i).stats.overruns;
+  return overruns;
+}
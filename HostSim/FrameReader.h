@@ -0,0 +1,111 @@
+/**
+ * FrameReader.h
+ *
+ * Incremental parser for SerialFraming.h frames on the host
+ *
+ * Feed it bytes as they arrive (whole capture or a tty, a few at a time);
+ * next() yields each frame whose CRC checks out. Bytes outside frames
+ * (the sketch's text messages) and damaged frames are skipped and counted.
+ */
+
+#ifndef HOSTSIM_FRAME_READER_H
+#define HOSTSIM_FRAME_READER_H
+
+#include <stdint.h>
+#include <string.h>
+
+#include <vector>
+
+#include "SerialFraming.h"
+
+struct FrameReaderStats {
+  unsigned long frames;
+  unsigned long crcErrors;
+  unsigned long unknownTypes;
+  unsigned long skippedBytes;
+  unsigned long sequenceGaps;    // Frames missing between received ones
+};
+
+class FrameReader {
+public:
+  /** payloadSize(type) → fixed payload length, 0 for unknown types */
+  typedef uint8_t (*PayloadSizeFn)(uint8_t type);
+
+  explicit FrameReader(PayloadSizeFn sizeOf)
+    : payloadSize(sizeOf), start(0), haveSequence(false), expectedSequence(0) {
+    memset(&counters, 0, sizeof(counters));
+  }
+
+  void feed(const uint8_t *data, size_t length) {
+    // Drop consumed bytes before growing
+    if (start > 0 && start == buffer.size()) {
+      buffer.clear();
+      start = 0;
+    } else if (start > 4096) {
+      buffer.erase(buffer.begin(), buffer.begin() + start);
+      start = 0;
+    }
+    buffer.insert(buffer.end(), data, data + length);
+  }
+
+  /**
+   * Next valid frame; type/sequence/payload point into the reader and stay
+   * valid until the next feed(). False when more bytes are needed.
+   */
+  bool next(uint8_t &type, uint8_t &sequence, const uint8_t *&payload) {
+    while (start + FRAME_HEADER_SIZE <= buffer.size()) {
+      const uint8_t *frame = &buffer[start];
+      if (frame[0] != FRAME_SYNC0 || frame[1] != FRAME_SYNC1) {
+        skip();
+        continue;
+      }
+
+      uint8_t size = payloadSize(frame[2]);
+      if (size == 0) {
+        counters.unknownTypes++;
+        skip();
+        continue;
+      }
+      if (start + FRAME_OVERHEAD + size > buffer.size()) return false;
+
+      uint16_t crc = frameCrc(&frame[2], 2 + size);
+      uint16_t sent = frame[FRAME_HEADER_SIZE + size] | (frame[FRAME_HEADER_SIZE + size + 1] << 8);
+      if (crc != sent) {
+        // False sync or damaged frame: resume the hunt one byte later
+        counters.crcErrors++;
+        skip();
+        continue;
+      }
+
+      type = frame[2];
+      sequence = frame[3];
+      payload = &frame[FRAME_HEADER_SIZE];
+      if (haveSequence && sequence != expectedSequence) {
+        counters.sequenceGaps += (uint8_t)(sequence - expectedSequence);
+      }
+      haveSequence = true;
+      expectedSequence = sequence + 1;
+      counters.frames++;
+      start += FRAME_OVERHEAD + size;
+      return true;
+    }
+    return false;
+  }
+
+  const FrameReaderStats &stats() const { return counters; }
+
+private:
+  void skip() {
+    counters.skippedBytes++;
+    start++;
+  }
+
+  PayloadSizeFn payloadSize;
+  std::vector<uint8_t> buffer;
+  size_t start;
+  bool haveSequence;
+  uint8_t expectedSequence;
+  FrameReaderStats counters;
+};
+
+#endif // HOSTSIM_FRAME_READER_H
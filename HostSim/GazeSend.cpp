@@ -0,0 +1,315 @@
+/**
+ * GazeSend.cpp
+ *
+ * Host stand-in for a PC-side gaze tracker (see GazeLink.h)
+ *
+ * Streams timestamped gaze commands to a serial device - the real board or
+ * `eyesim --pty` - and checks the result against the board's own binary
+ * telemetry:
+ * - every ACTIVE tick's eye target must be one of the commanded gazes
+ * - the delay from a command's timestamp to the tick that applied it must
+ *   stay within a narrow band (its width is the end-to-end jitter)
+ *
+ * The gaze pattern is two triangle sweeps at different rates, so each
+ * commanded (H, V) pair is unique over any short window.
+ *
+ * USAGE:
+ *   gazesend DEVICE [options]
+ *     --rate HZ        Commands per second (default 100)
+ *     --duration S     Streaming time (default 10)
+ *     --jitter MS      Random extra send delay of 0..MS per command (default 0)
+ *     --loss PCT       Percentage of frames never sent (default 0)
+ *     --blink S        Blink trigger every S seconds (default 0 = never)
+ *     --max-jitter MS  Widest acceptable delay band (default 25)
+ *     --seed N         Jitter / loss randomness (default 1)
+ *   Exit status 0 when the stream verified.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include "ChannelTable.h"
+#include "FrameReader.h"
+#include "GazeLink.h"
+#include "Telemetry.h"
+
+// SystemState in the sketch
+static const uint8_t STATE_ACTIVE_ID = 1;
+
+struct SendOptions {
+  const char *device;
+  double rateHz;
+  double durationS;
+  int jitterMs;
+  int lossPct;
+  double blinkS;
+  int maxJitterMs;
+  unsigned seed;
+};
+
+struct SentCommand {
+  uint32_t timeMs;
+  uint16_t pulseH;           // What the firmware should target
+  uint16_t pulseV;
+  bool dropped;              // --loss: never sent
+};
+
+struct ObservedTick {
+  uint32_t timeMs;
+  uint8_t state;
+  uint16_t targetH;
+  uint16_t targetV;
+};
+
+static void usage() {
+  fprintf(stderr,
+          "usage: gazesend DEVICE [--rate HZ] [--duration S] [--jitter MS] [--loss PCT]\n"
+          "                [--blink S] [--max-jitter MS] [--seed N]\n");
+  exit(2);
+}
+
+static SendOptions parseOptions(int argc, char **argv) {
+  SendOptions opt = {NULL, 100.0, 10.0, 0, 0, 0.0, 25, 1};
+  for (int i = 1; i < argc; i++) {
+    const char *arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (!strcmp(arg, "--rate") && hasValue) opt.rateHz = atof(argv[++i]);
+    else if (!strcmp(arg, "--duration") && hasValue) opt.durationS = atof(argv[++i]);
+    else if (!strcmp(arg, "--jitter") && hasValue) opt.jitterMs = atoi(argv[++i]);
+    else if (!strcmp(arg, "--loss") && hasValue) opt.lossPct = atoi(argv[++i]);
+    else if (!strcmp(arg, "--blink") && hasValue) opt.blinkS = atof(argv[++i]);
+    else if (!strcmp(arg, "--max-jitter") && hasValue) opt.maxJitterMs = atoi(argv[++i]);
+    else if (!strcmp(arg, "--seed") && hasValue) opt.seed = (unsigned)atoi(argv[++i]);
+    else if (arg[0] != '-' && opt.device == NULL) opt.device = arg;
+    else usage();
+  }
+  if (opt.device == NULL || opt.rateHz <= 0) usage();
+  return opt;
+}
+
+static uint64_t monotonicUs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+static void sleepUntilUs(uint64_t deadline) {
+  uint64_t now = monotonicUs();
+  if (deadline > now) usleep((useconds_t)(deadline - now));
+}
+
+static int openDevice(const char *path) {
+  int fd = open(path, O_RDWR | O_NOCTTY | O_NONBLOCK);
+  if (fd < 0) return -1;
+  struct termios tty;
+  if (tcgetattr(fd, &tty) == 0) {
+    cfmakeraw(&tty);
+    cfsetispeed(&tty, B115200);
+    cfsetospeed(&tty, B115200);
+    tcsetattr(fd, TCSANOW, &tty);
+  }
+  return fd;
+}
+
+static uint8_t payloadSize(uint8_t type) {
+  switch (type) {
+    case FRAME_TELEMETRY_TICK: return sizeof(TelemetryTick);
+    case FRAME_TELEMETRY_TIMING: return sizeof(TelemetryTiming);
+  }
+  return 0;
+}
+
+/** Pull everything the board sent so far into ticks */
+static void collect(int fd, FrameReader &reader, std::vector<ObservedTick> &ticks) {
+  uint8_t buffer[512];
+  ssize_t got;
+  while ((got = read(fd, buffer, sizeof(buffer))) > 0) {
+    reader.feed(buffer, (size_t)got);
+  }
+
+  uint8_t type, sequence;
+  const uint8_t *payload;
+  while (reader.next(type, sequence, payload)) {
+    if (type != FRAME_TELEMETRY_TICK) continue;
+    TelemetryTick t;
+    memcpy(&t, payload, sizeof(t));
+    ObservedTick tick = {t.timeMs, t.state, t.targetH, t.targetV};
+    ticks.push_back(tick);
+  }
+}
+
+static bool writeAll(int fd, const uint8_t *data, size_t length) {
+  while (length > 0) {
+    ssize_t n = write(fd, data, length);
+    if (n < 0) {
+      if (errno == EAGAIN) { usleep(200); continue; }
+      return false;
+    }
+    data += n;
+    length -= (size_t)n;
+  }
+  return true;
+}
+
+static uint16_t triangle(uint32_t step, uint16_t low, uint16_t high) {
+  uint32_t span = high - low;
+  uint32_t phase = step % (2 * span);
+  return (uint16_t)(low + (phase < span ? phase : 2 * span - phase));
+}
+
+int main(int argc, char **argv) {
+  SendOptions opt = parseOptions(argc, argv);
+  srand(opt.seed);
+  channelTableLoadDefaults();    // Expected pulses: the simulator runs EyeConfig.h values
+
+  int fd = openDevice(opt.device);
+  if (fd < 0) {
+    fprintf(stderr, "gazesend: cannot open %s: %s\n", opt.device, strerror(errno));
+    return 2;
+  }
+
+  FrameReader reader(payloadSize);
+  std::vector<ObservedTick> ticks;
+
+  // Wait for the sketch to reach ACTIVE (startup clip, etc.)
+  fprintf(stderr, "gazesend: waiting for ACTIVE telemetry on %s\n", opt.device);
+  uint64_t waitEnd = monotonicUs() + 30000000ULL;
+  while (ticks.empty() || ticks.back().state != STATE_ACTIVE_ID) {
+    if (monotonicUs() > waitEnd) {
+      fprintf(stderr, "gazesend: no ACTIVE telemetry (is TelemetrySettings::BINARY on?)\n");
+      return 2;
+    }
+    usleep(5000);
+    collect(fd, reader, ticks);
+  }
+  size_t firstTick = ticks.size();
+
+  // Stream
+  const uint64_t periodUs = (uint64_t)(1e6 / opt.rateHz);
+  const uint32_t commandCount = (uint32_t)(opt.durationS * opt.rateHz);
+  const uint32_t blinkEvery = opt.blinkS > 0 ? (uint32_t)(opt.blinkS * opt.rateHz) : 0;
+  std::vector<SentCommand> sent;
+  uint8_t sequence = 0;
+  uint32_t dropped = 0;
+  uint64_t start = monotonicUs();
+  uint64_t lastSendUs = start;
+
+  for (uint32_t k = 0; k < commandCount; k++) {
+    uint64_t nominal = start + k * periodUs;
+    sleepUntilUs(nominal);
+    collect(fd, reader, ticks);
+
+    GazeCommandPayload cmd;
+    cmd.timeMs = (uint32_t)(nominal / 1000);
+    cmd.gazeH = triangle(k * 3, 16, CHANNEL_POS_FULL - 16);
+    cmd.gazeV = triangle(k * 2 + 50, 32, CHANNEL_POS_FULL - 32);
+    cmd.lid = 0;
+    cmd.flags = GAZE_FLAG_GAZE;
+    if (blinkEvery && k > 0 && k % blinkEvery == 0) cmd.flags |= GAZE_FLAG_BLINK;
+
+    SentCommand record = {cmd.timeMs, channelPulse(CH_HORIZONTAL, cmd.gazeH),
+                          channelPulse(CH_VERTICAL, cmd.gazeV), false};
+
+    uint8_t seq = sequence++;
+    if (opt.lossPct > 0 && rand() % 100 < opt.lossPct) {
+      record.dropped = true;
+      sent.push_back(record);
+      dropped++;
+      continue;
+    }
+    sent.push_back(record);
+
+    // Simulated link jitter: late, but never reordered
+    if (opt.jitterMs > 0) {
+      uint64_t sendAt = nominal + (uint64_t)(rand() % (opt.jitterMs + 1)) * 1000;
+      if (sendAt < lastSendUs) sendAt = lastSendUs;
+      sleepUntilUs(sendAt);
+    }
+
+    uint8_t frame[FRAME_OVERHEAD + sizeof(GazeCommandPayload)];
+    frame[0] = FRAME_SYNC0;
+    frame[1] = FRAME_SYNC1;
+    frame[2] = FRAME_GAZE_COMMAND;
+    frame[3] = seq;
+    memcpy(&frame[FRAME_HEADER_SIZE], &cmd, sizeof(cmd));
+    uint16_t crc = frameCrc(&frame[2], 2 + sizeof(cmd));
+    frame[sizeof(frame) - 2] = (uint8_t)crc;
+    frame[sizeof(frame) - 1] = (uint8_t)(crc >> 8);
+    if (!writeAll(fd, frame, sizeof(frame))) {
+      fprintf(stderr, "gazesend: write failed: %s\n", strerror(errno));
+      return 2;
+    }
+    lastSendUs = monotonicUs();
+  }
+  double streamS = (monotonicUs() - start) / 1e6;
+
+  // Let the last commands play out
+  usleep(300000);
+  collect(fd, reader, ticks);
+  close(fd);
+
+  // Verify: match each ACTIVE tick to the command it applied
+  size_t hint = 0;
+  uint32_t considered = 0, matched = 0, timed = 0;
+  int32_t minDelay = INT32_MAX, maxDelay = INT32_MIN;
+  double sumDelay = 0;
+  bool started = false;
+
+  for (size_t i = firstTick; i < ticks.size(); i++) {
+    const ObservedTick &t = ticks[i];
+    if (t.state != STATE_ACTIVE_ID) continue;
+
+    size_t found = sent.size();
+    for (size_t k = hint; k < sent.size() && k < hint + 64; k++) {
+      if (sent[k].pulseH == t.targetH && sent[k].pulseV == t.targetV) {
+        found = k;
+        break;
+      }
+    }
+
+    if (!started) {
+      if (found == sent.size()) continue;   // Still on the joystick
+      started = true;
+    }
+    if (hint == sent.size() - 1 && found == sent.size()) break;   // Host went quiet
+
+    considered++;
+    if (found == sent.size()) continue;
+    matched++;
+    hint = found;
+
+    // A held command whose successor was dropped on purpose isn't jitter
+    if (found + 1 < sent.size() && sent[found + 1].dropped) continue;
+    timed++;
+    int32_t delay = (int32_t)(t.timeMs - sent[found].timeMs);
+    if (delay < minDelay) minDelay = delay;
+    if (delay > maxDelay) maxDelay = delay;
+    sumDelay += delay;
+    if (found == sent.size() - 1) break;
+  }
+
+  double achievedHz = sent.size() / streamS;
+  int32_t band = timed ? maxDelay - minDelay : 0;
+  printf("gazesend: %zu commands in %.2f s (%.1f/s), %u not sent (loss)\n",
+         sent.size(), streamS, achievedHz, dropped);
+  printf("gazesend: %u of %u ACTIVE ticks matched a command\n", matched, considered);
+  if (timed) {
+    printf("gazesend: command -> tick delay (incl. clock offset) min %d mean %.1f max %d ms, "
+           "jitter band %d ms\n", minDelay, sumDelay / timed, maxDelay, band);
+  }
+
+  bool ok = considered > 0 &&
+            matched * 100 >= considered * 95 &&
+            band <= opt.maxJitterMs &&
+            achievedHz >= opt.rateHz * 0.95;
+  printf("gazesend: %s\n", ok ? "PASS" : "FAIL");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,544 @@
+/**
+ * HotBench.cpp
+ *
+ * Host timing of the control hot path, per function and per loop() tick,
+ * with a regression check
+ *
+ * Micro benchmarks run the firmware modules unmodified, one call at a time
+ * over varying input (the functions they replaced in brackets):
+ *   joystick.update     JoystickFilter::update, both axes     (mapJoystick)
+ *   joystick.position   deflection → normalized gaze
+ *   tilt.update         TiltGaze::update: accel tilt + joystick fusion
+ *   motion.update       MotionAxis::update, target moving     (smooth)
+ *   channel.pulse       lid position → clamped pulse          (setEyelidPosition)
+ *   blink.layer         lid rest pose + blink layer
+ *   rig.compose         EyeRig::compose with the gaze moving  (moveEyes)
+ *   rig.idle            EyeRig::runIdle + compose
+ *   bus.flush           ServoBus::flush of six changed channels
+ *   power.apply         PowerBudget::apply, every servo moving, over budget
+ *
+ * Scenario: the whole sketch (setup()/loop(), as in eyesim) through
+ * startup → active → idle → active with a scripted nunchuck. Per state:
+ * host ns per loop() call and per motion tick, PWM channel writes, I2C
+ * transactions and bytes per motion tick. Host times here include the
+ * simulator's bus and device models, so compare them only with themselves;
+ * the write and byte counts are exact.
+ *
+ * avr_us_est is a rough AVR proxy: ns/op relative to a reference kernel
+ * (32-bit multiply, shift, table load, clamp - the firmware's usual fixed
+ * point mix) whose cost on the 16 MHz UNO is about AVR_REF_CYCLES. It
+ * assumes the function has the same op mix, so trust it to a factor of 2.
+ *
+ * Both are timed in this thread's CPU time, REPEATS rounds each with a
+ * reference round right before it, best round kept: another process
+ * taking the CPU, or a slow stretch of a shared host, does not reach the
+ * figures (make bench runs on loaded machines too).
+ *
+ * Results go to stdout and, with --csv, as bench,metric,value rows.
+ * --check FILE compares them with "bench metric max" lines (see
+ * scripts/hotbench.limits) and exits 1 if any is exceeded.
+ *
+ * USAGE:
+ *   hotbench [--csv FILE] [--check FILE]
+ */
+
+#include <ctype.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "ChannelTable.h"
+#include "EyeRig.h"
+#include "I2CQueue.h"
+#include "JoystickFilter.h"
+#include "PowerBudget.h"
+#include "TiltGaze.h"
+#include "ServoBus.h"
+#include "SimFirmware.h"
+#include "SimHardware.h"
+
+static const unsigned long TICK_MS = SchedulerSettings::MOTION_PERIOD_MS;
+static const long ITERATIONS = 200000;
+static const int REPEATS = 9;                  // Rounds per bench, against host noise
+
+// Not in SERVO_BOARD_LIST (EyeConfig.h), so the sketch's boards stay apart
+static const uint8_t BENCH_BOARD = 0x7E;
+
+// avr-gcc -Os, one reference iteration: __mulsi3 ~30, volatile 32-bit
+// load/store 16, indexed table load 8, shift 6, clamp 6, loop 4
+static const double AVR_REF_CYCLES = 70;
+static const double AVR_MHZ = 16;
+
+struct BenchValue {
+  std::string bench;
+  std::string metric;
+  double value;
+};
+
+static std::vector<BenchValue> results;
+static volatile int32_t sink;
+
+static void report(const char *bench, const char *metric, double value) {
+  BenchValue v = {bench, metric, value};
+  results.push_back(v);
+}
+
+static double hostNs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/**
+ * This thread's CPU time: time sliced away to other processes does not
+ * count (slower to read than hostNs, too slow for bus.flush's calls)
+ */
+static double cpuNs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static int triangle(long step, int span) {
+  long phase = step % (2 * span);
+  return (int)(phase < span ? phase : 2 * span - phase);
+}
+
+static long opIndex;             // Carries on across runs, so inputs keep varying
+
+/**
+ * ns per op(i) over one run of ITERATIONS calls
+ */
+template <class Op>
+static double runOps(Op op) {
+  double start = cpuNs();
+  for (long n = 0; n < ITERATIONS; n++, opIndex++) op(opIndex);
+  return (cpuNs() - start) / ITERATIONS;
+}
+
+/**
+ * ns per op(i), best of REPEATS runs
+ */
+template <class Op>
+static double timeOps(Op op) {
+  double best = 1e30;
+  for (int r = 0; r < REPEATS; r++) {
+    double ns = runOps(op);
+    if (ns < best) best = ns;
+  }
+  return best;
+}
+
+static double median(std::vector<double> values) {
+  std::sort(values.begin(), values.end());
+  size_t n = values.size();
+  return n % 2 ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2;
+}
+
+// ============================================================================
+// MICRO BENCHMARKS
+// ============================================================================
+
+static volatile int32_t refState = 1;
+static volatile int16_t refTable[16] = {3, 1, 4, 1, 5, 9, 2, 6, 5, 3, 5, 8, 9, 7, 9, 3};
+
+static void refKernel(long i) {
+  int32_t x = ((int32_t)refState * 181) >> 8;
+  x += refTable[i & 15];
+  if (x > 30000) x -= 30000;
+  refState = x;
+}
+
+static JoystickFilter makeFilter() {
+  JoystickAxisRange x = {NunchuckCalibration::JOY_X_MIN, NunchuckCalibration::CENTER,
+                         NunchuckCalibration::JOY_X_MAX};
+  JoystickAxisRange y = {NunchuckCalibration::JOY_Y_MIN, NunchuckCalibration::CENTER,
+                         NunchuckCalibration::JOY_Y_MAX};
+  JoystickFilterSettings settings = {
+    (uint16_t)((long)DEADZONE * JOY_FULL /
+               ((NunchuckCalibration::JOY_X_MAX - NunchuckCalibration::JOY_X_MIN) / 2)),
+    JoystickSettings::ASYMMETRIC_RANGE, JoystickSettings::FILTER,
+    JoystickSettings::MIN_CUTOFF_MILLIHZ, JoystickSettings::BETA_MILLIHZ,
+    JoystickSettings::SPEED_CUTOFF_MILLIHZ
+  };
+  JoystickFilter filter;
+  filter.configure(x, y, settings);
+  return filter;
+}
+
+static TiltGaze makeTilt() {
+  TiltGazeSettings settings = {
+    {TiltSettings::ACCEL_ZERO_X, TiltSettings::ACCEL_ZERO_Y, TiltSettings::ACCEL_ZERO_Z},
+    TiltSettings::ACCEL_ONE_G, TiltSettings::RANGE_DECIDEG, TiltSettings::DEADZONE_DECIDEG,
+    TiltSettings::TAU_MS, TiltSettings::ACTIVITY_DECIDEG,
+    TiltSettings::INVERT_X, TiltSettings::INVERT_Y
+  };
+  TiltGaze tilt;
+  tilt.configure(settings);
+  return tilt;
+}
+
+static MotionProfile eyeProfile() {
+  return motionProfile(MotionSettings::EYE_RESPONSE_MS, EYE_MAX_VELOCITY, EYE_MAX_ACCEL);
+}
+
+/**
+ * REPEATS rounds of the reference kernel and then round() (ns per op)
+ * back to back, timed in CPU time: ns_per_op is the best round, and
+ * avr_us_est compares it with the best reference round. Host noise only
+ * ever adds time, so best-of ignores it unless every round was hit, and
+ * interleaving keeps a slow stretch of the host from landing on one side
+ * of the ratio only
+ */
+template <class Round>
+static void printMicro(const char *bench, Round round) {
+  double best = 1e30;
+  double bestRef = 1e30;
+  for (int r = 0; r < REPEATS; r++) {
+    double refNs = runOps(refKernel);
+    double ns = round();
+    if (refNs < bestRef) bestRef = refNs;
+    if (ns < best) best = ns;
+  }
+  double avrUs = best / bestRef * AVR_REF_CYCLES / AVR_MHZ;
+  printf("%-18s %10.1f %12.1f\n", bench, best, avrUs);
+  report(bench, "ns_per_op", best);
+  report(bench, "avr_us_est", avrUs);
+}
+
+template <class Op>
+static void printMicroOps(const char *bench, Op op) {
+  printMicro(bench, [&]() { return runOps(op); });
+}
+
+static void runMicro() {
+  // Stick input: a slow sweep with ±2 counts of noise
+  int raw[256];
+  int16_t deflection[256];
+  randomSeed(1);
+  for (int i = 0; i < 256; i++) {
+    raw[i] = NunchuckCalibration::JOY_X_MIN +
+             triangle(i, NunchuckCalibration::JOY_X_MAX - NunchuckCalibration::JOY_X_MIN) +
+             (int)random(-2, 3);
+    deflection[i] = (int16_t)(triangle(i * 64, 2 * JOY_FULL) - JOY_FULL);
+  }
+
+  double refNs = timeOps(refKernel);
+
+  printf("%-18s %10s %12s\n", "bench", "ns/op", "avr_us_est");
+  printf("%-18s %10.1f %12.1f\n", "avr.ref", refNs, AVR_REF_CYCLES / AVR_MHZ);
+  report("avr.ref", "ns_per_op", refNs);
+
+  JoystickFilter filter = makeFilter();
+  printMicroOps("joystick.update", [&](long i) {
+    filter.update(raw[i & 255], raw[(i * 7) & 255], TICK_MS);
+    sink += filter.deflectionX() + filter.deflectionY();
+  });
+
+  printMicroOps("joystick.position", [&](long i) {
+    sink += joystickPosition(deflection[i & 255], CHANNEL_POS_FULL / 2);
+  });
+
+  // Nunchuck rolled and pitched through ±60°, every 16th sample a jolt
+  NunchuckSample tilted[256];
+  for (int i = 0; i < 256; i++) {
+    double roll = (triangle(i * 3, 240) - 120) * M_PI / 360;
+    double pitch = (triangle(i * 5, 240) - 120) * M_PI / 360;
+    double g = TiltSettings::ACCEL_ONE_G * ((i & 15) == 0 ? 2.0 : 1.0);
+    tilted[i] = simNunchuckSampleAt(0);
+    tilted[i].accelX = TiltSettings::ACCEL_ZERO_X + (int)(g * sin(roll)) + (int)random(-3, 4);
+    tilted[i].accelY = TiltSettings::ACCEL_ZERO_Y + (int)(g * sin(pitch)) + (int)random(-3, 4);
+    tilted[i].accelZ = TiltSettings::ACCEL_ZERO_Z + (int)(g * cos(roll) * cos(pitch));
+    tilted[i].connected = true;
+  }
+  TiltGaze tilt = makeTilt();
+  printMicroOps("tilt.update", [&](long i) {
+    tilt.update(tilted[i & 255], deflection[i & 255], deflection[(i * 7) & 255], TICK_MS);
+    sink += tilt.deflectionX() + tilt.deflectionY();
+  });
+
+  // Every rig's block: a PowerBudget covers them all
+  ChannelDescriptor table[POWER_SERVOS];
+  memcpy_P(table, CHANNEL_DEFAULTS, sizeof(table));
+
+  MotionAxis axis;
+  axis.setProfile(eyeProfile());
+  axis.reset(descriptorCenter(&table[CH_HORIZONTAL]));
+  int lowPulse = descriptorMin(&table[CH_HORIZONTAL]);
+  int highPulse = descriptorMax(&table[CH_HORIZONTAL]);
+  printMicroOps("motion.update", [&](long i) {
+    if ((i & 31) == 0) axis.setTarget((i & 32) ? lowPulse : highPulse);
+    sink += axis.update(TICK_MS);
+  });
+
+  const ChannelDescriptor *lid = &table[CH_L_UPPER];
+  printMicroOps("channel.pulse", [&](long i) {
+    uint16_t position = (uint16_t)triangle(i * 3, CHANNEL_POS_FULL);
+    sink += descriptorClamp(lid, descriptorPulse(lid, position));
+  });
+
+  BlinkEngine blinker;
+  PoseFrame pose;
+  memset(&pose, 0, sizeof(pose));
+  printMicroOps("blink.layer", [&](long i) {
+    unsigned long now = (unsigned long)i * TICK_MS;
+    if (i % 30 == 0) blinker.start(now, CHANNEL_POS_FULL);
+    blinker.rest((int16_t)(triangle(i, 512) - 256), pose);
+    blinker.apply(now, pose);
+    sink += pose.value[CH_L_UPPER] + pose.value[CH_L_LOWER];
+  });
+
+  // Rig on its own mock board
+  halBusClock(ServoBusSettings::I2C_CLOCK_HZ);
+  simAddPCA9685(BENCH_BOARD)->setLogging(false);
+  ServoFrame frame(BENCH_BOARD);
+  frame.begin(OUTPUT_PRESCALE);
+  halI2CFlush();
+  ServoBus bus(&frame, 1, servoBusBudget(ServoBusSettings::I2C_CLOCK_HZ,
+                                         ServoBusSettings::OUTPUT_BUDGET_US));
+  for (uint8_t c = 0; c < POWER_SERVOS; c++) {
+    table[c].board = 0;
+    table[c].channel = c % SERVO_FRAME_CHANNELS;
+  }
+  EyeRig rig;
+  rig.begin(table, &bus, eyeProfile());
+
+  printMicroOps("rig.compose", [&](long i) {
+    rig.setGaze(triangle(i * 5, CHANNEL_POS_FULL), triangle(i * 3, CHANNEL_POS_FULL));
+    rig.compose((unsigned long)i * TICK_MS, TICK_MS);
+  });
+
+  rig.enterIdle(0);
+  printMicroOps("rig.idle", [&](long i) {
+    unsigned long now = (unsigned long)i * TICK_MS;
+    rig.runIdle(now, TICK_MS);
+    rig.compose(now, TICK_MS);
+  });
+
+  // Per call: the bus model must drain between flushes, outside the timing.
+  // The median call, so the few a context switch lands in do not count
+  double clockNs = timeOps([](long) { sink += (int32_t)hostNs(); });
+  std::vector<double> calls(ITERATIONS / 50);
+  printMicro("bus.flush", [&]() {
+    for (size_t i = 0; i < calls.size(); i++) {
+      for (uint8_t c = 0; c < CHANNEL_COUNT; c++) {
+        bus.set(0, c, (uint16_t)(descriptorMin(&table[c]) + ((i + c) & 63)));
+      }
+      double start = hostNs();
+      bus.flush();
+      calls[i] = hostNs() - start;
+      halI2CFlush();
+    }
+    return median(calls) - clockNs;
+  });
+
+  // Smallest budget the config allows: every tick searches both caps
+  PowerBudget power(&bus, table, POWER_SERVOS * PowerSettings::HOLD_MA + PowerSettings::STALL_MA);
+  power.apply(0);
+  printMicroOps("power.apply", [&](long i) {
+    for (uint8_t c = 0; c < POWER_SERVOS; c++) {
+      const ChannelDescriptor *d = &table[c];
+      power.set(d, (i / 8 + c) & 1 ? descriptorMax(d) : descriptorMin(d));
+    }
+    power.apply(TICK_MS);
+    sink += power.stats().drawMa;
+  });
+}
+
+// ============================================================================
+// SCENARIO
+// ============================================================================
+
+static const uint32_t ACTIVE_FROM_MS = 7000;     // Startup is over by then
+static const uint32_t REST_FROM_MS = 22000;      // Idle follows IDLE_TIMEOUT_MS later
+static const uint32_t RETURN_FROM_MS = 52000;
+static const uint32_t SCENARIO_END_MS = 62000;
+
+static void scriptStick(uint32_t fromMs, uint32_t toMs) {
+  const int spanX = NunchuckCalibration::JOY_X_MAX - NunchuckCalibration::CENTER;
+  const int spanY = NunchuckCalibration::JOY_Y_MAX - NunchuckCalibration::CENTER;
+  for (uint32_t t = fromMs; t < toMs; t += TICK_MS) {
+    // Circles of varying size, one every 2 s, and a Z blink every 3 s
+    double phase = 2 * M_PI * (t % 2000) / 2000.0;
+    double radius = 0.3 + 0.7 * triangle(t / 100, 50) / 50.0;
+    NunchuckScriptStep step = {t, simNunchuckSampleAt(0)};
+    step.sample.joyX = NunchuckCalibration::CENTER + (int)(spanX * radius * cos(phase));
+    step.sample.joyY = NunchuckCalibration::CENTER + (int)(spanY * radius * sin(phase));
+    step.sample.buttonZ = t % 3000 < 100;
+    simNunchuckAddStep(step);
+  }
+}
+
+struct StateTotals {
+  unsigned long loops;
+  double hostNs;
+  uint64_t virtualUs;
+  uint32_t pwmWrites;
+  uint32_t transactions;
+  uint32_t bytes;
+};
+
+static uint32_t pwmWrites(const std::vector<MockPCA9685 *> &boards) {
+  uint32_t total = 0;
+  for (size_t b = 0; b < boards.size(); b++) total += boards[b]->channelWrites();
+  return total;
+}
+
+static void runScenario() {
+  std::vector<MockPCA9685 *> boards;
+  for (uint8_t b = 0; b < SERVO_BOARD_COUNT; b++) {
+    boards.push_back(simAddPCA9685(servoBoardAddress(b)));
+    boards.back()->setLogging(false);
+  }
+  simAddNunchuck();
+  NunchuckScriptStep rest = {0, simNunchuckSampleAt(0)};
+  rest.sample.joyX = rest.sample.joyY = NunchuckCalibration::CENTER;
+  rest.sample.connected = true;
+  simNunchuckAddStep(rest);
+  scriptStick(ACTIVE_FROM_MS, REST_FROM_MS);
+  rest.timeMs = REST_FROM_MS;
+  simNunchuckAddStep(rest);
+  scriptStick(RETURN_FROM_MS, SCENARIO_END_MS);
+  simAnalogSet(A0, 1);
+  simSerialSetSink(NULL);
+
+  // Script times are virtual time: this runs first, from 0
+  const uint64_t endUs = SCENARIO_END_MS * 1000ULL;
+  setup();
+
+  const int stateCount = simFirmwareStateCount();
+  std::vector<StateTotals> totals(stateCount);
+  memset(&totals[0], 0, stateCount * sizeof(StateTotals));
+
+  while (simNowUs() < endUs) {
+    int state = simFirmwareState();
+    uint64_t virtualStart = simNowUs();
+    uint32_t writesStart = pwmWrites(boards);
+    SimBusStats busStart = simBusStats();
+
+    double start = cpuNs();
+    loop();
+    double ns = cpuNs() - start;
+    simAdvanceUs(20);              // eyesim's default per-loop CPU charge
+
+    if (state < 0 || state >= stateCount) continue;
+    StateTotals &s = totals[state];
+    s.loops++;
+    s.hostNs += ns;
+    s.virtualUs += simNowUs() - virtualStart;
+    s.pwmWrites += pwmWrites(boards) - writesStart;
+    s.transactions += simBusStats().transactions - busStart.transactions;
+    s.bytes += simBusStats().bytes - busStart.bytes;
+  }
+
+  printf("%-10s %7s %7s %10s %10s %11s %9s %10s\n", "state", "loops", "ticks", "ns/loop",
+         "ns/tick", "pwm/tick", "txn/tick", "bytes/tick");
+  for (int i = 0; i < stateCount; i++) {
+    const StateTotals &s = totals[i];
+    double ticks = s.virtualUs / (TICK_MS * 1000.0);
+    if (s.loops == 0 || ticks < 1) continue;
+
+    std::string name = simFirmwareStateName(i);
+    for (size_t c = 0; c < name.size(); c++) name[c] = (char)tolower(name[c]);
+    double perLoop = s.hostNs / s.loops;
+    double perTick = s.hostNs / ticks;
+    printf("%-10s %7lu %7.0f %10.0f %10.0f %11.2f %9.2f %10.1f\n", name.c_str(), s.loops, ticks,
+           perLoop, perTick, s.pwmWrites / ticks, s.transactions / ticks, s.bytes / ticks);
+    report(name.c_str(), "ns_per_loop", perLoop);
+    report(name.c_str(), "ns_per_tick", perTick);
+    report(name.c_str(), "pwm_writes_per_tick", s.pwmWrites / ticks);
+    report(name.c_str(), "i2c_txn_per_tick", s.transactions / ticks);
+    report(name.c_str(), "i2c_bytes_per_tick", s.bytes / ticks);
+  }
+}
+
+// ============================================================================
+// OUTPUT
+// ============================================================================
+
+static bool writeCsv(const char *path) {
+  FILE *f = fopen(path, "w");
+  if (f == NULL) return false;
+  fprintf(f, "bench,metric,value\n");
+  for (size_t i = 0; i < results.size(); i++) {
+    fprintf(f, "%s,%s,%.3f\n", results[i].bench.c_str(), results[i].metric.c_str(),
+            results[i].value);
+  }
+  return fclose(f) == 0;
+}
+
+/**
+ * Compare with "bench metric max" lines ('#' starts a comment)
+ * Returns the number of limits exceeded or not measured, -1 if unreadable
+ */
+static int checkLimits(const char *path) {
+  FILE *f = fopen(path, "r");
+  if (f == NULL) return -1;
+
+  int failures = 0;
+  int checked = 0;
+  char line[256];
+  while (fgets(line, sizeof(line), f) != NULL) {
+    char *hash = strchr(line, '#');
+    if (hash != NULL) *hash = '\0';
+    char bench[64];
+    char metric[64];
+    double limit;
+    if (sscanf(line, "%63s %63s %lf", bench, metric, &limit) != 3) continue;
+
+    checked++;
+    const BenchValue *found = NULL;
+    for (size_t i = 0; i < results.size(); i++) {
+      if (results[i].bench == bench && results[i].metric == metric) found = &results[i];
+    }
+    if (found == NULL) {
+      printf("  %s %s: not measured\n", bench, metric);
+      failures++;
+    } else if (found->value > limit) {
+      printf("  %s %s: %.2f over the limit %.2f\n", bench, metric, found->value, limit);
+      failures++;
+    }
+  }
+  fclose(f);
+  printf("hotbench: %s (%d limits, %d exceeded)\n", failures ? "FAIL" : "PASS", checked, failures);
+  return failures;
+}
+
+int main(int argc, char **argv) {
+  const char *csvPath = NULL;
+  const char *limitsPath = NULL;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--csv") && i + 1 < argc) csvPath = argv[++i];
+    else if (!strcmp(argv[i], "--check") && i + 1 < argc) limitsPath = argv[++i];
+    else {
+      fprintf(stderr, "usage: hotbench [--csv FILE] [--check FILE]\n");
+      return 1;
+    }
+  }
+
+  printf("hotbench: best of %d x %ld calls, %lu ms motion ticks\n\n", REPEATS, ITERATIONS, TICK_MS);
+  runScenario();
+  printf("\n");
+  runMicro();
+
+  if (csvPath != NULL && !writeCsv(csvPath)) {
+    fprintf(stderr, "hotbench: cannot write %s\n", csvPath);
+    return 1;
+  }
+  if (limitsPath != NULL) {
+    printf("\n");
+    int failures = checkLimits(limitsPath);
+    if (failures < 0) {
+      fprintf(stderr, "hotbench: cannot read %s\n", limitsPath);
+      return 1;
+    }
+    if (failures > 0) return 1;
+  }
+  return 0;
+}
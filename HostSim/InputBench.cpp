@@ -0,0 +1,367 @@
+/**
+ * InputBench.cpp
+ *
+ * Joystick → PWM latency and jitter of the input pipeline (JoystickFilter.h)
+ *
+ * A modelled nunchuck stick (ADC noise, a rest position a few counts off
+ * CENTER, hand tremor while held) drives the real JoystickFilter, EyeRig
+ * motion and ServoBus output against the simulated bus, tick by tick like
+ * the sketch: the sample is read one nunchuck poll ahead of each 20 ms
+ * motion tick, the frame goes out right after it. Times are taken from
+ * the mock PCA9685's register writes, so they are joystick-to-PWM.
+ *
+ * Pipelines:
+ *   legacy     the old mapJoystick(): DEADZONE snapped to servo center,
+ *              linear over MIN..MAX, no filter
+ *   scaled     range correction + scaled radial deadzone, no filter
+ *   filtered   the same plus the One-Euro stage (JoystickSettings)
+ *   lead       filtered, each servo commanded ahead of its lag
+ *              (MotionSettings::SERVO_LEAD; the others run without)
+ *
+ * Per pipeline, on the horizontal eye:
+ *   rest   p-p   PWM spread with the stick released (noise only)
+ *   edge   p-p   the same for a worn stick that rests right on the
+ *                deadzone edge (the old snap toggles here)
+ *   held   p-p   PWM spread with the stick held at 60% (noise + tremor)
+ *   step         full-throw flick: first PWM change, 50% and 90% of the
+ *                move (ms after the stick moved, mean over random phases)
+ *   shaft        the same flick at the servo shaft: the PWM run through
+ *                the channel's identified response (PLANT_* in EyeConfig.h,
+ *                ServoModel.h) - what the eye actually does
+ *   creep jump   largest single-tick PWM change while the stick creeps
+ *                out of the deadzone (a snap shows up here)
+ *
+ * USAGE:
+ *   inputbench [--seed N]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+#include "ChannelTable.h"
+#include "EyeRig.h"
+#include "I2CQueue.h"
+#include "JoystickFilter.h"
+#include "NunchuckLink.h"
+#include "ServoBus.h"
+#include "ServoModel.h"
+#include "SimHardware.h"
+
+static const unsigned long TICK_US = SchedulerSettings::MOTION_PERIOD_MS * 1000UL;
+static const unsigned long CLOCK_HZ = ServoBusSettings::I2C_CLOCK_HZ;
+
+// Stick model, raw counts
+static const int REST_OFFSET = 3;        // Released stick rests this far off CENTER
+static const int NOISE = 2;              // Uniform +-
+static const int TREMOR = 3;             // Held: slow wander +-
+
+enum Pipeline { PIPE_LEGACY, PIPE_SCALED, PIPE_FILTERED, PIPE_LEAD, PIPE_COUNT };
+static const char *const PIPELINE_NAMES[PIPE_COUNT] = {"legacy", "scaled", "filtered", "lead"};
+
+// ============================================================================
+// STICK
+// ============================================================================
+
+/** Stick target (noise-free) as a function of time; noise is added per sample */
+struct StickPath {
+  virtual ~StickPath() {}
+  virtual int x(uint64_t us) const = 0;
+  virtual bool held(uint64_t us) const = 0;
+};
+
+struct RestPath : StickPath {
+  int offset;
+  explicit RestPath(int offset) : offset(offset) {}
+  int x(uint64_t) const { return NunchuckCalibration::CENTER + offset; }
+  bool held(uint64_t) const { return false; }
+};
+
+struct HoldPath : StickPath {
+  int x(uint64_t) const {
+    return NunchuckCalibration::CENTER +
+           6 * (NunchuckCalibration::JOY_X_MAX - NunchuckCalibration::CENTER) / 10;
+  }
+  bool held(uint64_t) const { return true; }
+};
+
+struct StepPath : StickPath {
+  uint64_t atUs;
+  int x(uint64_t us) const {
+    return us < atUs ? NunchuckCalibration::CENTER + REST_OFFSET : NunchuckCalibration::JOY_X_MAX;
+  }
+  bool held(uint64_t us) const { return us >= atUs; }
+};
+
+struct CreepPath : StickPath {
+  uint64_t startUs;
+  int x(uint64_t us) const {
+    // 0 → 30 counts over 3 s
+    long d = us < startUs ? 0 : (long)((us - startUs) * 30 / 3000000ULL);
+    return NunchuckCalibration::CENTER + (int)(d > 30 ? 30 : d);
+  }
+  bool held(uint64_t us) const { return us >= startUs; }
+};
+
+static int sampleStick(const StickPath &path, uint64_t us) {
+  int x = path.x(us) + (int)random(-NOISE, NOISE + 1);
+  if (path.held(us)) {
+    // Tremor: a slow triangle wander, ~4 Hz
+    long phase = (long)((us / 1000) % 250);
+    x += (int)((phase < 125 ? phase : 250 - phase) * 2 * TREMOR / 125 - TREMOR);
+  }
+  return constrain(x, 0, 255);
+}
+
+// ============================================================================
+// PIPELINE
+// ============================================================================
+
+/** The old mapJoystick(), for reference */
+static uint16_t legacyPosition(int joyValue) {
+  const int joyMin = NunchuckCalibration::JOY_X_MIN;
+  const int joyMax = NunchuckCalibration::JOY_X_MAX;
+  const uint16_t scale = ((uint32_t)CHANNEL_POS_FULL * 256 + (joyMax - joyMin) / 2) /
+                         (joyMax - joyMin);
+  if (abs(joyValue - (joyMin + joyMax) / 2) < DEADZONE) return CHANNEL_POS_FULL / 2;
+  int travel = constrain(joyValue, joyMin, joyMax) - joyMin;
+  return ((uint32_t)travel * scale + 128) >> 8;
+}
+
+static JoystickFilter makeFilter(bool filtered) {
+  JoystickAxisRange x = {NunchuckCalibration::JOY_X_MIN, NunchuckCalibration::CENTER,
+                         NunchuckCalibration::JOY_X_MAX};
+  JoystickAxisRange y = {NunchuckCalibration::JOY_Y_MIN, NunchuckCalibration::CENTER,
+                         NunchuckCalibration::JOY_Y_MAX};
+  JoystickFilterSettings settings = {
+    (uint16_t)((long)DEADZONE * JOY_FULL /
+               ((NunchuckCalibration::JOY_X_MAX - NunchuckCalibration::JOY_X_MIN) / 2)),
+    JoystickSettings::ASYMMETRIC_RANGE, filtered,
+    JoystickSettings::MIN_CUTOFF_MILLIHZ, JoystickSettings::BETA_MILLIHZ,
+    JoystickSettings::SPEED_CUTOFF_MILLIHZ
+  };
+  JoystickFilter filter;
+  filter.configure(x, y, settings);
+  return filter;
+}
+
+// ============================================================================
+// RUN
+// ============================================================================
+
+struct PwmPoint {
+  uint64_t us;
+  uint16_t pulse;
+};
+
+static uint8_t nextBoardAddress = 0x40;
+
+/**
+ * Drive one rig from the stick for durationUs; horizontal PWM writes out
+ */
+static std::vector<PwmPoint> run(Pipeline pipe, const StickPath &path, uint64_t durationUs,
+                                 uint32_t seed) {
+  randomSeed(seed);
+  halBusClock(CLOCK_HZ);
+  MockPCA9685 *board = simAddPCA9685(nextBoardAddress);
+  board->clearLog();
+  board->setLogging(true);
+  ServoFrame frame(nextBoardAddress++);
+  frame.begin(OUTPUT_PRESCALE);
+  ServoBus bus(&frame, 1, servoBusBudget(CLOCK_HZ, ServoBusSettings::OUTPUT_BUDGET_US));
+
+  MotionProfile profile =
+      motionProfile(MotionSettings::EYE_RESPONSE_MS, EYE_MAX_VELOCITY, EYE_MAX_ACCEL);
+  EyeRig rig;
+  rig.setServoLead(pipe == PIPE_LEAD);
+  rig.begin(rigChannels(0), &bus, profile);
+  bus.flush();
+  halI2CFlush();
+
+  const ChannelDescriptor *channels = rigChannels(0);
+  uint16_t centerH = descriptorCenterPosition(&channels[CH_HORIZONTAL]);
+  uint16_t centerV = descriptorCenterPosition(&channels[CH_VERTICAL]);
+  JoystickFilter filter = makeFilter(pipe == PIPE_FILTERED || pipe == PIPE_LEAD);
+  unsigned long leadUs = nunchuckPollUs(CLOCK_HZ) + SchedulerSettings::INPUT_LEAD_MARGIN_US;
+
+  // Start on a tick boundary; stick time is relative to the run start
+  uint64_t startUs = (simNowUs() / TICK_US + 1) * TICK_US;
+  simAdvanceUs(startUs - simNowUs());
+  board->clearLog();
+
+  for (uint64_t t = 0; t < durationUs; t += TICK_US) {
+    uint64_t tickStart = simNowUs();
+    int joyX = sampleStick(path, t > leadUs ? t - leadUs : 0);
+    int joyY = NunchuckCalibration::CENTER + (int)random(-NOISE, NOISE + 1);
+
+    uint16_t gazeH;
+    uint16_t gazeV;
+    if (pipe == PIPE_LEGACY) {
+      gazeH = legacyPosition(joyX);
+      gazeV = legacyPosition(joyY);
+    } else {
+      filter.update(joyX, joyY, TICK_US / 1000);
+      gazeH = joystickPosition(filter.deflectionX(), centerH);
+      gazeV = joystickPosition(filter.deflectionY(), centerV);
+    }
+    rig.setGaze(gazeH, gazeV);
+    rig.compose(halMillis(), TICK_US / 1000);
+    bus.flush();
+
+    uint64_t deadline = tickStart + TICK_US;
+    if (simNowUs() < deadline) simAdvanceUs(deadline - simNowUs());
+  }
+  halI2CFlush();
+
+  std::vector<PwmPoint> out;
+  uint8_t channelH = descriptorOutput(&channels[CH_HORIZONTAL]);
+  for (size_t i = 0; i < board->log().size(); i++) {
+    const PwmWrite &w = board->log()[i];
+    if (w.channel != channelH) continue;
+    PwmPoint p = {w.timeUs - startUs, w.off};
+    out.push_back(p);
+  }
+  board->setLogging(false);
+  return out;
+}
+
+/** Spread of the PWM after settleUs, and writes per second */
+static void spread(const std::vector<PwmPoint> &pwm, uint64_t settleUs, uint64_t endUs,
+                   int &peakToPeak, double &writesPerS) {
+  int lo = 10000;
+  int hi = -1;
+  int writes = 0;
+  for (size_t i = 0; i < pwm.size(); i++) {
+    if (pwm[i].us < settleUs) continue;
+    writes++;
+    if (pwm[i].pulse < lo) lo = pwm[i].pulse;
+    if (pwm[i].pulse > hi) hi = pwm[i].pulse;
+  }
+  peakToPeak = hi < 0 ? 0 : hi - lo;
+  writesPerS = writes * 1e6 / (endUs - settleUs);
+}
+
+/** Pulse commanded just before time us */
+static int pulseAt(const std::vector<PwmPoint> &pwm, uint64_t us, int initial) {
+  int pulse = initial;
+  for (size_t i = 0; i < pwm.size() && pwm[i].us <= us; i++) pulse = pwm[i].pulse;
+  return pulse;
+}
+
+/** Time after atUs for the PWM to first move / cover fraction of from → to */
+static double crossing(const std::vector<PwmPoint> &pwm, uint64_t atUs, int from, int to,
+                       double fraction) {
+  for (size_t i = 0; i < pwm.size(); i++) {
+    if (pwm[i].us < atUs) continue;
+    double covered = (double)(pwm[i].pulse - from) / (to - from);
+    if (fraction == 0 ? pwm[i].pulse != from : covered >= fraction) {
+      return (pwm[i].us - atUs) / 1000.0;
+    }
+  }
+  return -1;
+}
+
+/**
+ * Time after atUs for the horizontal shaft (ServoModel) to cover fraction
+ * of from → to, driven by the logged PWM from rest at from
+ */
+static double shaftCrossing(const std::vector<PwmPoint> &pwm, uint64_t atUs, int from, int to,
+                            double fraction) {
+  ServoModel shaft(HorizontalLimits::PLANT_TAU_MS, outputPulse(HorizontalLimits::PLANT_SLEW),
+                   from);
+  size_t next = 0;
+  int command = from;
+  while (next < pwm.size() && pwm[next].us <= atUs) command = pwm[next++].pulse;
+  const double stepMs = 0.1;
+  for (double t = 0; t < 1000; t += stepMs) {
+    uint64_t us = atUs + (uint64_t)(t * 1000);
+    while (next < pwm.size() && pwm[next].us <= us) command = pwm[next++].pulse;
+    shaft.run(command, stepMs);
+    if ((shaft.position - from) / (to - from) >= fraction) return t + stepMs;
+  }
+  return -1;
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+int main(int argc, char **argv) {
+  uint32_t seed = 1;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--seed") && i + 1 < argc) seed = (uint32_t)atoi(argv[++i]);
+    else {
+      fprintf(stderr, "usage: inputbench [--seed N]\n");
+      return 1;
+    }
+  }
+  channelTableLoadDefaults();
+
+  const int STEP_TRIALS = 20;
+  const uint64_t SETTLE_US = 1000000;
+
+  printf("inputbench: stick noise +-%d, rest %+d counts off CENTER, tremor +-%d; "
+         "%lu ms ticks, %lu kHz bus\n",
+         NOISE, REST_OFFSET, TREMOR, TICK_US / 1000, CLOCK_HZ / 1000);
+  printf("filter: min cutoff %.2f Hz, beta %.2f Hz per full/s, deadzone %d counts\n\n",
+         JoystickSettings::MIN_CUTOFF_MILLIHZ / 1000.0, JoystickSettings::BETA_MILLIHZ / 1000.0,
+         DEADZONE);
+  printf("%-9s %9s %9s %9s %12s %10s %10s %11s %11s %11s\n", "pipeline", "rest p-p",
+         "edge p-p", "held p-p", "step first", "step 50%", "step 90%", "shaft 50%", "shaft 90%",
+         "creep jump");
+
+  for (int p = 0; p < PIPE_COUNT; p++) {
+    Pipeline pipe = (Pipeline)p;
+
+    int restPP;
+    double restWrites;
+    std::vector<PwmPoint> rest = run(pipe, RestPath(REST_OFFSET), 10000000, seed);
+    spread(rest, SETTLE_US, 10000000, restPP, restWrites);
+
+    int edgePP;
+    double edgeWrites;
+    std::vector<PwmPoint> edgeRest = run(pipe, RestPath(DEADZONE), 10000000, seed + 3);
+    spread(edgeRest, SETTLE_US, 10000000, edgePP, edgeWrites);
+
+    int heldPP;
+    double heldWrites;
+    std::vector<PwmPoint> held = run(pipe, HoldPath(), 10000000, seed + 1);
+    spread(held, SETTLE_US, 10000000, heldPP, heldWrites);
+
+    // Flicks at random phases against the tick
+    double first = 0, half = 0, most = 0, shaftHalf = 0, shaftMost = 0;
+    for (int k = 0; k < STEP_TRIALS; k++) {
+      StepPath step;
+      step.atUs = SETTLE_US + (uint64_t)random(TICK_US);
+      std::vector<PwmPoint> pwm = run(pipe, step, SETTLE_US + 1000000, seed + 10 + k);
+      int from = pulseAt(pwm, step.atUs, descriptorCenter(&rigChannels(0)[CH_HORIZONTAL]));
+      int to = pwm.back().pulse;
+      first += crossing(pwm, step.atUs, from, to, 0);
+      half += crossing(pwm, step.atUs, from, to, 0.5);
+      most += crossing(pwm, step.atUs, from, to, 0.9);
+      shaftHalf += shaftCrossing(pwm, step.atUs, from, to, 0.5);
+      shaftMost += shaftCrossing(pwm, step.atUs, from, to, 0.9);
+    }
+
+    CreepPath creep;
+    creep.startUs = SETTLE_US;
+    std::vector<PwmPoint> edge = run(pipe, creep, SETTLE_US + 3000000, seed + 2);
+    int jump = 0;
+    for (size_t i = 1; i < edge.size(); i++) {
+      if (edge[i].us < SETTLE_US) continue;
+      int d = abs(edge[i].pulse - edge[i - 1].pulse);
+      if (d > jump) jump = d;
+    }
+
+    printf("%-9s %9d %9d %9d %9.1f ms %7.1f ms %7.1f ms %8.1f ms %8.1f ms %11d\n",
+           PIPELINE_NAMES[p], restPP, edgePP, heldPP, first / STEP_TRIALS, half / STEP_TRIALS,
+           most / STEP_TRIALS, shaftHalf / STEP_TRIALS, shaftMost / STEP_TRIALS, jump);
+  }
+  printf("\np-p and jumps in PWM counts (%.2f us each); step times from stick move to PCA9685 write,\n"
+         "shaft times to the servo getting there (%d ms lag, %d counts/s)\n",
+         1e6 * (OUTPUT_PRESCALE + 1) / PCA9685_OSCILLATOR_HZ, HorizontalLimits::PLANT_TAU_MS,
+         HorizontalLimits::PLANT_SLEW);
+  return 0;
+}
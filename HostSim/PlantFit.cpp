@@ -0,0 +1,226 @@
+/**
+ * PlantFit.cpp
+ *
+ * Fits a servo's response (ServoModel.h: first-order lag plus slew limit)
+ * to a logged step response and prints the EyeConfig.h lines for it
+ *
+ * The log is what ServoPulseCalibrator's 'r' command prints: CSV
+ * time_ms,command,response, both in calibration counts (the response is the
+ * pot wiper mapped to counts). The model is driven by the logged command,
+ * held between samples, and compared to the response; tau and slew are
+ * grid-searched, then refined around the best point.
+ *
+ * USAGE:
+ *   plantfit LOG.csv                    fit; rms error + PLANT_ lines on stdout
+ *   plantfit --simulate TAU SLEW [--noise N] [--seed N]
+ *                                       a synthetic step log on stdout
+ *   plantfit --check TAU SLEW [--noise N] [--seed N]
+ *                                       simulate, fit, PASS if tau and slew
+ *                                       come back within 10%
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+#include "ServoModel.h"
+
+// The 'r' sequence: percent of the calibrated window, each held STEP_MS
+static const int STEP_PERCENT[] = {50, 60, 40, 80, 20, 100, 0, 50};
+static const int STEP_COUNT = sizeof(STEP_PERCENT) / sizeof(STEP_PERCENT[0]);
+static const double STEP_MS = 400;
+static const double SAMPLE_MS = 4;
+static const double SIM_MIN = 250;   // A typical eye window
+static const double SIM_MAX = 450;
+
+// Search space
+static const double TAU_MIN_MS = 1, TAU_MAX_MS = 150;
+static const double SLEW_MIN = 100, SLEW_MAX = 10000;
+
+static const double CHECK_TOLERANCE = 0.10;
+
+struct Sample {
+  double timeMs;
+  double command;
+  double response;
+};
+
+typedef std::vector<Sample> Log;
+
+static void usage() {
+  fprintf(stderr,
+          "usage: plantfit LOG.csv\n"
+          "       plantfit --simulate TAU SLEW [--noise N] [--seed N]\n"
+          "       plantfit --check TAU SLEW [--noise N] [--seed N]\n");
+  exit(2);
+}
+
+static bool readLog(const char *path, Log &log) {
+  FILE *in = fopen(path, "r");
+  if (!in) {
+    perror(path);
+    return false;
+  }
+  char line[256];
+  while (fgets(line, sizeof(line), in)) {
+    Sample s;
+    // Header, blank and text lines (the calibrator's prompts) don't parse
+    if (sscanf(line, "%lf,%lf,%lf", &s.timeMs, &s.command, &s.response) == 3) {
+      log.push_back(s);
+    }
+  }
+  fclose(in);
+  return true;
+}
+
+/**
+ * The 'r' sequence through a ServoModel, sampled like the calibrator does:
+ * uniform noise of ±noise counts on the response
+ */
+static Log simulate(double tauMs, double slew, double noise) {
+  Log log;
+  ServoModel servo(tauMs, slew, SIM_MIN + (SIM_MAX - SIM_MIN) * STEP_PERCENT[0] / 100);
+  double timeMs = 0;
+  for (int step = 0; step < STEP_COUNT; step++) {
+    double command = SIM_MIN + (SIM_MAX - SIM_MIN) * STEP_PERCENT[step] / 100;
+    for (double held = 0; held < STEP_MS; held += SAMPLE_MS) {
+      double jitter = noise * (2.0 * rand() / RAND_MAX - 1.0);
+      Sample s = {timeMs, command, servo.position + jitter};
+      log.push_back(s);
+      servo.run(command, SAMPLE_MS);
+      timeMs += SAMPLE_MS;
+    }
+  }
+  return log;
+}
+
+/**
+ * Squared error of the model against the response, summed over the log
+ */
+static double cost(const Log &log, double tauMs, double slew) {
+  ServoModel servo(tauMs, slew, log[0].response);
+  double sum = 0;
+  for (size_t i = 1; i < log.size(); i++) {
+    servo.run(log[i - 1].command, log[i].timeMs - log[i - 1].timeMs);
+    double error = servo.position - log[i].response;
+    sum += error * error;
+  }
+  return sum;
+}
+
+/**
+ * Coarse grid (tau linear, slew logarithmic), then a pattern search that
+ * halves its step until it stops improving
+ */
+static double fit(const Log &log, double &tauMs, double &slew) {
+  double best = -1;
+  for (double t = TAU_MIN_MS; t <= TAU_MAX_MS; t += 2) {
+    for (double s = SLEW_MIN; s <= SLEW_MAX; s *= 1.12) {
+      double c = cost(log, t, s);
+      if (best < 0 || c < best) {
+        best = c;
+        tauMs = t;
+        slew = s;
+      }
+    }
+  }
+
+  double tauStep = 2;
+  double slewStep = 0.12;    // Relative
+  while (tauStep > 0.05 || slewStep > 0.002) {
+    bool moved = false;
+    const double tries[4][2] = {{tauStep, 0}, {-tauStep, 0}, {0, slewStep}, {0, -slewStep}};
+    for (int i = 0; i < 4; i++) {
+      double t = tauMs + tries[i][0];
+      double s = slew * (1.0 + tries[i][1]);
+      if (t < 0 || s < SLEW_MIN / 2) continue;
+      double c = cost(log, t, s);
+      if (c < best) {
+        best = c;
+        tauMs = t;
+        slew = s;
+        moved = true;
+      }
+    }
+    if (!moved) {
+      tauStep /= 2;
+      slewStep /= 2;
+    }
+  }
+  return sqrt(best / (log.size() - 1));
+}
+
+static void printFit(const Log &log, double tauMs, double slew, double rms) {
+  printf("plantfit: %zu samples over %.0f ms, rms error %.2f counts\n", log.size(),
+         log.back().timeMs - log[0].timeMs, rms);
+  printf("  tau %.1f ms, slew %.0f counts/s\n\n", tauMs, slew);
+  printf("Paste into the servo's limits struct in EyeConfig.h:\n");
+  printf("  static const int PLANT_TAU_MS = %d;   // Servo response (see above)\n",
+         (int)lround(tauMs));
+  printf("  static const int PLANT_SLEW = %d;     // counts/s\n", (int)lround(slew));
+}
+
+int main(int argc, char **argv) {
+  bool simulateOnly = false;
+  bool check = false;
+  double tauMs = 0, slew = 0, noise = 0;
+  const char *path = NULL;
+
+  for (int i = 1; i < argc; i++) {
+    if ((!strcmp(argv[i], "--simulate") || !strcmp(argv[i], "--check")) && i + 2 < argc) {
+      simulateOnly = !strcmp(argv[i], "--simulate");
+      check = !simulateOnly;
+      tauMs = atof(argv[++i]);
+      slew = atof(argv[++i]);
+    } else if (!strcmp(argv[i], "--noise") && i + 1 < argc) {
+      noise = atof(argv[++i]);
+    } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+      srand(atoi(argv[++i]));
+    } else if (argv[i][0] != '-' && !path) {
+      path = argv[i];
+    } else {
+      usage();
+    }
+  }
+  if ((simulateOnly || check) == (path != NULL)) usage();
+  if ((simulateOnly || check) && (tauMs < 0 || slew <= 0 || (check && tauMs == 0))) usage();
+
+  Log log;
+  if (path) {
+    if (!readLog(path, log)) return 1;
+  } else {
+    log = simulate(tauMs, slew, noise);
+  }
+
+  if (simulateOnly) {
+    printf("time_ms,command,response\n");
+    for (size_t i = 0; i < log.size(); i++) {
+      printf("%.0f,%.0f,%.1f\n", log[i].timeMs, log[i].command, log[i].response);
+    }
+    return 0;
+  }
+
+  if (log.size() < 10) {
+    fprintf(stderr, "plantfit: %zu samples - need a step response log (calibrator 'r')\n",
+            log.size());
+    return 1;
+  }
+
+  double fitTau = 0, fitSlew = 0;
+  double rms = fit(log, fitTau, fitSlew);
+  printFit(log, fitTau, fitSlew, rms);
+
+  if (check) {
+    double tauError = fabs(fitTau - tauMs) / tauMs;
+    double slewError = fabs(fitSlew - slew) / slew;
+    bool pass = tauError <= CHECK_TOLERANCE && slewError <= CHECK_TOLERANCE;
+    printf("\nplantfit: simulated tau %.0f ms, slew %.0f counts/s, noise ±%.1f: "
+           "tau off %.1f%%, slew off %.1f%%: %s\n",
+           tauMs, slew, noise, tauError * 100, slewError * 100, pass ? "PASS" : "FAIL");
+    return pass ? 0 : 1;
+  }
+  return 0;
+}
@@ -0,0 +1,141 @@
+/**
+ * PowerCheck.cpp
+ *
+ * PowerBudget catch-up check: an eye the budget held back must rejoin its
+ * target at the eye velocity limit, not in one jump
+ *
+ * Every servo in EYE_RIG_LIST on one mock board, under the smallest budget
+ * the config allows. For HOLD_TICKS motion ticks the lids flap end to end
+ * (a blink at full current) while the eye axes are sent to the far ends of
+ * their range: the lids take the budget and the eyes are held back. Then
+ * the lids rest and the budget frees up; from there until every eye is on
+ * target, each tick's step on each eye axis must be at most
+ *
+ *   catchUp = EYE_MAX_VELOCITY × tick / 1000   (output counts)
+ *
+ * (SafetyLimits::MAX_DELTA_PER_UPDATE, per tick). Also fails if the hold
+ * did not hold (the check would prove nothing) or an eye never arrives.
+ *
+ * USAGE:
+ *   powercheck          exit status 1 on failure
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ChannelTable.h"
+#include "PowerBudget.h"
+#include "ServoBus.h"
+#include "SimHardware.h"
+
+static const unsigned long TICK_MS = SchedulerSettings::MOTION_PERIOD_MS;
+static const int HOLD_TICKS = 8;
+static const int ARRIVE_TICKS = 200;        // Far more than a full sweep takes
+
+// Not in SERVO_BOARD_LIST (EyeConfig.h), like hotbench's
+static const uint8_t CHECK_BOARD = 0x7E;
+
+static bool isEye(uint8_t servo) {
+  return servo % CHANNEL_COUNT < CH_L_UPPER;
+}
+
+int main() {
+  ChannelDescriptor table[POWER_SERVOS];
+  memcpy_P(table, CHANNEL_DEFAULTS, sizeof(table));
+  for (uint8_t i = 0; i < POWER_SERVOS; i++) {
+    table[i].board = 0;
+    table[i].channel = i % SERVO_FRAME_CHANNELS;
+  }
+
+  halBusClock(ServoBusSettings::I2C_CLOCK_HZ);
+  simAddPCA9685(CHECK_BOARD)->setLogging(false);
+  ServoFrame frame(CHECK_BOARD);
+  frame.begin(OUTPUT_PRESCALE);
+  halI2CFlush();
+  ServoBus bus(&frame, 1, 0xFFFF);
+
+  const uint16_t budgetMa = POWER_SERVOS * PowerSettings::HOLD_MA + PowerSettings::STALL_MA;
+  PowerBudget power(&bus, table, budgetMa);
+  const uint16_t catchUp = (uint16_t)(EYE_MAX_VELOCITY * TICK_MS / 1000);
+
+  // Everything centered, as the first pose
+  for (uint8_t i = 0; i < POWER_SERVOS; i++) power.set(&table[i], descriptorCenter(&table[i]));
+  power.apply(0);
+
+  uint16_t eyeTarget[POWER_SERVOS];
+  for (uint8_t i = 0; i < POWER_SERVOS; i++) {
+    eyeTarget[i] = i % CHANNEL_COUNT == CH_HORIZONTAL ? descriptorMax(&table[i])
+                                                      : descriptorMin(&table[i]);
+  }
+
+  // Lids flap, eyes are sent far: the budget holds the eyes back
+  for (int t = 0; t < HOLD_TICKS; t++) {
+    for (uint8_t i = 0; i < POWER_SERVOS; i++) {
+      const ChannelDescriptor *d = &table[i];
+      if (isEye(i)) power.set(d, eyeTarget[i]);
+      else power.set(d, t & 1 ? descriptorMax(d) : descriptorMin(d));
+    }
+    power.apply(TICK_MS);
+    bus.flush();
+    halI2CFlush();
+  }
+
+  uint16_t heldBack = 0;
+  for (uint8_t i = 0; i < POWER_SERVOS; i++) {
+    if (!isEye(i)) continue;
+    uint16_t at = bus.get(0, table[i].channel);
+    uint16_t left = at > eyeTarget[i] ? at - eyeTarget[i] : eyeTarget[i] - at;
+    if (left > heldBack) heldBack = left;
+  }
+  printf("powercheck: budget %u mA, %d ticks of %lu ms held the eyes %u counts short "
+         "(catch-up %u counts/tick)\n",
+         budgetMa, HOLD_TICKS, TICK_MS, heldBack, catchUp);
+  if (heldBack <= catchUp) {
+    printf("powercheck: FAIL - the budget did not hold the eyes back\n");
+    return 1;
+  }
+
+  // Lids rest where they are: the eyes have the budget to themselves
+  uint16_t maxStep = 0;
+  int failures = 0;
+  int ticks = 0;
+  bool arrived = false;
+  while (!arrived && ticks < ARRIVE_TICKS) {
+    uint16_t before[POWER_SERVOS];
+    for (uint8_t i = 0; i < POWER_SERVOS; i++) {
+      before[i] = bus.get(0, table[i].channel);
+      power.set(&table[i], isEye(i) ? eyeTarget[i] : before[i]);
+    }
+    power.apply(TICK_MS);
+    bus.flush();
+    halI2CFlush();
+    ticks++;
+
+    arrived = true;
+    for (uint8_t i = 0; i < POWER_SERVOS; i++) {
+      if (!isEye(i)) continue;
+      uint16_t at = bus.get(0, table[i].channel);
+      uint16_t step = at > before[i] ? at - before[i] : before[i] - at;
+      if (step > maxStep) maxStep = step;
+      if (step > catchUp) {
+        printf("powercheck: rig %u axis %u stepped %u counts in tick %d (limit %u)\n",
+               i / CHANNEL_COUNT, i % CHANNEL_COUNT, step, ticks, catchUp);
+        failures++;
+      }
+      if (at != eyeTarget[i]) arrived = false;
+    }
+  }
+
+  printf("powercheck: eyes on target after %d ticks, largest step %u counts\n", ticks, maxStep);
+  if (!arrived) {
+    printf("powercheck: FAIL - eyes not on target after %d ticks\n", ARRIVE_TICKS);
+    return 1;
+  }
+  if (failures > 0) {
+    printf("powercheck: FAIL - %d steps over the catch-up limit\n", failures);
+    return 1;
+  }
+  printf("powercheck: PASS\n");
+  return 0;
+}
@@ -0,0 +1,209 @@
+/**
+ * RigBench.cpp
+ *
+ * Per-tick cost of the multi-rig output path at 6, 16, 32 and 64 channels
+ *
+ * Builds N channels' worth of EyeRigs (6 servos each; the surplus servos of
+ * a last partial rig are left unconnected), packed onto ceil(N/16) mock
+ * PCA9685 boards, and runs them through the real EyeRig / ServoBus /
+ * ServoFrame code against the simulated I2C bus, one 20 ms motion tick at
+ * a time:
+ *   idle   every rig runs its own idle behavior (look-around, blinks, clips)
+ *   sweep  every servo changes every tick (worst case)
+ *
+ * Reported per tick: I2C bytes and transactions, bus time (spent in the
+ * background by the I2C queue, but it still bounds the tick), ticks that
+ * hit the ServoBusSettings budget or a full queue and the longest run of
+ * them, and host CPU time of the rig + bus code (x86 - use it for scaling,
+ * not as AVR cycles).
+ *
+ * USAGE:
+ *   rigbench [--seconds S]     (default 60 virtual seconds per run)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <vector>
+
+#include "ChannelTable.h"
+#include "EyeRig.h"
+#include "I2CQueue.h"
+#include "ServoBus.h"
+#include "SimHardware.h"
+
+static const int CHANNEL_COUNTS[] = {6, 16, 32, 64};
+static const unsigned long CLOCKS_HZ[] = {100000, 400000};
+static const unsigned long TICK_US = SchedulerSettings::MOTION_PERIOD_MS * 1000UL;
+
+enum Scenario { SCENARIO_IDLE, SCENARIO_SWEEP };
+
+struct BenchResult {
+  double bytesMean;
+  unsigned bytesMax;
+  double transactionsMean;
+  double busUsMean;
+  unsigned long busUsMax;
+  double deferredPct;
+  unsigned maxDeferredRun;
+  double cpuUsMean;
+};
+
+static double hostSeconds() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int triangle(long step, int span) {
+  long phase = step % (2 * span);
+  return (int)(phase < span ? phase : 2 * span - phase);
+}
+
+static uint8_t nextBoardAddress = 0x40;
+
+static BenchResult runBench(int channels, unsigned long clockHz, Scenario scenario, double seconds) {
+  int rigCount = (channels + CHANNEL_COUNT - 1) / CHANNEL_COUNT;
+  int boardCount = (channels + SERVO_FRAME_CHANNELS - 1) / SERVO_FRAME_CHANNELS;
+
+  // Fresh mock boards per run (the bus keeps earlier ones; they stay idle)
+  halBusClock(clockHz);
+  std::vector<ServoFrame> frames;
+  frames.reserve(boardCount);     // begin() reports into the frame: no reallocation
+  for (int b = 0; b < boardCount; b++) {
+    uint8_t address = nextBoardAddress++;
+    simAddPCA9685(address)->setLogging(false);
+    frames.push_back(ServoFrame(address));
+    frames.back().begin(OUTPUT_PRESCALE);
+  }
+  ServoBus bus(&frames[0], (uint8_t)boardCount,
+               servoBusBudget(clockHz, ServoBusSettings::OUTPUT_BUDGET_US));
+
+  // Rig r servo i → output r*6+i, packed across boards; calibration of the first rig
+  std::vector<ChannelDescriptor> tables(rigCount * CHANNEL_COUNT);
+  for (int r = 0; r < rigCount; r++) {
+    for (int i = 0; i < CHANNEL_COUNT; i++) {
+      int output = r * CHANNEL_COUNT + i;
+      ChannelDescriptor &d = tables[output];
+      memcpy_P(&d, &CHANNEL_DEFAULTS[i], sizeof(d));
+      d.board = output < channels ? output / SERVO_FRAME_CHANNELS : 0;
+      d.channel = output < channels ? output % SERVO_FRAME_CHANNELS : 0xFF;
+    }
+  }
+
+  MotionProfile profile =
+      motionProfile(MotionSettings::EYE_RESPONSE_MS, EYE_MAX_VELOCITY, EYE_MAX_ACCEL);
+  std::vector<EyeRig> rigs(rigCount);
+  randomSeed(1);
+  for (int r = 0; r < rigCount; r++) {
+    rigs[r].begin(&tables[r * CHANNEL_COUNT], &bus, profile);
+    if (scenario == SCENARIO_IDLE) rigs[r].enterIdle(halMillis());
+  }
+  bus.flush();
+  while (bus.pending()) {
+    halI2CFlush();
+    bus.flush();
+  }
+  halI2CFlush();
+
+  long ticks = (long)(seconds * 1e6 / TICK_US);
+  unsigned long long bytes = 0, transactions = 0, busUs = 0;
+  unsigned bytesMax = 0;
+  unsigned long busUsMax = 0;
+  long deferredTicks = 0;
+  unsigned run = 0, maxRun = 0;
+  double cpu = 0;
+
+  for (long t = 0; t < ticks; t++) {
+    uint64_t tickStart = simNowUs();
+    unsigned long now = halMillis();
+
+    double c0 = hostSeconds();
+    for (int r = 0; r < rigCount; r++) {
+      EyeRig &rig = rigs[r];
+      if (scenario == SCENARIO_IDLE) {
+        rig.runIdle(now, TICK_US / 1000);
+      } else {
+        long step = t + 37 * r;   // Rigs out of phase
+        rig.setGaze(triangle(step * 5, CHANNEL_POS_FULL), triangle(step * 3, CHANNEL_POS_FULL));
+        rig.holdLids(triangle(step * 16, CHANNEL_POS_FULL));
+      }
+      rig.compose(now, TICK_US / 1000);
+    }
+    uint64_t busStart = simBusStats().busyUs;
+    bus.flush();
+    double c2 = hostSeconds();
+
+    // Host CPU of rig + scheduling code (the mock boards' decoding included)
+    cpu += c2 - c0;
+    const ServoBusStats &s = bus.lastFlush();
+    bytes += s.busBytes;
+    transactions += s.transactions;
+    if (s.busBytes > bytesMax) bytesMax = s.busBytes;
+    if (bus.pending()) {
+      deferredTicks++;
+      if (++run > maxRun) maxRun = run;
+    } else {
+      run = 0;
+    }
+
+    // The bursts go out while the tick idles; bus time is what they took
+    uint64_t deadline = tickStart + TICK_US;
+    if (simNowUs() < deadline) simAdvanceUs(deadline - simNowUs());
+    unsigned long spent = (unsigned long)(simBusStats().busyUs - busStart);
+    busUs += spent;
+    if (spent > busUsMax) busUsMax = spent;
+  }
+
+  BenchResult result;
+  result.bytesMean = (double)bytes / ticks;
+  result.bytesMax = bytesMax;
+  result.transactionsMean = (double)transactions / ticks;
+  result.busUsMean = (double)busUs / ticks;
+  result.busUsMax = busUsMax;
+  result.deferredPct = 100.0 * deferredTicks / ticks;
+  result.maxDeferredRun = maxRun;
+  result.cpuUsMean = cpu * 1e6 / ticks;
+  return result;
+}
+
+int main(int argc, char **argv) {
+  double seconds = 60;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--seconds") && i + 1 < argc) seconds = atof(argv[++i]);
+    else {
+      fprintf(stderr, "usage: rigbench [--seconds S]\n");
+      return 1;
+    }
+  }
+
+  printf("rigbench: %.0f s per run, %lu ms ticks, bus budget %lu us/tick, i2c queue %u bytes\n\n",
+         seconds, TICK_US / 1000, ServoBusSettings::OUTPUT_BUDGET_US, I2C_QUEUE_BYTES);
+  printf("%-8s %4s %6s %5s %-6s %10s %9s %8s %14s %9s %10s %8s\n", "channels", "rigs",
+         "boards", "kHz", "scene", "bytes/tick", "max", "txn/tick", "bus us (max)", "bus %tick",
+         "deferred", "cpu us");
+
+  for (size_t c = 0; c < sizeof(CHANNEL_COUNTS) / sizeof(CHANNEL_COUNTS[0]); c++) {
+    for (size_t k = 0; k < sizeof(CLOCKS_HZ) / sizeof(CLOCKS_HZ[0]); k++) {
+      for (int sc = SCENARIO_IDLE; sc <= SCENARIO_SWEEP; sc++) {
+        int channels = CHANNEL_COUNTS[c];
+        BenchResult r = runBench(channels, CLOCKS_HZ[k], (Scenario)sc, seconds);
+        char busText[32];
+        char deferredText[32];
+        snprintf(busText, sizeof(busText), "%.0f (%lu)", r.busUsMean, r.busUsMax);
+        snprintf(deferredText, sizeof(deferredText), "%.1f%%/%u", r.deferredPct, r.maxDeferredRun);
+        printf("%-8d %4d %6d %5lu %-6s %10.1f %9u %8.2f %14s %8.1f%% %10s %8.2f\n", channels,
+               (channels + CHANNEL_COUNT - 1) / CHANNEL_COUNT,
+               (channels + SERVO_FRAME_CHANNELS - 1) / SERVO_FRAME_CHANNELS,
+               CLOCKS_HZ[k] / 1000, sc == SCENARIO_IDLE ? "idle" : "sweep", r.bytesMean,
+               r.bytesMax, r.transactionsMean, busText, 100.0 * r.busUsMean / TICK_US,
+               deferredText, r.cpuUsMean);
+      }
+    }
+  }
+  printf("\ndeferred: ticks that left writes for the next tick (%%) / longest run of them\n"
+         "          (over the bus budget or the i2c queue full)\n");
+  return 0;
+}
@@ -0,0 +1,46 @@
+/**
+ * ServoModel.h
+ *
+ * Shaft of a hobby servo on the host: first-order lag plus rate limit, the
+ * plant PLANT_TAU_MS / PLANT_SLEW describe in EyeConfig.h
+ *
+ *   d(position)/dt = clamp((command - position) / tau, -slew, +slew)
+ *
+ * inputbench runs the PWM it logged through it to time the shaft, not just
+ * the pulse; plantfit fits tau and slew to a logged step response with it
+ * and synthesizes test logs.
+ */
+
+#ifndef HOSTSIM_SERVO_MODEL_H
+#define HOSTSIM_SERVO_MODEL_H
+
+#include <math.h>
+
+// Integration step: well under any tau worth fitting
+#define SERVO_MODEL_STEP_MS 0.1
+
+struct ServoModel {
+  double tauMs;
+  double slewPerMs;          // Counts per ms
+  double position;           // Counts
+
+  ServoModel(double tauMs, double slewPerSec, double position)
+    : tauMs(tauMs), slewPerMs(slewPerSec / 1000.0), position(position) {}
+
+  /** Follow command for dtMs */
+  void run(double command, double dtMs) {
+    while (dtMs > 0) {
+      double h = dtMs < SERVO_MODEL_STEP_MS ? dtMs : SERVO_MODEL_STEP_MS;
+      double error = command - position;
+      // The lag's exact solution over h (stable for any tau), then the limit
+      double move = tauMs > 0 ? error * (1.0 - exp(-h / tauMs)) : error;
+      double most = slewPerMs * h;
+      if (move > most) move = most;
+      if (move < -most) move = -most;
+      position += move;
+      dtMs -= h;
+    }
+  }
+};
+
+#endif // HOSTSIM_SERVO_MODEL_H
@@ -0,0 +1,54 @@
+/**
+ * SimFirmware.h
+ *
+ * Entry points and introspection for the firmware compiled into the host
+ * simulator (see Firmware.cpp)
+ */
+
+#ifndef SIM_FIRMWARE_H
+#define SIM_FIRMWARE_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+// Sketch entry points
+void setup();
+void loop();
+
+// Sketch state, read-only
+int simFirmwareState();
+const char *simFirmwareStateName(int state);
+int simFirmwareStateCount();
+
+// What the rigs are animating, for per-animation figures (rigs[0] first)
+int simFirmwareAnimation();
+const char *simFirmwareAnimationName(int animation);
+int simFirmwareAnimationCount();
+
+// Estimated servo current of the last output tick (PowerBudget.h), mA
+void simFirmwarePower(unsigned *drawMa, unsigned *demandMa, bool *limited);
+unsigned simFirmwarePowerBudget();
+void simFirmwareSetPowerBudget(unsigned ma);
+
+// Telemetry ring counters (frames queued, drops, high-water mark)
+void simFirmwarePrintTelemetry(FILE *out);
+
+// Host gaze command link counters
+void simFirmwarePrintGazeLink(FILE *out);
+
+// I2C queue and nunchuck link counters
+void simFirmwarePrintI2C(FILE *out);
+
+// Scheduler rate-group timing table
+void simFirmwarePrintTiming(FILE *out);
+
+// Ticks skipped by every rate group together (RateGroupStats::overruns)
+unsigned long simFirmwareOverruns();
+
+// Motion ticks run so far, and one rig channel as the last one staged it:
+// the pulse before the servo lead (eyes: the motion engine's output) and
+// the lead added to it, output counts
+unsigned long simFirmwareMotionTicks();
+void simFirmwareMotion(uint8_t rig, uint8_t channel, int *motion, int *lead);
+
+#endif // SIM_FIRMWARE_H
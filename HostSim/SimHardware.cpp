@@ -0,0 +1,569 @@
+/**
+ * SimHardware.cpp
+ *
+ * Linux implementation of EyeHAL.h plus the simulated devices behind it
+ */
+
+#include "SimHardware.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "EyeConfig.h"
+#include "I2CQueue.h"
+#include "NunchuckLink.h"
+
+// ============================================================================
+// VIRTUAL CLOCK
+// ============================================================================
+
+static uint64_t clockUs = 0;
+
+void simSerialService();  // ArduinoShim.cpp
+static void busRun(uint64_t untilUs);
+static void eepromRun(uint64_t untilUs);
+
+uint64_t simNowUs() {
+  return clockUs;
+}
+
+void simAdvanceUs(uint64_t us) {
+  // Bus transfers finish (and chain) at their own times along the way
+  uint64_t target = clockUs + us;
+  busRun(target);
+  eepromRun(target);
+  clockUs = target;
+  simSerialService();
+}
+
+// ============================================================================
+// I2C BUS
+// ============================================================================
+
+static std::vector<SimI2CDevice *> devices;
+static uint32_t busClockHz = 100000;   // Standard mode
+static SimBusStats busStats = {0, 0, 0, 0};
+
+// Per transaction: START + address byte + payload, 9 clocks per byte, STOP
+static const uint32_t BUS_FRAMING_CLOCKS = 2;
+
+void simI2CAttach(SimI2CDevice *device) {
+  devices.push_back(device);
+}
+
+void simI2CSetClock(uint32_t hz) {
+  busClockHz = hz;
+}
+
+uint32_t simI2CClock() {
+  return busClockHz;
+}
+
+uint32_t simI2CTransactionUs(size_t len) {
+  uint64_t clocks = BUS_FRAMING_CLOCKS + 9 * (uint64_t)(len + 1);
+  return (uint32_t)((clocks * 1000000ULL + busClockHz - 1) / busClockHz);
+}
+
+static SimI2CDevice *findDevice(uint8_t address) {
+  for (size_t i = 0; i < devices.size(); i++) {
+    if (devices[i]->address() == address && devices[i]->present()) {
+      return devices[i];
+    }
+  }
+  return NULL;
+}
+
+/*
+ * Background driver for i2cQueue - the TWI interrupt of the UNO backend.
+ * A transaction occupies the bus from its START (as soon as the previous
+ * STOP plus its holdUs allow) for its byte time; the device sees the data
+ * and the queue gets the outcome at the STOP. The firmware only pays CPU
+ * time when it waits in halI2CFlush().
+ */
+static bool twiBusy = false;
+static SimI2CDevice *twiDevice = NULL;   // NULL → address NACKed
+static uint64_t twiEndUs = 0;
+static uint64_t twiStopUs = 0;
+
+static uint64_t busNextEventUs() {
+  if (twiBusy) return twiEndUs;
+  const I2CTransaction *t = i2cQueue.front();
+  if (t == NULL) return UINT64_MAX;
+  uint64_t start = twiStopUs + t->holdUs;
+  return start > clockUs ? start : clockUs;
+}
+
+static void busStep() {
+  const I2CTransaction *t = i2cQueue.front();
+
+  if (!twiBusy) {
+    // START: the address byte decides ACK; a NACK ends it right there
+    twiDevice = findDevice(t->address);
+    size_t wireBytes = twiDevice != NULL ? t->length : 0;
+    uint32_t us = simI2CTransactionUs(wireBytes);
+    busStats.transactions++;
+    busStats.bytes += wireBytes + 1;
+    busStats.busyUs += us;
+    twiBusy = true;
+    twiEndUs = clockUs + us;
+    return;
+  }
+
+  // STOP
+  uint8_t status = I2C_NACK;
+  if (twiDevice != NULL) {
+    if (t->readBuffer != NULL) {
+      twiDevice->onRead(t->readBuffer, t->length);
+    } else {
+      uint8_t data[256];
+      for (uint8_t i = 0; i < t->length; i++) data[i] = i2cQueue.payload(i);
+      twiDevice->onWrite(data, t->length);
+    }
+    status = I2C_DONE;
+  }
+  twiBusy = false;
+  twiStopUs = clockUs;
+  i2cQueue.complete(status);
+}
+
+static void busRun(uint64_t untilUs) {
+  uint64_t next;
+  while ((next = busNextEventUs()) <= untilUs) {
+    clockUs = next;
+    busStep();
+  }
+}
+
+const SimBusStats &simBusStats() {
+  return busStats;
+}
+
+void simBusStatsReset() {
+  memset(&busStats, 0, sizeof(busStats));
+}
+
+// ============================================================================
+// MOCK PCA9685
+// ============================================================================
+
+static const uint8_t PCA9685_MODE1 = 0x00;
+static const uint8_t PCA9685_LED0_ON_L = 0x06;
+static const uint8_t PCA9685_PRESCALE = 0xFE;
+static const uint8_t MODE1_AI = 0x20;
+static const float PCA9685_OSC_HZ = 25000000.0f;
+
+MockPCA9685::MockPCA9685(uint8_t address)
+  : SimI2CDevice(address), logging_(true), channelWrites_(0), redundantWrites_(0) {
+  memset(regs_, 0, sizeof(regs_));
+  memset(off_, 0, sizeof(off_));
+  regs_[PCA9685_MODE1] = 0x11;      // Power-on: SLEEP | ALLCALL
+  regs_[PCA9685_PRESCALE] = 0x1E;   // Power-on: 200 Hz
+}
+
+void MockPCA9685::onWrite(const uint8_t *data, size_t len) {
+  if (len == 0) return;
+
+  uint8_t reg = data[0];
+  for (size_t i = 1; i < len; i++) {
+    regs_[reg] = data[i];
+
+    // A channel is latched when its OFF_H byte lands
+    if (reg >= PCA9685_LED0_ON_L && reg < PCA9685_LED0_ON_L + 64 &&
+        ((reg - PCA9685_LED0_ON_L) & 3) == 3) {
+      uint8_t channel = (reg - PCA9685_LED0_ON_L) >> 2;
+      uint8_t base = PCA9685_LED0_ON_L + 4 * channel;
+      uint16_t on = regs_[base] | ((regs_[base + 1] & 0x1F) << 8);
+      uint16_t offValue = regs_[base + 2] | ((regs_[base + 3] & 0x1F) << 8);
+
+      channelWrites_++;
+      if (offValue == off_[channel]) redundantWrites_++;
+      off_[channel] = offValue;
+
+      if (logging_) {
+        PwmWrite w = {simNowUs(), address(), channel, on, offValue};
+        log_.push_back(w);
+      }
+    }
+
+    if (regs_[PCA9685_MODE1] & MODE1_AI) reg++;
+  }
+}
+
+size_t MockPCA9685::onRead(uint8_t *data, size_t len) {
+  // Reads return MODE1 onward; the firmware only uses them for probing
+  for (size_t i = 0; i < len; i++) data[i] = regs_[i];
+  return len;
+}
+
+float MockPCA9685::frequencyHz() const {
+  return PCA9685_OSC_HZ / (4096.0f * (prescale() + 1));
+}
+
+float MockPCA9685::pulseWidthUs(uint8_t channel) const {
+  return off_[channel] * 1000000.0f / (4096.0f * frequencyHz());
+}
+
+static std::vector<MockPCA9685 *> shields;
+
+MockPCA9685 *simAddPCA9685(uint8_t address) {
+  MockPCA9685 *shield = new MockPCA9685(address);
+  shields.push_back(shield);
+  simI2CAttach(shield);
+  return shield;
+}
+
+MockPCA9685 *simPCA9685(uint8_t address) {
+  for (size_t i = 0; i < shields.size(); i++) {
+    if (shields[i]->address() == address) return shields[i];
+  }
+  return NULL;
+}
+
+// ============================================================================
+// FAKE NUNCHUCK
+// ============================================================================
+
+static std::vector<NunchuckScriptStep> script;
+
+static NunchuckSample restingSample() {
+  NunchuckSample s;
+  s.joyX = NunchuckCalibration::CENTER;
+  s.joyY = NunchuckCalibration::CENTER;
+  s.accelX = 512;
+  s.accelY = 512;
+  s.accelZ = 716;
+  s.buttonZ = false;
+  s.buttonC = false;
+  s.connected = true;
+  return s;
+}
+
+static bool stepEarlier(uint32_t timeMs, const NunchuckScriptStep &step) {
+  return timeMs < step.timeMs;
+}
+
+void simNunchuckAddStep(const NunchuckScriptStep &step) {
+  // Keep the script sorted (replays append thousands of steps in order)
+  script.insert(std::upper_bound(script.begin(), script.end(), step.timeMs, stepEarlier), step);
+}
+
+void simNunchuckClearScript() {
+  script.clear();
+}
+
+void simNunchuckClearScriptFrom(uint32_t timeMs) {
+  while (!script.empty() && script.back().timeMs >= timeMs) script.pop_back();
+}
+
+bool simNunchuckLoadScript(const char *path) {
+  FILE *f = fopen(path, "r");
+  if (f == NULL) return false;
+
+  char line[256];
+  while (fgets(line, sizeof(line), f) != NULL) {
+    char *hash = strchr(line, '#');
+    if (hash != NULL) *hash = '\0';
+
+    NunchuckScriptStep step;
+    step.sample = restingSample();
+    unsigned long t;
+    int z, c, ax, ay, az, connected;
+    int n = sscanf(line, "%lu %d %d %d %d %d %d %d %d", &t, &step.sample.joyX, &step.sample.joyY,
+                   &z, &c, &ax, &ay, &az, &connected);
+    if (n <= 0) continue;
+    if (n < 5) {
+      fclose(f);
+      return false;
+    }
+    step.timeMs = (uint32_t)t;
+    step.sample.buttonZ = z != 0;
+    step.sample.buttonC = c != 0;
+    if (n >= 8) {
+      step.sample.accelX = ax;
+      step.sample.accelY = ay;
+      step.sample.accelZ = az;
+    }
+    if (n >= 9) step.sample.connected = connected != 0;
+    simNunchuckAddStep(step);
+  }
+  fclose(f);
+  return true;
+}
+
+NunchuckSample simNunchuckSampleAt(uint64_t timeUs) {
+  uint64_t timeMs = timeUs / 1000;
+  if (timeMs > 0xFFFFFFFFULL) timeMs = 0xFFFFFFFFULL;
+  std::vector<NunchuckScriptStep>::const_iterator it =
+    std::upper_bound(script.begin(), script.end(), (uint32_t)timeMs, stepEarlier);
+  return it == script.begin() ? restingSample() : (it - 1)->sample;
+}
+
+/** Whether the script unplugs the nunchuck at any point in [fromUs, toUs] */
+static bool unpluggedBetween(uint64_t fromUs, uint64_t toUs) {
+  if (!simNunchuckSampleAt(fromUs).connected) return true;
+  std::vector<NunchuckScriptStep>::const_iterator it =
+    std::upper_bound(script.begin(), script.end(), (uint32_t)(fromUs / 1000), stepEarlier);
+  for (; it != script.end() && (uint64_t)it->timeMs * 1000 <= toUs; ++it) {
+    uint64_t t = (uint64_t)it->timeMs * 1000;
+    if (t > fromUs && !it->sample.connected) return true;
+  }
+  return false;
+}
+
+/**
+ * Register-level nunchuck: answers only after the unencrypted-mode init
+ * (F0 55, FB 00) - again after every replug - with the ID at 0xFA and the
+ * 6-byte report in the standard Wii format at 0x00. Reads auto-increment
+ * the register pointer, so a poll that isn't re-armed reads garbage.
+ */
+class FakeNunchuck : public SimI2CDevice {
+public:
+  FakeNunchuck()
+    : SimI2CDevice(NUNCHUCK_ADDRESS), pointer_(0), unlocked_(false), initialized_(false),
+      initUs_(0) {}
+
+  bool present() const {
+    return simNunchuckSampleAt(simNowUs()).connected;
+  }
+
+  void onWrite(const uint8_t *data, size_t len) {
+    if (len == 0) return;
+    pointer_ = data[0];
+    if (len < 2) return;
+
+    if (data[0] == 0xF0 && data[1] == 0x55) {
+      unlocked_ = true;
+    } else if (data[0] == 0xFB && data[1] == 0x00 && unlocked_) {
+      initialized_ = true;
+      initUs_ = simNowUs();
+    }
+  }
+
+  size_t onRead(uint8_t *data, size_t len) {
+    static const uint8_t ID[6] = {0x00, 0x00, 0xA4, 0x20, 0x00, 0x00};
+
+    if (initialized_ && unpluggedBetween(initUs_, simNowUs())) {
+      unlocked_ = false;
+      initialized_ = false;
+    }
+
+    NunchuckSample s = simNunchuckSampleAt(simNowUs());
+    uint8_t report[6];
+    report[0] = (uint8_t)s.joyX;
+    report[1] = (uint8_t)s.joyY;
+    report[2] = (uint8_t)(s.accelX >> 2);
+    report[3] = (uint8_t)(s.accelY >> 2);
+    report[4] = (uint8_t)(s.accelZ >> 2);
+    report[5] = (uint8_t)(((s.accelZ & 3) << 6) | ((s.accelY & 3) << 4) | ((s.accelX & 3) << 2) |
+                          (s.buttonC ? 0 : 2) | (s.buttonZ ? 0 : 1));
+
+    for (size_t i = 0; i < len; i++) {
+      uint8_t reg = (uint8_t)(pointer_ + i);
+      data[i] = 0xFF;
+      if (!initialized_) continue;
+      if (reg < 6) data[i] = report[reg];
+      if (reg >= 0xFA) data[i] = ID[reg - 0xFA];
+    }
+    pointer_ = (uint8_t)(pointer_ + len);
+    return len;
+  }
+
+private:
+  uint8_t pointer_;
+  bool unlocked_;
+  bool initialized_;
+  uint64_t initUs_;
+};
+
+static FakeNunchuck *fakeNunchuck = NULL;
+
+void simAddNunchuck() {
+  if (fakeNunchuck == NULL) {
+    fakeNunchuck = new FakeNunchuck();
+    simI2CAttach(fakeNunchuck);
+  }
+}
+
+// ============================================================================
+// EEPROM
+// ============================================================================
+
+static const uint32_t EEPROM_WRITE_US = 3400;   // Erase + write, per byte
+
+static uint8_t eeprom[SIM_EEPROM_BYTES];
+static bool eepromErased = false;
+static SimEepromStats eepromStats;
+
+// Background queue (halEepromQueue): one contiguous run, written a byte
+// per EEPROM write time while the firmware runs on
+static uint8_t eepromQueue[HAL_EEPROM_QUEUE_SIZE];
+static uint8_t eepromHead = 0;
+static uint8_t eepromCount = 0;
+static uint16_t eepromAddress = 0;       // Address of the front byte
+static uint64_t eepromReadyUs = 0;       // EEPROM free again (last write done)
+
+static void eepromInit() {
+  if (eepromErased) return;
+  memset(eeprom, 0xFF, sizeof(eeprom));
+  eepromErased = true;
+}
+
+bool simEepromLoad(const char *path) {
+  eepromInit();
+  FILE *f = fopen(path, "rb");
+  if (f == NULL) return false;
+  size_t got = fread(eeprom, 1, sizeof(eeprom), f);
+  fclose(f);
+  return got == sizeof(eeprom);
+}
+
+bool simEepromSave(const char *path) {
+  eepromInit();
+  FILE *f = fopen(path, "wb");
+  if (f == NULL) return false;
+  bool ok = fwrite(eeprom, 1, sizeof(eeprom), f) == sizeof(eeprom);
+  return fclose(f) == 0 && ok;
+}
+
+const SimEepromStats &simEepromStats() {
+  return eepromStats;
+}
+
+static void eepromRun(uint64_t untilUs) {
+  while (eepromCount > 0 && eepromReadyUs <= untilUs) {
+    uint8_t value = eepromQueue[eepromHead];
+    if (eepromAddress < SIM_EEPROM_BYTES && eeprom[eepromAddress] != value) {
+      eeprom[eepromAddress] = value;
+      eepromStats.bytesWritten++;
+      eepromStats.backgroundBytes++;
+      eepromReadyUs += EEPROM_WRITE_US;
+    }
+    eepromAddress++;
+    eepromHead = (eepromHead + 1) % HAL_EEPROM_QUEUE_SIZE;
+    eepromCount--;
+  }
+}
+
+// ============================================================================
+// ANALOG INPUTS
+// ============================================================================
+
+static int analogValues[20];
+
+void simAnalogSet(uint8_t pin, int value) {
+  if (pin < 20) analogValues[pin] = value;
+}
+
+int analogRead(uint8_t pin) {
+  return pin < 20 ? analogValues[pin] : 0;
+}
+
+// ============================================================================
+// HAL: TIME
+// ============================================================================
+
+unsigned long halMillis() {
+  return (unsigned long)(clockUs / 1000);
+}
+
+unsigned long halMicros() {
+  return (unsigned long)clockUs;
+}
+
+void halDelay(unsigned long ms) {
+  simAdvanceUs((uint64_t)ms * 1000);
+}
+
+void halIdleUntil(unsigned long deadlineUs) {
+  long wait = (long)(deadlineUs - halMicros());
+  if (wait > 0) simAdvanceUs((uint64_t)wait);
+}
+
+// ============================================================================
+// HAL: I2C BUS
+// ============================================================================
+
+void halBusClock(unsigned long hz) {
+  simI2CSetClock((uint32_t)hz);
+}
+
+void halI2CService() {
+  busRun(clockUs);
+}
+
+void halI2CFlush() {
+  while (!i2cQueue.idle()) {
+    uint64_t next = busNextEventUs();
+    busStats.waitUs += next - clockUs;
+    simAdvanceUs(next - clockUs);
+  }
+}
+
+// ============================================================================
+// HAL: EEPROM
+// ============================================================================
+
+void halEepromRead(uint16_t address, void *data, uint16_t length) {
+  eepromInit();
+  uint8_t *out = (uint8_t *)data;
+  for (uint16_t i = 0; i < length; i++) {
+    out[i] = address + i < SIM_EEPROM_BYTES ? eeprom[address + i] : 0xFF;
+  }
+}
+
+void halEepromWrite(uint16_t address, const void *data, uint16_t length) {
+  eepromInit();
+  while (eepromCount > 0) {
+    uint64_t wait = eepromReadyUs > clockUs ? eepromReadyUs - clockUs : 0;
+    eepromStats.writeUs += wait;
+    simAdvanceUs(wait);
+  }
+  const uint8_t *in = (const uint8_t *)data;
+  for (uint16_t i = 0; i < length && address + i < SIM_EEPROM_BYTES; i++) {
+    if (eeprom[address + i] == in[i]) continue;
+    eeprom[address + i] = in[i];
+    eepromStats.bytesWritten++;
+    eepromStats.writeUs += EEPROM_WRITE_US;
+    simAdvanceUs(EEPROM_WRITE_US);
+  }
+}
+
+uint8_t halEepromQueue(uint16_t address, const uint8_t *data, uint8_t length) {
+  eepromInit();
+  if (eepromCount == 0) {
+    eepromAddress = address;
+    if (eepromReadyUs < clockUs) eepromReadyUs = clockUs;
+  } else if (address != eepromAddress + eepromCount) {
+    return 0;
+  }
+
+  uint8_t taken = 0;
+  while (taken < length && eepromCount < HAL_EEPROM_QUEUE_SIZE) {
+    eepromQueue[(eepromHead + eepromCount) % HAL_EEPROM_QUEUE_SIZE] = data[taken++];
+    eepromCount++;
+  }
+  return taken;
+}
+
+uint8_t halEepromQueued() {
+  return eepromCount;
+}
+
+// ============================================================================
+// HAL: SYSTEM
+// ============================================================================
+
+unsigned long halRandomSeed() {
+  return analogRead(A0);
+}
+
+void halHalt() {
+  fprintf(stderr, "eyesim: firmware halted at t=%.3f s\n", clockUs / 1e6);
+  exit(2);
+}
+
+uint16_t halStackFree() {
+  return 0xFFFF;
+}
@@ -0,0 +1,189 @@
+/**
+ * SimHardware.h
+ *
+ * Linux backend for the Animatronic Eyes HAL (EyeHAL.h)
+ *
+ * Everything the firmware normally touches on the UNO is modelled here:
+ * - Virtual clock: time only advances when the firmware waits (delay,
+ *   idling to the next tick, a full Serial buffer, halI2CFlush) or by the
+ *   per-loop CPU overhead the simulator charges. Hours of behaviour run
+ *   in seconds.
+ * - I2C bus: runs i2cQueue in the background like the UNO's TWI interrupt,
+ *   byte-accurate at the configured SCL clock, with register-level device
+ *   models attached by address.
+ * - Mock PCA9685: decodes register writes (including auto-increment
+ *   bursts) and records every channel write with a timestamp.
+ * - Fake nunchuck: replays a time-keyed script of joystick/button/accel
+ *   samples, including unplug/replug.
+ * - EEPROM: the UNO's 1 KB, erased (0xFF) until loaded from a file; each
+ *   changed byte costs the UNO's write time on the virtual clock.
+ */
+
+#ifndef SIM_HARDWARE_H
+#define SIM_HARDWARE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+#include "EyeHAL.h"
+
+// ============================================================================
+// VIRTUAL CLOCK
+// ============================================================================
+
+uint64_t simNowUs();
+void simAdvanceUs(uint64_t us);
+
+// ============================================================================
+// I2C BUS
+// ============================================================================
+
+/**
+ * Register-level device attached to the simulated bus
+ * Address ACK is decided by present(); payload handling by onWrite/onRead.
+ */
+class SimI2CDevice {
+public:
+  explicit SimI2CDevice(uint8_t address) : address_(address) {}
+  virtual ~SimI2CDevice() {}
+
+  uint8_t address() const { return address_; }
+  virtual bool present() const { return true; }
+  virtual void onWrite(const uint8_t *data, size_t len) = 0;
+  virtual size_t onRead(uint8_t *data, size_t len) = 0;
+
+private:
+  uint8_t address_;
+};
+
+struct SimBusStats {
+  uint32_t transactions;   // START..STOP sequences, including NACKed ones
+  uint32_t bytes;          // Bytes on the wire, including address bytes
+  uint64_t busyUs;         // Total time the bus was driven
+  uint64_t waitUs;         // Time the firmware waited for it (halI2CFlush)
+};
+
+void simI2CAttach(SimI2CDevice *device);
+void simI2CSetClock(uint32_t hz);
+uint32_t simI2CClock();
+
+/** Bus time for one transaction carrying len payload bytes */
+uint32_t simI2CTransactionUs(size_t len);
+
+const SimBusStats &simBusStats();
+void simBusStatsReset();
+
+// ============================================================================
+// MOCK PCA9685
+// ============================================================================
+
+struct PwmWrite {
+  uint64_t timeUs;
+  uint8_t address;
+  uint8_t channel;
+  uint16_t on;
+  uint16_t off;
+};
+
+class MockPCA9685 : public SimI2CDevice {
+public:
+  explicit MockPCA9685(uint8_t address);
+
+  void onWrite(const uint8_t *data, size_t len);
+  size_t onRead(uint8_t *data, size_t len);
+
+  uint16_t off(uint8_t channel) const { return off_[channel]; }
+  uint8_t prescale() const { return regs_[0xFE]; }
+  bool autoIncrement() const { return (regs_[0x00] & 0x20) != 0; }
+  float frequencyHz() const;
+  float pulseWidthUs(uint8_t channel) const;
+
+  /** Every LEDn write, in order, with its bus timestamp */
+  const std::vector<PwmWrite> &log() const { return log_; }
+  void clearLog() { log_.clear(); }
+  void setLogging(bool enabled) { logging_ = enabled; }
+
+  uint32_t channelWrites() const { return channelWrites_; }
+  uint32_t redundantWrites() const { return redundantWrites_; }
+
+private:
+  uint8_t regs_[256];
+  uint16_t off_[16];
+  std::vector<PwmWrite> log_;
+  bool logging_;
+  uint32_t channelWrites_;
+  uint32_t redundantWrites_;
+};
+
+MockPCA9685 *simAddPCA9685(uint8_t address);
+MockPCA9685 *simPCA9685(uint8_t address);
+
+// ============================================================================
+// FAKE NUNCHUCK
+// ============================================================================
+
+/**
+ * One script step: from timeMs onward the nunchuck reports this sample
+ * Script file format, one step per line ('#' starts a comment):
+ *   time_ms joyX joyY buttonZ buttonC [accelX accelY accelZ] [connected]
+ */
+struct NunchuckScriptStep {
+  uint32_t timeMs;
+  NunchuckSample sample;
+};
+
+/** Put the fake nunchuck on the bus (it follows the script) */
+void simAddNunchuck();
+
+void simNunchuckAddStep(const NunchuckScriptStep &step);
+bool simNunchuckLoadScript(const char *path);
+void simNunchuckClearScript();
+
+/** Drop the steps at or after timeMs (a replay takes over from there) */
+void simNunchuckClearScriptFrom(uint32_t timeMs);
+NunchuckSample simNunchuckSampleAt(uint64_t timeUs);
+
+// ============================================================================
+// SERIAL PORT
+// ============================================================================
+
+struct SimSerialStats {
+  uint32_t bytesWritten;
+  uint64_t blockedUs;      // Virtual time spent waiting for TX buffer space
+  uint32_t bytesReceived;
+  uint32_t rxOverflows;    // Bytes lost to a full RX buffer (64 bytes, like the UNO)
+};
+
+/** Where drained TX bytes go (NULL discards) */
+void simSerialSetSink(FILE *sink);
+
+/** Bytes arriving on RX now; beyond the 64-byte buffer they are lost */
+void simSerialInject(const uint8_t *data, size_t len);
+const SimSerialStats &simSerialStats();
+
+// ============================================================================
+// EEPROM
+// ============================================================================
+
+#define SIM_EEPROM_BYTES 1024
+
+struct SimEepromStats {
+  uint32_t bytesWritten;   // Bytes that actually changed
+  uint64_t writeUs;        // Virtual time the firmware spent writing (blocked)
+  uint32_t backgroundBytes;  // Of bytesWritten, through halEepromQueue()
+};
+
+/** Image from a file (missing file: stays erased) / back to a file */
+bool simEepromLoad(const char *path);
+bool simEepromSave(const char *path);
+const SimEepromStats &simEepromStats();
+
+// ============================================================================
+// ANALOG INPUTS
+// ============================================================================
+
+void simAnalogSet(uint8_t pin, int value);
+
+#endif // SIM_HARDWARE_H
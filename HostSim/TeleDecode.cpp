@@ -0,0 +1,197 @@
+/**
+ * TeleDecode.cpp
+ *
+ * Decodes the firmware's binary telemetry stream (Telemetry.h) into CSV
+ *
+ * Reads a raw capture of the Serial port - from eyesim --serial-log, or
+ * from the real board (e.g. `cat /dev/ttyACM0 > capture.bin`). Text the
+ * sketch prints between frames is skipped; frames failing the CRC are
+ * counted and skipped.
+ *
+ * USAGE:
+ *   teledecode [--timing FILE] [--performance FILE] [CAPTURE]   (stdin if no CAPTURE)
+ *     tick records → CSV on stdout
+ *     --timing FILE       rate-group timing records → CSV
+ *     --performance FILE  a streamed recording ("rec start serial") → log
+ *                         file (PerformanceLog.h layout, for eyesim --replay)
+ *   Summary (frames, CRC errors, sequence gaps, firmware drops) on stderr.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+#include "FrameReader.h"
+#include "PerformanceLog.h"
+#include "Telemetry.h"
+
+// SystemState in the sketch
+static const char *stateName(uint8_t state) {
+  switch (state) {
+    case 0: return "STARTUP";
+    case 1: return "ACTIVE";
+    case 2: return "IDLE";
+  }
+  return "?";
+}
+
+static uint8_t payloadSize(uint8_t type) {
+  switch (type) {
+    case FRAME_TELEMETRY_TICK: return sizeof(TelemetryTick);
+    case FRAME_TELEMETRY_TIMING: return sizeof(TelemetryTiming);
+    case FRAME_PERFORMANCE_DATA: return sizeof(PerformanceChunk);
+    case FRAME_PERFORMANCE_END: return sizeof(PerformanceHeader);
+  }
+  return 0;
+}
+
+static const char *performanceName(uint8_t flags) {
+  if (flags & TELEMETRY_FLAG_REPLAYING) return "play";
+  if (flags & TELEMETRY_FLAG_RECORDING) return "rec";
+  return "-";
+}
+
+static void writeTick(FILE *out, const TelemetryTick &t) {
+  fprintf(out, "%lu,%s,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%s,%u,%u\n",
+          (unsigned long)t.timeMs, stateName(t.state), t.joyX, t.joyY,
+          (t.flags & TELEMETRY_FLAG_BUTTON_Z) ? 1 : 0, (t.flags & TELEMETRY_FLAG_BUTTON_C) ? 1 : 0,
+          (t.flags & TELEMETRY_FLAG_CONNECTED) ? 1 : 0, (t.flags & TELEMETRY_FLAG_BLINKING) ? 1 : 0,
+          t.targetH, t.targetV, t.currentH, t.currentV, t.lids[0], t.lids[1], t.lids[2], t.lids[3],
+          t.motionExecUs, t.motionLateUs, t.busBytes, t.drops, performanceName(t.flags),
+          (t.flags & TELEMETRY_FLAG_POWER_LIMITED) ? 1 : 0, (t.flags & TELEMETRY_FLAG_TILT) ? 1 : 0);
+}
+
+static void writeTiming(FILE *out, const TelemetryTiming &t) {
+  fprintf(out, "%u,%lu,%lu,%u,%u,%u,%u\n", t.group, (unsigned long)t.runs,
+          (unsigned long)t.overruns, t.execUs, t.wcetUs, t.lateUs, t.jitterUs);
+}
+
+/**
+ * Header + data as one log file; fails if the stream is incomplete
+ */
+static int writePerformance(const char *path, bool done, const PerformanceHeader &header,
+                            std::vector<uint8_t> &data, const std::vector<bool> &have) {
+  if (!done) {
+    fprintf(stderr, "teledecode: no complete recording in the capture (rec stop sent?)\n");
+    return 1;
+  }
+  size_t missing = 0;
+  for (size_t i = 0; i < header.length; i++) {
+    if (i >= have.size() || !have[i]) missing++;
+  }
+  data.resize(header.length);
+  uint16_t crc = FRAME_CRC_INIT;
+  for (size_t i = 0; i < data.size(); i++) crc = frameCrcUpdate(crc, data[i]);
+  if (missing > 0 || crc != header.crc) {
+    fprintf(stderr, "teledecode: recording incomplete (%zu of %lu bytes missing, CRC %s)\n",
+            missing, (unsigned long)header.length, crc == header.crc ? "ok" : "bad");
+    return 1;
+  }
+
+  FILE *out = fopen(path, "wb");
+  if (out == NULL || fwrite(&header, sizeof(header), 1, out) != 1 ||
+      (header.length > 0 && fwrite(data.data(), header.length, 1, out) != 1) || fclose(out) != 0) {
+    fprintf(stderr, "teledecode: cannot write %s\n", path);
+    return 1;
+  }
+  fprintf(stderr, "teledecode: recording %lu ticks (%.1f s) in %lu bytes → %s\n",
+          (unsigned long)header.ticks, header.ticks * header.tickMs / 1000.0,
+          (unsigned long)header.length, path);
+  return 0;
+}
+
+int main(int argc, char **argv) {
+  const char *capturePath = NULL;
+  const char *timingPath = NULL;
+  const char *performancePath = NULL;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--timing") && i + 1 < argc) timingPath = argv[++i];
+    else if (!strcmp(argv[i], "--performance") && i + 1 < argc) performancePath = argv[++i];
+    else if (argv[i][0] != '-' && capturePath == NULL) capturePath = argv[i];
+    else {
+      fprintf(stderr, "usage: teledecode [--timing FILE] [--performance FILE] [CAPTURE]\n");
+      return 1;
+    }
+  }
+
+  FILE *in = capturePath ? fopen(capturePath, "rb") : stdin;
+  if (in == NULL) {
+    fprintf(stderr, "teledecode: cannot read %s\n", capturePath);
+    return 1;
+  }
+  FILE *timing = NULL;
+  if (timingPath != NULL && (timing = fopen(timingPath, "w")) == NULL) {
+    fprintf(stderr, "teledecode: cannot write %s\n", timingPath);
+    return 1;
+  }
+
+  printf("time_ms,state,joy_x,joy_y,button_z,button_c,connected,blinking,"
+         "target_h,target_v,current_h,current_v,lid_lu,lid_ll,lid_ru,lid_rl,"
+         "motion_exec_us,motion_late_us,bus_bytes,drops,performance,power_limited,tilt\n");
+  if (timing) fprintf(timing, "group,runs,overruns,exec_us,wcet_us,late_us,jitter_us\n");
+
+  FrameReader reader(payloadSize);
+  unsigned long firmwareDrops = 0;    // Last drop count reported by the sketch
+
+  // Streamed recording: chunks placed by offset, the header ends it
+  std::vector<uint8_t> performance;
+  std::vector<bool> performanceHave;
+  PerformanceHeader performanceHeader;
+  bool performanceDone = false;
+
+  uint8_t chunk[4096];
+  size_t got;
+  while ((got = fread(chunk, 1, sizeof(chunk), in)) > 0) {
+    reader.feed(chunk, got);
+
+    uint8_t type, sequence;
+    const uint8_t *payload;
+    while (reader.next(type, sequence, payload)) {
+      if (type == FRAME_TELEMETRY_TICK) {
+        TelemetryTick tick;
+        memcpy(&tick, payload, sizeof(tick));
+        firmwareDrops = tick.drops;
+        writeTick(stdout, tick);
+      } else if (type == FRAME_TELEMETRY_TIMING && timing != NULL) {
+        TelemetryTiming t;
+        memcpy(&t, payload, sizeof(t));
+        writeTiming(timing, t);
+      } else if (type == FRAME_PERFORMANCE_DATA) {
+        PerformanceChunk c;
+        memcpy(&c, payload, sizeof(c));
+        if (c.offset == 0) {
+          // A new recording starts over
+          performance.clear();
+          performanceHave.clear();
+          performanceDone = false;
+        }
+        size_t end = (size_t)c.offset + c.length;
+        if (performance.size() < end) {
+          performance.resize(end);
+          performanceHave.resize(end, false);
+        }
+        for (uint8_t i = 0; i < c.length; i++) {
+          performance[c.offset + i] = c.data[i];
+          performanceHave[c.offset + i] = true;
+        }
+      } else if (type == FRAME_PERFORMANCE_END) {
+        memcpy(&performanceHeader, payload, sizeof(performanceHeader));
+        performanceDone = true;
+      }
+    }
+  }
+
+  const FrameReaderStats &stats = reader.stats();
+  fprintf(stderr, "teledecode: %lu frames, %lu CRC errors, %lu unknown, %lu bytes skipped, "
+          "%lu missing by sequence, %lu dropped by firmware\n",
+          stats.frames, stats.crcErrors, stats.unknownTypes, stats.skippedBytes,
+          stats.sequenceGaps, firmwareDrops);
+
+  if (in != stdin) fclose(in);
+  if (timing) fclose(timing);
+  return performancePath != NULL ? writePerformance(performancePath, performanceDone, performanceHeader,
+                                                    performance, performanceHave)
+                                 : 0;
+}
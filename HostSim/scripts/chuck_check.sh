@@ -0,0 +1,41 @@
+#!/bin/sh
+# Nunchuck characterization against modelled nunchucks (NunchuckStats.h)
+#
+# For each seed, chucksim runs a session (rest captures, a range capture)
+# and checks the proposed NunchuckCalibration / DEADZONE against the
+# model; then chuckdecode decodes the binary dump of the same session and
+# must propose the identical EyeConfig.h block.
+#
+#   scripts/chuck_check.sh [SEEDS...]     (default 1 2 3)
+
+set -eu
+cd "$(dirname "$0")/.."
+
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT INT TERM
+
+# The paste-ready block, from the "Paste into" line on
+block() {
+  sed -n '/^Paste into EyeConfig.h/,/^#define DEADZONE/p' "$1" | tr -d '\r'
+}
+
+for seed in ${*:-1 2 3}; do
+  build/chucksim --seed "$seed" --dump "$TMP/chuck.bin" >"$TMP/sim.txt" || {
+    cat "$TMP/sim.txt"
+    echo "chuck_check: FAIL - seed $seed proposals off" >&2
+    exit 1
+  }
+  build/chuckdecode "$TMP/chuck.bin" >"$TMP/decoded.txt" 2>/dev/null || {
+    echo "chuck_check: FAIL - seed $seed dump did not decode" >&2
+    exit 1
+  }
+  block "$TMP/sim.txt" >"$TMP/sim.block"
+  block "$TMP/decoded.txt" >"$TMP/decoded.block"
+  [ -s "$TMP/sim.block" ] && cmp -s "$TMP/sim.block" "$TMP/decoded.block" || {
+    diff "$TMP/sim.block" "$TMP/decoded.block" || true
+    echo "chuck_check: FAIL - seed $seed decoded proposal differs from the board's" >&2
+    exit 1
+  }
+  tail -n 1 "$TMP/sim.txt" | sed "s/^/seed $seed: /"
+done
+echo "chuck_check: PASS"
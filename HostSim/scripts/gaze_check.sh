@@ -0,0 +1,35 @@
+#!/bin/sh
+# End-to-end check of the host gaze-command link (GazeLink.h)
+#
+# Runs the simulator in real time on a pseudo-terminal and streams gaze
+# commands into it with gazesend, which verifies the board's telemetry.
+#
+#   scripts/gaze_check.sh [gazesend options]     (default: 100 Hz for 10 s)
+
+set -eu
+cd "$(dirname "$0")/.."
+
+LOG=$(mktemp)
+trap 'kill "$SIM" 2>/dev/null || true; rm -f "$LOG"' EXIT INT TERM
+
+build/eyesim --pty --no-nunchuck --duration 25 >"$LOG" 2>&1 &
+SIM=$!
+
+PTY=""
+for _ in $(seq 50); do
+  PTY=$(sed -n 's/^eyesim: pty //p' "$LOG")
+  [ -n "$PTY" ] && break
+  sleep 0.1
+done
+if [ -z "$PTY" ]; then
+  echo "gaze_check: simulator did not open a pty" >&2
+  cat "$LOG" >&2
+  exit 2
+fi
+
+STATUS=0
+build/gazesend "$PTY" "$@" || STATUS=$?
+
+wait "$SIM" || true
+sed -n '/=== eyesim summary/,$p' "$LOG"
+exit $STATUS
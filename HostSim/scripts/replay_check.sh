@@ -0,0 +1,56 @@
+#!/bin/sh
+# End-to-end check of performance record / replay (PerformanceLog.h)
+#
+# 1. Records part of the demo session to EEPROM with "rec start", plays it
+#    back with "rec play" and compares the nunchuck input of both, tick
+#    for tick, from the telemetry.
+# 2. Records the same span streamed over Serial, rebuilds the log with
+#    teledecode --performance and checks it equals the EEPROM one.
+# 3. Replays that log through eyesim --replay (the host-side regression
+#    path) and checks the recorded input comes back in order.
+#
+#   scripts/replay_check.sh [LOG]     (LOG: keep the recorded log there)
+
+set -eu
+cd "$(dirname "$0")/.."
+
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT INT TERM
+LOG=${1:-$TMP/demo.nkr}
+
+# Columns: joy_x, joy_y, button_z, button_c of the ticks tagged $2
+inputs() {
+  awk -F, -v tag="$2" 'NR > 1 && $21 == tag { print $3, $4, $5, $6 }' "$1"
+}
+
+fail() {
+  echo "replay_check: FAIL - $1" >&2
+  exit 1
+}
+
+build/eyesim --duration 40 --script scripts/demo.nks --eeprom "$TMP/eeprom.bin" \
+  --serial-log "$TMP/eeprom.cap" \
+  --send "6500:rec start" --send "13000:rec stop" --send "16000:rec play" >/dev/null
+build/teledecode "$TMP/eeprom.cap" >"$TMP/eeprom.csv" 2>/dev/null
+inputs "$TMP/eeprom.csv" rec >"$TMP/recorded.txt"
+inputs "$TMP/eeprom.csv" play >"$TMP/played.txt"
+[ -s "$TMP/recorded.txt" ] || fail "nothing recorded"
+cmp -s "$TMP/recorded.txt" "$TMP/played.txt" || fail "EEPROM replay differs from the recording"
+echo "EEPROM record/replay: $(wc -l <"$TMP/recorded.txt") ticks identical"
+
+build/eyesim --duration 20 --script scripts/demo.nks --serial-log "$TMP/stream.cap" \
+  --send "6500:rec start serial" --send "13000:rec stop" >/dev/null
+build/teledecode --performance "$LOG" "$TMP/stream.cap" >/dev/null 2>"$TMP/stream.err" ||
+  { cat "$TMP/stream.err" >&2; fail "no log in the stream"; }
+SIZE=$(wc -c <"$LOG")
+dd if="$TMP/eeprom.bin" bs=1 skip=128 count="$SIZE" 2>/dev/null | cmp -s - "$LOG" ||
+  fail "streamed log differs from the EEPROM one"
+echo "Serial stream: $SIZE-byte log identical to EEPROM"
+
+build/eyesim --duration 20 --replay "7000:$LOG" --serial-log "$TMP/replay.cap" >"$TMP/replay.txt"
+build/teledecode "$TMP/replay.cap" >"$TMP/replay.csv" 2>/dev/null
+inputs "$TMP/replay.csv" - | tr '\n' ';' >"$TMP/replayed.txt"
+tr '\n' ';' <"$TMP/recorded.txt" >"$TMP/wanted.txt"
+grep -qF "$(cat "$TMP/wanted.txt")" "$TMP/replayed.txt" || fail "eyesim --replay lost input"
+echo "eyesim --replay: input identical, $(sed -n 's/^wall time.*(\(.*\))/\1/p' "$TMP/replay.txt")"
+echo "replay_check: PASS"
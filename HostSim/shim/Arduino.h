@@ -0,0 +1,145 @@
+/**
+ * Arduino.h (HostSim shim)
+ *
+ * Minimal stand-in for the Arduino core so the firmware sketches compile
+ * unmodified on Linux. Only what the sketches actually use is provided.
+ *
+ * Time functions (millis/micros/delay) are routed to the simulator's
+ * virtual clock, and Serial is a model of the UNO's 64-byte TX buffer
+ * draining at the configured baud rate - so a print storm costs virtual
+ * time exactly like it blocks the real loop.
+ */
+
+#ifndef HOSTSIM_ARDUINO_H
+#define HOSTSIM_ARDUINO_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// ============================================================================
+// TYPES AND FLASH-STRING SUPPORT
+// ============================================================================
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper *>(string_literal))
+
+// PROGMEM is ordinary memory on the host
+#define PROGMEM
+#define PSTR(s) (s)
+#define pgm_read_byte(addr)  (*(const uint8_t *)(addr))
+#define pgm_read_word(addr)  (*(const uint16_t *)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+#define pgm_read_ptr(addr)   (*(void * const *)(addr))
+#define memcpy_P memcpy
+#define memcmp_P memcmp
+#define strcmp_P strcmp
+#define strlen_P strlen
+
+#define DEC 10
+#define HEX 16
+#define BIN 2
+
+#define A0 14
+#define A1 15
+#define A2 16
+#define A3 17
+#define A4 18
+#define A5 19
+
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+#define LOW 0x0
+#define HIGH 0x1
+
+// ============================================================================
+// MATH HELPERS
+// ============================================================================
+
+template <typename T, typename L, typename H>
+inline T constrain(T x, L lo, H hi) {
+  return x < (T)lo ? (T)lo : (x > (T)hi ? (T)hi : x);
+}
+
+template <typename A, typename B>
+inline A min(A a, B b) { return a < (A)b ? a : (A)b; }
+
+template <typename A, typename B>
+inline A max(A a, B b) { return a > (A)b ? a : (A)b; }
+
+inline long map(long x, long inMin, long inMax, long outMin, long outMax) {
+  return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+// ============================================================================
+// CORE FUNCTIONS (implemented in ArduinoShim.cpp)
+// ============================================================================
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+void randomSeed(unsigned long seed);
+long random(long howBig);
+long random(long howSmall, long howBig);
+
+int analogRead(uint8_t pin);
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+// Status register (save / cli() / restore critical sections); no I-bit here
+extern volatile uint8_t SREG;
+inline void cli() {}
+inline void sei() {}
+
+// ============================================================================
+// SERIAL
+// ============================================================================
+
+class HardwareSerial {
+public:
+  void begin(unsigned long baud);
+  void end() {}
+
+  int available();
+  int read();
+  int peek();
+  int availableForWrite();
+  void flush();
+
+  size_t write(uint8_t c);
+  size_t write(const uint8_t *buffer, size_t size);
+  size_t write(const char *str) { return write((const uint8_t *)str, strlen(str)); }
+
+  size_t print(const __FlashStringHelper *s) { return write((const char *)s); }
+  size_t print(const char *s) { return write(s); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(unsigned char n, int base = DEC) { return print((unsigned long)n, base); }
+  size_t print(int n, int base = DEC) { return print((long)n, base); }
+  size_t print(unsigned int n, int base = DEC) { return print((unsigned long)n, base); }
+  size_t print(long n, int base = DEC);
+  size_t print(unsigned long n, int base = DEC);
+  size_t print(double n, int digits = 2);
+
+  size_t println() { return write("\r\n"); }
+  template <typename T>
+  size_t println(T value) { size_t n = print(value); return n + println(); }
+  template <typename T>
+  size_t println(T value, int format) { size_t n = print(value, format); return n + println(); }
+
+  operator bool() { return true; }
+};
+
+extern HardwareSerial Serial;
+
+#endif // HOSTSIM_ARDUINO_H
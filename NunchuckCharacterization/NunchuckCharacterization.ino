@@ -1,239 +1,189 @@
 /**
- * Nunchuck Characterization Tool - Min/Max Tracker
- * 
- * This tool tracks and displays the minimum and maximum values for all nunchuck inputs
- * Great for understanding your specific nunchuck's range!
- * 
+ * Nunchuck Characterization Tool - On-Device Statistics
+ *
+ * Measures your specific nunchuck: joystick range and center, how much the
+ * stick jitters at rest (deadzone), accelerometer noise - in a few seconds
+ * per controller, and proposes the NunchuckCalibration / DEADZONE values
+ * for EyeConfig.h.
+ *
+ * Captures read the nunchuck back to back (400 kHz I2C, no printing) and
+ * keep statistics in fixed memory (NunchuckStats.h); results are printed
+ * only when asked for.
+ *
  * LIBRARY REQUIRED:
  * 1. Arduino IDE → Sketch → Include Library → Manage Libraries
  * 2. Search: "WiiChuck"
  * 3. Install: "WiiChuck" by madhephaestus
- * 
+ *
  * Hardware:
  * - Arduino UNO
  * - Wii Nunchuck with I2C adapter
  * - Connect: SDA → A4, SCL → A5, VCC → 3.3V or 5V, GND → GND
- * 
- * INSTRUCTIONS:
- * 1. Upload this sketch
- * 2. Open Serial Monitor (115200 baud)
- * 3. Move joystick to ALL extremes (up, down, left, right, diagonals)
- * 4. Tilt nunchuck in all directions (for accelerometer)
- * 5. Press both buttons
- * 6. Watch min/max values update
+ *
+ * CONTROLS (Serial Monitor, 115200 baud):
+ * - 'c' → REST capture: let go of the stick, nunchuck flat and still
+ *         (REST_CAPTURE_MS). Repeat 3-4 times, flicking the stick in between:
+ *         the deadzone covers everywhere it comes back to
+ * - 'r' → RANGE capture: roll the stick around its rim, tilt the nunchuck,
+ *         press both buttons (RANGE_CAPTURE_MS)
+ * - 's' → SUMMARY: statistics + EyeConfig.h block to paste
+ * - 'b' → BINARY dump of the statistics, for HostSim's chuckdecode
+ * - 'v' → current VALUES, one line
+ * - 'x' → reset the statistics (next controller)
+ * - 'h' → help
+ * Any key ends a capture early.
+ *
+ * Typical session: c, (flick) c, (flick) c, r, s - about 15 seconds.
+ *
+ * BINARY DUMP: the statistics as framed records (same framing as the eye
+ * sketch's telemetry), ~0.5 KB. Capture the port to a file and decode:
+ *   cat /dev/ttyACM0 > chuck.bin     (send 'b', then Ctrl-C)
+ *   HostSim/build/chuckdecode chuck.bin
  */
 
 #include <Wire.h>
 #include <WiiChuck.h>
+#include "NunchuckStats.h"
+
+// ============================================================================
+// SETTINGS
+// ============================================================================
+
+#define REST_CAPTURE_MS 2000
+#define RANGE_CAPTURE_MS 6000
+#define CHUCK_I2C_HZ 400000        // Nunchucks run at 400 kHz; 100000 for long cables
 
 // Create nunchuck object
 Accessory nunchuck;
 
-// Current values
-int joyX = 0;
-int joyY = 0;
-int joyAccX = 0;
-int joyAccY = 0;
-int joyAccZ = 0;
-bool buttonZ = false;
-bool buttonC = false;
-
-// Min/Max tracking variables - initialized to opposite extremes
-int joyX_min = 32767;   // Start at max int
-int joyX_max = -32768;  // Start at min int
-int joyY_min = 32767;
-int joyY_max = -32768;
-
-int joyAccX_min = 32767;
-int joyAccX_max = -32768;
-int joyAccY_min = 32767;
-int joyAccY_max = -32768;
-int joyAccZ_min = 32767;
-int joyAccZ_max = -32768;
-
-// Button tracking (count how many times pressed)
-int buttonZ_count = 0;
-int buttonC_count = 0;
-bool buttonZ_lastState = false;
-bool buttonC_lastState = false;
+NunchuckStats stats;
 
 void setup() {
   Serial.begin(115200);
-  
+
   Serial.println(F("\n\n========================================"));
   Serial.println(F("Wii Nunchuck Characterization Tool"));
-  Serial.println(F("Min/Max Value Tracker"));
+  Serial.println(F("On-Device Statistics"));
   Serial.println(F("========================================\n"));
-  
+
   // Initialize nunchuck
   nunchuck.begin();
-  
+  Wire.setClock(CHUCK_I2C_HZ);
+
   // Wait for nunchuck to be ready
   Serial.println(F("Waiting for nunchuck..."));
   while (nunchuck.type != NUNCHUCK) {
     nunchuck.readData();
     delay(100);
   }
-  
+
   Serial.println(F("Nunchuck connected!\n"));
-  Serial.println(F("INSTRUCTIONS:"));
-  Serial.println(F("1. Move joystick to ALL extremes"));
-  Serial.println(F("2. Tilt nunchuck in all directions"));
-  Serial.println(F("3. Press both buttons"));
-  Serial.println(F("4. Watch min/max values update\n"));
-  
-  delay(2000);
+  printInstructions();
 }
 
 void loop() {
-  // Update nunchuck data
-  nunchuck.readData();
-  
-  // Get current joystick values
-  joyX = nunchuck.getJoyX();
-  joyY = nunchuck.getJoyY();
-  
-  // Get current accelerometer values
-  joyAccX = nunchuck.getAccelX();
-  joyAccY = nunchuck.getAccelY();
-  joyAccZ = nunchuck.getAccelZ();
-  
-  // Get button states
-  buttonZ = nunchuck.getButtonZ();
-  buttonC = nunchuck.getButtonC();
-  
-  // Update min/max for joystick X
-  if (joyX < joyX_min) joyX_min = joyX;
-  if (joyX > joyX_max) joyX_max = joyX;
-  
-  // Update min/max for joystick Y
-  if (joyY < joyY_min) joyY_min = joyY;
-  if (joyY > joyY_max) joyY_max = joyY;
-  
-  // Update min/max for accelerometer X
-  if (joyAccX < joyAccX_min) joyAccX_min = joyAccX;
-  if (joyAccX > joyAccX_max) joyAccX_max = joyAccX;
-  
-  // Update min/max for accelerometer Y
-  if (joyAccY < joyAccY_min) joyAccY_min = joyAccY;
-  if (joyAccY > joyAccY_max) joyAccY_max = joyAccY;
-  
-  // Update min/max for accelerometer Z
-  if (joyAccZ < joyAccZ_min) joyAccZ_min = joyAccZ;
-  if (joyAccZ > joyAccZ_max) joyAccZ_max = joyAccZ;
-  
-  // Count button presses (detect rising edge)
-  if (buttonZ && !buttonZ_lastState) {
-    buttonZ_count++;
-  }
-  if (buttonC && !buttonC_lastState) {
-    buttonC_count++;
+  if (Serial.available() > 0) {
+    char command = Serial.read();
+
+    switch (command) {
+      case 'c':  // Rest capture
+      case 'C':
+        Serial.println(F("REST: hands off, nunchuck flat and still..."));
+        stats.capture(STATS_REST, REST_CAPTURE_MS);
+        break;
+
+      case 'r':  // Range capture
+      case 'R':
+        Serial.println(F("RANGE: roll the stick around its rim, tilt, press Z and C..."));
+        stats.capture(STATS_RANGE, RANGE_CAPTURE_MS);
+        break;
+
+      case 's':  // Summary
+      case 'S':
+        stats.printSummary();
+        break;
+
+      case 'b':  // Binary dump
+      case 'B':
+        stats.writeDump();
+        break;
+
+      case 'v':  // Current values
+      case 'V':
+        printValues();
+        break;
+
+      case 'x':  // Reset
+      case 'X':
+        stats.reset();
+        Serial.println(F("Statistics reset"));
+        break;
+
+      case 'h':  // Help
+      case 'H':
+      case '?':
+        printInstructions();
+        break;
+
+      default:
+        // Ignore newlines and other chars
+        break;
+    }
   }
-  buttonZ_lastState = buttonZ;
-  buttonC_lastState = buttonC;
-  
-  // Print current values and min/max
-  printCharacterization();
-  
-  delay(100);
 }
 
-void printCharacterization() {
-  // Clear screen (optional - comment out if it's too jumpy)
-  // Serial.write(27);       // ESC
-  // Serial.print("[2J");    // Clear screen
-  // Serial.write(27);       // ESC
-  // Serial.print("[H");     // Home cursor
-  
-  Serial.println(F("========================================"));
-  Serial.println(F("CURRENT VALUES"));
-  Serial.println(F("========================================"));
-  Serial.println(F("Joy-X  Joy-Y    |  Z-Btn   C-Btn   |  AccX  AccY  AccZ"));
-  Serial.println(F("----------------------------------------------------------"));
-  
-  // Current values
-  Serial.print(joyX);
-  Serial.print("\t");
-  Serial.print(joyY);
-  Serial.print("\t| ");
-  
-  if (buttonZ) {
-    Serial.print("PRESSED ");
-  } else {
-    Serial.print("------- ");
-  }
-  
-  if (buttonC) {
-    Serial.print(" PRESSED |  ");
-  } else {
-    Serial.print(" ------- |  ");
+/**
+ * One reading for NunchuckStats; an all-0xFF report is a failed read
+ * (bus error or the nunchuck not ready), not a stick at its corner
+ */
+bool chuckReadSample(ChuckReading &sample) {
+  nunchuck.readData();
+  sample.joyX = nunchuck.getJoyX();
+  sample.joyY = nunchuck.getJoyY();
+  sample.acc[0] = nunchuck.getAccelX();
+  sample.acc[1] = nunchuck.getAccelY();
+  sample.acc[2] = nunchuck.getAccelZ();
+  sample.buttonZ = nunchuck.getButtonZ();
+  sample.buttonC = nunchuck.getButtonC();
+  return !(sample.joyX == 0xFF && sample.joyY == 0xFF && sample.acc[0] == 0x3FF &&
+           sample.acc[1] == 0x3FF && sample.acc[2] == 0x3FF);
+}
+
+void printValues() {
+  ChuckReading sample;
+  if (!chuckReadSample(sample)) {
+    Serial.println(F("Read failed"));
+    return;
   }
-  
-  Serial.print(joyAccX);
-  Serial.print("   ");
-  Serial.print(joyAccY);
-  Serial.print("   ");
-  Serial.print(joyAccZ);
-  
-  Serial.println("\n");
-  
-  // Min/Max Values Section
+  Serial.print(F("Joy "));
+  Serial.print(sample.joyX);
+  Serial.print(' ');
+  Serial.print(sample.joyY);
+  Serial.print(F("  Acc "));
+  Serial.print(sample.acc[0]);
+  Serial.print(' ');
+  Serial.print(sample.acc[1]);
+  Serial.print(' ');
+  Serial.print(sample.acc[2]);
+  Serial.print(F("  Z "));
+  Serial.print(sample.buttonZ ? F("PRESSED") : F("-------"));
+  Serial.print(F("  C "));
+  Serial.println(sample.buttonC ? F("PRESSED") : F("-------"));
+}
+
+void printInstructions() {
   Serial.println(F("========================================"));
-  Serial.println(F("MIN/MAX VALUES RECORDED"));
+  Serial.println(F("INSTRUCTIONS"));
   Serial.println(F("========================================"));
-  
-  // Joystick X
-  Serial.print(F("Joy-X:  Min = "));
-  Serial.print(joyX_min);
-  Serial.print(F("\tMax = "));
-  Serial.print(joyX_max);
-  Serial.print(F("\tRange = "));
-  Serial.println(joyX_max - joyX_min);
-  
-  // Joystick Y
-  Serial.print(F("Joy-Y:  Min = "));
-  Serial.print(joyY_min);
-  Serial.print(F("\tMax = "));
-  Serial.print(joyY_max);
-  Serial.print(F("\tRange = "));
-  Serial.println(joyY_max - joyY_min);
-  
-  Serial.println();
-  
-  // Accelerometer X
-  Serial.print(F("Acc-X:  Min = "));
-  Serial.print(joyAccX_min);
-  Serial.print(F("\tMax = "));
-  Serial.print(joyAccX_max);
-  Serial.print(F("\tRange = "));
-  Serial.println(joyAccX_max - joyAccX_min);
-  
-  // Accelerometer Y
-  Serial.print(F("Acc-Y:  Min = "));
-  Serial.print(joyAccY_min);
-  Serial.print(F("\tMax = "));
-  Serial.print(joyAccY_max);
-  Serial.print(F("\tRange = "));
-  Serial.println(joyAccY_max - joyAccY_min);
-  
-  // Accelerometer Z
-  Serial.print(F("Acc-Z:  Min = "));
-  Serial.print(joyAccZ_min);
-  Serial.print(F("\tMax = "));
-  Serial.print(joyAccZ_max);
-  Serial.print(F("\tRange = "));
-  Serial.println(joyAccZ_max - joyAccZ_min);
-  
-  Serial.println();
-  
-  // Button press counts
-  Serial.print(F("Button Z pressed: "));
-  Serial.print(buttonZ_count);
-  Serial.println(F(" times"));
-  
-  Serial.print(F("Button C pressed: "));
-  Serial.print(buttonC_count);
-  Serial.println(F(" times"));
-  
-  Serial.println(F("========================================\n\n"));
+  Serial.println(F("  c = REST capture (hands off, flat, still)"));
+  Serial.println(F("      repeat 3-4x, flicking the stick between"));
+  Serial.println(F("  r = RANGE capture (roll stick around rim,"));
+  Serial.println(F("      tilt, press Z and C)"));
+  Serial.println(F("  s = Summary + EyeConfig.h values"));
+  Serial.println(F("  b = Binary dump (HostSim chuckdecode)"));
+  Serial.println(F("  v = Current values"));
+  Serial.println(F("  x = Reset (next controller)"));
+  Serial.println(F("  h = Show this help"));
+  Serial.println(F("Any key ends a capture early"));
+  Serial.println(F("========================================\n"));
 }
@@ -0,0 +1,318 @@
+/**
+ * NunchuckStats.cpp
+ *
+ * See NunchuckStats.h
+ */
+
+#include "NunchuckStats.h"
+#include <math.h>
+
+#define STATS_REST_NOISY 3.0f      // Rest noise σ above this: the stick was touched
+#define STATS_REST_STILL 4         // Counts of slack before a lone rest reading counts as a touch
+#define STATS_FRAME_SYNC0 0xA5     // SerialFraming.h
+#define STATS_FRAME_SYNC1 0x5A
+
+static const char *const AXIS_NAMES[STATS_AXES] = {"joy X", "joy Y", "acc X", "acc Y", "acc Z"};
+
+// CRC-16/CCITT, init 0xFFFF (SerialFraming.h's frameCrcUpdate)
+static uint16_t crcUpdate(uint16_t crc, uint8_t data) {
+  data ^= (uint8_t)crc;
+  data ^= data << 4;
+  return ((((uint16_t)data << 8) | (crc >> 8)) ^ (uint8_t)(data >> 4) ^ ((uint16_t)data << 3));
+}
+
+static uint16_t saturatingIncrement(uint16_t value) {
+  return value == 0xFFFF ? value : value + 1;
+}
+
+NunchuckStats::NunchuckStats() : sequence(0) {
+  reset();
+}
+
+void NunchuckStats::reset() {
+  memset(&session, 0, sizeof(session));
+  memset(axes, 0, sizeof(axes));
+  for (uint8_t i = 0; i < STATS_AXES; i++) {
+    axes[i].axis = i;
+    axes[i].min = 0xFFFF;
+    axes[i].restMin = 0xFFFF;
+    axes[i].captureMeanMin = 0xFFFF;
+  }
+  phase = STATS_IDLE;
+  lastZ = false;
+  lastC = false;
+}
+
+void NunchuckStats::load(const NunchuckAxisStats &a) {
+  if (a.axis < STATS_AXES) axes[a.axis] = a;
+}
+
+// ============================================================================
+// CAPTURE
+// ============================================================================
+
+void NunchuckStats::capture(uint8_t newPhase, unsigned long ms) {
+  for (uint8_t i = 0; i < STATS_AXES; i++) {
+    captureCount[i] = axes[i].restCount;
+    captureSum[i] = axes[i].restSum;
+    captureSumSq[i] = axes[i].restSumSq;
+  }
+  while (Serial.available()) Serial.read();   // The command's line ending
+
+  uint32_t before = newPhase == STATS_REST ? session.restSamples : session.rangeSamples;
+  phase = newPhase;
+  unsigned long start = millis();
+  while (millis() - start < ms && !Serial.available()) {
+    ChuckReading sample;
+    if (chuckReadSample(sample)) {
+      add(sample);
+    } else {
+      session.readErrors = saturatingIncrement(session.readErrors);
+    }
+  }
+  unsigned long elapsed = millis() - start;
+  phase = STATS_IDLE;
+
+  uint32_t samples;
+  if (newPhase == STATS_REST) {
+    session.restMs += elapsed;
+    session.restCaptures++;
+    samples = session.restSamples - before;
+    endCapture();
+  } else {
+    session.rangeMs += elapsed;
+    session.rangeCaptures++;
+    samples = session.rangeSamples - before;
+  }
+
+  Serial.print(newPhase == STATS_REST ? F("Rest: ") : F("Range: "));
+  Serial.print(samples);
+  Serial.print(F(" samples in "));
+  Serial.print(elapsed);
+  Serial.print(F(" ms ("));
+  Serial.print(elapsed > 0 ? samples * 1000UL / elapsed : 0UL);
+  Serial.println(F(" Hz)"));
+}
+
+void NunchuckStats::add(const ChuckReading &sample) {
+  if (phase == STATS_IDLE) return;
+  if (phase == STATS_REST) {
+    session.restSamples++;
+  } else {
+    session.rangeSamples++;
+    if (sample.buttonZ && !lastZ) session.pressesZ = saturatingIncrement(session.pressesZ);
+    if (sample.buttonC && !lastC) session.pressesC = saturatingIncrement(session.pressesC);
+  }
+  lastZ = sample.buttonZ;
+  lastC = sample.buttonC;
+
+  addAxis(STATS_JOY_X, sample.joyX);
+  addAxis(STATS_JOY_Y, sample.joyY);
+  for (uint8_t i = 0; i < 3; i++) {
+    addAxis(STATS_ACC_X + i, sample.acc[i] & 0x3FF);
+  }
+}
+
+void NunchuckStats::addAxis(uint8_t axis, uint16_t value) {
+  NunchuckAxisStats &a = axes[axis];
+  if (phase == STATS_RANGE) {
+    if (value < a.min) a.min = value;
+    if (value > a.max) a.max = value;
+    uint8_t bin = value >> (axis < STATS_ACC_X ? STATS_JOY_BIN_SHIFT : STATS_ACCEL_BIN_SHIFT);
+    a.bins[bin] = saturatingIncrement(a.bins[bin]);
+    return;
+  }
+
+  // Full: over a minute of rest at ~1 kHz; later samples are left out
+  if (a.restSumSq > 0xFFFFFFFFUL - (uint32_t)STATS_REST_CLAMP * STATS_REST_CLAMP) return;
+  if (a.restCount == 0) a.restOrigin = value;
+  int deviation = constrain((int)value - (int)a.restOrigin, -STATS_REST_CLAMP, STATS_REST_CLAMP);
+  a.restCount++;
+  a.restSum += deviation;
+  a.restSumSq += (uint32_t)((long)deviation * deviation);
+  if (value < a.restMin) a.restMin = value;
+  if (value > a.restMax) a.restMax = value;
+}
+
+/**
+ * This REST capture's mean per axis, into the lowest / highest seen, and
+ * its spread around that mean into the noise
+ */
+void NunchuckStats::endCapture() {
+  for (uint8_t i = 0; i < STATS_AXES; i++) {
+    NunchuckAxisStats &a = axes[i];
+    uint32_t n = a.restCount - captureCount[i];
+    if (n == 0) continue;
+    int32_t sum = a.restSum - captureSum[i];
+    float spread = (float)(a.restSumSq - captureSumSq[i]) - (float)sum * sum / n;
+    if (spread > 0) a.restNoiseSq += (uint32_t)spread;
+    uint16_t meanQ4 = (uint16_t)((int32_t)a.restOrigin * 16 + sum * 16 / (int32_t)n);
+    if (meanQ4 < a.captureMeanMin) a.captureMeanMin = meanQ4;
+    if (meanQ4 > a.captureMeanMax) a.captureMeanMax = meanQ4;
+  }
+}
+
+// ============================================================================
+// PROPOSAL
+// ============================================================================
+
+void NunchuckStats::propose(NunchuckProposal &p) const {
+  memset(&p, 0, sizeof(p));
+  const NunchuckAxisStats &x = axes[STATS_JOY_X];
+  const NunchuckAxisStats &y = axes[STATS_JOY_Y];
+
+  p.haveRange = session.rangeSamples > 0 && x.max >= x.min && y.max >= y.min;
+  p.joyXMin = p.haveRange ? x.min + STATS_RANGE_INSET : 0;
+  p.joyXMax = p.haveRange ? x.max - STATS_RANGE_INSET : 255;
+  p.joyYMin = p.haveRange ? y.min + STATS_RANGE_INSET : 0;
+  p.joyYMax = p.haveRange ? y.max - STATS_RANGE_INSET : 255;
+
+  for (uint8_t i = 0; i < STATS_AXES; i++) {
+    const NunchuckAxisStats &a = axes[i];
+    if (a.restCount == 0) continue;
+    p.restMean[i] = a.restOrigin + (float)a.restSum / a.restCount;
+    p.restSigma[i] = sqrt((float)a.restNoiseSq / a.restCount);
+  }
+
+  p.haveRest = x.restCount > 0;
+  if (!p.haveRest) {
+    p.center = (p.joyXMin + p.joyXMax + p.joyYMin + p.joyYMax) / 4;
+    return;
+  }
+  p.center = (int)(0.5f * (p.restMean[STATS_JOY_X] + p.restMean[STATS_JOY_Y]) + 0.5f);
+
+  // Deadzone: every rest reading, and every capture's mean plus its noise
+  float deadzone = STATS_MIN_DEADZONE;
+  for (uint8_t i = STATS_JOY_X; i <= STATS_JOY_Y; i++) {
+    const NunchuckAxisStats &a = axes[i];
+    float far = fmax(fabs((float)a.restMin - p.center), fabs((float)a.restMax - p.center));
+    float drift = fmax(fabs(a.captureMeanMin / 16.0f - p.center),
+                       fabs(a.captureMeanMax / 16.0f - p.center));
+    float needed = fmax(far, drift + STATS_REST_SIGMAS * p.restSigma[i]) + 1;
+    if (needed > deadzone) deadzone = needed;
+
+    // Noisier than a stick at rest, or a reading far outside where it rested
+    float settled = (a.captureMeanMax - a.captureMeanMin) / 16.0f + 8 * p.restSigma[i];
+    if (p.restSigma[i] > STATS_REST_NOISY || a.restMax - a.restMin > settled + STATS_REST_STILL) {
+      p.restMoved = true;
+    }
+  }
+  p.deadzone = (int)ceil(deadzone);
+}
+
+// ============================================================================
+// REPORTS
+// ============================================================================
+
+static void printRate(uint32_t samples, uint32_t ms) {
+  Serial.print(samples);
+  Serial.print(F(" samples, "));
+  Serial.print(ms > 0 ? samples * 1000UL / ms : 0UL);
+  Serial.println(F(" Hz"));
+}
+
+void NunchuckStats::printSummary() const {
+  NunchuckProposal p;
+  propose(p);
+
+  Serial.println(F("\n--- Nunchuck statistics ---"));
+  Serial.print(F("Rest:  "));
+  Serial.print(session.restCaptures);
+  Serial.print(F(" captures, "));
+  printRate(session.restSamples, session.restMs);
+  Serial.print(F("Range: "));
+  Serial.print(session.rangeCaptures);
+  Serial.print(F(" captures, "));
+  printRate(session.rangeSamples, session.rangeMs);
+  Serial.print(F("Presses Z "));
+  Serial.print(session.pressesZ);
+  Serial.print(F(", C "));
+  Serial.print(session.pressesC);
+  Serial.print(F("; read errors "));
+  Serial.println(session.readErrors);
+
+  Serial.println(F("axis    range     rest mean  sigma  rest min-max  capture means"));
+  for (uint8_t i = 0; i < STATS_AXES; i++) {
+    const NunchuckAxisStats &a = axes[i];
+    Serial.print(AXIS_NAMES[i]);
+    Serial.print(F("   "));
+    if (a.max >= a.min) {
+      Serial.print(a.min);
+      Serial.print('-');
+      Serial.print(a.max);
+    } else {
+      Serial.print('-');
+    }
+    Serial.print(F("\t  "));
+    if (a.restCount > 0) {
+      Serial.print(p.restMean[i], 1);
+      Serial.print(F("\t     "));
+      Serial.print(p.restSigma[i], 2);
+      Serial.print(F("   "));
+      Serial.print(a.restMin);
+      Serial.print('-');
+      Serial.print(a.restMax);
+      Serial.print(F("\t    "));
+      Serial.print(a.captureMeanMin / 16.0, 1);
+      Serial.print('-');
+      Serial.println(a.captureMeanMax / 16.0, 1);
+    } else {
+      Serial.println('-');
+    }
+  }
+
+  if (!p.haveRange) Serial.println(F("No RANGE capture yet ('r'): joystick MIN/MAX are placeholders"));
+  if (!p.haveRest) Serial.println(F("No REST capture yet ('c'): CENTER is the middle of the range"));
+  if (p.restMoved) Serial.println(F("The stick moved during a REST capture: reset ('x') and redo it"));
+
+  Serial.println(F("\nPaste into EyeConfig.h:"));
+  Serial.println(F("struct NunchuckCalibration {"));
+  Serial.print(F("  static const int JOY_X_MIN = "));
+  Serial.print(p.joyXMin);
+  Serial.println(';');
+  Serial.print(F("  static const int JOY_X_MAX = "));
+  Serial.print(p.joyXMax);
+  Serial.println(';');
+  Serial.print(F("  static const int JOY_Y_MIN = "));
+  Serial.print(p.joyYMin);
+  Serial.println(';');
+  Serial.print(F("  static const int JOY_Y_MAX = "));
+  Serial.print(p.joyYMax);
+  Serial.println(';');
+  Serial.print(F("  static const int CENTER = "));
+  Serial.print(p.center);
+  Serial.println(';');
+  Serial.println(F("};"));
+  if (p.haveRest) {
+    Serial.print(F("#define DEADZONE "));
+    Serial.println(p.deadzone);
+  }
+  Serial.println();
+}
+
+// ============================================================================
+// BINARY DUMP
+// ============================================================================
+
+void NunchuckStats::writeDump() {
+  writeFrame(STATS_FRAME_SESSION, (const uint8_t *)&session, sizeof(session));
+  for (uint8_t i = 0; i < STATS_AXES; i++) {
+    writeFrame(STATS_FRAME_AXIS, (const uint8_t *)&axes[i], sizeof(axes[i]));
+  }
+}
+
+/**
+ * One SerialFraming.h frame; blocking - a dump is on request, not in a
+ * control loop
+ */
+void NunchuckStats::writeFrame(uint8_t type, const uint8_t *payload, uint8_t length) {
+  uint8_t header[4] = {STATS_FRAME_SYNC0, STATS_FRAME_SYNC1, type, sequence++};
+  uint16_t crc = 0xFFFF;
+  crc = crcUpdate(crc, header[2]);
+  crc = crcUpdate(crc, header[3]);
+  for (uint8_t i = 0; i < length; i++) crc = crcUpdate(crc, payload[i]);
+  Serial.write(header, sizeof(header));
+  Serial.write(payload, length);
+  Serial.write((uint8_t)(crc & 0xFF));
+  Serial.write((uint8_t)(crc >> 8));
+}
@@ -0,0 +1,184 @@
+/**
+ * NunchuckStats.h
+ *
+ * On-device statistics for characterizing a nunchuck in seconds
+ *
+ * The old tracker read at 10 Hz and printed a ~1 KB screen per sample, so
+ * the UART set the pace and all it kept was min/max. Here a capture reads
+ * the nunchuck back to back for a few seconds and folds every sample into
+ * fixed-size statistics; nothing is printed until asked for.
+ *
+ * Two kinds of capture, each repeatable (they accumulate):
+ *
+ *   REST   stick released, nunchuck flat and still: per-axis mean and
+ *          variance (center and rest noise → deadzone), accelerometer
+ *          noise; each capture's mean is kept too, so a few captures with
+ *          a flick of the stick in between show where it returns to
+ *   RANGE  stick rolled around its rim, nunchuck tilted: per-axis min/max
+ *          and a histogram, button presses
+ *
+ * printSummary() gives the short text report with a paste-ready
+ * NunchuckCalibration / DEADZONE block; writeDump() sends the raw
+ * statistics as a handful of framed binary records (SerialFraming.h
+ * layout, same sync and CRC as the eye sketch's telemetry) for HostSim's
+ * chuckdecode, which draws the histograms and proposes the same block.
+ *
+ * Memory: ~0.5 KB of RAM, independent of how long the captures run.
+ */
+
+#ifndef NUNCHUCK_STATS_H
+#define NUNCHUCK_STATS_H
+
+#include <Arduino.h>
+
+#define STATS_BINS 32
+#define STATS_JOY_BIN_SHIFT 3      // 256 values / 32 bins
+#define STATS_ACCEL_BIN_SHIFT 5    // 1024 values / 32 bins
+#define STATS_REST_CLAMP 255       // Rest deviations beyond this are clamped (stick was moved)
+
+// Frame types, reserved in the eye sketch's SerialFraming.h
+#define STATS_FRAME_SESSION 0x05
+#define STATS_FRAME_AXIS 0x06
+
+// Proposals: what the eye sketch's NunchuckCalibration / DEADZONE should be
+#define STATS_RANGE_INSET 2        // Counts inside the extremes, so full deflection reaches full
+#define STATS_REST_SIGMAS 3        // Deadzone covers rest noise to this many σ
+#define STATS_MIN_DEADZONE 3
+
+enum StatsAxis {
+  STATS_JOY_X,
+  STATS_JOY_Y,
+  STATS_ACC_X,
+  STATS_ACC_Y,
+  STATS_ACC_Z,
+  STATS_AXES
+};
+
+enum StatsPhase {
+  STATS_IDLE,
+  STATS_REST,
+  STATS_RANGE
+};
+
+/**
+ * One reading: joystick 0-255, accelerometer 0-1023
+ */
+struct ChuckReading {
+  uint8_t joyX;
+  uint8_t joyY;
+  uint16_t acc[3];
+  bool buttonZ;
+  bool buttonC;
+};
+
+/**
+ * One axis (STATS_FRAME_AXIS payload)
+ *
+ * Rest sums are of (value - restOrigin), the first rest value: small
+ * numbers, so the sum of squares fits and the variance stays exact.
+ * restNoiseSq leaves out where each capture came to rest: the noise alone.
+ */
+struct NunchuckAxisStats {
+  uint8_t axis;              // StatsAxis
+  uint16_t min;              // RANGE captures (0xFFFF / 0: none yet)
+  uint16_t max;
+  uint16_t bins[STATS_BINS]; // RANGE histogram (saturating)
+  uint32_t restCount;
+  int32_t restSum;
+  uint32_t restSumSq;
+  uint32_t restNoiseSq;      // Σ (value - its capture's mean)², at the end of each capture
+  uint16_t restOrigin;
+  uint16_t restMin;          // Any single rest reading
+  uint16_t restMax;
+  uint16_t captureMeanMin;   // Lowest / highest REST capture mean, Q4
+  uint16_t captureMeanMax;
+} __attribute__((packed));
+
+/**
+ * Whole session (STATS_FRAME_SESSION payload)
+ */
+struct NunchuckSessionStats {
+  uint32_t restSamples;
+  uint32_t restMs;
+  uint32_t rangeSamples;
+  uint32_t rangeMs;
+  uint16_t readErrors;       // Failed or all-0xFF reads (skipped)
+  uint16_t pressesZ;
+  uint16_t pressesC;
+  uint8_t restCaptures;
+  uint8_t rangeCaptures;
+} __attribute__((packed));
+
+/**
+ * What the statistics suggest for the eye sketch's EyeConfig.h
+ */
+struct NunchuckProposal {
+  bool haveRange;            // Else min/max are the defaults
+  bool haveRest;             // Else center is the middle of the range
+  int joyXMin;
+  int joyXMax;
+  int joyYMin;
+  int joyYMax;
+  int center;                // NunchuckCalibration has one CENTER for both axes
+  int deadzone;
+  float restMean[STATS_AXES];
+  float restSigma[STATS_AXES]; // Noise within a capture
+  bool restMoved;            // A rest capture saw the stick move: redo it
+};
+
+class NunchuckStats {
+public:
+  NunchuckStats();
+
+  void reset();
+
+  /**
+   * Read the nunchuck back to back for ms (or until a byte arrives on
+   * Serial) and fold every sample in. Blocks; one line of result on Serial.
+   */
+  void capture(uint8_t phase, unsigned long ms);
+
+  /** Fold one sample into the current phase (capture() calls this) */
+  void add(const ChuckReading &sample);
+
+  /** Short text report and the EyeConfig.h block, on Serial */
+  void printSummary() const;
+
+  /** The raw statistics as framed binary records, on Serial */
+  void writeDump();
+
+  const NunchuckSessionStats &sessionStats() const { return session; }
+  const NunchuckAxisStats &axisStats(uint8_t axis) const { return axes[axis]; }
+
+  /** Load decoded records (host decoder) */
+  void load(const NunchuckSessionStats &s) { session = s; }
+  void load(const NunchuckAxisStats &a);
+
+  void propose(NunchuckProposal &p) const;
+
+private:
+  void addAxis(uint8_t axis, uint16_t value);
+  void endCapture();
+  void writeFrame(uint8_t type, const uint8_t *payload, uint8_t length);
+
+  NunchuckSessionStats session;
+  NunchuckAxisStats axes[STATS_AXES];
+  uint8_t phase;
+  bool lastZ;
+  bool lastC;
+  uint8_t sequence;
+
+  // Where the current REST capture started, per axis
+  uint32_t captureCount[STATS_AXES];
+  int32_t captureSum[STATS_AXES];
+  uint32_t captureSumSq[STATS_AXES];
+};
+
+// ============================================================================
+// PROVIDED BY THE SKETCH (or the host model, HostSim/ChuckSim.cpp)
+// ============================================================================
+
+/** One fresh reading; false if the read failed */
+bool chuckReadSample(ChuckReading &sample);
+
+#endif // NUNCHUCK_STATS_H
@@ -0,0 +1,162 @@
+/**
+ * AutoCalibrator.cpp
+ *
+ * See AutoCalibrator.h
+ */
+
+#include "AutoCalibrator.h"
+
+AutoCalibrator::AutoCalibrator(const AutoChannel *channels, uint8_t count,
+                               const AutoProbeSettings &settings)
+  : channels(channels), count(count > AUTO_MAX_CHANNELS ? AUTO_MAX_CHANNELS : count),
+    settings(settings), baselineCounts(0), elapsedMs(0) {
+  memset(results, 0, sizeof(results));
+}
+
+uint16_t AutoCalibrator::start(uint8_t index) const {
+  // Middle of the window: assumed free (checked before searching)
+  return (channels[index].floor + channels[index].ceiling) / 2;
+}
+
+int AutoCalibrator::sample() {
+  long sum = 0;
+  for (uint8_t i = 0; i < settings.samples; i++) {
+    sum += calibratorReadProbe();
+  }
+  return (int)(sum / settings.samples);
+}
+
+bool AutoCalibrator::binds(uint8_t index, uint16_t pulse) {
+  calibratorWritePulse(channels[index].channel, pulse);
+  delay(settings.settleMs);
+  results[index].probes++;
+  return sample() > baselineCounts + (int)settings.stallRise;
+}
+
+uint16_t AutoCalibrator::findEdge(uint8_t index, uint16_t freePulse, uint16_t limitPulse,
+                                  bool &found) {
+  // Window edge free: nothing to find inside the window
+  found = binds(index, limitPulse);
+  if (!found) return limitPulse;
+
+  // Invariant: freeSide is free, bindSide binds
+  int freeSide = freePulse;
+  int bindSide = limitPulse;
+  while (abs(freeSide - bindSide) > settings.resolution) {
+    int mid = (freeSide + bindSide) / 2;
+    if (binds(index, mid)) {
+      bindSide = mid;
+    } else {
+      freeSide = mid;
+    }
+  }
+  return freeSide;
+}
+
+bool AutoCalibrator::run() {
+  unsigned long startMs = millis();
+
+  Serial.print(F("\nAuto-calibrating "));
+  Serial.print(count);
+  Serial.println(F(" channels"));
+
+  // Park everything, then measure what the rail draws at rest
+  for (uint8_t i = 0; i < count; i++) {
+    calibratorWritePulse(channels[i].channel, start(i));
+  }
+  delay(2 * settings.settleMs);
+  baselineCounts = sample();
+  Serial.print(F("Baseline probe: "));
+  Serial.print(baselineCounts);
+  Serial.print(F(" (binding above "));
+  Serial.print(baselineCounts + settings.stallRise);
+  Serial.println(F(")"));
+
+  bool allOk = true;
+  for (uint8_t i = 0; i < count; i++) {
+    const AutoChannel &c = channels[i];
+    AutoResult &r = results[i];
+    uint16_t s = start(i);
+
+    Serial.print(F("  ch "));
+    Serial.print(c.channel);
+    Serial.print(' ');
+    Serial.print(c.name);
+    Serial.print(F(": "));
+
+    // A start that binds means the window is off; searching would be wrong
+    if (binds(i, s)) {
+      calibratorWritePulse(c.channel, s);
+      r.ok = false;
+      allOk = false;
+      Serial.println(F("FAILED - binding at window center, check floor/ceiling"));
+      continue;
+    }
+
+    uint16_t edge = findEdge(i, s, c.floor, r.lowFound);
+    r.low = r.lowFound ? min((uint16_t)(edge + settings.margin), s) : c.floor;
+    calibratorWritePulse(c.channel, s);
+
+    edge = findEdge(i, s, c.ceiling, r.highFound);
+    r.high = r.highFound ? max((uint16_t)(edge - settings.margin), s) : c.ceiling;
+    calibratorWritePulse(c.channel, s);
+    r.ok = true;
+
+    Serial.print(r.low);
+    Serial.print(r.lowFound ? F("") : F(" (floor)"));
+    Serial.print(F(" - "));
+    Serial.print(r.high);
+    Serial.print(r.highFound ? F("") : F(" (ceiling)"));
+    Serial.print(F(", "));
+    Serial.print(r.probes);
+    Serial.println(F(" probes"));
+  }
+
+  elapsedMs = millis() - startMs;
+  Serial.print(F("Session: "));
+  Serial.print(elapsedMs / 1000);
+  Serial.print('.');
+  Serial.print((elapsedMs / 100) % 10);
+  Serial.println(F(" s"));
+  return allOk;
+}
+
+void AutoCalibrator::printConfig() const {
+  Serial.println(F("\n// ---- Auto-calibrated limits: paste into EyeConfig.h ----"));
+  for (uint8_t i = 0; i < count; i++) {
+    const AutoChannel &c = channels[i];
+    const AutoResult &r = results[i];
+    if (!r.ok) {
+      Serial.print(F("// "));
+      Serial.print(c.name);
+      Serial.println(F(": not calibrated"));
+      continue;
+    }
+
+    bool eye = c.kind == AUTO_EYE;
+    Serial.print(F("struct "));
+    Serial.print(c.name);
+    Serial.println(F(" {"));
+    Serial.print(eye ? F("  static const int MIN = ") : F("  static const int OPEN = "));
+    Serial.print(r.low);
+    Serial.println(r.lowFound ? F(";") : F(";  // Window floor, no binding found"));
+    if (eye) {
+      Serial.print(F("  static const int CENTER = "));
+      Serial.print((r.low + r.high) / 2);
+      Serial.println(';');
+    }
+    Serial.print(eye ? F("  static const int MAX = ") : F("  static const int CLOSED = "));
+    Serial.print(r.high);
+    Serial.println(r.highFound ? F(";") : F(";  // Window ceiling, no binding found"));
+    if (!eye) {
+      Serial.print(F("  static const int HALF = "));
+      Serial.print((r.low + r.high) / 2);
+      Serial.println(';');
+    }
+    Serial.print(F("  static const bool INVERTED = "));
+    Serial.print(c.inverted ? F("true") : F("false"));
+    Serial.println(';');
+    Serial.println(F("};"));
+  }
+  Serial.println(F("// ---------------------------------------------------------"));
+}
@@ -0,0 +1,111 @@
+/**
+ * AutoCalibrator.h
+ *
+ * Single-session limit search for every servo of an eye mechanism
+ *
+ * The manual calibrator finds one channel's MIN/MAX per flash by ear. Here
+ * a current probe does the listening: a servo pushed past its mechanical
+ * stop stalls and draws current, one that isn't holds at its idle draw.
+ * "Binds at pulse p" is monotonic on each side of a free start position,
+ * so each limit is a binary search:
+ *
+ *   floor ........ edge ......... start ......... edge ........ ceiling
+ *   (binds)    [first free]       (free)      [last free]       (binds)
+ *
+ * ~8 probes per limit instead of dozens of key presses. Each probe moves
+ * the servo, waits for it to arrive and averages the probe ADC; a binding
+ * probe lasts only that long. The limit is the edge backed off by a margin,
+ * never outside the [floor, ceiling] window the operator set. If the
+ * window edge itself is free the window edge is the limit (reported).
+ *
+ * All channels are parked at their start while the baseline current is
+ * measured, and stay there while the others are searched: one shared
+ * current sensor on the servo rail is enough.
+ *
+ * The result prints as a paste-ready EyeConfig.h block.
+ */
+
+#ifndef AUTO_CALIBRATOR_H
+#define AUTO_CALIBRATOR_H
+
+#include <Arduino.h>
+
+#define AUTO_MAX_CHANNELS 8
+
+enum AutoChannelKind {
+  AUTO_EYE,                  // MIN / CENTER / MAX
+  AUTO_LID                   // OPEN / CLOSED / HALF
+};
+
+/**
+ * One servo to calibrate (see AUTO_CHANNEL_LIST in CalibratorConfig.h)
+ */
+struct AutoChannel {
+  const char *name;          // EyeConfig.h struct the result is printed as
+  uint8_t channel;
+  uint16_t floor;            // Search window: never commanded outside it
+  uint16_t ceiling;
+  uint8_t kind;              // AutoChannelKind
+  bool inverted;             // Copied into the output (direction isn't measured)
+};
+
+struct AutoProbeSettings {
+  uint16_t stallRise;        // ADC counts above baseline that mean "binding"
+  uint16_t settleMs;         // Travel + settle time before sampling
+  uint8_t samples;           // ADC readings averaged per probe
+  uint8_t margin;            // Pulse units backed off from the binding edge
+  uint8_t resolution;        // Search stops when the bracket is this narrow
+};
+
+struct AutoResult {
+  uint16_t low;
+  uint16_t high;
+  bool lowFound;             // false: no binding inside the window (limit = floor)
+  bool highFound;
+  bool ok;                   // false: binding at the start position (check window)
+  uint8_t probes;
+};
+
+class AutoCalibrator {
+public:
+  AutoCalibrator(const AutoChannel *channels, uint8_t count, const AutoProbeSettings &settings);
+
+  /**
+   * Search every channel's limits (blocks for the whole session, with
+   * progress on Serial). Returns false if any channel failed.
+   */
+  bool run();
+
+  /** EyeConfig.h structs for every calibrated channel, on Serial */
+  void printConfig() const;
+
+  uint8_t channelCount() const { return count; }
+  const AutoResult &result(uint8_t index) const { return results[index]; }
+  int baseline() const { return baselineCounts; }
+  unsigned long sessionMs() const { return elapsedMs; }
+
+private:
+  uint16_t start(uint8_t index) const;
+  int sample();
+  bool binds(uint8_t index, uint16_t pulse);
+  uint16_t findEdge(uint8_t index, uint16_t freePulse, uint16_t limitPulse, bool &found);
+
+  const AutoChannel *channels;
+  uint8_t count;
+  AutoProbeSettings settings;
+  AutoResult results[AUTO_MAX_CHANNELS];
+  int baselineCounts;
+  unsigned long elapsedMs;
+};
+
+// ============================================================================
+// PROVIDED BY THE SKETCH (or the host model, HostSim/CalSim.cpp)
+// ============================================================================
+
+/** Command a channel's pulse (PCA9685 OFF count) */
+void calibratorWritePulse(uint8_t channel, uint16_t pulse);
+
+/** One reading of the current probe (ADC counts, higher = more current) */
+int calibratorReadProbe();
+
+#endif // AUTO_CALIBRATOR_H
@@ -81,6 +81,7 @@ const char* SERVO_NAME = "Horizontal Eye (Channel 0)";
  */
 
 // Default conservative limits for SG90 servos
+// (applied under DEFAULTS below when no preset is uncommented)
 // #define ABSOLUTE_MIN_PULSE 100   // Never go below this (HARD FLOOR)
 // #define ABSOLUTE_MAX_PULSE 650   // Never go above this (HARD CEILING)
 
@@ -166,6 +167,85 @@ const char* SERVO_NAME = "Horizontal Eye (Channel 0)";
 // #define STARTING_MIN_PULSE 275
 // #define STARTING_MAX_PULSE 375
 
+// ---- DEFAULTS (no preset uncommented) ----
+#ifndef ABSOLUTE_MIN_PULSE
+#define ABSOLUTE_MIN_PULSE 100
+#define ABSOLUTE_MAX_PULSE 650
+#define STARTING_MIN_PULSE 150
+#define STARTING_MAX_PULSE 600
+#endif
+
+// ============================================================================
+// AUTO-CALIBRATION (all channels in one session, 'a' command)
+// ============================================================================
+
+/**
+ * CURRENT PROBE
+ *
+ * Auto mode needs to know when a servo binds. Put a current sensor in the
+ * servo supply (e.g. a 0.1 ohm shunt + INA169, or an ACS712) and wire its
+ * output to PROBE_PIN. A stalled SG90 draws several hundred mA more than a
+ * holding one, so PROBE_STALL_RISE only has to clear the noise.
+ *
+ * Check first: send 'p' to print the probe reading, then push a servo
+ * against its stop by hand-stepping with 1/4 - the reading must rise by
+ * well over PROBE_STALL_RISE.
+ */
+#define PROBE_PIN A1
+#define PROBE_STALL_RISE 40        // ADC counts above the parked baseline = binding
+#define PROBE_SETTLE_MS 250        // Full-window travel + settle before sampling
+#define PROBE_SAMPLES 16           // Readings averaged per probe
+
+/**
+ * SEARCH
+ * - AUTO_MARGIN: pulse units backed off from the first binding position
+ * - AUTO_RESOLUTION: search stops when binding/free are this close
+ */
+#define AUTO_MARGIN 6
+#define AUTO_RESOLUTION 2
+
+/**
+ * CHANNELS
+ *
+ * One line per servo: EyeConfig.h struct name, channel, search window
+ * (floor/ceiling - the ABSOLUTE limits for that servo: auto mode never
+ * goes outside them), kind and the INVERTED flag to print. The middle of
+ * the window must be a free position.
+ *
+ * The windows below are the presets above. Widen them for a new servo.
+ */
+#define AUTO_CHANNEL_LIST(CHANNEL) \
+  CHANNEL("HorizontalLimits", 0, 200, 490, AUTO_EYE, true) \
+  CHANNEL("VerticalLimits",   1, 240, 460, AUTO_EYE, false) \
+  CHANNEL("LeftUpperLid",     2, 240, 430, AUTO_LID, false) \
+  CHANNEL("LeftLowerLid",     3, 300, 420, AUTO_LID, true) \
+  CHANNEL("RightUpperLid",    4, 255, 425, AUTO_LID, true) \
+  CHANNEL("RightLowerLid",    5, 255, 395, AUTO_LID, false)
+
+// ============================================================================
+// STEP RESPONSE ('r' command, for HostSim plantfit)
+// ============================================================================
+
+/**
+ * FEEDBACK
+ *
+ * 'r' times how fast the servo on SERVO_CHANNEL actually follows its pulse.
+ * It needs the position: solder a wire to the middle (wiper) leg of the
+ * servo's pot and take it, through a 10k resistor, to FEEDBACK_PIN. The
+ * pot sits across the servo's own supply - common ground with the Arduino.
+ *
+ * 'r' maps the wiper to pulse counts from two settled readings (MIN, MAX),
+ * then steps the servo through a fixed set of positions in the
+ * MIN..MAX window and prints time_ms,command,response every
+ * RESPONSE_SAMPLE_MS. Copy the CSV lines to a file and run
+ * `plantfit FILE` - it prints the PLANT_TAU_MS / PLANT_SLEW lines for the
+ * servo's struct in EyeConfig.h.
+ */
+#define FEEDBACK_PIN A2
+#define FEEDBACK_MIN_SPAN 40       // ADC counts MIN..MAX at least, else no wiper wired
+#define RESPONSE_STEP_MS 400       // Each step held this long
+#define RESPONSE_SAMPLE_MS 4       // One CSV line per sample (~20 chars at 115200)
+
 // ============================================================================
 // SAFETY NOTES
 // ============================================================================
@@ -21,6 +21,15 @@
  * - Send '-' in Serial Monitor → DECREASE step size by 5 (finer control)
  * - Send 't' in Serial Monitor → TEST sweep with current values
  * - Send 's' in Serial Monitor → SAVE/display current values
+ * - Send 'a' in Serial Monitor → AUTO-calibrate every channel in one pass
+ * - Send 'p' in Serial Monitor → PROBE reading (current sensor, for auto mode)
+ * - Send 'r' in Serial Monitor → step RESPONSE log (pot feedback, for HostSim plantfit)
+ * 
+ * AUTO MODE:
+ * - Needs a current sensor on the servo supply (PROBE_PIN in CalibratorConfig.h)
+ * - Binary-searches MIN and MAX of every channel in AUTO_CHANNEL_LIST,
+ *   within each channel's window, in well under a minute
+ * - Prints a complete EyeConfig.h block to paste (see AutoCalibrator.h)
  * 
  * STEP SIZE CONTROL:
  * - Default step size: Set in CalibratorConfig.h
@@ -34,15 +43,27 @@
  * - Arduino UNO
  * - Adafruit Servo Shield (address in CalibratorConfig.h)
  * - 1x SG90 Servo on channel specified in CalibratorConfig.h
+ *   (auto mode: every servo in AUTO_CHANNEL_LIST + a current sensor on PROBE_PIN)
  * - 5V power supply
  */
 
 #include <Wire.h>
 #include <Adafruit_PWMServoDriver.h>
 #include "CalibratorConfig.h"  // ALL CONFIGURATION HERE
+#include "AutoCalibrator.h"    // All-channel limit search (auto mode)
 
 Adafruit_PWMServoDriver pwm = Adafruit_PWMServoDriver(SERVO_SHIELD_ADDRESS);
 
+// Auto mode: every servo in AUTO_CHANNEL_LIST, one session
+#define AUTO_CHANNEL_ENTRY(name, channel, floor, ceiling, kind, inverted) \
+  { name, channel, floor, ceiling, kind, inverted },
+const AutoChannel autoChannels[] = { AUTO_CHANNEL_LIST(AUTO_CHANNEL_ENTRY) };
+const AutoProbeSettings autoProbe = {
+  PROBE_STALL_RISE, PROBE_SETTLE_MS, PROBE_SAMPLES, AUTO_MARGIN, AUTO_RESOLUTION
+};
+AutoCalibrator autoCalibrator(autoChannels, sizeof(autoChannels) / sizeof(autoChannels[0]),
+                              autoProbe);
+
 // Starting values (loaded from config, user can adjust)
 int servoMin = STARTING_MIN_PULSE;
 int servoMax = STARTING_MAX_PULSE;
@@ -189,6 +210,23 @@ void loop() {
         displayFinalValues();
         break;
         
+      case 'a':  // Auto-calibrate every channel
+      case 'A':
+        autoCalibrator.run();
+        autoCalibrator.printConfig();
+        break;
+        
+      case 'p':  // Probe reading
+      case 'P':
+        Serial.print(F("Probe: "));
+        Serial.println(calibratorReadProbe());
+        break;
+        
+      case 'r':  // Step response log
+      case 'R':
+        logStepResponse();
+        break;
+        
       case 'h':  // Help
       case 'H':
       case '?':
@@ -218,6 +256,10 @@ void printInstructions() {
   Serial.println(F(""));
   Serial.println(F("  t = Test full sweep"));
   Serial.println(F("  s = Show/save current values"));
+  Serial.println(F(""));
+  Serial.println(F("  a = Auto-calibrate ALL channels"));
+  Serial.println(F("  p = Show current probe reading"));
+  Serial.println(F("  r = Log step response (pot feedback)"));
   Serial.println(F("  h = Show this help"));
   Serial.println(F(""));
   Serial.println(F("GOAL: Adjust until servo reaches"));
@@ -316,3 +358,74 @@ void displayFinalValues() {
   Serial.println(F("You'll need them for each servo channel."));
   Serial.println(F("========================================\n"));
 }
+
+// ============================================================================
+// STEP RESPONSE (HostSim plantfit)
+// ============================================================================
+
+// Percent of MIN..MAX: small and large steps both ways (plantfit's sequence)
+const uint8_t RESPONSE_STEPS[] = {50, 60, 40, 80, 20, 100, 0, 50};
+
+int readFeedback() {
+  long sum = 0;
+  for (uint8_t i = 0; i < PROBE_SAMPLES; i++) {
+    sum += analogRead(FEEDBACK_PIN);
+  }
+  return sum / PROBE_SAMPLES;
+}
+
+int settledFeedback(int pulse) {
+  pwm.setPWM(SERVO_CHANNEL, 0, pulse);
+  delay(RESPONSE_STEP_MS * 2);
+  return readFeedback();
+}
+
+void logStepResponse() {
+  // Wiper → pulse counts, from the shaft settled at both ends
+  int adcMin = settledFeedback(servoMin);
+  int adcMax = settledFeedback(servoMax);
+  if (abs(adcMax - adcMin) < FEEDBACK_MIN_SPAN) {
+    Serial.print(F("No feedback on FEEDBACK_PIN (MIN "));
+    Serial.print(adcMin);
+    Serial.print(F(", MAX "));
+    Serial.print(adcMax);
+    Serial.println(F(") - wire the pot wiper, see CalibratorConfig.h"));
+    return;
+  }
+  settledFeedback(servoMin + (long)(servoMax - servoMin) * RESPONSE_STEPS[0] / 100);
+
+  Serial.println(F("\nStep response - copy the CSV lines to a file, run plantfit on it"));
+  Serial.println(F("time_ms,command,response"));
+  unsigned long start = millis();
+  unsigned long next = start;
+  for (uint8_t step = 0; step < sizeof(RESPONSE_STEPS); step++) {
+    int command = servoMin + (long)(servoMax - servoMin) * RESPONSE_STEPS[step] / 100;
+    pwm.setPWM(SERVO_CHANNEL, 0, command);
+    unsigned long stepEnd = millis() + RESPONSE_STEP_MS;
+    while ((long)(millis() - stepEnd) < 0) {
+      while ((long)(millis() - next) < 0) {}
+      next += RESPONSE_SAMPLE_MS;
+      unsigned long now = millis() - start;
+      long response = servoMin + (long)(readFeedback() - adcMin) * (servoMax - servoMin) /
+                                 (adcMax - adcMin);
+      Serial.print(now);
+      Serial.print(',');
+      Serial.print(command);
+      Serial.print(',');
+      Serial.println(response);
+    }
+  }
+  Serial.println(F("Step response done\n"));
+}
+
+// ============================================================================
+// AUTO MODE HOOKS (AutoCalibrator.h)
+// ============================================================================
+
+void calibratorWritePulse(uint8_t channel, uint16_t pulse) {
+  pwm.setPWM(channel, 0, pulse);
+}
+
+int calibratorReadProbe() {
+  return analogRead(PROBE_PIN);
+}